@@ -35,7 +35,9 @@ std::shared_ptr<Query> Analyze::do_analyze(std::shared_ptr<ast::TreeNode> parse)
         std::vector<ColMeta> all_cols;
         get_all_cols(query->tables, all_cols);
 
-        if(!x->has_aggre) {
+        if (x->has_group) {
+            analyze_group(x, all_cols, query);
+        } else {
             for (auto &sv_sel_col: x->cols) {
                 TabCol sel_col = {.tab_name = sv_sel_col->tab_name, .col_name = sv_sel_col->col_name};
                 query->cols.push_back(sel_col);
@@ -62,19 +64,6 @@ std::shared_ptr<Query> Analyze::do_analyze(std::shared_ptr<ast::TreeNode> parse)
                     order->cols->tab_name = order_clause.tab_name;
                 }
             }
-        } else {
-            auto aggre = x->aggreClause;
-            auto col_ = aggre->aggregation_column_;
-            if(col_== nullptr) {
-                    auto ccol = all_cols.begin();
-                    TabCol sel_col = {.tab_name = ccol->tab_name, .col_name = ccol->name};
-                    query->cols.push_back(sel_col);
-            } else {
-                TabCol col_name = {.tab_name = col_->tab_name,
-                        .col_name = col_->col_name};
-                query->cols.push_back(col_name);
-                check_column(all_cols, col_name);
-            }
         }
         //处理where条件
         get_clause(x->conds, query->conds);
@@ -130,6 +119,60 @@ std::shared_ptr<Query> Analyze::do_analyze(std::shared_ptr<ast::TreeNode> parse)
     return query;
 }
 
+/**
+ * @description: GROUP BY和聚合函数：补全分组字段和聚合字段的表名，非聚合的select字段和排序字段必须是分组字段，
+ * 排序字段也可以是聚合函数的别名。query->cols按select列表的顺序，聚合结果的表名为空、字段名为别名
+ */
+void Analyze::analyze_group(std::shared_ptr<ast::SelectStmt> x, const std::vector<ColMeta> &all_cols, std::shared_ptr<Query> query) {
+    std::vector<TabCol> group_cols;
+    for (auto &group_col : x->group_bys) {
+        TabCol col = check_column(all_cols, {.tab_name = group_col->tab_name, .col_name = group_col->col_name});
+        group_col->tab_name = col.tab_name;
+        group_cols.push_back(col);
+    }
+    auto check_grouped = [&](const TabCol &col) {
+        if (std::none_of(group_cols.begin(), group_cols.end(), [&](const TabCol &group_col) {
+                return group_col.tab_name == col.tab_name && group_col.col_name == col.col_name;
+            })) {
+            throw InvalidGroupByError(col.tab_name + '.' + col.col_name);
+        }
+    };
+    if (x->items.empty()) {
+        // select *
+        for (auto &col : all_cols) {
+            TabCol sel_col = {.tab_name = col.tab_name, .col_name = col.name};
+            check_grouped(sel_col);
+            query->cols.push_back(sel_col);
+        }
+    }
+    for (auto &item : x->items) {
+        if (item->aggre != nullptr) {
+            auto &aggre_col = item->aggre->aggregation_column_;
+            if (aggre_col != nullptr) {
+                aggre_col->tab_name = check_column(all_cols, {.tab_name = aggre_col->tab_name, .col_name = aggre_col->col_name}).tab_name;
+            }
+            query->cols.push_back({.tab_name = "", .col_name = item->aggre->nickname_});
+        } else {
+            TabCol sel_col = check_column(all_cols, {.tab_name = item->col->tab_name, .col_name = item->col->col_name});
+            check_grouped(sel_col);
+            query->cols.push_back(sel_col);
+        }
+    }
+    for (auto &order : x->orders) {
+        auto &order_col = order->cols;
+        bool is_aggre = order_col->tab_name.empty() &&
+                        std::any_of(x->items.begin(), x->items.end(), [&](const std::shared_ptr<ast::SelectItem> &item) {
+                            return item->aggre != nullptr && item->aggre->nickname_ == order_col->col_name;
+                        });
+        if (is_aggre) {
+            continue;
+        }
+        TabCol col = check_column(all_cols, {.tab_name = order_col->tab_name, .col_name = order_col->col_name});
+        check_grouped(col);
+        order_col->tab_name = col.tab_name;
+    }
+}
+
 TabCol Analyze::check_column(const std::vector<ColMeta> &all_cols, TabCol target) {
     if (target.tab_name.empty()) {
         // Table name not specified, infer table name from column name
@@ -51,6 +51,7 @@ public:
 
 private:
     TabCol check_column(const std::vector<ColMeta> &all_cols, TabCol target);
+    void analyze_group(std::shared_ptr<ast::SelectStmt> x, const std::vector<ColMeta> &all_cols, std::shared_ptr<Query> query);
     // TabCol check_column(const std::vector<ColMeta> &all_cols, TabCol &target);
     void get_all_cols(const std::vector<std::string> &tab_names, std::vector<ColMeta> &all_cols);
     void get_clause(const std::vector<std::shared_ptr<ast::BinaryExpr>> &sv_conds, std::vector<Condition> &conds);
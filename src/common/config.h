@@ -38,6 +38,11 @@ static constexpr int PAGE_SIZE = 4096;                                        //
 static constexpr int BUFFER_POOL_SIZE = 262144*4;                                // size of buffer pool 4GB
 static constexpr int LOG_BUFFER_SIZE = (65536 * PAGE_SIZE);                    // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr int LOAD_THREAD_NUM = 16;                                    // max threads parsing a csv in bulk load
+static constexpr int LOAD_CHUNK_MIN_SIZE = 1 << 20;                           // min bytes of csv parsed by one thread
+static constexpr int EXEC_MAX_DOP = 16;                                        // max worker threads of a parallel query
+static constexpr int SCAN_MORSEL_PAGES = 64;                                  // pages handed to a worker at a time in parallel scan
+static constexpr int PARALLEL_SCAN_MIN_PAGES = 4 * SCAN_MORSEL_PAGES;         // smaller tables are always scanned serially
 
 using frame_id_t = int32_t;  // frame id type, 帧页ID, 页在BufferPool中的存储单元称为帧,一帧对应一页
 using page_id_t = int32_t;   // page id type , 页ID
@@ -56,3 +61,6 @@ static const std::string LOG_FILE_NAME = "db.log";
 static const std::string REPLACER_TYPE = "LRU";
 
 static const std::string DB_META_NAME = "db.meta";
+
+// 排序等算子写出中间结果的临时文件名前缀，文件位于数据库目录中，打开数据库时清除
+static const std::string SPILL_FILE_PREFIX = "spill_";
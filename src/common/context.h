@@ -38,4 +38,5 @@ public:
     int *offset_;
     bool ellipsis_;
     bool close;
+    int dop_ = 1;           // 本会话查询的并行度，由set parallel_degree设置
 };
\ No newline at end of file
@@ -56,6 +56,11 @@ inline std::string coltype2str(ColType type) {
     return m.at(type);
 }
 
+/* 索引的组织方式 */
+enum IndexType {
+    INDEX_BTREE, INDEX_HASH
+};
+
 class RecScan {
 public:
     virtual ~RecScan() = default;
@@ -138,6 +138,12 @@ class InvalidValueCountError : public RMDBError {
     InvalidValueCountError() : RMDBError("Invalid value count") {}
 };
 
+class InvalidTableOptionError : public RMDBError {
+   public:
+    InvalidTableOptionError(const std::string &key, const std::string &value)
+        : RMDBError("Invalid table option: " + key + "=" + value) {}
+};
+
 class NeedNewPageError : public RMDBError {
 public:
     NeedNewPageError(const std::string &info) : RMDBError(info) {}
@@ -167,4 +173,12 @@ class PageNotExistError : public RMDBError {
    public:
     PageNotExistError(const std::string &table_name, int page_no)
         : RMDBError("Page " + std::to_string(page_no) + " in table " + table_name + "not exits") {}
-};
\ No newline at end of file
+};
+class InvalidGroupByError : public RMDBError {
+   public:
+    InvalidGroupByError(const std::string &col_name) : RMDBError("Column must appear in GROUP BY: " + col_name) {}
+};
+class QueryMemoryLimitError : public RMDBError {
+   public:
+    QueryMemoryLimitError(const std::string &op) : RMDBError("Query memory limit exceeded in " + op) {}
+};
@@ -0,0 +1,285 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+/**
+ * 执行器性能测试：在合成表和按TPC-C的order_line、stock表结构生成的数据上，
+ * 分别用逐条记录的get_block路径和按批的begin_batch/next_batch路径执行同一个查询计划，
+ * 校验两条路径输出的记录完全相同，并输出各自的耗时；
+ * 并行扫描、并行hash join和并行GROUP BY在宽记录的大表上按并行度1、2、4...执行，输出各并行度的耗时和相对串行的加速比，
+ * 并行度最大到工作线程数min(EXEC_MAX_DOP, CPU核数)，单核机器上只有并行度1，此时输出一行说明没有测量加速比
+ * 用法：exec_bench [合成表的记录数] [并行扫描大表的记录数]，大表每条记录128字节，例如20000000条约2.5GB
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "analyze/analyze.h"
+#include "errors.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/planner.h"
+#include "portal.h"
+
+namespace {
+
+const std::string BENCH_DB_NAME = "exec_bench_db";
+constexpr int BENCH_POOL_SIZE = 65536;
+constexpr int BENCH_REPEAT = 5;
+constexpr int BENCH_ITEMS = 100000;             // stock表的记录数，与TPC-C每个仓库的商品数相同
+
+using Clock = std::chrono::steady_clock;
+
+auto disk_manager = std::make_unique<DiskManager>();
+auto buffer_pool_manager = std::make_unique<BufferPoolManager>(BENCH_POOL_SIZE, disk_manager.get());
+auto rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+auto ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
+auto sm_manager = std::make_unique<SmManager>(disk_manager.get(), buffer_pool_manager.get(), rm_manager.get(), ix_manager.get());
+auto txn_manager = std::make_unique<TransactionManager>(sm_manager.get());
+auto lock_manager = std::make_unique<LockManager>(txn_manager.get());
+auto ql_manager = std::make_unique<QlManager>(sm_manager.get(), txn_manager.get());
+auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+auto planner = std::make_unique<Planner>(sm_manager.get());
+auto optimizer = std::make_unique<Optimizer>(sm_manager.get(), planner.get());
+auto portal = std::make_unique<Portal>(sm_manager.get());
+auto analyze = std::make_unique<Analyze>(sm_manager.get());
+
+char data_send[BUFFER_LENGTH];
+int offset = 0;
+txn_id_t txn_id = INVALID_TXN_ID;
+
+/* 解析sql并生成计划，返回执行器树的根 */
+std::shared_ptr<PortalStmt> prepare(const std::string &sql, Context *context) {
+    YY_BUFFER_STATE buf = yy_scan_string(sql.c_str());
+    if (yyparse() != 0 || ast::parse_tree == nullptr) {
+        yy_delete_buffer(buf);
+        throw InternalError("exec_bench: failed to parse " + sql);
+    }
+    yy_delete_buffer(buf);
+    auto query = analyze->do_analyze(ast::parse_tree);
+    auto plan = optimizer->plan_query(query, context);
+    return portal->start(plan, context);
+}
+
+void execute(const std::string &sql, Context *context) {
+    offset = 0;
+    portal->run(prepare(sql, context), ql_manager.get(), &txn_id, context);
+}
+
+/* 两条路径的输出：记录数和按顺序累加的校验和 */
+struct Result {
+    size_t rows = 0;
+    uint64_t checksum = 0;
+
+    void add(const char *rec, size_t len) {
+        rows++;
+        for (size_t i = 0; i < len; i++) {
+            checksum = checksum * 131 + (unsigned char)rec[i];
+        }
+    }
+
+    // 并行执行时输出的顺序不确定，各条记录的hash值相加，与顺序无关
+    void add_unordered(const char *rec, size_t len) {
+        rows++;
+        uint64_t hash = 0;
+        for (size_t i = 0; i < len; i++) {
+            hash = hash * 131 + (unsigned char)rec[i];
+        }
+        checksum += hash;
+    }
+};
+
+Result run_volcano(AbstractExecutor *root) {
+    Result result;
+    root->beginTuple();
+    for (auto &rec : root->get_block()) {
+        result.add(rec->data, root->tupleLen());
+    }
+    return result;
+}
+
+Result run_batch(AbstractExecutor *root, bool unordered = false) {
+    Result result;
+    RecordBatch batch;
+    root->begin_batch();
+    while (root->next_batch(batch)) {
+        for (size_t k = 0; k < batch.size(); k++) {
+            if (unordered) {
+                result.add_unordered(batch.at(k), root->tupleLen());
+            } else {
+                result.add(batch.at(k), root->tupleLen());
+            }
+        }
+    }
+    return result;
+}
+
+/* 每条路径执行BENCH_REPEAT次取最短耗时，每次重新生成执行器树 */
+bool bench(const std::string &name, const std::string &sql, Context *context) {
+    double best[2] = {1e18, 1e18};
+    Result results[2];
+    for (int i = 0; i < BENCH_REPEAT; i++) {
+        for (int mode = 0; mode < 2; mode++) {
+            auto stmt = prepare(sql, context);
+            auto start = Clock::now();
+            results[mode] = mode == 0 ? run_volcano(stmt->root.get()) : run_batch(stmt->root.get());
+            best[mode] = std::min(best[mode], std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+    }
+    std::cout << name << ": " << results[1].rows << " rows, tuple " << best[0] << " ms, batch " << best[1]
+              << " ms (" << best[0] / best[1] << "x)" << std::endl;
+    if (results[0].rows != results[1].rows || results[0].checksum != results[1].checksum) {
+        std::cerr << "exec_bench: " << name << " results differ (" << results[0].rows << " vs " << results[1].rows
+                  << " rows)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/* 按批执行同一个查询，会话的并行度从1开始逐级加倍直到工作线程数，校验各并行度的输出与串行相同 */
+bool bench_parallel(const std::string &name, const std::string &sql, Context *context) {
+    bool ok = true;
+    double serial = 0;
+    Result expect;
+    for (size_t dop = 1; dop <= WorkerPool::instance().size(); dop *= 2) {
+        context->dop_ = (int)dop;
+        double best = 1e18;
+        Result result;
+        for (int i = 0; i < BENCH_REPEAT; i++) {
+            auto stmt = prepare(sql, context);
+            auto start = Clock::now();
+            result = run_batch(stmt->root.get(), true);
+            best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        if (dop == 1) {
+            serial = best;
+            expect = result;
+        }
+        std::cout << name << " dop " << dop << ": " << result.rows << " rows, " << best << " ms (" << serial / best
+                  << "x)" << std::endl;
+        if (result.rows != expect.rows || result.checksum != expect.checksum) {
+            std::cerr << "exec_bench: " << name << " dop " << dop << " results differ (" << result.rows << " vs "
+                      << expect.rows << " rows)" << std::endl;
+            ok = false;
+        }
+    }
+    if (WorkerPool::instance().size() == 1) {
+        std::cout << name << ": only one worker thread (" << std::thread::hardware_concurrency()
+                  << " CPU cores), parallel speedup not measured" << std::endl;
+    }
+    context->dop_ = 1;
+    return ok;
+}
+
+/* 直接写入数据文件，不经过SQL，建表之后、建索引之前调用 */
+void fill_table(const std::string &tab_name, int num_rows, const std::function<void(int, char *)> &make) {
+    auto fh = sm_manager->fhs_.at(tab_name).get();
+    auto &tab = sm_manager->db_.get_table(tab_name);
+    size_t len = tab.cols.back().offset + tab.cols.back().len;
+    std::vector<char> buf(len);
+    for (int i = 0; i < num_rows; i++) {
+        std::fill(buf.begin(), buf.end(), 0);
+        make(i, buf.data());
+        fh->insert_record(buf.data(), nullptr);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    int num_rows = argc > 1 ? atoi(argv[1]) : 200000;
+    int big_rows = argc > 2 ? atoi(argv[2]) : 1000000;
+    if (sm_manager->is_dir(BENCH_DB_NAME)) {
+        sm_manager->drop_db(BENCH_DB_NAME);
+    }
+    sm_manager->create_db(BENCH_DB_NAME);
+    sm_manager->open_db(BENCH_DB_NAME);
+    auto context = std::make_unique<Context>(lock_manager.get(), log_manager.get(), nullptr, data_send, &offset);
+    context->txn_ = txn_manager->begin(nullptr, log_manager.get());
+    txn_id = context->txn_->get_transaction_id();
+    context->txn_->set_txn_mode(false);
+
+    // 合成表：v在[0, 10000)内均匀分布
+    execute("create table t (id int, v int, f float, s char(16));", context.get());
+    std::mt19937 rng(42);
+    fill_table("t", num_rows, [&](int i, char *rec) {
+        int v = (int)(rng() % 10000);
+        float f = (float)(rng() % 100000) / 100;
+        memcpy(rec, &i, sizeof(int));
+        memcpy(rec + 4, &v, sizeof(int));
+        memcpy(rec + 8, &f, sizeof(float));
+        snprintf(rec + 12, 16, "row%d", i);
+    });
+
+    // TPC-C的order_line和stock，只保留Stock-Level事务用到的字段
+    execute("create table order_line (ol_o_id int, ol_number int, ol_i_id int, ol_amount float);", context.get());
+    execute("create table stock (s_i_id int, s_quantity int, s_dist_01 char(24));", context.get());
+    fill_table("order_line", num_rows, [&](int i, char *rec) {
+        int o_id = i / 10, number = i % 10 + 1, i_id = (int)(rng() % BENCH_ITEMS);
+        float amount = (float)(rng() % 1000000) / 100;
+        memcpy(rec, &o_id, sizeof(int));
+        memcpy(rec + 4, &number, sizeof(int));
+        memcpy(rec + 8, &i_id, sizeof(int));
+        memcpy(rec + 12, &amount, sizeof(float));
+    });
+    fill_table("stock", BENCH_ITEMS, [&](int i, char *rec) {
+        int quantity = 10 + (int)(rng() % 91);
+        memcpy(rec, &i, sizeof(int));
+        memcpy(rec + 4, &quantity, sizeof(int));
+        snprintf(rec + 8, 24, "dist%d", i);
+    });
+    execute("create index stock(s_i_id);", context.get());
+
+    // 并行扫描的大表：v在[0, 10000)内均匀分布，pad把记录补齐到128字节
+    execute("create table big (id int, v int, f float, pad char(116));", context.get());
+    fill_table("big", big_rows, [&](int i, char *rec) {
+        int v = (int)(rng() % 10000);
+        float f = (float)(rng() % 100000) / 100;
+        memcpy(rec, &i, sizeof(int));
+        memcpy(rec + 4, &v, sizeof(int));
+        memcpy(rec + 8, &f, sizeof(float));
+        snprintf(rec + 12, 116, "pad%d", i);
+    });
+
+    bool ok = true;
+    ok &= bench("scan filter 1%", "select id, v from t where v < 100;", context.get());
+    ok &= bench("scan filter 50%", "select id, f from t where v < 5000;", context.get());
+    ok &= bench("full scan", "select * from t;", context.get());
+    ok &= bench("aggregate", "select sum(f) as total from t where v < 5000;", context.get());
+    ok &= bench("order_line scan", "select ol_i_id, ol_amount from order_line where ol_o_id > 5000;", context.get());
+    ok &= bench("order_line sort", "select ol_o_id, ol_number, ol_amount from order_line order by ol_amount desc;", context.get());
+    ok &= bench("order_line top-n", "select ol_o_id, ol_number, ol_amount from order_line order by ol_amount desc limit 10;", context.get());
+    ok &= bench("stock level join",
+                "select ol_o_id, s_i_id from order_line, stock where ol_i_id = s_i_id and s_quantity < 15 and ol_o_id > 15000;",
+                context.get());
+    ok &= bench("nested loop join", "select id, s_i_id from t, stock where s_i_id < 20 and v < s_quantity;",
+                context.get());
+    ok &= bench_parallel("parallel scan 1%", "select id, v from big where v < 100;", context.get());
+    ok &= bench_parallel("parallel scan 50%", "select id, f, pad from big where v < 5000;", context.get());
+    ok &= bench_parallel("parallel hash join",
+                         "select id, ol_amount from big, order_line where id = ol_o_id and ol_number < 3;",
+                         context.get());
+    ok &= bench_parallel("parallel group by", "select v, count(*) as c, sum(f) as s from big group by v;",
+                         context.get());
+
+    txn_manager->commit(context->txn_, log_manager.get());
+    sm_manager->close_db();
+    sm_manager->drop_db(BENCH_DB_NAME);
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "exec_bench: OK" << std::endl;
+    return 0;
+}
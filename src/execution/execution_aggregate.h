@@ -0,0 +1,389 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "execution_defs.h"
+#include "common/common.h"
+#include "index/ix.h"
+#include "parser/ast.h"
+#include "system/sm_meta.h"
+
+/**
+ * GROUP BY和聚合函数共用的分组状态布局：每个分组的状态是定长的一段字节，
+ * 开头是分组key（各分组字段的原始字节依次拼接），后面依次是各聚合函数的中间状态：
+ * COUNT和整数的SUM为int64，浮点数的SUM为double，MAX/MIN为当前最值的原始字节
+ * 输出记录依次是各分组字段和各聚合函数的结果，聚合结果的字段没有表名，字段名为AS后的别名
+ */
+class GroupAggregator {
+   private:
+    /* 一个聚合函数：输入字段在记录中的位置，中间状态在分组状态中的位置，结果在输出记录中的位置 */
+    struct Spec {
+        ast::AggregationType type;
+        bool star;              // COUNT(*)
+        ColMeta in;             // 输入字段，COUNT(*)时不使用
+        int state_off;
+        ColMeta out;
+    };
+
+    std::vector<ColMeta> group_in_;     // 分组字段在输入记录中的位置
+    std::vector<Spec> specs_;
+    int key_len_ = 0;
+    int state_len_ = 0;
+    std::vector<ColMeta> out_cols_;
+    size_t out_len_ = 0;
+
+    static const ColMeta &find_col(const std::vector<ColMeta> &cols, const TabCol &target) {
+        auto pos = std::find_if(cols.begin(), cols.end(), [&](const ColMeta &col) {
+            return (target.tab_name.empty() || col.tab_name == target.tab_name) && col.name == target.col_name;
+        });
+        if (pos == cols.end()) {
+            throw ColumnNotFoundError(target.tab_name + '.' + target.col_name);
+        }
+        return *pos;
+    }
+
+    static bool is_int(ColType type) { return type == TYPE_INT || type == TYPE_BIGINT; }
+
+    static std::int64_t load_int(const char *val, ColType type) {
+        if (type == TYPE_INT) {
+            int v;
+            memcpy(&v, val, sizeof(int));
+            return v;
+        }
+        std::int64_t v;
+        memcpy(&v, val, sizeof(std::int64_t));
+        return v;
+    }
+
+   public:
+    GroupAggregator() = default;
+    GroupAggregator(const std::vector<ColMeta> &in_cols, const std::vector<TabCol> &group_cols,
+                    const std::vector<std::shared_ptr<ast::AggreClause>> &aggres) {
+        for (auto &group_col : group_cols) {
+            auto col = find_col(in_cols, group_col);
+            group_in_.push_back(col);
+            col.offset = out_len_;
+            out_cols_.push_back(col);
+            out_len_ += col.len;
+            key_len_ += col.len;
+        }
+        state_len_ = key_len_;
+        for (auto &aggre : aggres) {
+            Spec spec{aggre->aggregation_type_, aggre->aggregation_column_ == nullptr, ColMeta{}, state_len_, ColMeta{}};
+            spec.out.name = aggre->nickname_;
+            if (spec.star) {
+                spec.out.type = TYPE_INT;
+                spec.out.len = sizeof(int);
+                state_len_ += sizeof(std::int64_t);
+            } else {
+                spec.in = find_col(in_cols, {aggre->aggregation_column_->tab_name, aggre->aggregation_column_->col_name});
+                switch (spec.type) {
+                    case ast::AggregationType::COUNT:
+                        spec.out.type = TYPE_INT;
+                        spec.out.len = sizeof(int);
+                        state_len_ += sizeof(std::int64_t);
+                        break;
+                    case ast::AggregationType::SUM:
+                        if (spec.in.type == TYPE_FLOAT) {
+                            spec.out.type = TYPE_FLOAT;
+                            spec.out.len = sizeof(float);
+                            state_len_ += sizeof(double);
+                        } else if (is_int(spec.in.type)) {
+                            spec.out.type = TYPE_BIGINT;
+                            spec.out.len = sizeof(std::int64_t);
+                            state_len_ += sizeof(std::int64_t);
+                        } else {
+                            throw IncompatibleTypeError(coltype2str(spec.in.type), "SUM");
+                        }
+                        break;
+                    case ast::AggregationType::MAX:
+                    case ast::AggregationType::MIN:
+                        spec.out.type = spec.in.type;
+                        spec.out.len = spec.in.len;
+                        state_len_ += spec.in.len;
+                        break;
+                }
+            }
+            spec.out.offset = out_len_;
+            out_len_ += spec.out.len;
+            out_cols_.push_back(spec.out);
+            specs_.push_back(spec);
+        }
+    }
+
+    int key_len() const { return key_len_; }
+    int state_len() const { return state_len_; }
+    size_t out_len() const { return out_len_; }
+    const std::vector<ColMeta> &out_cols() const { return out_cols_; }
+
+    /**
+     * @brief 没有分组字段，且各聚合函数读取的都是同一个字段时，只需要该字段就能完成聚合
+     * @param col 各聚合函数读取的字段，全部是COUNT(*)时不修改
+     */
+    bool single_input(ColMeta &col) const {
+        if (!group_in_.empty()) {
+            return false;
+        }
+        for (auto &spec : specs_) {
+            if (spec.star) {
+                continue;
+            }
+            if (!col.name.empty() && (col.tab_name != spec.in.tab_name || col.name != spec.in.name)) {
+                return false;
+            }
+            col = spec.in;
+        }
+        return true;
+    }
+
+    // 0.0和-0.0属于同一个分组但字节不同，统一成0.0
+    void make_key(const char *row, char *key) const {
+        for (auto &col : group_in_) {
+            memcpy(key, row + col.offset, col.len);
+            if (col.type == TYPE_FLOAT && *(float *)key == 0) {
+                *(float *)key = 0;
+            }
+            key += col.len;
+        }
+    }
+
+    // 用分组的第一条记录初始化状态，key已经写在state的开头
+    void init(char *state, const char *row) const {
+        for (auto &spec : specs_) {
+            char *acc = state + spec.state_off;
+            switch (spec.type) {
+                case ast::AggregationType::COUNT: {
+                    std::int64_t one = 1;
+                    memcpy(acc, &one, sizeof(one));
+                    break;
+                }
+                case ast::AggregationType::SUM:
+                    if (spec.in.type == TYPE_FLOAT) {
+                        float v;
+                        memcpy(&v, row + spec.in.offset, sizeof(float));
+                        double sum = v;
+                        memcpy(acc, &sum, sizeof(sum));
+                    } else {
+                        std::int64_t sum = load_int(row + spec.in.offset, spec.in.type);
+                        memcpy(acc, &sum, sizeof(sum));
+                    }
+                    break;
+                case ast::AggregationType::MAX:
+                case ast::AggregationType::MIN:
+                    memcpy(acc, row + spec.in.offset, spec.in.len);
+                    break;
+            }
+        }
+    }
+
+    // 没有任何输入记录时（只在没有GROUP BY时输出）的状态：COUNT和SUM为0，MAX/MIN为全0
+    void init_empty(char *state) const { memset(state, 0, state_len_); }
+
+    void update(char *state, const char *row) const {
+        for (auto &spec : specs_) {
+            char *acc = state + spec.state_off;
+            switch (spec.type) {
+                case ast::AggregationType::COUNT: {
+                    std::int64_t cnt;
+                    memcpy(&cnt, acc, sizeof(cnt));
+                    cnt++;
+                    memcpy(acc, &cnt, sizeof(cnt));
+                    break;
+                }
+                case ast::AggregationType::SUM:
+                    if (spec.in.type == TYPE_FLOAT) {
+                        float v;
+                        double sum;
+                        memcpy(&v, row + spec.in.offset, sizeof(float));
+                        memcpy(&sum, acc, sizeof(sum));
+                        sum += v;
+                        memcpy(acc, &sum, sizeof(sum));
+                    } else {
+                        std::int64_t sum;
+                        memcpy(&sum, acc, sizeof(sum));
+                        sum += load_int(row + spec.in.offset, spec.in.type);
+                        memcpy(acc, &sum, sizeof(sum));
+                    }
+                    break;
+                case ast::AggregationType::MAX:
+                case ast::AggregationType::MIN: {
+                    int cmp = ix_compare(row + spec.in.offset, acc, spec.in.type, spec.in.len);
+                    if (spec.type == ast::AggregationType::MAX ? cmp > 0 : cmp < 0) {
+                        memcpy(acc, row + spec.in.offset, spec.in.len);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    // 把同一个分组的另一份中间状态合并进state，用于并行聚合时合并各线程的局部结果
+    void merge(char *state, const char *other) const {
+        for (auto &spec : specs_) {
+            char *acc = state + spec.state_off;
+            const char *val = other + spec.state_off;
+            switch (spec.type) {
+                case ast::AggregationType::COUNT:
+                case ast::AggregationType::SUM:
+                    if (spec.type == ast::AggregationType::SUM && spec.in.type == TYPE_FLOAT) {
+                        double sum, add;
+                        memcpy(&sum, acc, sizeof(sum));
+                        memcpy(&add, val, sizeof(add));
+                        sum += add;
+                        memcpy(acc, &sum, sizeof(sum));
+                    } else {
+                        std::int64_t sum, add;
+                        memcpy(&sum, acc, sizeof(sum));
+                        memcpy(&add, val, sizeof(add));
+                        sum += add;
+                        memcpy(acc, &sum, sizeof(sum));
+                    }
+                    break;
+                case ast::AggregationType::MAX:
+                case ast::AggregationType::MIN: {
+                    int cmp = ix_compare(val, acc, spec.in.type, spec.in.len);
+                    if (spec.type == ast::AggregationType::MAX ? cmp > 0 : cmp < 0) {
+                        memcpy(acc, val, spec.in.len);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    // 把分组状态转换成输出记录
+    void finalize(const char *state, char *out) const {
+        memcpy(out, state, key_len_);
+        for (auto &spec : specs_) {
+            const char *acc = state + spec.state_off;
+            char *res = out + spec.out.offset;
+            switch (spec.type) {
+                case ast::AggregationType::COUNT: {
+                    std::int64_t cnt;
+                    memcpy(&cnt, acc, sizeof(cnt));
+                    int v = (int)cnt;
+                    memcpy(res, &v, sizeof(v));
+                    break;
+                }
+                case ast::AggregationType::SUM:
+                    if (spec.in.type == TYPE_FLOAT) {
+                        double sum;
+                        memcpy(&sum, acc, sizeof(sum));
+                        float v = (float)sum;
+                        memcpy(res, &v, sizeof(v));
+                    } else {
+                        memcpy(res, acc, sizeof(std::int64_t));
+                    }
+                    break;
+                case ast::AggregationType::MAX:
+                case ast::AggregationType::MIN:
+                    memcpy(res, acc, spec.out.len);
+                    break;
+            }
+        }
+    }
+
+    // 在输出记录的字段中查找，聚合结果按别名查找
+    ColMeta get_col(const TabCol &target) const {
+        auto pos = std::find_if(out_cols_.begin(), out_cols_.end(), [&](const ColMeta &col) {
+            return (target.tab_name.empty() || col.tab_name == target.tab_name) && col.name == target.col_name;
+        });
+        if (pos == out_cols_.end()) {
+            throw ColumnNotFoundError(target.tab_name + '.' + target.col_name);
+        }
+        return *pos;
+    }
+};
+
+/**
+ * 分组状态的hash表：各分组的状态按GroupAggregator的布局定长连续存放，状态开头就是分组key，
+ * 开放寻址的槽位中只保存分组的下标，线性探查，槽位数保持在分组数的2倍以上
+ */
+class GroupHashTable {
+   public:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    explicit GroupHashTable(int key_len = 0, int state_len = 0) : key_len_(key_len), state_len_(state_len) { clear(); }
+
+    size_t size() const { return num_groups_; }
+    char *state(size_t i) { return states_.data() + i * state_len_; }
+    uint64_t hash(size_t i) const { return hashes_[i]; }
+
+    /**
+     * @brief 查找key所在的分组
+     * @return 分组的下标，不存在时返回NIL，pos为之后insert用的空槽位
+     */
+    uint32_t find(const char *key, uint64_t hash, size_t &pos) const {
+        size_t mask = slots_.size() - 1;
+        for (pos = hash & mask; slots_[pos] != NIL; pos = (pos + 1) & mask) {
+            uint32_t g = slots_[pos];
+            if (hashes_[g] == hash && memcmp(states_.data() + (size_t)g * state_len_, key, key_len_) == 0) {
+                return g;
+            }
+        }
+        return NIL;
+    }
+
+    // 在find返回的空槽位上新建分组，只写入key，返回它的状态
+    char *insert(size_t pos, const char *key, uint64_t hash) {
+        slots_[pos] = num_groups_;
+        states_.resize((num_groups_ + 1) * state_len_);
+        hashes_.push_back(hash);
+        char *res = state(num_groups_);
+        memcpy(res, key, key_len_);
+        num_groups_++;
+        if (num_groups_ * 2 > slots_.size()) {
+            rehash(slots_.size() * 2);
+        }
+        return res;
+    }
+
+    // 容纳groups个分组（包括槽位扩容后的大小）需要的内存
+    size_t bytes_for(size_t groups) const {
+        size_t capacity = slots_.size();
+        while (groups * 2 > capacity) {
+            capacity <<= 1;
+        }
+        return groups * (state_len_ + sizeof(uint64_t)) + capacity * sizeof(uint32_t);
+    }
+
+    void clear() {
+        states_.clear();
+        hashes_.clear();
+        slots_.assign(16, NIL);
+        num_groups_ = 0;
+    }
+
+   private:
+    void rehash(size_t capacity) {
+        slots_.assign(capacity, NIL);
+        size_t mask = capacity - 1;
+        for (size_t g = 0; g < num_groups_; g++) {
+            size_t pos = hashes_[g] & mask;
+            while (slots_[pos] != NIL) {
+                pos = (pos + 1) & mask;
+            }
+            slots_[pos] = g;
+        }
+    }
+
+    int key_len_;
+    int state_len_;
+    std::vector<char> states_;
+    std::vector<uint64_t> hashes_;
+    std::vector<uint32_t> slots_;
+    size_t num_groups_ = 0;
+};
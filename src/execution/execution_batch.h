@@ -0,0 +1,66 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "execution_predicate.h"
+
+constexpr size_t EXEC_BATCH_SIZE = 1024;    // next_batch每批最多返回的记录数
+
+/**
+ * 批量执行时算子之间传递的一批定长记录：所有行连续存放在data中，sel按顺序列出仍然有效的行号
+ * 过滤只改写sel，不移动记录；消费者按sel访问，用at(k)取第k条有效记录
+ * 同一个RecordBatch在多次next_batch之间复用，缓冲区只在第一次或记录变长时分配
+ */
+struct RecordBatch {
+    size_t tuple_len = 0;               // 每条记录的长度
+    size_t num_rows = 0;                // data中已经写入的行数
+    std::vector<char> data;
+    std::vector<uint16_t> sel;          // 有效记录的行号
+
+    void reset(size_t len) {
+        tuple_len = len;
+        num_rows = 0;
+        sel.clear();
+        if (data.size() < len * EXEC_BATCH_SIZE) {
+            data.resize(len * EXEC_BATCH_SIZE);
+        }
+    }
+
+    bool full() const { return num_rows == EXEC_BATCH_SIZE; }
+    size_t size() const { return sel.size(); }
+    bool empty() const { return sel.empty(); }
+
+    char *row(size_t i) { return data.data() + i * tuple_len; }
+    const char *at(size_t k) const { return data.data() + sel[k] * tuple_len; }
+
+    // 追加一行并标记为有效，返回写入位置
+    char *append() {
+        sel.push_back(num_rows);
+        return row(num_rows++);
+    }
+
+    void append(const char *rec) { memcpy(append(), rec, tuple_len); }
+
+    // 只保留满足pred的记录
+    void select(const CompiledPredicate &pred) {
+        size_t n = 0;
+        for (auto i : sel) {
+            if (pred.eval(data.data() + i * tuple_len)) {
+                sel[n++] = i;
+            }
+        }
+        sel.resize(n);
+    }
+};
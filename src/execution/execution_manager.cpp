@@ -17,7 +17,6 @@ See the Mulan PSL v2 for more details. */
 #include "executor_seq_scan.h"
 #include "executor_delete.h"
 #include "executor_update.h"
-#include "executor_aggre.h"
 #include "index/ix.h"
 #include "record_printer.h"
 // class SeqScanExecutor;
@@ -25,7 +24,7 @@ See the Mulan PSL v2 for more details. */
 const char *help_info = "Supported SQL syntax:\n"
                    "  command ;\n"
                    "command:\n"
-                   "  CREATE TABLE table_name (column_name type [, column_name type ...])\n"
+                   "  CREATE TABLE table_name (column_name type [, column_name type ...]) [WITH (layout = {row | pax})]\n"
                    "  DROP TABLE table_name\n"
                    "  CREATE INDEX table_name (column_name)\n"
                    "  DROP INDEX table_name (column_name)\n"
@@ -52,7 +51,7 @@ void QlManager::run_mutli_query(std::shared_ptr<Plan> plan, Context *context){
         switch(x->tag) {
             case T_CreateTable:
             {
-                sm_manager_->create_table(x->tab_name_, x->cols_, context);
+                sm_manager_->create_table(x->tab_name_, x->cols_, context, x->layout_);
                 break;
             }
             case T_DropTable:
@@ -62,7 +61,8 @@ void QlManager::run_mutli_query(std::shared_ptr<Plan> plan, Context *context){
             }
             case T_CreateIndex:
             {
-                sm_manager_->create_index(x->tab_name_, x->tab_col_names_, context);
+                sm_manager_->create_index(x->tab_name_, x->tab_col_names_, context, x->fill_factor_,
+                                          x->index_type_, x->unique_);
                 break;
             }
             case T_DropIndex:
@@ -183,47 +183,39 @@ void QlManager::select_from(std::unique_ptr<AbstractExecutor> executorTreeRoot,
     // Print records
     size_t num_rec = 0;
     // 执行query_plan
-    executorTreeRoot->beginTuple();
-    auto block = executorTreeRoot->get_block();
-    for (const auto& Tuple: block) {
-        std::vector<std::string> columns;
-        for (auto &col: executorTreeRoot->cols()) {
-            std::string col_str;
-            char *rec_buf = Tuple->data + col.offset;
-            if (col.type == TYPE_INT) {
-                col_str = std::to_string(*(int *) rec_buf);
-            } else if (col.type == TYPE_FLOAT) {
-                if (executorTreeRoot->has_aggre() &&
-                    executorTreeRoot->get_aggre_type() == ast::AggregationType::COUNT) {
+    executorTreeRoot->begin_batch();
+    RecordBatch batch;
+    while (executorTreeRoot->next_batch(batch)) {
+        for (size_t k = 0; k < batch.size(); k++) {
+            std::vector<std::string> columns;
+            for (auto &col: executorTreeRoot->cols()) {
+                std::string col_str;
+                const char *rec_buf = batch.at(k) + col.offset;
+                if (col.type == TYPE_INT) {
                     col_str = std::to_string(*(int *) rec_buf);
-                } else {
+                } else if (col.type == TYPE_FLOAT) {
                     col_str = std::to_string(*(float *) rec_buf);
-                }
-            } else if (col.type == TYPE_STRING) {
-                if (executorTreeRoot->has_aggre() &&
-                    executorTreeRoot->get_aggre_type() == ast::AggregationType::COUNT) {
-                    col_str = std::to_string(*(int *) rec_buf);
-                } else {
+                } else if (col.type == TYPE_STRING) {
+                    col_str = std::string((char *) rec_buf, col.len);
+                    col_str.resize(strlen(col_str.c_str()));
+                } else if (col.type == TYPE_BIGINT) {
+                    col_str = std::to_string(*(std::int64_t *) rec_buf);
+                } else if (col.type == TYPE_DATETIME) {
                     col_str = std::string((char *) rec_buf, col.len);
                     col_str.resize(strlen(col_str.c_str()));
                 }
-            } else if (col.type == TYPE_BIGINT) {
-                col_str = std::to_string(*(std::int64_t *) rec_buf);
-            } else if (col.type == TYPE_DATETIME) {
-                col_str = std::string((char *) rec_buf, col.len);
-                col_str.resize(strlen(col_str.c_str()));
+                columns.push_back(col_str);
             }
-            columns.push_back(col_str);
-        }
-        // print record into buffer
-        rec_printer.print_record(columns, context);
-        // print record into file
-        outfile << "|";
-        for (int i = 0; i < columns.size(); ++i) {
-            outfile << " " << columns[i] << " |";
+            // print record into buffer
+            rec_printer.print_record(columns, context);
+            // print record into file
+            outfile << "|";
+            for (int i = 0; i < columns.size(); ++i) {
+                outfile << " " << columns[i] << " |";
+            }
+            outfile << "\n";
+            num_rec++;
         }
-        outfile << "\n";
-        num_rec++;
     }
     outfile.close();
     // Print footer into buffer
@@ -0,0 +1,88 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+constexpr size_t QUERY_MEM_BUDGET = 256 << 20;     // 一个查询中所有物化算子可以使用的内存总量
+constexpr size_t MEM_RESERVE_CHUNK = 1 << 20;      // 算子每次向预算申请的最小字节数
+
+/**
+ * 一个查询的内存预算，由Portal为每个查询创建，排序、hash表的build端、嵌套循环连接的内表等物化算子共享
+ * 扫描、过滤、投影等流水线算子只持有一批记录，不占用预算
+ */
+class MemoryBudget {
+   private:
+    size_t limit_;
+    std::atomic<size_t> used_{0};
+
+   public:
+    explicit MemoryBudget(size_t limit = QUERY_MEM_BUDGET) : limit_(limit) {}
+
+    // 预算不足时不做任何修改，返回false
+    bool try_reserve(size_t bytes) {
+        size_t used = used_.load();
+        do {
+            if (used + bytes > limit_) {
+                return false;
+            }
+        } while (!used_.compare_exchange_weak(used, used + bytes));
+        return true;
+    }
+
+    void release(size_t bytes) { used_ -= bytes; }
+
+    size_t used() const { return used_.load(); }
+    size_t limit() const { return limit_; }
+};
+
+/**
+ * 一个算子从MemoryBudget中得到的预留，按chunk（默认MEM_RESERVE_CHUNK）为单位增长，析构或reset时归还
+ * 并行算子中每个工作线程各有一份预留，用较小的chunk，避免每个线程都至少占一整块
+ * 没有预算（例如不经过Portal直接构造的算子）时不做限制
+ */
+class MemoryReservation {
+   private:
+    std::shared_ptr<MemoryBudget> budget_;
+    size_t bytes_ = 0;
+    size_t chunk_ = MEM_RESERVE_CHUNK;
+
+   public:
+    MemoryReservation() = default;
+    explicit MemoryReservation(std::shared_ptr<MemoryBudget> budget, size_t chunk = MEM_RESERVE_CHUNK)
+        : budget_(std::move(budget)), chunk_(chunk) {}
+    MemoryReservation(const MemoryReservation &) = delete;
+    MemoryReservation &operator=(const MemoryReservation &) = delete;
+    ~MemoryReservation() { reset(); }
+
+    // 保证预留至少need字节，预算不足时返回false
+    bool grow(size_t need) {
+        if (need <= bytes_ || budget_ == nullptr) {
+            return true;
+        }
+        size_t add = std::max(need - bytes_, chunk_);
+        if (!budget_->try_reserve(add)) {
+            return false;
+        }
+        bytes_ += add;
+        return true;
+    }
+
+    void reset() {
+        if (budget_ != nullptr) {
+            budget_->release(bytes_);
+        }
+        bytes_ = 0;
+    }
+};
@@ -0,0 +1,143 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/config.h"
+
+/**
+ * 所有并行查询共用的工作线程池，第一次使用时创建，线程数为EXEC_MAX_DOP和CPU核数中的较小值
+ * 任务按提交顺序执行；等待任务结果的线程不能是池中的线程，否则可能互相等待
+ */
+class WorkerPool {
+   private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_;
+    std::vector<std::thread> threads_;
+    bool stop_ = false;
+
+    explicit WorkerPool(size_t num_threads) {
+        for (size_t i = 0; i < num_threads; i++) {
+            threads_.emplace_back([this] { work(); });
+        }
+    }
+
+    void work() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+                if (tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+   public:
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto &thread : threads_) {
+            thread.join();
+        }
+    }
+
+    static WorkerPool &instance() {
+        static WorkerPool pool(std::max(1u, std::min<unsigned>(EXEC_MAX_DOP, std::thread::hardware_concurrency())));
+        return pool;
+    }
+
+    size_t size() const { return threads_.size(); }
+
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        cv_.notify_one();
+    }
+
+    // 在池中并行执行task(0)...task(n-1)并等待全部完成，有任务抛出异常时在调用线程中重新抛出第一个异常
+    void run(size_t n, const std::function<void(size_t)> &task) {
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t left = n;
+        std::exception_ptr error;
+        for (size_t i = 0; i < n; i++) {
+            submit([&, i] {
+                std::exception_ptr e;
+                try {
+                    task(i);
+                } catch (...) {
+                    e = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                if (e != nullptr && error == nullptr) {
+                    error = e;
+                }
+                if (--left == 0) {
+                    done.notify_all();
+                }
+            });
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return left == 0; });
+        if (error != nullptr) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+/**
+ * 并行扫描时表的页面按morsel分给各个工作线程：每次取走相邻的SCAN_MORSEL_PAGES个页面，扫描完再取下一个，
+ * 先扫描完的线程自然多取，各线程的负载不需要事先划分
+ */
+class PageMorsels {
+   private:
+    std::atomic<int> next_{0};
+    int end_ = 0;
+
+   public:
+    // 在开始扫描前（没有线程在取morsel时）设置要扫描的页面范围[begin, end)
+    void reset(int begin, int end) {
+        next_ = begin;
+        end_ = end;
+    }
+
+    // 取下一个morsel，所有页面都已经分出去时返回false
+    bool next(int &begin, int &end) {
+        int page = next_.fetch_add(SCAN_MORSEL_PAGES);
+        if (page >= end_) {
+            return false;
+        }
+        begin = page;
+        end = std::min(page + SCAN_MORSEL_PAGES, end_);
+        return true;
+    }
+};
@@ -0,0 +1,200 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "execution_defs.h"
+#include "common/common.h"
+#include "system/sm_meta.h"
+
+/* 比较函数：lhs、rhs分别指向两个值，len为字符串比较的长度 */
+using PredicateCmp = bool (*)(const char *lhs, const char *rhs, int len);
+
+// 数值比较，rhs的类型可以比lhs窄（BIGINT字段与INT常量比较时先扩展成int64）
+template <typename L, typename R, typename Op>
+bool predicate_cmp_num(const char *lhs, const char *rhs, int) {
+    L a;
+    R b;
+    memcpy(&a, lhs, sizeof(L));
+    memcpy(&b, rhs, sizeof(R));
+    return Op{}(a, static_cast<L>(b));
+}
+
+// 字符串和DATETIME按字节比较
+template <typename Op>
+bool predicate_cmp_bytes(const char *lhs, const char *rhs, int len) {
+    return Op{}(memcmp(lhs, rhs, len), 0);
+}
+
+/**
+ * 编译后的条件：把一组Condition在构造时解析成(偏移, 类型, 操作符, 常量)的步骤，
+ * 每个步骤的比较函数按类型和操作符实例化好，求值时不再按名字查找字段，遇到不满足的步骤立即返回
+ * 常量的原始字节拷贝在consts_中，Condition之后被修改需要重新bind
+ * 连接条件可以按左右两条记录的布局分别bind，求值时字段直接在两条记录中按偏移引用，不必拼接记录
+ */
+class CompiledPredicate {
+   private:
+    struct Step {
+        int lhs_off;            // lhs字段在记录中的偏移
+        int rhs_off;            // rhs为字段时在记录中的偏移，为常量时在consts_中的偏移
+        bool rhs_is_const;
+        bool lhs_right;         // 两条记录上求值时lhs字段在右边的记录中
+        bool rhs_right;         // 两条记录上求值时rhs字段在右边的记录中
+        int len;                // 字符串比较的长度，取lhs字段的长度
+        bool bytes;             // 按字节比较
+        PredicateCmp cmp;
+    };
+
+    std::vector<Step> steps_;
+    std::string consts_;        // 所有常量的原始字节
+
+    template <typename Op>
+    static PredicateCmp pick(ColType lhs_type, ColType rhs_type) {
+        switch (lhs_type) {
+            case TYPE_INT:
+                return predicate_cmp_num<int, int, Op>;
+            case TYPE_FLOAT:
+                return predicate_cmp_num<float, float, Op>;
+            case TYPE_BIGINT:
+                if (rhs_type == TYPE_INT) {
+                    return predicate_cmp_num<std::int64_t, int, Op>;
+                }
+                return predicate_cmp_num<std::int64_t, std::int64_t, Op>;
+            case TYPE_STRING:
+            case TYPE_DATETIME:
+                return predicate_cmp_bytes<Op>;
+            default:
+                throw InternalError("Unexpected data type");
+        }
+    }
+
+    static PredicateCmp pick(CompOp op, ColType lhs_type, ColType rhs_type) {
+        switch (op) {
+            case OP_EQ:
+                return pick<std::equal_to<>>(lhs_type, rhs_type);
+            case OP_NE:
+                return pick<std::not_equal_to<>>(lhs_type, rhs_type);
+            case OP_LT:
+                return pick<std::less<>>(lhs_type, rhs_type);
+            case OP_GT:
+                return pick<std::greater<>>(lhs_type, rhs_type);
+            case OP_LE:
+                return pick<std::less_equal<>>(lhs_type, rhs_type);
+            case OP_GE:
+                return pick<std::greater_equal<>>(lhs_type, rhs_type);
+            default:
+                throw InternalError("Unexpected op type");
+        }
+    }
+
+    static const ColMeta *match_col(const std::vector<ColMeta> &rec_cols, const TabCol &target) {
+        auto pos = std::find_if(rec_cols.begin(), rec_cols.end(), [&](const ColMeta &col) {
+            return (target.tab_name.empty() || col.tab_name == target.tab_name) && col.name == target.col_name;
+        });
+        return pos == rec_cols.end() ? nullptr : &*pos;
+    }
+
+    // 先在左边的字段中找，找不到时在右边找，right返回字段所在的一边
+    static const ColMeta &find_col(const std::vector<ColMeta> &left_cols, const std::vector<ColMeta> &right_cols,
+                                   const TabCol &target, bool &right) {
+        auto col = match_col(left_cols, target);
+        right = col == nullptr;
+        if (right) {
+            col = match_col(right_cols, target);
+        }
+        if (col == nullptr) {
+            throw ColumnNotFoundError(target.tab_name + '.' + target.col_name);
+        }
+        return *col;
+    }
+
+   public:
+    CompiledPredicate() = default;
+    CompiledPredicate(const std::vector<ColMeta> &rec_cols, const std::vector<Condition> &conds) {
+        bind(rec_cols, conds);
+    }
+
+    // 按rec_cols的布局解析conds，类型不兼容时在这里抛出IncompatibleTypeError
+    void bind(const std::vector<ColMeta> &rec_cols, const std::vector<Condition> &conds) { bind(rec_cols, {}, conds); }
+
+    // 连接条件：字段在left_cols或right_cols中，之后用eval(left, right)在两条记录上求值
+    void bind(const std::vector<ColMeta> &left_cols, const std::vector<ColMeta> &right_cols,
+              const std::vector<Condition> &conds) {
+        steps_.clear();
+        consts_.clear();
+        for (auto &cond : conds) {
+            bool lhs_right;
+            auto &lhs_col = find_col(left_cols, right_cols, cond.lhs_col, lhs_right);
+            Step step{lhs_col.offset, 0, cond.is_rhs_val, lhs_right, false, lhs_col.len,
+                      lhs_col.type == TYPE_STRING || lhs_col.type == TYPE_DATETIME, nullptr};
+            ColType rhs_type;
+            if (cond.is_rhs_val) {
+                rhs_type = cond.rhs_val.type;
+                if (cond.rhs_val.raw == nullptr) {
+                    throw InternalError("Condition value is not initialized");
+                }
+                // 常量不足lhs字段的长度时补0，保证按lhs长度比较不会越界
+                step.rhs_off = consts_.size();
+                int n = std::min(cond.rhs_val.raw->size, lhs_col.len);
+                consts_.append(cond.rhs_val.raw->data, n);
+                consts_.append(lhs_col.len - n, '\0');
+            } else {
+                auto &rhs_col = find_col(left_cols, right_cols, cond.rhs_col, step.rhs_right);
+                rhs_type = rhs_col.type;
+                step.rhs_off = rhs_col.offset;
+            }
+            if (rhs_type != lhs_col.type) {
+                if (rhs_type == TYPE_DATETIME && lhs_col.type == TYPE_STRING && lhs_col.len >= 19) {
+                } else if (rhs_type == TYPE_INT && lhs_col.type == TYPE_BIGINT) {
+                } else {
+                    throw IncompatibleTypeError(coltype2str(lhs_col.type), coltype2str(rhs_type));
+                }
+            }
+            step.cmp = pick(cond.op, lhs_col.type, rhs_type);
+            steps_.push_back(step);
+        }
+        // 数值比较比按字节比较便宜，先做
+        std::stable_partition(steps_.begin(), steps_.end(), [](const Step &step) { return !step.bytes; });
+    }
+
+    bool eval(const char *rec) const {
+        const char *consts = consts_.data();
+        for (auto &step : steps_) {
+            const char *rhs = step.rhs_is_const ? consts + step.rhs_off : rec + step.rhs_off;
+            if (!step.cmp(rec + step.lhs_off, rhs, step.len)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool eval(const RmRecord *rec) const { return eval(rec->data); }
+
+    // 在连接的两条记录上求值，按bind(left_cols, right_cols, conds)时字段所在的一边取值
+    bool eval(const char *left, const char *right) const {
+        const char *consts = consts_.data();
+        for (auto &step : steps_) {
+            const char *lhs = (step.lhs_right ? right : left) + step.lhs_off;
+            const char *rhs = step.rhs_is_const ? consts + step.rhs_off : (step.rhs_right ? right : left) + step.rhs_off;
+            if (!step.cmp(lhs, rhs, step.len)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool empty() const { return steps_.empty(); }
+};
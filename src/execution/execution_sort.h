@@ -11,35 +11,65 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 #include "execution_defs.h"
 #include "execution_manager.h"
+#include "execution_memory.h"
+#include "execution_spill.h"
 #include "executor_abstract.h"
 #include "index/ix.h"
 #include "system/sm.h"
 
+constexpr size_t SORT_MEM_LIMIT = 64 << 20;     // 一个run在内存中的上限，超过后把已排好序的run写入临时文件
 
+/**
+ * ORDER BY的外部排序：输入记录定长连续存放在内存的run中，对(规范化的key前缀, 记录下标)排序，
+ * 前缀能区分的比较不访问记录，相同时再逐个字段比较，最后按输入顺序，因此排序是稳定的
+ * run超过SORT_MEM_LIMIT或查询的内存预算不足时，排好序写入临时文件；输入结束后最后一个run留在内存中，
+ * 所有run用败者树做k路归并。有LIMIT且前LIMIT条记录放得下时只用一个大小为LIMIT的堆保留最靠前的记录
+ */
 class SortExecutor : public AbstractExecutor {
    private:
+    /* run中的一条记录：第一个排序字段规范化后的前8字节（按无符号整数比较与排序方向一致）、记录下标和输入顺序 */
+    struct SortEntry {
+        uint64_t prefix;
+        uint32_t row;
+        uint32_t seq;
+    };
+
+    /* 归并的一路输入：临时文件中的run或内存中的run */
+    struct MergeSource {
+        SpillFile *run;             // 为nullptr时是内存中的run
+        size_t pos;                 // 内存中的run的下一条记录
+        const char *cur;            // 当前记录，为nullptr时该路已经读完
+        uint64_t prefix;
+    };
+
     std::unique_ptr<AbstractExecutor> prev_;
     std::vector<ColMeta> cols_; // 框架中只支持一个键排序，需要自行修改数据结构支持多个键排序
-    // std::vector<ColMeta> col;
-    size_t tuple_num;
     bool has_nlj = false;
     size_t off = 0;
     int limit_ = -1;
-    bool has_limit = false;
+    int emitted_ = 0;                       // 已经输出的记录数
     std::string tbl_name_;
-    // bool is_desc_;
     std::vector<std::shared_ptr<ast::OrderBy>> orders_;
-    std::vector<size_t> used_tuple;
-    std::vector<std::unique_ptr<RmRecord>> all_tuples;
-    // std::unique_ptr<RmRecord> current_tuple;
-    std::unique_ptr<RmRecord> next_tuple;
     std::vector<std::pair<ColMeta, ast::OrderByDir>> sort_cols_;
+    MemoryReservation mem_;                 // 内存中的run占用的查询内存预算
+    DiskManager *disk_manager_;             // 写临时文件，为nullptr时不能溢出，超过内存预算时报错
+
+    size_t len_;
+    std::vector<char> rows_;                // 内存中的run的记录
+    std::vector<SortEntry> entries_;
+    std::vector<std::unique_ptr<SpillFile>> runs_;
+    std::vector<MergeSource> sources_;
+    std::vector<int> tree_;                 // 败者树，tree_[0]为胜者，其余为各内部结点上的败者
+    const char *cur_ = nullptr;             // 当前输出的记录
+    bool begun_ = false;
 
    public:
     [[nodiscard]] const std::vector<ColMeta> &cols() const override {
        return prev_->cols();
     }
-    SortExecutor(std::unique_ptr<AbstractExecutor> prev, std::vector<std::shared_ptr<ast::OrderBy>> orders, int limit) {
+    SortExecutor(std::unique_ptr<AbstractExecutor> prev, std::vector<std::shared_ptr<ast::OrderBy>> orders, int limit,
+                 std::shared_ptr<MemoryBudget> budget = nullptr, DiskManager *disk_manager = nullptr)
+        : mem_(std::move(budget)), disk_manager_(disk_manager) {
         prev_ = std::move(prev);
         has_nlj = prev_->has_nlj();
         if(has_nlj) {
@@ -66,76 +96,279 @@ class SortExecutor : public AbstractExecutor {
             }
         }
        orders_ = orders;
-        tuple_num = 0;
         limit_ = limit;
-        used_tuple.clear();
+        len_ = prev_->tupleLen();
     }
 
-
     void beginTuple() override {
-        // Get all tuples
-        // std::cout<<"sort begin tuple"<<std::endl;
+        begun_ = true;
+        emitted_ = 0;
+        cur_ = nullptr;
+        rows_.clear();
+        entries_.clear();
+        runs_.clear();
+        sources_.clear();
+        mem_.reset();
         if(limit_==0) {
             return;
         }
-        if(limit_>0){
-            has_limit = true;
-        }
-        prev_->beginTuple();
-        while(!prev_->is_end()) {
-            all_tuples.push_back(prev_->Next());
-            prev_->nextTuple();
-        }
-        tuple_num = all_tuples.size();
-        if(tuple_num==0) {
-            return ;
-        }
-        // std::cout<<"afet sort, tuple_num is "<<tuple_num<<std::endl;
-        // 对所有元组进行一次排序
-        std::sort(all_tuples.begin(), all_tuples.end(),
-                  [this](const std::unique_ptr<RmRecord>& a, const std::unique_ptr<RmRecord>& b) -> bool {
-                      for(auto& sort_col : this->sort_cols_){
-                          const char *data_a = a->data+sort_col.first.offset;
-                          const char *data_b = b->data+sort_col.first.offset;
-                          int comparison = ix_compare(data_a, data_b, sort_col.first.type, sort_col.first.len);
-                          if(comparison != 0){
-                              return sort_col.second == ast::OrderBy_DESC ? comparison < 0 : comparison > 0;
-                          }
-                      }
-                      return false;
-                  });
-        // std::cout<<"there are "<<all_tuples.size()<<" tuples\n";
-        // next_tuple = std::move(all_tuples.back());
-        // all_tuples.erase(all_tuples.end() - 1);
+        // 排序是流水线的断点，需要物化全部输入，内存中的run占用的内存计入查询的预算
+        prev_->begin_batch();
+        size_t top_n_bytes = limit_ > 0 ? (size_t)limit_ * (len_ + sizeof(SortEntry)) : SIZE_MAX;
+        if (top_n_bytes <= SORT_MEM_LIMIT && mem_.grow(top_n_bytes)) {
+            top_n();
+        } else {
+            RecordBatch batch;
+            while (prev_->next_batch(batch)) {
+                for (size_t k = 0; k < batch.size(); k++) {
+                    size_t need = (entries_.size() + 1) * (len_ + sizeof(SortEntry));
+                    if (!entries_.empty() && (need > SORT_MEM_LIMIT || !mem_.grow(need))) {
+                        spill();
+                    }
+                    const char *rec = batch.at(k);
+                    uint32_t row = entries_.size();
+                    entries_.push_back(SortEntry{key_prefix(rec), row, row});
+                    rows_.insert(rows_.end(), rec, rec + len_);
+                }
+            }
+            if (!mem_.grow(entries_.size() * (len_ + sizeof(SortEntry)))) {
+                spill();
+            }
+        }
+        sort_entries();
+        // 各个run和内存中的run（输入顺序在最后）作为归并的输入
+        for (auto &run : runs_) {
+            run->finish();
+            sources_.push_back(MergeSource{run.get(), 0, nullptr, 0});
+        }
+        sources_.push_back(MergeSource{nullptr, 0, nullptr, 0});
+        for (auto &source : sources_) {
+            advance(source);
+        }
+        tree_.assign(sources_.size(), -1);
+        tree_[0] = build(1);
+        cur_ = sources_[tree_[0]].cur;
     }
 
     [[nodiscard]] bool is_end() const override {
-        if(has_limit) {
-            return ((limit_<=0)||(tuple_num<=0));
-        } else {
-            return tuple_num <= 0;
+        return cur_ == nullptr || (limit_ >= 0 && emitted_ >= limit_);
+    }
+
+    void nextTuple() override {
+        if (is_end()) {
+            return;
         }
+        emitted_++;
+        pop();
     }
+
+    std::unique_ptr<RmRecord> Next() override {
+        if (is_end()) {
+            return nullptr;
+        }
+        auto rec = std::make_unique<RmRecord>(len_);
+        memcpy(rec->data, cur_, len_);
+        return rec;
+    }
+
     std::vector<std::unique_ptr<RmRecord>> get_block() override {
-        std::reverse(all_tuples.begin(),all_tuples.end());
-        if(has_limit&&all_tuples.size()>limit_) {
-            all_tuples.erase(all_tuples.begin()+limit_,all_tuples.end());
+        if (!begun_) {
+            beginTuple();
+        }
+        std::vector<std::unique_ptr<RmRecord>> block;
+        for (; !is_end(); nextTuple()) {
+            block.push_back(Next());
         }
-        return std::move(all_tuples);
+        return block;
     }
-    void nextTuple() override {
-            next_tuple = std::move(all_tuples.back());
-            all_tuples.erase(all_tuples.end() - 1);
+    size_t tupleLen() const override { return len_; }
+
+    bool next_batch(RecordBatch &batch) override {
+        if (!begun_) {
+            beginTuple();
+        }
+        batch.reset(len_);
+        while (!batch.full() && !is_end()) {
+            batch.append(cur_);
+            emitted_++;
+            pop();
+        }
+        return !batch.empty();
     }
 
-    std::unique_ptr<RmRecord> Next() override {
-        tuple_num--;
-        limit_--;
-        return std::move(next_tuple);
+    Rid &rid() override { return _abstract_rid; }
+
+   private:
+    // 第一个排序字段的前8字节，整数翻转符号位、浮点数按符号翻转、字符串按大端，降序时取反
+    uint64_t key_prefix(const char *rec) const {
+        auto &col = sort_cols_.front().first;
+        const char *val = rec + col.offset;
+        uint64_t prefix = 0;
+        switch (col.type) {
+            case TYPE_INT: {
+                int v;
+                memcpy(&v, val, sizeof(int));
+                prefix = (uint64_t)((uint32_t)v ^ 0x80000000u) << 32;
+                break;
+            }
+            case TYPE_BIGINT: {
+                std::int64_t v;
+                memcpy(&v, val, sizeof(std::int64_t));
+                prefix = (uint64_t)v ^ (1ull << 63);
+                break;
+            }
+            case TYPE_FLOAT: {
+                float v;
+                memcpy(&v, val, sizeof(float));
+                if (v == 0) {
+                    v = 0;      // -0.0与0.0相等
+                }
+                uint32_t bits;
+                memcpy(&bits, &v, sizeof(bits));
+                bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+                prefix = (uint64_t)bits << 32;
+                break;
+            }
+            default:
+                for (int i = 0; i < 8; i++) {
+                    prefix = prefix << 8 | (i < col.len ? (unsigned char)val[i] : 0);
+                }
+                break;
+        }
+        return sort_cols_.front().second == ast::OrderBy_DESC ? ~prefix : prefix;
     }
 
-    void feed(const std::map<TabCol, Value> &feed_dict) override {
-        throw InternalError("Cannot feed a sort node");
+    // 按排序字段逐个比较记录，a排在b之前时返回负数
+    int compare(const char *a, const char *b) const {
+        for (auto &sort_col : sort_cols_) {
+            int cmp = ix_compare(a + sort_col.first.offset, b + sort_col.first.offset, sort_col.first.type, sort_col.first.len);
+            if (cmp != 0) {
+                return sort_col.second == ast::OrderBy_DESC ? -cmp : cmp;
+            }
+        }
+        return 0;
     }
-    Rid &rid() override { return _abstract_rid; }
-};
\ No newline at end of file
+
+    // a是否排在b之前，ra、rb为两条记录的数据
+    bool before(const SortEntry &a, const char *ra, const SortEntry &b, const char *rb) const {
+        if (a.prefix != b.prefix) {
+            return a.prefix < b.prefix;
+        }
+        int cmp = compare(ra, rb);
+        return cmp != 0 ? cmp < 0 : a.seq < b.seq;
+    }
+
+    void sort_entries() {
+        const char *rows = rows_.data();
+        std::sort(entries_.begin(), entries_.end(), [&](const SortEntry &a, const SortEntry &b) {
+            return before(a, rows + (size_t)a.row * len_, b, rows + (size_t)b.row * len_);
+        });
+    }
+
+    /**
+     * ORDER BY ... LIMIT n：只保留当前最靠前的n条记录，entries_是以排在最后的记录为堆顶的大根堆，
+     * rows_固定为n个位置，新记录排在堆顶之前时替换堆顶的位置；前缀就能判断排在堆顶之后的记录不访问rows_
+     */
+    void top_n() {
+        rows_.resize((size_t)limit_ * len_);
+        auto cmp = [&](const SortEntry &a, const SortEntry &b) {
+            return before(a, rows_.data() + (size_t)a.row * len_, b, rows_.data() + (size_t)b.row * len_);
+        };
+        uint32_t seq = 0;
+        RecordBatch batch;
+        while (prev_->next_batch(batch)) {
+            for (size_t k = 0; k < batch.size(); k++) {
+                const char *rec = batch.at(k);
+                SortEntry entry{key_prefix(rec), 0, seq++};
+                if (entries_.size() < (size_t)limit_) {
+                    entry.row = entries_.size();
+                } else {
+                    auto &top = entries_.front();
+                    if (entry.prefix > top.prefix || !before(entry, rec, top, rows_.data() + (size_t)top.row * len_)) {
+                        continue;
+                    }
+                    entry.row = top.row;
+                    std::pop_heap(entries_.begin(), entries_.end(), cmp);
+                    entries_.pop_back();
+                }
+                memcpy(rows_.data() + (size_t)entry.row * len_, rec, len_);
+                entries_.push_back(entry);
+                std::push_heap(entries_.begin(), entries_.end(), cmp);
+            }
+        }
+    }
+
+    // 内存中的run排好序写入临时文件，没有DiskManager时不能溢出
+    void spill() {
+        if (disk_manager_ == nullptr) {
+            throw QueryMemoryLimitError("sort");
+        }
+        sort_entries();
+        auto run = std::make_unique<SpillFile>(disk_manager_, len_);
+        for (auto &entry : entries_) {
+            run->append(rows_.data() + (size_t)entry.row * len_);
+        }
+        runs_.push_back(std::move(run));
+        rows_.clear();
+        entries_.clear();
+    }
+
+    void advance(MergeSource &source) {
+        if (source.run != nullptr) {
+            source.cur = source.run->next();
+        } else if (source.pos < entries_.size()) {
+            source.cur = rows_.data() + (size_t)entries_[source.pos++].row * len_;
+        } else {
+            source.cur = nullptr;
+        }
+        if (source.cur != nullptr) {
+            source.prefix = key_prefix(source.cur);
+        }
+    }
+
+    // 第a路的当前记录是否排在第b路之前，读完的一路排在最后，相同时输入顺序靠前的run先输出
+    bool beats(int a, int b) const {
+        auto &x = sources_[a];
+        auto &y = sources_[b];
+        if (x.cur == nullptr || y.cur == nullptr) {
+            return y.cur == nullptr && x.cur != nullptr;
+        }
+        if (x.prefix != y.prefix) {
+            return x.prefix < y.prefix;
+        }
+        int cmp = compare(x.cur, y.cur);
+        return cmp != 0 ? cmp < 0 : a < b;
+    }
+
+    /**
+     * @brief 建立败者树：结点node的儿子为2node和2node+1，编号不小于k的结点是第node-k路输入
+     * @return 以node为根的子树的胜者
+     */
+    int build(size_t node) {
+        size_t k = sources_.size();
+        if (node >= k) {
+            return node - k;
+        }
+        int l = build(2 * node);
+        int r = build(2 * node + 1);
+        if (beats(l, r)) {
+            tree_[node] = r;
+            return l;
+        }
+        tree_[node] = l;
+        return r;
+    }
+
+    // 输出胜者的当前记录后，该路读入下一条，沿到根的路径与各结点上的败者比较
+    void pop() {
+        int winner = tree_[0];
+        advance(sources_[winner]);
+        for (size_t node = (winner + sources_.size()) / 2; node >= 1; node /= 2) {
+            if (beats(tree_[node], winner)) {
+                std::swap(tree_[node], winner);
+            }
+        }
+        tree_[0] = winner;
+        cur_ = sources_[winner].cur;
+    }
+};
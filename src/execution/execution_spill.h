@@ -0,0 +1,164 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "execution_defs.h"
+#include "storage/disk_manager.h"
+
+constexpr int SPILL_PARTITION_BITS = 4;         // 每次分区用hash值的4位，分成16个分区
+constexpr int SPILL_MAX_DEPTH = 3;              // 分区后仍然放不下时再分区的最大层数
+
+/**
+ * 算子溢出到临时文件的一串定长记录：按顺序紧密排列，跨页存放，通过DiskManager按页写入和读取
+ * 先逐条append，finish后从头逐条读出；最后一页不满时也写满一页，读取时按记录数判断结束
+ * 临时文件在写出第一页时才创建，没有写过记录时不占文件
+ */
+class SpillFile {
+   private:
+    DiskManager *disk_manager_;
+    std::string path_;
+    int fd_ = -1;
+    size_t len_;                    // 记录长度
+    size_t rows_ = 0;               // 文件中的记录数
+    size_t read_ = 0;               // 已经读出的记录数
+    page_id_t page_no_ = 0;
+    size_t page_pos_ = 0;           // 页内的读写位置
+    std::vector<char> page_;
+    std::vector<char> row_;         // 当前记录，可能跨页，拷贝出来
+
+    void flush_page() {
+        if (fd_ == -1) {
+            path_ = disk_manager_->create_spill_file();
+            fd_ = disk_manager_->open_file(path_);
+        }
+        disk_manager_->write_page(fd_, page_no_++, page_.data(), PAGE_SIZE);
+        page_pos_ = 0;
+    }
+
+    void load_page() {
+        disk_manager_->read_page(fd_, page_no_++, page_.data(), PAGE_SIZE);
+        page_pos_ = 0;
+    }
+
+   public:
+    SpillFile(DiskManager *disk_manager, size_t len) : disk_manager_(disk_manager), len_(len), page_(PAGE_SIZE), row_(len) {}
+
+    SpillFile(const SpillFile &) = delete;
+    SpillFile &operator=(const SpillFile &) = delete;
+
+    // 析构时不能抛出异常（可能正在因为别的异常而回收算子），清理失败时只能留下临时文件，下次打开数据库时删除
+    ~SpillFile() {
+        if (fd_ == -1) {
+            return;
+        }
+        try {
+            disk_manager_->close_file(fd_);
+        } catch (RMDBError &) {
+        }
+        try {
+            disk_manager_->destroy_file(path_);
+        } catch (RMDBError &) {
+        }
+    }
+
+    size_t rows() const { return rows_; }
+
+    void append(const char *rec) {
+        for (size_t done = 0; done < len_;) {
+            size_t n = std::min(len_ - done, PAGE_SIZE - page_pos_);
+            memcpy(page_.data() + page_pos_, rec + done, n);
+            page_pos_ += n;
+            done += n;
+            if (page_pos_ == PAGE_SIZE) {
+                flush_page();
+            }
+        }
+        rows_++;
+    }
+
+    // 写完之后转为从头读取
+    void finish() {
+        if (page_pos_ > 0) {
+            flush_page();
+        }
+        page_no_ = 0;
+        page_pos_ = PAGE_SIZE;
+        read_ = 0;
+    }
+
+    // 读出下一条记录，读完时返回nullptr
+    const char *next() {
+        if (read_ == rows_) {
+            return nullptr;
+        }
+        for (size_t done = 0; done < len_;) {
+            if (page_pos_ == PAGE_SIZE) {
+                load_page();
+            }
+            size_t n = std::min(len_ - done, PAGE_SIZE - page_pos_);
+            memcpy(row_.data() + done, page_.data() + page_pos_, n);
+            page_pos_ += n;
+            done += n;
+        }
+        read_++;
+        return row_.data();
+    }
+};
+
+/**
+ * 一个溢出分区：每一路输入一个文件（hash聚合只有一路，hash join为build端和probe端两路），
+ * depth为已经用过的hash位数（以SPILL_PARTITION_BITS为单位）
+ */
+struct SpillPartition {
+    std::vector<std::unique_ptr<SpillFile>> files;
+    int depth = 0;
+};
+
+/**
+ * 按hash值把记录写入一组溢出分区：第depth层用hash值从高位起的第depth组位选分区，
+ * 内存中的哈希表用的是低位，两者互不相关；分区后仍然放不下时用depth + 1层继续分区
+ */
+class SpillPartitioner {
+   private:
+    std::vector<SpillPartition> parts_;
+    int depth_;
+
+   public:
+    // lens为各路输入的记录长度
+    SpillPartitioner(DiskManager *disk_manager, const std::vector<size_t> &lens, int depth) : depth_(depth) {
+        parts_.resize(1 << SPILL_PARTITION_BITS);
+        for (auto &part : parts_) {
+            for (auto len : lens) {
+                part.files.push_back(std::make_unique<SpillFile>(disk_manager, len));
+            }
+            part.depth = depth;
+        }
+    }
+
+    static size_t partition_of(uint64_t hash, int depth) {
+        return hash >> (64 - SPILL_PARTITION_BITS * depth) & ((1 << SPILL_PARTITION_BITS) - 1);
+    }
+
+    void write(size_t input, uint64_t hash, const char *rec) {
+        parts_[partition_of(hash, depth_)].files[input]->append(rec);
+    }
+
+    // 写完之后把各分区转为读取，追加到partitions中
+    void finish(std::vector<SpillPartition> &partitions) {
+        for (auto &part : parts_) {
+            for (auto &file : part.files) {
+                file->finish();
+            }
+            partitions.push_back(std::move(part));
+        }
+        parts_.clear();
+    }
+};
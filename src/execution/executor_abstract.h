@@ -10,6 +10,9 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <functional>
+
+#include "execution_batch.h"
 #include "execution_defs.h"
 #include "common/common.h"
 #include "index/ix.h"
@@ -34,21 +37,30 @@ class AbstractExecutor {
 
     virtual void nextTuple(){};
 
-    virtual bool has_aggre() { return false; };
-    virtual std::string get_nickname() { return ""; };
     virtual void set_conds(std::vector<Condition> conds) {} ;
     virtual bool is_end() const { return true; };
-    virtual void feed(const std::map<TabCol, Value> &feed_dict) = 0;
-    virtual ast::AggregationType get_aggre_type() {};
-    // virtual void feed(const std::map<TabCol, Value> &feed_dict) = 0;
 
     virtual std::vector<std::unique_ptr<RmRecord>> get_block() {};
+
+    // 批量执行：先调用begin_batch，再反复调用next_batch直到返回false，每批最多EXEC_BATCH_SIZE条记录
+    // 返回true时批中的记录可能已经全部被过滤掉
+    virtual void begin_batch() { beginTuple(); }
+    // 默认用Next/nextTuple逐条拼成一批，没有改写的算子也能作为批量算子的儿子
+    virtual bool next_batch(RecordBatch &batch) {
+        batch.reset(tupleLen());
+        while (!batch.full() && !is_end()) {
+            auto rec = Next();
+            batch.append(rec->data);
+            nextTuple();
+        }
+        return !batch.empty();
+    }
     virtual Rid &rid() = 0;
 
     virtual std::unique_ptr<RmRecord> Next() = 0;
 
     virtual ColMeta get_col_offset(const TabCol &target) { return ColMeta();};
-    virtual bool has_nlj() {};
+    virtual bool has_nlj() { return false; };
     virtual std::string get_tbl_name() {};
     virtual size_t get_sort_offset() {};
     std::vector<ColMeta>::const_iterator get_col(const std::vector<ColMeta> &rec_cols, const TabCol &target) {
@@ -65,38 +77,7 @@ class AbstractExecutor {
         return pos;
     }
 
-    virtual void fast_feed(const std::map<TabCol, std::vector<Value>> &feed_dict, size_t cnt) {};
+    // 列式访问：对每条满足条件的记录，用col字段的地址调用visit；不支持列式访问的算子返回false
+    virtual bool scan_column(const ColMeta &col, const std::function<void(const char *)> &visit) { return false; }
     virtual TabMeta get_tables() {}
-    // 对于每一个表列，我们都将他们的值加入到map里面，并返回这个map
-    std::map<TabCol, Value> rec2dict(const std::vector<ColMeta> &cols, const RmRecord *rec) {
-        std::map<TabCol, Value> rec_dict;
-        for (auto &col : cols) {
-            TabCol key{col.tab_name, col.name};
-            Value val;
-            // 目前的问题是，左表是空表的时候也会进行下一步
-            auto val_buf = rec->data + col.offset;
-            if (col.type == TYPE_INT) {
-                // std::cout<<(*(int*)val_buf)<<std::endl;
-                // if((*(std::string *)val_buf).empty()) continue;
-                val.set_real_int(*(int*)val_buf);
-            } else if (col.type == TYPE_FLOAT) {
-                val.set_float(*(float *)val_buf);
-            } else if (col.type == TYPE_STRING) {
-                std::string str_val((char *)val_buf, col.len);
-                str_val.resize(strlen(str_val.c_str()));
-                val.set_str(str_val);
-            } else if (col.type == TYPE_BIGINT) {
-                // if((*(std::string *)val_buf).empty()) continue;
-                val.set_real_bigint(*(std::int64_t *)val_buf);
-            } else if(col.type == TYPE_DATETIME) {
-                std::string str_val((char *)val_buf, col.len);
-                str_val.resize(strlen(str_val.c_str()));
-                val.set_str(str_val);
-            }
-            assert(rec_dict.count(key) == 0);
-            val.init_raw(col.len);
-            rec_dict[key] = val;
-        }
-        return rec_dict;
-    }
 };
\ No newline at end of file
@@ -123,12 +123,7 @@ public:
         for (size_t index_i = 0; index_i < tab.indexes.size(); index_i++) {
             if (ihs[index_i] != nullptr) {
                 char *key = new char[tab.indexes[index_i].col_tot_len];
-                memset(key, 0, tab.indexes[index_i].col_tot_len);
-                int offset = 0;
-                for (auto &col: tab.indexes[index_i].cols) {
-                    memcpy(key + offset, rec->data + col.offset, col.len);
-                    offset += col.len;
-                }
+                ix_make_key(tab.indexes[index_i].cols, rec->data, key);
                     LogRecord index_delete_log_record = LogRecord(context_->txn_->get_transaction_id(),
                                                                   context_->txn_->get_prev_lsn(),
                                                                   LogType::DELETE_ENTRY, rid, key,
@@ -141,7 +136,7 @@ public:
         }
         for(size_t index_i = 0; index_i < tab.indexes.size(); index_i++){
             if (ihs[index_i] != nullptr){
-                auto flag = ihs[index_i]->delete_entry(keys[index_i], context_->txn_);
+                auto flag = ihs[index_i]->delete_entry(keys[index_i], rid, context_->txn_);
                 if(flag&&context_->txn_->get_txn_mode()) {
                     auto *indexWriteRecord = new IndexWriteRecord(WType::DELETE_TUPLE, tab_name_,
                                                                   rid, index_i, keys[index_i],tab.indexes[index_i].col_tot_len);
@@ -184,8 +179,5 @@ public:
         }
         return nullptr;
     }
-    void feed(const std::map<TabCol, Value> &feed_dict) override {
-        throw InternalError("Cannot feed a projection node");
-    }
     Rid &rid() override { return _abstract_rid; }
 };
\ No newline at end of file
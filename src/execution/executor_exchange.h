@@ -0,0 +1,170 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <exception>
+
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "execution_parallel.h"
+#include "executor_abstract.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * 并行执行的汇合点：几个结构相同的算子流水线（例如共享同一个PageMorsels的扫描加投影）分别在工作线程池中
+ * 用next_batch取数据，结果批放进有界队列，由调用线程按到达顺序取出，输出的顺序不确定
+ * 各流水线的begin_batch在调用线程中依次执行（加表锁等只需要做一次的工作在这里完成），之后才交给工作线程
+ * 任一流水线抛出异常时其余流水线停止，异常在调用线程的next_batch中重新抛出
+ */
+class ExchangeExecutor : public AbstractExecutor {
+   private:
+    std::vector<std::unique_ptr<AbstractExecutor>> pipelines_;
+    std::mutex mutex_;
+    std::condition_variable not_empty_;         // 队列中有批或所有流水线都已结束
+    std::condition_variable not_full_;          // 队列中有空位或已经取消
+    std::deque<RecordBatch> queue_;
+    size_t capacity_;                           // 队列最多缓存的批数
+    size_t running_ = 0;                        // 还没有结束的流水线数
+    std::atomic<bool> cancelled_{false};
+    std::exception_ptr error_;
+    RecordBatch cur_;                           // 逐条执行时当前的批
+    size_t pos_ = 0;
+
+   public:
+    explicit ExchangeExecutor(std::vector<std::unique_ptr<AbstractExecutor>> pipelines) {
+        pipelines_ = std::move(pipelines);
+        capacity_ = 2 * pipelines_.size();
+    }
+
+    ~ExchangeExecutor() override { stop(); }
+
+    [[nodiscard]] const std::vector<ColMeta> &cols() const override { return pipelines_[0]->cols(); }
+
+    std::string getType() override { return "ExchangeExecutor"; }
+
+    size_t tupleLen() const override { return pipelines_[0]->tupleLen(); }
+
+    ColMeta get_col_offset(const TabCol &target) override { return pipelines_[0]->get_col_offset(target); }
+
+    void begin_batch() override {
+        stop();
+        for (auto &pipeline : pipelines_) {
+            pipeline->begin_batch();
+        }
+        cancelled_ = false;
+        error_ = nullptr;
+        running_ = pipelines_.size();
+        for (auto &pipeline : pipelines_) {
+            WorkerPool::instance().submit([this, p = pipeline.get()] { run(p); });
+        }
+    }
+
+    bool next_batch(RecordBatch &batch) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return !queue_.empty() || running_ == 0 || error_ != nullptr; });
+        if (error_ != nullptr) {
+            std::rethrow_exception(error_);
+        }
+        if (queue_.empty()) {
+            return false;
+        }
+        batch = std::move(queue_.front());
+        queue_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    std::vector<std::unique_ptr<RmRecord>> get_block() override {
+        std::vector<std::unique_ptr<RmRecord>> block;
+        for (begin_batch(); next_batch(cur_);) {
+            for (size_t k = 0; k < cur_.size(); k++) {
+                auto rec = std::make_unique<RmRecord>(tupleLen());
+                memcpy(rec->data, cur_.at(k), tupleLen());
+                block.push_back(std::move(rec));
+            }
+        }
+        return block;
+    }
+
+    void beginTuple() override {
+        begin_batch();
+        cur_.sel.clear();
+        pos_ = 0;
+        fill();
+    }
+
+    void nextTuple() override {
+        if (is_end()) {
+            return;
+        }
+        pos_++;
+        fill();
+    }
+
+    bool is_end() const override { return pos_ >= cur_.size(); }
+
+    std::unique_ptr<RmRecord> Next() override {
+        if (is_end()) {
+            return nullptr;
+        }
+        auto rec = std::make_unique<RmRecord>(tupleLen());
+        memcpy(rec->data, cur_.at(pos_), tupleLen());
+        return rec;
+    }
+
+    Rid &rid() override { return _abstract_rid; }
+
+   private:
+    void fill() {
+        while (pos_ >= cur_.size() && next_batch(cur_)) {
+            pos_ = 0;
+        }
+    }
+
+    // 在工作线程中执行一条流水线，把非空的批放进队列
+    void run(AbstractExecutor *pipeline) {
+        try {
+            RecordBatch batch;
+            while (!cancelled_ && pipeline->next_batch(batch)) {
+                if (batch.empty()) {
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(mutex_);
+                not_full_.wait(lock, [this] { return queue_.size() < capacity_ || cancelled_; });
+                if (cancelled_) {
+                    break;
+                }
+                queue_.push_back(std::move(batch));
+                not_empty_.notify_one();
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (error_ == nullptr) {
+                error_ = std::current_exception();
+            }
+            cancelled_ = true;
+            not_full_.notify_all();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_--;
+        not_empty_.notify_all();
+    }
+
+    // 取消还在执行的流水线并等待它们结束，之后才能重新开始或析构流水线
+    void stop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cancelled_ = true;
+        not_full_.notify_all();
+        not_empty_.wait(lock, [this] { return running_ == 0; });
+        queue_.clear();
+    }
+};
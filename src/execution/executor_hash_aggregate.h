@@ -0,0 +1,194 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+#include "execution_aggregate.h"
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "execution_memory.h"
+#include "execution_spill.h"
+#include "executor_abstract.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+constexpr size_t HASH_AGG_MEM_LIMIT = 64 << 20;     // 内存中分组状态的上限，超过后新分组的记录按hash分区写入临时文件
+
+/**
+ * GROUP BY的hash聚合：分组状态放在GroupHashTable中
+ * 分组状态超过mem_limit或查询的内存预算不足后，已经在内存中的分组继续聚合，其余记录按hash分区写入临时文件，
+ * 内存中的分组输出完后再逐个分区聚合，分区中仍然放不下时用hash值的下几位继续分区，到达SPILL_MAX_DEPTH后不再限制内存
+ * 没有GROUP BY时即使没有输入记录也输出一行
+ */
+class HashAggregateExecutor : public AbstractExecutor {
+   private:
+    std::unique_ptr<AbstractExecutor> prev_;
+    GroupAggregator agg_;
+    size_t in_len_;
+    size_t mem_limit_;
+    MemoryReservation mem_;                     // 分组状态和槽位占用的查询内存预算
+    DiskManager *disk_manager_;                 // 写溢出分区，为nullptr时不能溢出，超过内存上限时报错
+
+    GroupHashTable groups_;                     // 本轮在内存中的分组
+    std::unique_ptr<SpillPartitioner> spill_;   // 本轮溢出的分区，没有溢出时为nullptr
+    std::vector<SpillPartition> partitions_;    // 待处理的分区
+    size_t emit_pos_ = 0;                       // 下一个输出的分组
+    bool begun_ = false;
+
+   public:
+    [[nodiscard]] const std::vector<ColMeta> &cols() const override { return agg_.out_cols(); }
+
+    HashAggregateExecutor(std::unique_ptr<AbstractExecutor> prev, const std::vector<TabCol> &group_cols,
+                          const std::vector<std::shared_ptr<ast::AggreClause>> &aggres,
+                          std::shared_ptr<MemoryBudget> budget = nullptr, DiskManager *disk_manager = nullptr,
+                          size_t mem_limit = HASH_AGG_MEM_LIMIT)
+        : mem_(std::move(budget)), disk_manager_(disk_manager) {
+        prev_ = std::move(prev);
+        agg_ = GroupAggregator(prev_->cols(), group_cols, aggres);
+        groups_ = GroupHashTable(agg_.key_len(), agg_.state_len());
+        in_len_ = prev_->tupleLen();
+        mem_limit_ = mem_limit;
+    }
+
+    std::string getType() override { return "HashAggregateExecutor"; }
+
+    size_t tupleLen() const override { return agg_.out_len(); }
+
+    ColMeta get_col_offset(const TabCol &target) override { return agg_.get_col(target); }
+
+    void beginTuple() override {
+        close_partitions();
+        begun_ = true;
+        RecordBatch batch;
+        prev_->begin_batch();
+        start_pass();
+        while (prev_->next_batch(batch)) {
+            for (size_t k = 0; k < batch.size(); k++) {
+                add(batch.at(k), 0);
+            }
+        }
+        finish_pass();
+        if (groups_.size() == 0 && agg_.key_len() == 0) {
+            agg_.init_empty(groups_.insert(0, "", 0));
+        }
+        advance();
+    }
+
+    void nextTuple() override {
+        if (is_end()) {
+            return;
+        }
+        emit_pos_++;
+        advance();
+    }
+
+    bool is_end() const override { return emit_pos_ == groups_.size() && partitions_.empty(); }
+
+    std::unique_ptr<RmRecord> Next() override {
+        if (is_end()) {
+            return nullptr;
+        }
+        auto rec = std::make_unique<RmRecord>(agg_.out_len());
+        agg_.finalize(groups_.state(emit_pos_), rec->data);
+        return rec;
+    }
+
+    std::vector<std::unique_ptr<RmRecord>> get_block() override {
+        std::vector<std::unique_ptr<RmRecord>> block;
+        if (!begun_) {
+            beginTuple();
+        }
+        while (!is_end()) {
+            block.push_back(Next());
+            nextTuple();
+        }
+        return block;
+    }
+
+    bool next_batch(RecordBatch &batch) override {
+        if (!begun_) {
+            beginTuple();
+        }
+        batch.reset(agg_.out_len());
+        while (!batch.full() && !is_end()) {
+            agg_.finalize(groups_.state(emit_pos_), batch.append());
+            emit_pos_++;
+            advance();
+        }
+        return !batch.empty();
+    }
+
+    Rid &rid() override { return _abstract_rid; }
+
+   private:
+    void start_pass() {
+        groups_.clear();
+        emit_pos_ = 0;
+        mem_.reset();
+    }
+
+    // 把本轮溢出的分区加入待处理列表
+    void finish_pass() {
+        if (spill_ != nullptr) {
+            spill_->finish(partitions_);
+            spill_ = nullptr;
+        }
+    }
+
+    /**
+     * @brief 把一条输入记录聚合到它的分组中，本轮已经溢出且分组不在内存中时写入分区
+     * @param depth 当前处理的分区的层数，从子节点读取时为0
+     */
+    void add(const char *row, int depth) {
+        char key[agg_.key_len() + 1];
+        agg_.make_key(row, key);
+        uint64_t hash = ix_hash_key(key, agg_.key_len());
+        size_t pos;
+        uint32_t g = groups_.find(key, hash, pos);
+        if (g != GroupHashTable::NIL) {
+            agg_.update(groups_.state(g), row);
+            return;
+        }
+        if (spill_ != nullptr || (depth < SPILL_MAX_DEPTH && !reserve(groups_.size() + 1))) {
+            if (spill_ == nullptr) {
+                if (disk_manager_ == nullptr) {
+                    throw QueryMemoryLimitError("hash aggregation");
+                }
+                spill_ = std::make_unique<SpillPartitioner>(disk_manager_, std::vector<size_t>{in_len_}, depth + 1);
+            }
+            spill_->write(0, hash, row);
+            return;
+        }
+        agg_.init(groups_.insert(pos, key, hash), row);
+    }
+
+    // 能否容纳groups个分组（包括槽位扩容后的大小）
+    bool reserve(size_t groups) {
+        size_t need = groups_.bytes_for(groups);
+        return need <= mem_limit_ && mem_.grow(need);
+    }
+
+    // 内存中的分组输出完后，取出下一个非空的分区重新聚合
+    void advance() {
+        while (emit_pos_ == groups_.size() && !partitions_.empty()) {
+            auto part = std::move(partitions_.back());
+            partitions_.pop_back();
+            start_pass();
+            while (const char *row = part.files[0]->next()) {
+                add(row, part.depth);
+            }
+            finish_pass();
+        }
+    }
+
+    void close_partitions() {
+        spill_ = nullptr;
+        partitions_.clear();
+    }
+};
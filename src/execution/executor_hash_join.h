@@ -0,0 +1,411 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "execution_memory.h"
+#include "execution_predicate.h"
+#include "execution_spill.h"
+#include "executor_join_output.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+constexpr size_t HASH_JOIN_MEM_LIMIT = 64 << 20;    // build端在内存中的上限，超过后按hash分区写入临时文件
+
+/**
+ * 连接用的开放寻址哈希表，只保存下标：每个槽位对应一个不同的key，记录hash值和该key的第一条、最后一条build记录，
+ * key相同的记录按插入顺序用next_串起来；线性探查，槽位数为记录数的2倍以上
+ */
+class JoinHashTable {
+public:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    // keys为n个连续存放的key，hashes为各自的hash值，keys在哈希表使用期间必须保持有效
+    void build(const char *keys, const uint64_t *hashes, size_t n, int key_len) {
+        keys_ = keys;
+        key_len_ = key_len;
+        size_t capacity = 16;
+        while (capacity < n * 2) {
+            capacity <<= 1;
+        }
+        mask_ = capacity - 1;
+        slots_.assign(capacity, Slot{0, NIL, NIL});
+        next_.assign(n, NIL);
+        for (size_t i = 0; i < n; i++) {
+            for (size_t pos = hashes[i] & mask_;; pos = (pos + 1) & mask_) {
+                auto &slot = slots_[pos];
+                if (slot.head == NIL) {
+                    slot = Slot{hashes[i], (uint32_t)i, (uint32_t)i};
+                    break;
+                }
+                if (slot.hash == hashes[i] && memcmp(keys_ + (size_t)slot.head * key_len_, keys_ + i * key_len_, key_len_) == 0) {
+                    next_[slot.tail] = i;
+                    slot.tail = i;
+                    break;
+                }
+            }
+        }
+    }
+
+    // key相同的第一条记录的下标，没有时返回NIL，之后用next遍历
+    uint32_t find(const char *key, uint64_t hash) const {
+        for (size_t pos = hash & mask_;; pos = (pos + 1) & mask_) {
+            auto &slot = slots_[pos];
+            if (slot.head == NIL) {
+                return NIL;
+            }
+            if (slot.hash == hash && memcmp(keys_ + (size_t)slot.head * key_len_, key, key_len_) == 0) {
+                return slot.head;
+            }
+        }
+    }
+
+    uint32_t next(uint32_t i) const { return next_[i]; }
+
+    // 一批key先预取各自的槽位，再逐个查找，隐藏访问槽位数组的cache miss
+    void prefetch(uint64_t hash) const { __builtin_prefetch(&slots_[hash & mask_]); }
+
+    void clear() {
+        slots_.clear();
+        next_.clear();
+    }
+
+private:
+    struct Slot {
+        uint64_t hash;
+        uint32_t head;
+        uint32_t tail;
+    };
+
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> next_;
+    const char *keys_ = nullptr;
+    int key_len_ = 0;
+    size_t mask_ = 0;
+};
+
+/**
+ * 等值连接的key：所有左右两边字段类型、长度相同的等值连接条件对应字段的原始字节依次拼接
+ */
+class JoinKeys {
+   public:
+    JoinKeys() = default;
+
+    // 从conds中取出能用作key的条件，其余条件放进rest，由调用方在拼好的记录上检查
+    JoinKeys(const std::vector<ColMeta> &lcols, const std::vector<ColMeta> &rcols, std::vector<Condition> conds,
+             std::vector<Condition> &rest) {
+        auto find = [](const std::vector<ColMeta> &cols, const TabCol &target) {
+            return std::find_if(cols.begin(), cols.end(), [&](const ColMeta &col) {
+                return col.tab_name == target.tab_name && col.name == target.col_name;
+            });
+        };
+        for (auto &cond : conds) {
+            if (!cond.is_rhs_val && cond.op == OP_EQ) {
+                auto l = find(lcols, cond.lhs_col);
+                auto r = find(rcols, cond.rhs_col);
+                if (l == lcols.end() || r == rcols.end()) {
+                    l = find(lcols, cond.rhs_col);
+                    r = find(rcols, cond.lhs_col);
+                }
+                if (l != lcols.end() && r != rcols.end() && l->type == r->type && l->len == r->len) {
+                    parts_.push_back(KeyPart{l->offset, r->offset, l->type, l->len});
+                    len_ += l->len;
+                    continue;
+                }
+            }
+            rest.push_back(std::move(cond));
+        }
+        if (parts_.empty()) {
+            throw InternalError("Hash join requires an equi-join condition");
+        }
+    }
+
+    int len() const { return len_; }
+
+    // 从一边的记录中拼出key，0.0和-0.0相等但字节不同，统一成0.0
+    void make(const char *rec, bool left, char *key) const {
+        for (auto &part : parts_) {
+            memcpy(key, rec + (left ? part.left_off : part.right_off), part.len);
+            if (part.type == TYPE_FLOAT && *(float *)key == 0) {
+                *(float *)key = 0;
+            }
+            key += part.len;
+        }
+    }
+
+   private:
+    /* key中的一个字段在左右两边记录中的位置 */
+    struct KeyPart {
+        int left_off;
+        int right_off;
+        ColType type;
+        int len;
+    };
+
+    std::vector<KeyPart> parts_;
+    int len_ = 0;
+};
+
+/**
+ * 等值连接的hash join：在较小的一边（build端，由计划决定）上建哈希表，另一边（probe端）按批探查
+ * key为所有左右两边字段类型、长度相同的等值连接条件对应字段的原始字节，其余条件在拼好的记录上检查
+ * build端超过mem_limit或查询的内存预算不足时改为Grace hash join：两边都按key的hash分区写入临时文件，再逐个分区建表探查，
+ * 分区仍然放不下时用hash值的下几位继续分区
+ * 输出记录的布局与NestedLoopJoinExecutor相同，左边在前
+ */
+class HashJoinExecutor : public JoinOutputExecutor {
+   private:
+    static constexpr size_t BUILD = 0;          // 溢出分区中build端的文件
+    static constexpr size_t PROBE = 1;          // 溢出分区中probe端的文件
+
+    std::unique_ptr<AbstractExecutor> left_;    // 左儿子节点（需要join的表）
+    std::unique_ptr<AbstractExecutor> right_;   // 右儿子节点（需要join的表）
+    std::vector<ColMeta> cols_;                 // join后获得的记录的字段
+    std::vector<Condition> conds_;              // 不能用作key的其余连接条件
+    CompiledPredicate pred_;                    // 由conds_编译出的条件，在拼好的记录上求值
+    JoinKeys key_;
+    int key_len_ = 0;
+    bool build_left_;                           // 是否在左边建哈希表
+    size_t mem_limit_;
+    MemoryReservation mem_;                     // 内存中build端占用的查询内存预算
+    DiskManager *disk_manager_;                 // 写溢出分区，为nullptr时不能溢出，超过内存上限时报错
+    size_t l_len_;
+    size_t r_len_;
+
+    std::vector<char> rows_;                    // 内存中的build端记录，定长连续存放
+    std::vector<char> keys_;                    // 各条build记录的key
+    std::vector<uint64_t> hashes_;
+    JoinHashTable table_;
+    std::vector<SpillPartition> partitions_;    // 待处理的分区
+    SpillPartition cur_;                        // 正在探查的分区，没有溢出时为空，从probe端的子节点读取
+    bool spilled_ = false;
+
+    RecordBatch probe_in_;                      // 当前探查的一批probe端记录
+
+    AbstractExecutor *build_side() const { return build_left_ ? left_.get() : right_.get(); }
+    AbstractExecutor *probe_side() const { return build_left_ ? right_.get() : left_.get(); }
+    size_t build_len() const { return build_left_ ? l_len_ : r_len_; }
+    size_t probe_len() const { return build_left_ ? r_len_ : l_len_; }
+
+   public:
+    [[nodiscard]] const std::vector<ColMeta> &cols() const override {
+        return cols_; }
+    HashJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right,
+                     std::vector<Condition> conds, bool build_left, std::shared_ptr<MemoryBudget> budget = nullptr,
+                     DiskManager *disk_manager = nullptr, size_t mem_limit = HASH_JOIN_MEM_LIMIT)
+        : mem_(std::move(budget)), disk_manager_(disk_manager) {
+        left_ = std::move(left);
+        right_ = std::move(right);
+        build_left_ = build_left;
+        mem_limit_ = mem_limit;
+        l_len_ = left_->tupleLen();
+        r_len_ = right_->tupleLen();
+        len_ = l_len_ + r_len_;
+        cols_ = left_->cols();
+        auto right_cols = right_->cols();
+        for (auto &col : right_cols) {
+            col.offset += l_len_;
+        }
+        cols_.insert(cols_.end(), right_cols.begin(), right_cols.end());
+        key_ = JoinKeys(left_->cols(), right_->cols(), std::move(conds), conds_);
+        key_len_ = key_.len();
+        pred_.bind(cols_, conds_);
+    }
+
+    ColMeta get_col_offset(const TabCol &target) override {
+        try {
+            return left_->get_col_offset(target);
+        }
+        catch (...) {
+            return right_->get_col_offset(target);
+        }
+    }
+
+    void beginTuple() override {
+        close_partitions();
+        rows_.clear();
+        keys_.clear();
+        hashes_.clear();
+        table_.clear();
+        spilled_ = false;
+        mem_.reset();
+        reset_output();
+        // build端全部读入，超过内存上限时改为分区写出
+        std::unique_ptr<SpillPartitioner> spill;
+        auto build = build_side();
+        RecordBatch batch;
+        build->begin_batch();
+        while (build->next_batch(batch)) {
+            for (size_t k = 0; k < batch.size(); k++) {
+                const char *rec = batch.at(k);
+                if (spilled_) {
+                    write_partitioned(*spill, BUILD, rec);
+                    continue;
+                }
+                rows_.insert(rows_.end(), rec, rec + build_len());
+                size_t need = rows_.size() + rows_.size() / build_len() * (key_len_ + 24);
+                if (need > mem_limit_ || !mem_.grow(need)) {
+                    if (disk_manager_ == nullptr) {
+                        throw QueryMemoryLimitError("hash join");
+                    }
+                    spilled_ = true;
+                    spill = create_partitioner(1);
+                    for (size_t off = 0; off < rows_.size(); off += build_len()) {
+                        write_partitioned(*spill, BUILD, rows_.data() + off);
+                    }
+                    rows_.clear();
+                    rows_.shrink_to_fit();
+                    mem_.reset();
+                }
+            }
+        }
+        auto probe = probe_side();
+        probe->begin_batch();
+        if (!spilled_) {
+            build_table();
+        } else {
+            while (probe->next_batch(batch)) {
+                for (size_t k = 0; k < batch.size(); k++) {
+                    write_partitioned(*spill, PROBE, batch.at(k));
+                }
+            }
+            spill->finish(partitions_);
+            if (!next_partition()) {
+                finish();
+            }
+        }
+        fill();
+    }
+
+    // 探查下一批probe端记录，当前分区探查完后换到下一个分区，所有分区都处理完后不再有结果
+    void produce() override {
+        auto &batch = probe_in_;
+        if (!spilled_) {
+            if (!probe_side()->next_batch(batch)) {
+                finish();
+                return;
+            }
+        } else {
+            batch.reset(probe_len());
+            while (!batch.full()) {
+                const char *rec = cur_.files[PROBE]->next();
+                if (rec == nullptr) {
+                    break;
+                }
+                batch.append(rec);
+            }
+            if (batch.empty()) {
+                if (!next_partition()) {
+                    finish();
+                }
+                return;
+            }
+        }
+        // 先算出整批的key和hash并预取槽位，再逐个查找
+        std::vector<char> keys(batch.size() * key_len_);
+        std::vector<uint64_t> hashes(batch.size());
+        for (size_t i = 0; i < batch.size(); i++) {
+            key_.make(batch.at(i), !build_left_, keys.data() + i * key_len_);
+            hashes[i] = ix_hash_key(keys.data() + i * key_len_, key_len_);
+            table_.prefetch(hashes[i]);
+        }
+        for (size_t i = 0; i < batch.size(); i++) {
+            for (auto j = table_.find(keys.data() + i * key_len_, hashes[i]); j != JoinHashTable::NIL; j = table_.next(j)) {
+                char *record = append();
+                const char *build_rec = rows_.data() + (size_t)j * build_len();
+                memcpy(record, build_left_ ? build_rec : batch.at(i), l_len_);
+                memcpy(record + l_len_, build_left_ ? batch.at(i) : build_rec, r_len_);
+                if (pred_.eval(record)) {
+                    commit();
+                }
+            }
+        }
+    }
+
+    bool has_nlj() override {
+        return true;
+    }
+    std::string get_tbl_name() override {
+        return left_->get_tbl_name();
+    }
+    size_t get_sort_offset() override {
+        return l_len_;
+    }
+
+   private:
+    // 对rows_中的build记录算出key和hash，建哈希表
+    void build_table() {
+        size_t n = rows_.size() / build_len();
+        keys_.resize(n * key_len_);
+        hashes_.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            key_.make(rows_.data() + i * build_len(), build_left_, keys_.data() + i * key_len_);
+            hashes_[i] = ix_hash_key(keys_.data() + i * key_len_, key_len_);
+        }
+        table_.build(keys_.data(), hashes_.data(), n, key_len_);
+    }
+
+    std::unique_ptr<SpillPartitioner> create_partitioner(int depth) const {
+        return std::make_unique<SpillPartitioner>(disk_manager_, std::vector<size_t>{build_len(), probe_len()}, depth);
+    }
+
+    // 按key的hash把build端（input为BUILD）或probe端的一条记录写入分区
+    void write_partitioned(SpillPartitioner &spill, size_t input, const char *rec) const {
+        char key[key_len_];
+        key_.make(rec, input == BUILD ? build_left_ : !build_left_, key);
+        spill.write(input, ix_hash_key(key, key_len_), rec);
+    }
+
+    /**
+     * @brief 取出下一个非空的分区建哈希表，分区的build端仍然超过内存上限时再分区
+     * @return 没有分区时返回false
+     */
+    bool next_partition() {
+        mem_.reset();
+        while (!partitions_.empty()) {
+            cur_ = std::move(partitions_.back());
+            partitions_.pop_back();
+            auto &build = *cur_.files[BUILD];
+            size_t size = build.rows() * build_len();
+            if (size == 0 || cur_.files[PROBE]->rows() == 0) {
+                continue;
+            }
+            if ((size > mem_limit_ || !mem_.grow(size)) && cur_.depth < SPILL_MAX_DEPTH) {
+                repartition(cur_);
+                continue;
+            }
+            rows_.resize(size);
+            for (size_t off = 0; off < size; off += build_len()) {
+                memcpy(rows_.data() + off, build.next(), build_len());
+            }
+            build_table();
+            return true;
+        }
+        cur_ = SpillPartition();
+        return false;
+    }
+
+    void repartition(SpillPartition &part) {
+        auto spill = create_partitioner(part.depth + 1);
+        while (const char *rec = part.files[BUILD]->next()) {
+            write_partitioned(*spill, BUILD, rec);
+        }
+        while (const char *rec = part.files[PROBE]->next()) {
+            write_partitioned(*spill, PROBE, rec);
+        }
+        spill->finish(partitions_);
+    }
+
+    void close_partitions() {
+        cur_ = SpillPartition();
+        partitions_.clear();
+    }
+};
@@ -0,0 +1,228 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+#include <numeric>
+
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "execution_predicate.h"
+#include "executor_join_output.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+
+/**
+ * 索引嵌套循环连接：内表是有索引的基本表，索引的每个字段都由外表字段或常量等值确定
+ * 每次取一批外表记录拼出探查key，排序去重后用IxIndexHandle::lookup_many一次探查，
+ * 再按外表记录的顺序回表读取内表记录、检查其余条件
+ * 输出记录的布局与计划中的左右顺序一致，内表可以在左边
+ */
+class IndexNLJoinExecutor : public JoinOutputExecutor {
+   private:
+    /* 探查key中的一个索引字段，值来自外表记录中的字段或常量 */
+    struct KeyPart {
+        ColMeta col;                            // 索引字段
+        int key_off;                            // 在key中的偏移
+        int outer_off;                          // 在外表记录中的偏移，常量时为-1
+    };
+
+    std::unique_ptr<AbstractExecutor> outer_;   // 外表
+    std::string inner_tab_;                     // 内表
+    std::vector<ColMeta> inner_cols_;           // 内表的字段
+    std::vector<Condition> inner_conds_;        // 只涉及内表的条件
+    std::vector<Condition> join_conds_;         // 连接条件
+    CompiledPredicate inner_pred_;              // 由inner_conds_编译出的条件，在内表记录上求值
+    CompiledPredicate join_pred_;               // 由join_conds_编译出的条件，在拼好的记录上求值
+    bool inner_is_left_;                        // 内表是否在输出记录的左边
+    RmFileHandle *fh_;                          // 内表的数据文件句柄
+    IxIndexHandle *ih_;                         // 内表的索引
+    std::vector<KeyPart> key_parts_;
+    std::vector<char> const_key_;               // 常量字段已经编码好的key模板
+    int key_len_;                               // 探查key的长度，不含非唯一索引追加的rid
+    size_t outer_len_;
+    size_t inner_len_;
+    std::vector<ColMeta> cols_;                 // join后获得的记录的字段
+    RecordBatch outer_in_;                      // 当前探查的一批外表记录
+    SmManager *sm_manager_;
+
+   public:
+    [[nodiscard]] const std::vector<ColMeta> &cols() const override {
+        return cols_; }
+    IndexNLJoinExecutor(std::unique_ptr<AbstractExecutor> outer, SmManager *sm_manager, std::string inner_tab,
+                        std::vector<Condition> inner_conds, std::vector<std::string> index_col_names,
+                        std::vector<Condition> join_conds, bool inner_is_left, Context *context) {
+        outer_ = std::move(outer);
+        sm_manager_ = sm_manager;
+        context_ = context;
+        inner_tab_ = std::move(inner_tab);
+        inner_conds_ = std::move(inner_conds);
+        join_conds_ = std::move(join_conds);
+        inner_is_left_ = inner_is_left;
+        auto &tab = sm_manager_->db_.get_table(inner_tab_);
+        inner_cols_ = tab.cols;
+        fh_ = sm_manager_->fhs_.at(inner_tab_).get();
+        auto ix_manager = sm_manager_->get_ix_manager();
+        auto index_name = ix_manager->get_index_name(inner_tab_, index_col_names);
+        if (sm_manager_->ihs_.find(index_name) == sm_manager_->ihs_.end()) {
+            sm_manager_->ihs_[index_name] = ix_manager->open_index(inner_tab_, index_col_names);
+        }
+        ih_ = sm_manager_->ihs_.at(index_name).get();
+
+        outer_len_ = outer_->tupleLen();
+        inner_len_ = inner_cols_.back().offset + inner_cols_.back().len;
+        len_ = outer_len_ + inner_len_;
+        auto outer_cols = outer_->cols();
+        auto inner_cols = inner_cols_;
+        auto &right_cols = inner_is_left_ ? outer_cols : inner_cols;
+        for (auto &col : right_cols) {
+            col.offset += inner_is_left_ ? inner_len_ : outer_len_;
+        }
+        cols_ = inner_is_left_ ? inner_cols : outer_cols;
+        cols_.insert(cols_.end(), right_cols.begin(), right_cols.end());
+
+        // 每个索引字段的值：优先取与外表字段的等值连接条件，否则取内表上的常量等值条件
+        auto &index_meta = *tab.get_index_meta(index_col_names);
+        key_len_ = index_meta.col_tot_len;
+        const_key_.assign(key_len_, 0);
+        int key_off = 0;
+        for (auto &col : index_meta.cols) {
+            KeyPart part{col, key_off, -1};
+            for (auto &cond : join_conds_) {
+                if (cond.is_rhs_val || cond.op != OP_EQ) {
+                    continue;
+                }
+                const TabCol *outer_col = nullptr;
+                if (cond.lhs_col.tab_name == inner_tab_ && cond.lhs_col.col_name == col.name) {
+                    outer_col = &cond.rhs_col;
+                } else if (cond.rhs_col.tab_name == inner_tab_ && cond.rhs_col.col_name == col.name) {
+                    outer_col = &cond.lhs_col;
+                }
+                if (outer_col != nullptr && outer_col->tab_name != inner_tab_) {
+                    part.outer_off = get_col(outer_->cols(), *outer_col)->offset;
+                    break;
+                }
+            }
+            if (part.outer_off == -1) {
+                auto it = std::find_if(inner_conds_.begin(), inner_conds_.end(), [&](const Condition &cond) {
+                    return cond.is_rhs_val && cond.op == OP_EQ && cond.lhs_col.col_name == col.name;
+                });
+                if (it == inner_conds_.end()) {
+                    throw InternalError("Index join key column " + col.name + " is not bound");
+                }
+                ix_encode_col(col.type, col.len, it->rhs_val.raw->data, const_key_.data() + key_off);
+            }
+            key_parts_.push_back(part);
+            key_off += col.len;
+        }
+        inner_pred_.bind(inner_cols_, inner_conds_);
+        join_pred_.bind(cols_, join_conds_);
+    }
+
+    // 与NestedLoopJoinExecutor一致，先在左边查找再在右边查找，返回的是在各自记录中的偏移
+    ColMeta get_col_offset(const TabCol &target) override {
+        if (inner_is_left_) {
+            try {
+                return *get_col(inner_cols_, target);
+            } catch (...) {
+                return outer_->get_col_offset(target);
+            }
+        }
+        try {
+            return outer_->get_col_offset(target);
+        } catch (...) {
+            return *get_col(inner_cols_, target);
+        }
+    }
+
+    void beginTuple() override {
+        if(context_->txn_->get_txn_mode()) {
+            auto lock_mgr = context_->lock_mgr_;
+            if (!lock_mgr->lock_on_table(context_->txn_, fh_->GetFd(), LockMode::SHARED)) {
+                throw TransactionAbortException(context_->txn_->get_transaction_id(), AbortReason::FAILED_TO_LOCK);
+            }
+        }
+        reset_output();
+        outer_->begin_batch();
+        fill();
+    }
+
+    // 探查下一批外表记录，外表结束后不再有结果
+    void produce() override {
+        auto &batch = outer_in_;
+        if (!outer_->next_batch(batch)) {
+            finish();
+            return;
+        }
+        // 拼出每条外表记录的key，按key排序去重后批量探查
+        std::vector<char> keys(batch.size() * key_len_);
+        for (size_t i = 0; i < batch.size(); i++) {
+            char *key = keys.data() + i * key_len_;
+            memcpy(key, const_key_.data(), key_len_);
+            for (auto &part : key_parts_) {
+                if (part.outer_off != -1) {
+                    ix_encode_col(part.col.type, part.col.len, batch.at(i) + part.outer_off, key + part.key_off);
+                }
+            }
+        }
+        auto key_at = [&](size_t i) { return keys.data() + i * key_len_; };
+        std::vector<size_t> order(batch.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return memcmp(key_at(a), key_at(b), key_len_) < 0;
+        });
+        std::vector<char> probe_keys;
+        std::vector<int> probe_of(batch.size());
+        int num_probes = 0;
+        for (size_t k = 0; k < order.size(); k++) {
+            if (k == 0 || memcmp(key_at(order[k - 1]), key_at(order[k]), key_len_) != 0) {
+                probe_keys.insert(probe_keys.end(), key_at(order[k]), key_at(order[k]) + key_len_);
+                num_probes++;
+            }
+            probe_of[order[k]] = num_probes - 1;
+        }
+        std::vector<std::vector<Rid>> matches(num_probes);
+        if (ih_->is_hash()) {
+            for (int i = 0; i < num_probes; i++) {
+                ih_->get_value(probe_keys.data() + (size_t)i * key_len_, &matches[i], context_->txn_);
+            }
+        } else {
+            ih_->lookup_many(probe_keys.data(), num_probes, [&](int i, const Rid &rid) { matches[i].push_back(rid); });
+        }
+        // 按外表记录的顺序输出
+        for (size_t i = 0; i < batch.size(); i++) {
+            for (auto &rid : matches[probe_of[i]]) {
+                auto inner = fh_->get_record(rid, context_);
+                if (!inner_pred_.eval(inner.get())) {
+                    continue;
+                }
+                char *record = append();
+                const char *left = inner_is_left_ ? inner->data : batch.at(i);
+                const char *right = inner_is_left_ ? batch.at(i) : inner->data;
+                size_t left_len = inner_is_left_ ? inner_len_ : outer_len_;
+                memcpy(record, left, left_len);
+                memcpy(record + left_len, right, len_ - left_len);
+                if (join_pred_.eval(record)) {
+                    commit();
+                }
+            }
+        }
+    }
+
+    bool has_nlj() override {
+        return true;
+    }
+    std::string get_tbl_name() override {
+        return inner_is_left_ ? inner_tab_ : outer_->get_tbl_name();
+    }
+    size_t get_sort_offset() override {
+        return inner_is_left_ ? inner_len_ : outer_len_;
+    }
+};
@@ -12,6 +12,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "execution_defs.h"
 #include "execution_manager.h"
+#include "execution_predicate.h"
 #include "executor_abstract.h"
 #include "index/ix.h"
 #include "analyze/analyze.h"
@@ -27,10 +28,21 @@ private:
     std::vector<ColMeta> cols_;                 // 需要读取的字段
     size_t len_;                                // 选取出来的一条记录的长度
     std::vector<Condition> fed_conds_;          // 扫描条件，和conds_字段相同
+    std::vector<Condition> stop_conds_;         // 不满足时扫描结束的条件，见bind_conds
+    CompiledPredicate pred_;                    // 由fed_conds_编译出的条件
+    CompiledPredicate stop_pred_;               // 由stop_conds_编译出的条件
 
     std::vector<std::string> index_col_names_;  // index scan涉及到的索引包含的字段
     IndexMeta index_meta_;                      // index scan涉及到的索引元数据
 
+    bool covering_;                             // 用到的字段都在索引key中，直接从叶子中的key还原记录
+    std::vector<std::pair<int, ColMeta>> key_cols_;  // 覆盖扫描时每个索引字段在key中的偏移和对应的表字段
+    std::unique_ptr<RmRecord> rec_;             // 当前位置的记录，覆盖扫描时由叶子中的key还原
+    bool reverse_;                              // 按索引的逆序输出，用于ORDER BY ... DESC和MAX
+    int limit_;                                 // 最多输出的记录数，-1表示不限制
+    bool ordered_;                              // 上层的流式聚合依赖索引顺序
+    int emitted_{0};                            // 已经输出的记录数
+
     Rid rid_;
     std::unique_ptr<RecScan> scan_;
 
@@ -40,7 +52,7 @@ public:
     [[nodiscard]] const std::vector<ColMeta> &cols() const override {
         return cols_; }
     IndexScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds, std::vector<std::string> index_col_names,
-                      Context *context) {
+                      Context *context, bool covering = false, bool reverse = false, int limit = -1, bool ordered = false) {
         sm_manager_ = sm_manager;
         context_ = context;
         tab_name_ = std::move(tab_name);
@@ -52,6 +64,15 @@ public:
         fh_ = sm_manager_->fhs_.at(tab_name_).get();
         cols_ = tab_.cols;
         len_ = cols_.back().offset + cols_.back().len;
+        covering_ = covering && index_meta_.type != INDEX_HASH;
+        reverse_ = reverse;
+        limit_ = limit;
+        ordered_ = ordered;
+        int key_off = 0;
+        for (auto &col : index_meta_.cols) {
+            key_cols_.emplace_back(key_off, *tab_.get_col(col.name));
+            key_off += col.len;
+        }
         std::map<CompOp, CompOp> swap_op = {
                 {OP_EQ, OP_EQ}, {OP_NE, OP_NE}, {OP_LT, OP_GT}, {OP_GT, OP_LT}, {OP_LE, OP_GE}, {OP_GE, OP_LE},
         };
@@ -66,6 +87,7 @@ public:
             }
         }
         fed_conds_ = conds_;
+        bind_conds();
     }
     static std::vector<ColMeta>::const_iterator get_col(const std::vector<ColMeta> &rec_cols, const TabCol &target) {
         auto pos = std::find_if(rec_cols.begin(), rec_cols.end(), [&](const ColMeta &col) {
@@ -88,89 +110,39 @@ public:
             assert(cond.lhs_col.tab_name == tab_name_);
         }
     }
-    void feed(const std::map<TabCol, Value> &feed_dict) {
-        for (auto &cond : fed_conds_) {
-            if (!cond.is_rhs_val && cond.rhs_col.tab_name != tab_name_) {
-                cond.is_rhs_val = true;
-                cond.rhs_val = feed_dict.at(cond.rhs_col);
+
+    // 编译扫描条件；索引按key有序，最左前缀上的等值条件以及下一个字段上的<、<=条件一旦不满足，后面的记录也不会满足
+    // 逆序扫描时下一个字段上换成>、>=条件
+    void bind_conds() {
+        stop_conds_.clear();
+        for(auto& col:index_meta_.cols){
+            auto on_col=[&](const Condition& cond){return cond.is_rhs_val&&cond.lhs_col.col_name==col.name;};
+            auto it=std::find_if(fed_conds_.begin(),fed_conds_.end(),[&](const Condition& cond){
+                return on_col(cond)&&cond.op==OP_EQ;
+            });
+            if (it!=fed_conds_.end()) {
+                stop_conds_.push_back(*it);
+                continue;
             }
-            if(feed_dict.find(cond.rhs_col)==feed_dict.end()) { continue ;}
-            cond.rhs_val = feed_dict.at(cond.rhs_col);
+            std::copy_if(fed_conds_.begin(),fed_conds_.end(),std::back_inserter(stop_conds_),[&](const Condition& cond){
+                return on_col(cond)&&(reverse_?cond.op==OP_GT||cond.op==OP_GE:cond.op==OP_LT||cond.op==OP_LE);
+            });
+            break;
         }
-        check_runtime_conds();
+        pred_.bind(cols_, fed_conds_);
+        stop_pred_.bind(cols_, stop_conds_);
     }
+    // 沿索引遍历，只读出索引范围内的记录
     std::vector<std::unique_ptr<RmRecord>> get_block() override {
-        if(context_->txn_->get_txn_mode()) {
-            auto tab_fd = fh_->GetFd();
-            auto lock_mgr = context_->lock_mgr_;
-            if (!lock_mgr->lock_on_table(context_->txn_, tab_fd, LockMode::SHARED)) {
-                throw TransactionAbortException(context_->txn_->get_transaction_id(), AbortReason::FAILED_TO_LOCK);
-            }
-        }
         auto block = std::vector<std::unique_ptr<RmRecord>>{};
-        scan_ = std::make_unique<RmScan>(fh_);
-        while (!scan_->is_end()) {
-            rid_ = scan_->rid();
-            auto rec = fh_->get_record(rid_,context_);
-            if (eval_conds(cols_, fed_conds_, rec.get())) {
-                block.push_back(std::move(rec));
-            }
-            scan_->next();
+        for (beginTuple(); !is_end(); nextTuple()) {
+            block.push_back(Next());
         }
         return block;
     }
-    bool eval_cond(const std::vector<ColMeta> &rec_cols,
-                   const Condition &cond,
-                   const RmRecord *rec) {
-        auto lhs_col = get_col(rec_cols, cond.lhs_col);
-        auto *lhs = rec->data + lhs_col->offset;
-        char* rhs;
-//        std::cout<<"lhs="<<*(int*)lhs<<std::endl;
-        ColType rhs_type;
-        if (cond.is_rhs_val) {
-            rhs_type = cond.rhs_val.type;
-            rhs = cond.rhs_val.raw->data;
-        } else {
-            // rhs is a column
-            auto rhs_col = get_col(rec_cols, cond.rhs_col);
-            rhs_type = rhs_col->type;
-            rhs = rec->data + rhs_col->offset;
-        }
-        if(rhs_type != lhs_col->type){
-            // 这里暂时没有管长度
-            if(rhs_type==TYPE_DATETIME&&lhs_col->type==TYPE_STRING&&lhs_col->len>=19) {
-            } else if(rhs_type==TYPE_INT&&lhs_col->type==TYPE_BIGINT){}else {
-                throw IncompatibleTypeError(coltype2str(lhs_col->type), coltype2str(rhs_type));
-            }
-        } // TODO convert to common type
-        int cmp = ix_compare(lhs, rhs, rhs_type, lhs_col->len);
-        if (cond.op == OP_EQ) {
-//            std::cout<<"op==EQ ,cmp=="<<cmp<<std::endl;
-            return cmp == 0;
-        } else if (cond.op == OP_NE) {
-            return cmp != 0;
-        } else if (cond.op == OP_LT) {
-            return cmp < 0;
-        } else if (cond.op == OP_GT) {
-            return cmp > 0;
-        } else if (cond.op == OP_LE) {
-            return cmp <= 0;
-        } else if (cond.op == OP_GE) {
-            return cmp >= 0;
-        } else {
-            throw InternalError("Unexpected op type");
-        }
-    }
-
-    bool eval_conds(const std::vector<ColMeta> &rec_cols,
-                    const std::vector<Condition> &conds,
-                    const RmRecord *rec) {
-        return std::all_of(conds.begin(), conds.end(), [&](const Condition &cond) {
-            return eval_cond(rec_cols, cond, rec);
-        });
-    }
-
-    void make_key(const std::vector<Condition>& conds,const std::vector<std::string>& index_col_names,std::vector<ColMeta>& cols,std::vector<int>& lens,char* key) {
+    // 用等值和>、>=条件的右值构造查找key，没有条件的字段保持全0，即该字段编码后的最小值
+    // upper为true时改用等值和<、<=条件构造上界，调用者把key预先填为全0xFF
+    void make_key(const std::vector<Condition>& conds,const std::vector<std::string>& index_col_names,std::vector<ColMeta>& cols,std::vector<int>& lens,char* key,bool upper=false) {
         auto index_pos = [&index_col_names](const std::string &name) -> int {
             for (auto i = 0; i < index_col_names.size(); i++) {
                 if (index_col_names.at(i) == name) {
@@ -187,49 +159,37 @@ public:
             return off;
         };
         for (auto &cond: conds) {
-            if (cond.is_rhs_val && (cond.op == OP_EQ || cond.op == OP_GT)) {
+            bool bound = upper ? cond.op == OP_LT || cond.op == OP_LE : cond.op == OP_GT || cond.op == OP_GE;
+            if (cond.is_rhs_val && (cond.op == OP_EQ || bound)) {
+                auto pos = index_pos(cond.lhs_col.col_name);
+                if (pos == -1) {
+                    continue;
+                }
+                const char *tmp = nullptr;
+                std::int64_t wide;
                 switch (cond.rhs_val.type) {
-                    case TYPE_STRING: {
-                        auto tmp = cond.rhs_val.str_val.c_str();
-                        auto pos = index_pos(cond.lhs_col.col_name);
-                        if (pos == -1)break;
-                        auto off = offset(lens, pos);
-                        memcpy(key + off, tmp, lens[pos]);
+                    case TYPE_STRING:
+                    case TYPE_DATETIME:
+                        tmp = cond.rhs_val.str_val.c_str();
                         break;
-                    }
-
-                    case TYPE_INT: {
-                        auto tmp = (const char *) (&cond.rhs_val.int_val);
-                        auto pos = index_pos(cond.lhs_col.col_name);
-                        if (pos == -1)break;
-                        auto off = offset(lens, pos);
-                        memcpy(key + off, tmp, lens[pos]);
+                    case TYPE_INT:
+                        // BIGINT字段上的INT常量先扩展成int64
+                        if (index_meta_.cols[pos].type == TYPE_BIGINT) {
+                            wide = cond.rhs_val.int_val;
+                            tmp = (const char *) (&wide);
+                        } else {
+                            tmp = (const char *) (&cond.rhs_val.int_val);
+                        }
                         break;
-                    }
-                    case TYPE_FLOAT: {
-                        auto tmp = (const char *) (&cond.rhs_val.float_val);
-                        auto pos = index_pos(cond.lhs_col.col_name);
-                        auto off = offset(lens, pos);
-                        if (pos == -1)break;
-                        memcpy(key + off, tmp, lens[pos]);
+                    case TYPE_FLOAT:
+                        tmp = (const char *) (&cond.rhs_val.float_val);
                         break;
-                    }
-                    case TYPE_BIGINT: {
-                        auto tmp = (const char *) (&cond.rhs_val.bigint_val);
-                        auto pos = index_pos(cond.lhs_col.col_name);
-                        if (pos == -1)break;
-                        auto off = offset(lens, pos);
-                        memcpy(key + off, tmp, lens[pos]);
+                    case TYPE_BIGINT:
+                        tmp = (const char *) (&cond.rhs_val.bigint_val);
                         break;
-                    }
-                    case TYPE_DATETIME: {
-                        auto tmp = cond.rhs_val.str_val.c_str();
-                        auto pos = index_pos(cond.lhs_col.col_name);
-                        if (pos == -1)break;
-                        auto off = offset(lens, pos);
-                        memcpy(key + off, tmp, lens[pos]);
-                        break;
-                    }
+                }
+                if (tmp != nullptr) {
+                    ix_encode_col(index_meta_.cols[pos].type, lens[pos], tmp, key + offset(lens, pos));
                 }
             }
         }
@@ -260,43 +220,85 @@ public:
         char key[key_len];
         memset(key,0,key_len);
         assert(!index_col_names_.empty());
-        make_key(fed_conds_,index_col_names_,cols_,col_len,key);
-//        std::cout<<"e\n";
-        int id=*(int*)(key);
-        // 获取迭代范围
         auto ih=sm_manager_->ihs_[index_name].get();
         assert(ih!= nullptr);
-//        std::cout<<"num pages="<<ih->get_ix_file_hdr()->num_pages_<<"\n";
-        auto start=ih->leaf_begin(key);
-        auto end=ih->leaf_end();
-//        std::cout<<"start.page no="<<start.page_no<<", slot_no="<<start.slot_no<<"\n";
-//        std::cout<<"end.page no="<<end.page_no<<", slot_no="<<end.slot_no<<"\n";
-        scan_=std::make_unique<IxScan>(ih,start,end,sm_manager_->get_bpm());
-        assert(scan_!= nullptr);
-        while (!scan_->is_end()){
-            rid_=scan_->rid();
-            auto rec=fh_->get_record(rid_,context_);
-            if (eval_conds(cols_,fed_conds_,rec.get())){
-                break;
+        if (ih->is_hash()) {
+            // 哈希索引只在所有字段都有等值条件时被选中，只用等值条件构造完整的key，直接点查
+            std::vector<Condition> eq_conds;
+            std::copy_if(fed_conds_.begin(),fed_conds_.end(),std::back_inserter(eq_conds),
+                         [](const Condition& cond){return cond.op==OP_EQ;});
+            make_key(eq_conds,index_col_names_,cols_,col_len,key);
+            std::vector<Rid> rids;
+            ih->get_value(key,&rids,context_->txn_);
+            scan_=std::make_unique<IxPointScan>(std::move(rids));
+        } else {
+            make_key(fed_conds_,index_col_names_,cols_,col_len,key);
+            // 获取迭代范围
+//            std::cout<<"num pages="<<ih->get_ix_file_hdr()->num_pages_<<"\n";
+            auto start=ih->leaf_begin(key);
+            if (reverse_) {
+                // 从上界的前一项反向遍历到start
+                char upper[key_len];
+                memset(upper,0xFF,key_len);
+                make_key(fed_conds_,index_col_names_,cols_,col_len,upper,true);
+                scan_=std::make_unique<IxScan>(ih,start,ih->leaf_upper(upper),sm_manager_->get_bpm(),true);
+            } else {
+                auto end=ih->leaf_end();
+//            std::cout<<"start.page no="<<start.page_no<<", slot_no="<<start.slot_no<<"\n";
+//            std::cout<<"end.page no="<<end.page_no<<", slot_no="<<end.slot_no<<"\n";
+                scan_=std::make_unique<IxScan>(ih,start,end,sm_manager_->get_bpm());
             }
-            scan_->next();
         }
+        assert(scan_!= nullptr);
+        emitted_=0;
+        if (limit_==0) {
+            scan_->set_end();
+        }
+        seek();
     }
     void nextTuple() override {
         check_runtime_conds();
         if(is_end()){
             return;
         }
+        if (limit_>=0&&++emitted_>=limit_) {
+            scan_->set_end();
+            return;
+        }
         scan_->next();
-        // 只要开始不满足条件，后续所有的元组都不满足条件，直接置为end
-        if (!scan_->is_end()){
-            auto rec=fh_->get_record(scan_->rid(),context_);
-            if (!eval_conds(cols_,fed_conds_,rec.get())){
+        seek();
+    }
+
+    // 从当前位置找到第一条满足所有条件的记录；key相同的记录可能有多条，其余条件不满足时跳过而不是结束
+    void seek() {
+        while (!scan_->is_end()){
+            auto rec=read_current();
+            if (!stop_pred_.eval(rec.get())){
                 scan_->set_end();
-            }else{
-                rid_=scan_->rid();
+                return;
+            }
+            if (pred_.eval(rec.get())){
+                rec_=std::move(rec);
+                return;
             }
+            scan_->next();
+        }
+    }
+
+    // 读出当前位置的记录；覆盖扫描时把叶子中的key解码回记录中各字段的位置，不在索引中的字段保持全0
+    std::unique_ptr<RmRecord> read_current() {
+        if (!covering_) {
+            rid_=scan_->rid();
+            return fh_->get_record(rid_,context_);
+        }
+        char key[IX_MAX_COL_LEN];
+        rid_=static_cast<IxScan*>(scan_.get())->entry(key);
+        auto rec=std::make_unique<RmRecord>(len_);
+        memset(rec->data,0,len_);
+        for (auto& [off,col]:key_cols_) {
+            ix_decode_col(col.type,col.len,key+off,rec->data+col.offset);
         }
+        return rec;
     }
 
     ColMeta get_col_offset(const TabCol &target) override {
@@ -313,7 +315,17 @@ public:
         if(is_end()){
             return nullptr;
         }
-        return fh_->get_record(rid_,context_);
+        return std::make_unique<RmRecord>(*rec_);
+    }
+
+    // begin_batch即beginTuple，按索引定位到第一条满足条件的记录，这里沿索引成批输出，省去Next的拷贝
+    bool next_batch(RecordBatch &batch) override {
+        batch.reset(len_);
+        while (!batch.full() && !is_end()) {
+            batch.append(rec_->data);
+            nextTuple();
+        }
+        return !batch.empty();
     }
 
     bool is_end() const override {
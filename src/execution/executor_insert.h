@@ -67,18 +67,17 @@ public:
             val.init_raw(col.len);
             memcpy(rec.data + col.offset, val.raw->data, col.len);
         }
-        // 唯一性检查
+        // 唯一性检查，非唯一索引不检查
         std::vector<size_t> ins;
         for(size_t i = 0; i < tab_.indexes.size(); ++i) {
             auto& index = tab_.indexes[i];
+            if (!index.unique) {
+                ins.push_back(i);
+                continue;
+            }
             auto ih = sm_manager_->ihs_.at(sm_manager_->get_ix_manager()->get_index_name(tab_name_, index.cols)).get();
             char key[index.col_tot_len];
-            memset(key,0,index.col_tot_len);
-            int offset = 0;
-            for(size_t i_ = 0; i_ < index.col_num; ++i_) {
-                memcpy(key + offset, rec.data + index.cols[i_].offset, index.cols[i_].len);
-                offset += index.cols[i_].len;
-            }
+            ix_make_key(index.cols, rec.data, key);
             std::vector<Rid> value;
             bool unique=!ih->get_value(key,&value,context_->txn_);
             if (!unique){
@@ -103,12 +102,7 @@ public:
             auto& index = tab_.indexes[i];
             auto ih = sm_manager_->ihs_.at(sm_manager_->get_ix_manager()->get_index_name(tab_name_, index.cols)).get();
             char *key = new char[index.col_tot_len];
-            memset(key,0,index.col_tot_len);
-            int offset = 0;
-            for(size_t i_ = 0; i_ < index.col_num; ++i_) {
-                memcpy(key + offset, rec.data + index.cols[i_].offset, index.cols[i_].len);
-                offset += index.cols[i_].len;
-            }
+            ix_make_key(index.cols, rec.data, key);
             // index log
                 auto index_name = sm_manager_->get_ix_manager()->get_index_name(tab_name_, index.cols);
                 // ih->insert_entry(key, rid_, context_->txn_);
@@ -124,15 +118,12 @@ public:
             auto ih = sm_manager_->ihs_.at(sm_manager_->get_ix_manager()->get_index_name(tab_name_, index.cols)).get();
             auto flag = ih->insert_entry(keys[j], rid_, context_->txn_);
             if(flag&&context_->txn_->get_txn_mode()) {
-                auto *indexWriteRecord = new IndexWriteRecord(WType::INSERT_TUPLE, tab_name_, i,
+                auto *indexWriteRecord = new IndexWriteRecord(WType::INSERT_TUPLE, tab_name_, rid_, i,
                                                               keys[j],index.col_tot_len);
                 txn->append_index_write_record(indexWriteRecord);
             }
         }
         return nullptr;
     }
-    void feed(const std::map<TabCol, Value> &feed_dict) override {
-        throw InternalError("Cannot feed a projection node");
-    }
     Rid &rid() override { return rid_; }
 };
@@ -0,0 +1,114 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "execution_defs.h"
+#include "executor_abstract.h"
+
+/**
+ * 批量连接算子的公共部分：连接结果按批产生，定长连续存放在out_中，逐条或成段地输出
+ * 子类在produce中产生下一批结果（可能为空），没有更多结果时调用finish；
+ * 拼一条结果时先用append在out_的尾部取一个位置，直接在上面拼出连接结果，满足其余条件时再commit，否则不commit即撤回
+ */
+class JoinOutputExecutor : public AbstractExecutor {
+   protected:
+    size_t len_;                                // join后获得的每条记录的长度
+    std::vector<char> out_;                     // 当前批次的连接结果，定长连续存放
+    size_t out_rows_ = 0;
+    size_t out_pos_ = 0;
+    bool done_ = false;
+    bool begun_ = false;                        // 上层的连接算子可能不调用beginTuple就直接next_batch
+
+    // 产生下一批连接结果，调用前out_已经清空
+    virtual void produce() = 0;
+
+    // 子类的beginTuple在开始产生结果之前调用
+    void reset_output() {
+        out_rows_ = 0;
+        out_pos_ = 0;
+        done_ = false;
+        begun_ = true;
+    }
+
+    void finish() { done_ = true; }
+
+    char *append() {
+        if (out_.size() < (out_rows_ + 1) * len_) {
+            out_.resize(std::max(out_.size() * 2, (out_rows_ + 1) * len_));
+        }
+        return out_.data() + out_rows_ * len_;
+    }
+
+    void commit() { out_rows_++; }
+
+    // 当前批次的结果用完后继续产生下一批，直到有结果或没有更多结果
+    void fill() {
+        while (out_pos_ == out_rows_ && !done_) {
+            out_rows_ = 0;
+            out_pos_ = 0;
+            produce();
+        }
+    }
+
+   public:
+    size_t tupleLen() const override { return len_; }
+
+    void nextTuple() override {
+        if (is_end()) {
+            return;
+        }
+        out_pos_++;
+        fill();
+    }
+
+    bool is_end() const override { return out_pos_ == out_rows_ && done_; }
+
+    std::vector<std::unique_ptr<RmRecord>> get_block() override {
+        auto block = std::vector<std::unique_ptr<RmRecord>>{};
+        if (!begun_) {
+            beginTuple();
+        }
+        while (!is_end()) {
+            block.push_back(Next());
+            out_pos_++;
+            fill();
+        }
+        return block;
+    }
+
+    // 把当前批次的结果成段拷贝到batch中
+    bool next_batch(RecordBatch &batch) override {
+        if (!begun_) {
+            beginTuple();
+        }
+        batch.reset(len_);
+        while (!batch.full() && !is_end()) {
+            size_t n = std::min(out_rows_ - out_pos_, EXEC_BATCH_SIZE - batch.num_rows);
+            for (size_t k = 0; k < n; k++) {
+                batch.append(out_.data() + (out_pos_ + k) * len_);
+            }
+            out_pos_ += n;
+            fill();
+        }
+        return !batch.empty();
+    }
+
+    std::unique_ptr<RmRecord> Next() override {
+        if (is_end()) {
+            return nullptr;
+        }
+        auto rec = std::make_unique<RmRecord>(len_);
+        memcpy(rec->data, out_.data() + out_pos_ * len_, len_);
+        return rec;
+    }
+
+    Rid &rid() override { return _abstract_rid; }
+};
@@ -0,0 +1,194 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "execution_predicate.h"
+#include "executor_join_output.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+
+/**
+ * 归并连接：左右两边都已经按连接key递增输出（例如按索引顺序的IndexScanExecutor），同时向前推进两边
+ * 右边key相同的一段记录缓存在run_中，左边key相同的每条记录都与这一段连接，左边key变大后丢弃
+ * 只需要缓存一段重复key的右边记录，其余条件在拼好的记录上检查；输出记录的布局与NestedLoopJoinExecutor相同
+ */
+class MergeJoinExecutor : public JoinOutputExecutor {
+   private:
+    /* key中的一个字段在左右两边记录中的位置，按两边的排序顺序排列 */
+    struct KeyPart {
+        int left_off;
+        int right_off;
+        ColType type;
+        int len;
+    };
+
+    std::unique_ptr<AbstractExecutor> left_;    // 左儿子节点（需要join的表）
+    std::unique_ptr<AbstractExecutor> right_;   // 右儿子节点（需要join的表）
+    std::vector<ColMeta> cols_;                 // join后获得的记录的字段
+    std::vector<Condition> conds_;              // key以外的其余连接条件
+    CompiledPredicate pred_;                    // 由conds_编译出的条件，在拼好的记录上求值
+    std::vector<KeyPart> key_parts_;
+    size_t l_len_;
+    size_t r_len_;
+
+    /* 一个儿子当前读到的一批记录和其中的位置 */
+    struct Input {
+        AbstractExecutor *child;
+        RecordBatch batch;
+        size_t pos = 0;
+    };
+
+    Input lin_;
+    Input rin_;
+    std::unique_ptr<RmRecord> lrec_;            // 左边当前的记录，左边结束后为nullptr
+    std::unique_ptr<RmRecord> rrec_;            // 右边下一条还没有放进run_的记录
+    std::vector<std::unique_ptr<RmRecord>> run_;    // 右边key相同的一段记录
+
+   public:
+    [[nodiscard]] const std::vector<ColMeta> &cols() const override {
+        return cols_; }
+    // keys为按排序顺序排列的(左边字段, 右边字段)，两边的记录都按这些字段递增
+    MergeJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right,
+                      std::vector<Condition> conds, const std::vector<std::pair<TabCol, TabCol>> &keys) {
+        left_ = std::move(left);
+        right_ = std::move(right);
+        l_len_ = left_->tupleLen();
+        r_len_ = right_->tupleLen();
+        len_ = l_len_ + r_len_;
+        cols_ = left_->cols();
+        auto right_cols = right_->cols();
+        for (auto &col : right_cols) {
+            col.offset += l_len_;
+        }
+        cols_.insert(cols_.end(), right_cols.begin(), right_cols.end());
+
+        for (auto &[lcol, rcol] : keys) {
+            auto l = get_col(left_->cols(), lcol);
+            auto r = get_col(right_->cols(), rcol);
+            key_parts_.push_back(KeyPart{l->offset, r->offset, l->type, l->len});
+        }
+        // 作为key的等值条件不再检查
+        auto same = [](const TabCol &x, const TabCol &y) { return x.tab_name == y.tab_name && x.col_name == y.col_name; };
+        for (auto &cond : conds) {
+            bool is_key = !cond.is_rhs_val && cond.op == OP_EQ &&
+                          std::any_of(keys.begin(), keys.end(), [&](const std::pair<TabCol, TabCol> &key) {
+                              return (same(cond.lhs_col, key.first) && same(cond.rhs_col, key.second)) ||
+                                     (same(cond.lhs_col, key.second) && same(cond.rhs_col, key.first));
+                          });
+            if (!is_key) {
+                conds_.push_back(std::move(cond));
+            }
+        }
+        pred_.bind(cols_, conds_);
+    }
+
+    ColMeta get_col_offset(const TabCol &target) override {
+        try {
+            return left_->get_col_offset(target);
+        }
+        catch (...) {
+            return right_->get_col_offset(target);
+        }
+    }
+
+    // 左边记录的key与右边记录的key比较
+    int compare(const RmRecord *lrec, const RmRecord *rrec) const {
+        for (auto &part : key_parts_) {
+            int cmp = ix_compare(lrec->data + part.left_off, rrec->data + part.right_off, part.type, part.len);
+            if (cmp != 0) {
+                return cmp;
+            }
+        }
+        return 0;
+    }
+
+    // 从儿子当前的一批中取出下一条记录，这一批取完后再向儿子要下一批
+    static std::unique_ptr<RmRecord> pull(Input &in) {
+        while (in.pos == in.batch.size()) {
+            in.pos = 0;
+            if (!in.child->next_batch(in.batch)) {
+                return nullptr;
+            }
+        }
+        auto rec = std::make_unique<RmRecord>(in.batch.tuple_len);
+        memcpy(rec->data, in.batch.at(in.pos++), in.batch.tuple_len);
+        return rec;
+    }
+
+    // 两边都是IndexScanExecutor，用beginTuple而不是begin_batch开始，保证之后next_batch沿索引顺序输出
+    static void begin_input(Input &in, AbstractExecutor *child) {
+        in.child = child;
+        in.batch.reset(child->tupleLen());
+        in.pos = 0;
+        child->beginTuple();
+    }
+
+    void beginTuple() override {
+        reset_output();
+        run_.clear();
+        begin_input(lin_, left_.get());
+        begin_input(rin_, right_.get());
+        lrec_ = pull(lin_);
+        rrec_ = pull(rin_);
+        fill();
+    }
+
+    // 归并出下一批结果，直到凑满一批或一边结束
+    void produce() override {
+        while (out_rows_ < EXEC_BATCH_SIZE && lrec_ != nullptr) {
+            // 左边的key与缓存的一段相同，与这一段逐条连接
+            if (!run_.empty() && compare(lrec_.get(), run_.front().get()) == 0) {
+                for (auto &rrec : run_) {
+                    char *record = append();
+                    memcpy(record, lrec_->data, l_len_);
+                    memcpy(record + l_len_, rrec->data, r_len_);
+                    if (pred_.eval(record)) {
+                        commit();
+                    }
+                }
+                lrec_ = pull(lin_);
+                continue;
+            }
+            run_.clear();
+            while (rrec_ != nullptr && compare(lrec_.get(), rrec_.get()) > 0) {
+                rrec_ = pull(rin_);
+            }
+            if (rrec_ == nullptr) {
+                // 右边已经结束，左边剩下的记录不会再有匹配
+                lrec_ = nullptr;
+                break;
+            }
+            if (compare(lrec_.get(), rrec_.get()) < 0) {
+                lrec_ = pull(lin_);
+                continue;
+            }
+            while (rrec_ != nullptr && compare(lrec_.get(), rrec_.get()) == 0) {
+                run_.push_back(std::move(rrec_));
+                rrec_ = pull(rin_);
+            }
+        }
+        if (lrec_ == nullptr) {
+            finish();
+        }
+    }
+
+    bool has_nlj() override {
+        return true;
+    }
+    std::string get_tbl_name() override {
+        return left_->get_tbl_name();
+    }
+    size_t get_sort_offset() override {
+        return l_len_;
+    }
+};
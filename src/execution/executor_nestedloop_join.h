@@ -11,29 +11,34 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 #include "execution_defs.h"
 #include "execution_manager.h"
+#include "execution_memory.h"
+#include "execution_predicate.h"
 #include "executor_abstract.h"
 #include "index/ix.h"
 #include "system/sm.h"
 
+/**
+ * 嵌套循环连接：右边（内表）全部读入内存，左边（外表）按批流式读取，每条左边记录与所有右边记录比较
+ * 只有内表需要物化，占用的内存计入查询的预算；外表每次只持有一批记录，第一批连接结果不必等外表读完
+ * 连接条件按左右两边的布局编译一次，两边的字段直接在外表记录和内表记录中按偏移比较，换左边记录时不需要重新编译
+ */
 class NestedLoopJoinExecutor : public AbstractExecutor {
    private:
     std::unique_ptr<AbstractExecutor> left_;    // 左儿子节点（需要join的表）
     std::unique_ptr<AbstractExecutor> right_;   // 右儿子节点（需要join的表）
     size_t len_;                                // join后获得的每条记录的长度
     std::vector<ColMeta> cols_;                 // join后获得的记录的字段
-    std::map<TabCol, Value> _prev_feed_dict;
     std::vector<Condition> fed_conds_;          // join条件
+    CompiledPredicate pred_;                    // 由fed_conds_按左右两边的布局编译出的条件
     bool endend = false;
-    std::unique_ptr<RmRecord> cur = std::make_unique<RmRecord>();
-    std::vector<std::unique_ptr<RmRecord>> lhs_block_;  // 添加一个变量来存储一块数据
-    std::vector<std::unique_ptr<RmRecord>> rhs_block_;  // 添加一个变量来存储一块数据
-    int l_size_;
-    int r_size_;
+    bool begun_ = false;                        // 上层的连接算子可能不调用beginTuple就直接next_batch
+    RecordBatch lhs_batch_;                     // 当前的一批左边记录
+    std::vector<char> rhs_rows_;                // 全部右边记录，定长连续存放
+    MemoryReservation mem_;                     // rhs_rows_占用的查询内存预算
+    int l_size_ = 0;
+    int r_size_ = 0;
     int l_cnt = 0; // 标记当前在buffer的下标
     int r_cnt = 0;
-    std::string tab_name_;
-    std::vector<ColMeta> r_cols;
-    std::map<TabCol, std::vector<Value>> all_dict_;
     int l_len;
     int r_len;
 
@@ -41,7 +46,8 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
     [[nodiscard]] const std::vector<ColMeta> &cols() const override {
         return cols_; }
     NestedLoopJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right,
-                            std::vector<Condition> conds) {
+                            std::vector<Condition> conds, std::shared_ptr<MemoryBudget> budget = nullptr)
+        : mem_(std::move(budget)) {
         left_ = std::move(left);
         right_ = std::move(right);
         len_ = left_->tupleLen() + right_->tupleLen();
@@ -52,42 +58,10 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
         }
         cols_.insert(cols_.end(), right_cols.begin(), right_cols.end());
         fed_conds_ = std::move(conds);
-        r_cols = right_->cols();
-        tab_name_ = right_->get_tbl_name();
+        pred_.bind(left_->cols(), right_->cols(), fed_conds_);
         l_len = left_->tupleLen();
         r_len = right_->tupleLen();
     }
-    void setDict() {
-        auto cols = left_->cols();
-        // 遍历lhs_block_中的每一个RmRecord
-        for (auto& rec : lhs_block_) {
-            // 遍历每一个列
-            for (auto& col : cols) {
-                TabCol key{col.tab_name, col.name};
-                Value val;
-
-                auto val_buf = rec->data + col.offset;
-                if (col.type == TYPE_INT) {
-                    val.set_real_int(*(int*)val_buf);
-                } else if (col.type == TYPE_FLOAT) {
-                    val.set_float(*(float *)val_buf);
-                } else if (col.type == TYPE_STRING) {
-                    std::string str_val((char *)val_buf, col.len);
-                    str_val.resize(strlen(str_val.c_str()));
-                    val.set_str(str_val);
-                } else if (col.type == TYPE_BIGINT) {
-                    val.set_real_bigint(*(std::int64_t *)val_buf);
-                } else if(col.type == TYPE_DATETIME) {
-                    std::string str_val((char *)val_buf, col.len);
-                    str_val.resize(strlen(str_val.c_str()));
-                    val.set_str(str_val);
-                }
-                val.init_raw(col.len);
-                // 将val添加到map对应列的对应vector的末尾
-                all_dict_[key].push_back(val);
-            }
-        }
-    }
     ColMeta get_col_offset(const TabCol &target) override {
         try {
             // 尝试在 left_ 对象上调用函数
@@ -98,10 +72,6 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
             return right_->get_col_offset(target);
         }
     }
-    void feed(const std::map<TabCol, Value> &feed_dict) override {
-        _prev_feed_dict = feed_dict; // 记录一下前一个扫描算子使用了哪些表列值的map
-        left_->feed(feed_dict);
-    }
     std::vector<std::string> get_tbl_names(){
         std::vector<std::string> tbls;
         for(const auto& col:cols_){
@@ -110,116 +80,73 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
         return tbls;
     }
     void set_conds(std::vector<Condition> conds) override {
-        fed_conds_ = conds;
+        fed_conds_ = std::move(conds);
+        pred_.bind(left_->cols(), right_->cols(), fed_conds_);
     }
 
-    bool eval_cond(const std::vector<ColMeta> &rec_cols,
-                   const Condition &cond,
-                   const RmRecord *rec) {
-        auto lhs_col = get_col(rec_cols, cond.lhs_col);
-        auto *lhs = rec->data + lhs_col->offset;
-        char* rhs;
-        ColType rhs_type;
-        if (cond.is_rhs_val) {
-            rhs_type = cond.rhs_val.type;
-            rhs = cond.rhs_val.raw->data;
-        } else {
-            // rhs is a column
-            auto rhs_col = get_col(rec_cols, cond.rhs_col);
-            rhs_type = rhs_col->type;
-            rhs = rec->data + rhs_col->offset;
+    void beginTuple() override {
+        begun_ = true;
+        endend = false;
+        l_size_ = 0;
+        l_cnt = 0;
+        r_cnt = 0;
+        left_->begin_batch();
+        if (!next_left()) {
+            return;
         }
-        if(rhs_type != lhs_col->type){
-            if(rhs_type==TYPE_DATETIME&&lhs_col->type==TYPE_STRING&&lhs_col->len>=19) {
-            } else {
-                throw IncompatibleTypeError(coltype2str(lhs_col->type), coltype2str(rhs_type));
+        // 内表全部读入
+        rhs_rows_.clear();
+        mem_.reset();
+        RecordBatch batch;
+        right_->begin_batch();
+        while (right_->next_batch(batch)) {
+            for (size_t k = 0; k < batch.size(); k++) {
+                rhs_rows_.insert(rhs_rows_.end(), batch.at(k), batch.at(k) + r_len);
+            }
+            if (!mem_.grow(rhs_rows_.capacity())) {
+                throw QueryMemoryLimitError("nested loop join");
             }
-        }  // TODO convert to common type
-        int cmp = ix_compare(lhs, rhs, rhs_type, lhs_col->len);
-        if (cond.op == OP_EQ) {
-            return cmp == 0;
-        } else if (cond.op == OP_NE) {
-            return cmp != 0;
-        } else if (cond.op == OP_LT) {
-            return cmp < 0;
-        } else if (cond.op == OP_GT) {
-            return cmp > 0;
-        } else if (cond.op == OP_LE) {
-            return cmp <= 0;
-        } else if (cond.op == OP_GE) {
-            return cmp >= 0;
-        } else {
-            throw InternalError("Unexpected op type");
         }
-    }
-
-    bool eval_conds(const std::vector<ColMeta> &rec_cols,
-                    const std::vector<Condition> &conds,
-                    const RmRecord *rec) {
-        return std::all_of(conds.begin(), conds.end(), [&](const Condition &cond) {
-            return eval_cond(rec_cols, cond, rec);
-        });
-    }
-
-    void beginTuple() override {
-        lhs_block_ = left_->get_block();
-        if(lhs_block_.empty()) {
+        r_size_ = rhs_rows_.size() / r_len;
+        if (r_size_ == 0) {
             endend = true;
             return;
         }
-        rhs_block_ = right_->get_block();
-        l_size_ = lhs_block_.size();
-        r_size_ = rhs_block_.size();
-        setDict();
-        static std::map<CompOp, CompOp> swap_op_ack = {
-                {OP_EQ, OP_EQ}, {OP_NE, OP_NE}, {OP_LT, OP_GT}, {OP_GT, OP_LT}, {OP_LE, OP_GE}, {OP_GE, OP_LE},
-        };
-        for (auto &cond : fed_conds_) {
-            if(cond.lhs_col.tab_name != tab_name_) {
-                assert(!cond.is_rhs_val && cond.rhs_col.tab_name == tab_name_);
-                std::swap(cond.lhs_col, cond.rhs_col);
-                cond.op = swap_op_ack.at(cond.op);
-            }
-        }
+        nextTuple();
+    }
 
-        for(;l_cnt<l_size_;l_cnt++){
-            for (auto &cond : fed_conds_) {
-                if (!cond.is_rhs_val && cond.rhs_col.tab_name != tab_name_) {
-                    cond.is_rhs_val = true;
-                    cond.rhs_val = all_dict_.at(cond.rhs_col)[l_cnt];
-                }
-                if(all_dict_.find(cond.rhs_col)==all_dict_.end()) { continue ;}
-                cond.rhs_val = all_dict_.at(cond.rhs_col)[l_cnt];
-            }
-            for(;r_cnt<r_size_;r_cnt++){
-                if(eval_conds(r_cols,fed_conds_,rhs_block_[r_cnt].get())){
-                    return ;
-                }
+    // 读入下一批非空的左边记录，左边结束时返回false
+    bool next_left() {
+        while (left_->next_batch(lhs_batch_)) {
+            if (!lhs_batch_.empty()) {
+                l_size_ = lhs_batch_.size();
+                l_cnt = 0;
+                r_cnt = 0;
+                return true;
             }
-            r_cnt=0;
         }
+        endend = true;
+        return false;
     }
 
-    void nextTuple() override {
+    const char *rhs_row(int i) const { return rhs_rows_.data() + (size_t)i * r_len; }
 
-        for(;l_cnt<l_size_;l_cnt++){
-            for (auto &cond : fed_conds_) {
-                if (!cond.is_rhs_val && cond.rhs_col.tab_name != tab_name_) {
-                    cond.is_rhs_val = true;
-                    cond.rhs_val = all_dict_.at(cond.rhs_col)[l_cnt];
-                }
-                if(all_dict_.find(cond.rhs_col)==all_dict_.end()) { continue ;}
-                cond.rhs_val = all_dict_.at(cond.rhs_col)[l_cnt];
-            }
-            for(;r_cnt<r_size_;r_cnt++){
-                if(eval_conds(r_cols,fed_conds_,rhs_block_[r_cnt].get())){
-                    return ;
+    // 从(l_cnt, r_cnt)开始找到下一对满足条件的记录，当前一批左边记录用完后读入下一批
+    void nextTuple() override {
+        while (!endend) {
+            for(;l_cnt<l_size_;l_cnt++){
+                const char *lhs = lhs_batch_.at(l_cnt);
+                for(;r_cnt<r_size_;r_cnt++){
+                    if(pred_.eval(lhs, rhs_row(r_cnt))){
+                        return ;
+                    }
                 }
+                r_cnt = 0;
             }
-            r_cnt = 0;
+            next_left();
         }
     }
-    bool is_end() const override { return (endend)||(l_cnt==lhs_block_.size());}
+    bool is_end() const override { return endend; }
     bool has_nlj() override {
         return true;
     }
@@ -233,10 +160,13 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
 
     std::vector<std::unique_ptr<RmRecord>> get_block() override {
         auto block = std::vector<std::unique_ptr<RmRecord>>{};
+        if (!begun_) {
+            beginTuple();
+        }
         while(!is_end()) {
             auto record = std::make_unique<RmRecord>(len_);
-            memcpy(record->data, lhs_block_[l_cnt]->data, l_len);
-            memcpy(record->data + l_len, rhs_block_[r_cnt]->data, r_len);
+            memcpy(record->data, lhs_batch_.at(l_cnt), l_len);
+            memcpy(record->data + l_len, rhs_row(r_cnt), r_len);
             r_cnt+=1;
             block.push_back(std::move(record));
             nextTuple();
@@ -244,11 +174,26 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
         return block;
     }
 
+    bool next_batch(RecordBatch &batch) override {
+        if (!begun_) {
+            beginTuple();
+        }
+        batch.reset(len_);
+        while (!batch.full() && !is_end()) {
+            char *rec = batch.append();
+            memcpy(rec, lhs_batch_.at(l_cnt), l_len);
+            memcpy(rec + l_len, rhs_row(r_cnt), r_len);
+            r_cnt+=1;
+            nextTuple();
+        }
+        return !batch.empty();
+    }
+
     std::unique_ptr<RmRecord> Next() override {
         if(is_end()) return nullptr;
         auto record = std::make_unique<RmRecord>(len_);
-        memcpy(record->data, lhs_block_[l_cnt]->data, l_len);
-        memcpy(record->data + l_len, rhs_block_[r_cnt]->data, r_len);
+        memcpy(record->data, lhs_batch_.at(l_cnt), l_len);
+        memcpy(record->data + l_len, rhs_row(r_cnt), r_len);
         r_cnt+=1;
         return record;
     }
@@ -0,0 +1,208 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "execution_aggregate.h"
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "execution_memory.h"
+#include "execution_parallel.h"
+#include "executor_abstract.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+constexpr int PARALLEL_AGG_PARTITION_BITS = 6;      // 合并局部分组时用hash值的高6位分成64个分区
+
+/**
+ * 两阶段的并行hash聚合：第一阶段各工作线程从自己的流水线读入记录，在线程自己的GroupHashTable中预聚合；
+ * 第二阶段各线程逐个领取分区，把所有线程在该分区中的局部分组用GroupAggregator::merge合并成最终分组
+ * 分组状态全部放在内存中并计入查询的内存预算，预算不足时报错，不像HashAggregateExecutor那样写出到临时文件
+ * 没有GROUP BY时即使没有输入记录也输出一行
+ */
+class ParallelHashAggregateExecutor : public AbstractExecutor {
+   private:
+    std::vector<std::unique_ptr<AbstractExecutor>> inputs_;
+    GroupAggregator agg_;
+    std::shared_ptr<MemoryBudget> budget_;
+    std::deque<MemoryReservation> mems_;        // 预聚合时各线程的局部分组，合并后归还
+    MemoryReservation mem_;                     // 全部分区的最终分组
+
+    std::vector<GroupHashTable> results_;       // 各分区的最终分组
+    size_t part_ = 0;                           // 正在输出的分区
+    size_t emit_pos_ = 0;                       // 该分区中下一个输出的分组
+    bool begun_ = false;
+
+   public:
+    [[nodiscard]] const std::vector<ColMeta> &cols() const override { return agg_.out_cols(); }
+
+    ParallelHashAggregateExecutor(std::vector<std::unique_ptr<AbstractExecutor>> inputs,
+                                  const std::vector<TabCol> &group_cols,
+                                  const std::vector<std::shared_ptr<ast::AggreClause>> &aggres,
+                                  std::shared_ptr<MemoryBudget> budget)
+        : budget_(std::move(budget)), mem_(budget_) {
+        inputs_ = std::move(inputs);
+        agg_ = GroupAggregator(inputs_[0]->cols(), group_cols, aggres);
+    }
+
+    std::string getType() override { return "ParallelHashAggregateExecutor"; }
+
+    size_t tupleLen() const override { return agg_.out_len(); }
+
+    ColMeta get_col_offset(const TabCol &target) override { return agg_.get_col(target); }
+
+    void beginTuple() override {
+        begun_ = true;
+        size_t n = inputs_.size();
+        size_t num_parts = 1 << PARALLEL_AGG_PARTITION_BITS;
+        // 加表锁等在调用线程中依次完成
+        for (auto &input : inputs_) {
+            input->begin_batch();
+        }
+        mems_.clear();
+        mem_.reset();
+        for (size_t i = 0; i < n; i++) {
+            mems_.emplace_back(budget_, MEM_RESERVE_CHUNK / EXEC_MAX_DOP);
+        }
+        std::vector<GroupHashTable> locals(n, GroupHashTable(agg_.key_len(), agg_.state_len()));
+        std::vector<std::vector<std::vector<uint32_t>>> members(n);     // members[w][p]为线程w落在分区p的局部分组
+        WorkerPool::instance().run(n, [&](size_t w) {
+            auto &table = locals[w];
+            RecordBatch batch;
+            std::vector<char> key(agg_.key_len() + 1);
+            while (inputs_[w]->next_batch(batch)) {
+                for (size_t k = 0; k < batch.size(); k++) {
+                    const char *row = batch.at(k);
+                    agg_.make_key(row, key.data());
+                    uint64_t hash = ix_hash_key(key.data(), agg_.key_len());
+                    size_t pos;
+                    uint32_t g = table.find(key.data(), hash, pos);
+                    if (g != GroupHashTable::NIL) {
+                        agg_.update(table.state(g), row);
+                        continue;
+                    }
+                    if (!mems_[w].grow(table.bytes_for(table.size() + 1))) {
+                        throw QueryMemoryLimitError("parallel aggregation");
+                    }
+                    agg_.init(table.insert(pos, key.data(), hash), row);
+                }
+            }
+            members[w].resize(num_parts);
+            for (size_t g = 0; g < table.size(); g++) {
+                members[w][partition_of(table.hash(g))].push_back(g);
+            }
+        });
+        results_.assign(num_parts, GroupHashTable(agg_.key_len(), agg_.state_len()));
+        // 合并前按局部分组数（最终分组数的上限）一次性预留，合并后再按实际的分组数调整
+        size_t bound = 0;
+        for (size_t p = 0; p < num_parts; p++) {
+            size_t groups = 0;
+            for (size_t w = 0; w < n; w++) {
+                groups += members[w][p].size();
+            }
+            bound += results_[p].bytes_for(groups);
+        }
+        if (!mem_.grow(bound)) {
+            throw QueryMemoryLimitError("parallel aggregation");
+        }
+        std::atomic<size_t> next{0};
+        WorkerPool::instance().run(n, [&](size_t) {
+            for (size_t p = next++; p < num_parts; p = next++) {
+                auto &result = results_[p];
+                for (size_t w = 0; w < n; w++) {
+                    for (auto g : members[w][p]) {
+                        const char *state = locals[w].state(g);     // 状态以key开头
+                        uint64_t hash = locals[w].hash(g);
+                        size_t pos;
+                        uint32_t r = result.find(state, hash, pos);
+                        if (r != GroupHashTable::NIL) {
+                            agg_.merge(result.state(r), state);
+                            continue;
+                        }
+                        memcpy(result.insert(pos, state, hash), state, agg_.state_len());
+                    }
+                }
+            }
+        });
+        // 局部分组在这里释放
+        mems_.clear();
+        size_t groups = 0;
+        size_t bytes = 0;
+        for (auto &result : results_) {
+            groups += result.size();
+            bytes += result.bytes_for(result.size());
+        }
+        mem_.reset();
+        mem_.grow(bytes);
+        if (groups == 0 && agg_.key_len() == 0) {
+            agg_.init_empty(results_[0].insert(0, "", 0));
+        }
+        part_ = 0;
+        emit_pos_ = 0;
+        advance();
+    }
+
+    void nextTuple() override {
+        if (is_end()) {
+            return;
+        }
+        emit_pos_++;
+        advance();
+    }
+
+    bool is_end() const override { return part_ == results_.size(); }
+
+    std::unique_ptr<RmRecord> Next() override {
+        if (is_end()) {
+            return nullptr;
+        }
+        auto rec = std::make_unique<RmRecord>(agg_.out_len());
+        agg_.finalize(results_[part_].state(emit_pos_), rec->data);
+        return rec;
+    }
+
+    std::vector<std::unique_ptr<RmRecord>> get_block() override {
+        std::vector<std::unique_ptr<RmRecord>> block;
+        if (!begun_) {
+            beginTuple();
+        }
+        while (!is_end()) {
+            block.push_back(Next());
+            nextTuple();
+        }
+        return block;
+    }
+
+    bool next_batch(RecordBatch &batch) override {
+        if (!begun_) {
+            beginTuple();
+        }
+        batch.reset(agg_.out_len());
+        while (!batch.full() && !is_end()) {
+            agg_.finalize(results_[part_].state(emit_pos_), batch.append());
+            emit_pos_++;
+            advance();
+        }
+        return !batch.empty();
+    }
+
+    Rid &rid() override { return _abstract_rid; }
+
+   private:
+    static size_t partition_of(uint64_t hash) { return hash >> (64 - PARALLEL_AGG_PARTITION_BITS); }
+
+    // 跳过已经输出完的分区
+    void advance() {
+        while (part_ < results_.size() && emit_pos_ == results_[part_].size()) {
+            part_++;
+            emit_pos_ = 0;
+        }
+    }
+};
@@ -0,0 +1,237 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "execution_memory.h"
+#include "execution_parallel.h"
+#include "execution_predicate.h"
+#include "executor_join_output.h"
+#include "executor_hash_join.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+constexpr int PARALLEL_JOIN_PARTITION_BITS = 6;     // 并行建表时用hash值的高6位分成64个分区
+
+/**
+ * 并行hash join的build端，由各条探查流水线共享：
+ * 第一阶段各工作线程读入自己的输入（build端是并行扫描时每个线程一条流水线，否则只有一条），
+ * 按key的hash值的高位把记录分到线程自己的各个分区；第二阶段各线程逐个领取分区，把所有线程在该分区中的记录拼接起来并建哈希表
+ * 哈希表用的是hash值的低位，探查时先由高位找到分区，分区之间互不相关，建表不需要加锁
+ * build端全部放在内存中并计入查询的内存预算，预算不足时报错；放不下的build端由计划改用串行的HashJoinExecutor
+ */
+class ParallelJoinBuild {
+   public:
+    /* 一个分区的build记录，rows、keys、hashes按下标一一对应 */
+    struct Partition {
+        std::vector<char> rows;
+        std::vector<char> keys;
+        std::vector<uint64_t> hashes;
+        JoinHashTable table;
+    };
+
+    ParallelJoinBuild(std::vector<std::unique_ptr<AbstractExecutor>> inputs, const std::vector<ColMeta> &probe_cols,
+                      std::vector<Condition> conds, bool build_left, std::shared_ptr<MemoryBudget> budget)
+        : budget_(std::move(budget)), mem_(budget_) {
+        inputs_ = std::move(inputs);
+        build_left_ = build_left;
+        len_ = inputs_[0]->tupleLen();
+        auto &build_cols = inputs_[0]->cols();
+        key_ = build_left_ ? JoinKeys(build_cols, probe_cols, std::move(conds), rest_)
+                           : JoinKeys(probe_cols, build_cols, std::move(conds), rest_);
+    }
+
+    const std::vector<ColMeta> &cols() const { return inputs_[0]->cols(); }
+    size_t tupleLen() const { return len_; }
+    bool build_left() const { return build_left_; }
+    const JoinKeys &key() const { return key_; }
+    const std::vector<Condition> &rest() const { return rest_; }
+
+    static size_t partition_of(uint64_t hash) { return hash >> (64 - PARALLEL_JOIN_PARTITION_BITS); }
+
+    const Partition &partition(uint64_t hash) const { return parts_[partition_of(hash)]; }
+
+    // 在调用线程中依次begin_batch（加表锁等），再在工作线程池中读入build端并建哈希表，返回时所有分区都已经建好
+    void build() {
+        size_t n = inputs_.size();
+        size_t num_parts = 1 << PARALLEL_JOIN_PARTITION_BITS;
+        for (auto &input : inputs_) {
+            input->begin_batch();
+        }
+        parts_.clear();
+        parts_.resize(num_parts);
+        mems_.clear();
+        mem_.reset();
+        for (size_t i = 0; i < n; i++) {
+            mems_.emplace_back(budget_, MEM_RESERVE_CHUNK / EXEC_MAX_DOP);
+        }
+        std::vector<std::vector<Partition>> local(n, std::vector<Partition>(num_parts));
+        int key_len = key_.len();
+        WorkerPool::instance().run(n, [&](size_t w) {
+            RecordBatch batch;
+            std::vector<char> key(key_len);
+            size_t bytes = 0;
+            while (inputs_[w]->next_batch(batch)) {
+                for (size_t k = 0; k < batch.size(); k++) {
+                    const char *rec = batch.at(k);
+                    key_.make(rec, build_left_, key.data());
+                    uint64_t hash = ix_hash_key(key.data(), key_len);
+                    auto &part = local[w][partition_of(hash)];
+                    part.rows.insert(part.rows.end(), rec, rec + len_);
+                    part.keys.insert(part.keys.end(), key.begin(), key.end());
+                    part.hashes.push_back(hash);
+                }
+                bytes += batch.size() * (len_ + key_len + sizeof(uint64_t));
+                if (!mems_[w].grow(bytes)) {
+                    throw QueryMemoryLimitError("parallel hash join");
+                }
+            }
+        });
+        // 建好的各分区一次性按总行数预留：拼接后的记录和key，以及hash、槽位和next数组（与HashJoinExecutor的估计相同）
+        size_t total = 0;
+        for (auto &parts : local) {
+            for (auto &part : parts) {
+                total += part.hashes.size();
+            }
+        }
+        if (!mem_.grow(total * (len_ + key_len + 24))) {
+            throw QueryMemoryLimitError("parallel hash join");
+        }
+        std::atomic<size_t> next{0};
+        WorkerPool::instance().run(n, [&](size_t) {
+            for (size_t p = next++; p < num_parts; p = next++) {
+                auto &part = parts_[p];
+                size_t rows = 0;
+                for (size_t w = 0; w < n; w++) {
+                    rows += local[w][p].hashes.size();
+                }
+                part.rows.reserve(rows * len_);
+                part.keys.reserve(rows * key_len);
+                part.hashes.reserve(rows);
+                for (size_t w = 0; w < n; w++) {
+                    auto &src = local[w][p];
+                    part.rows.insert(part.rows.end(), src.rows.begin(), src.rows.end());
+                    part.keys.insert(part.keys.end(), src.keys.begin(), src.keys.end());
+                    part.hashes.insert(part.hashes.end(), src.hashes.begin(), src.hashes.end());
+                    src = Partition();
+                }
+                part.table.build(part.keys.data(), part.hashes.data(), rows, key_len);
+            }
+        });
+        // 线程局部的分区已经释放
+        mems_.clear();
+    }
+
+   private:
+    std::vector<std::unique_ptr<AbstractExecutor>> inputs_;
+    bool build_left_;
+    size_t len_;
+    JoinKeys key_;
+    std::vector<Condition> rest_;               // 不能用作key的其余连接条件
+    std::shared_ptr<MemoryBudget> budget_;
+    std::deque<MemoryReservation> mems_;        // 建表时各线程的局部分区，建好后归还
+    MemoryReservation mem_;                     // 建好的全部分区
+    std::vector<Partition> parts_;
+};
+
+/**
+ * 并行hash join的探查端，每个工作线程一个，共享同一个ParallelJoinBuild：从自己的流水线（通常是并行扫描）读入一批probe端记录，
+ * 在对应分区的哈希表中查找，拼出连接结果；输出记录的布局与HashJoinExecutor相同，左边在前
+ * leader为true的那一个在begin_batch中建表，ExchangeExecutor保证它的begin_batch在其余流水线之前、在调用线程中执行
+ */
+class HashJoinProbeExecutor : public JoinOutputExecutor {
+   private:
+    std::shared_ptr<ParallelJoinBuild> build_;
+    bool leader_;
+    bool build_left_;
+    size_t l_len_;
+    size_t r_len_;
+    std::vector<ColMeta> cols_;
+    std::vector<Condition> conds_;              // 不能用作key的其余连接条件
+    CompiledPredicate pred_;                    // 由conds_编译出的条件，在拼好的记录上求值
+
+    RecordBatch in_;                            // 当前探查的一批probe端记录
+    std::vector<char> keys_;
+    std::vector<uint64_t> hashes_;
+
+   public:
+    HashJoinProbeExecutor(std::unique_ptr<AbstractExecutor> probe, std::shared_ptr<ParallelJoinBuild> build, bool leader) {
+        prev_ = std::move(probe);
+        build_ = std::move(build);
+        leader_ = leader;
+        build_left_ = build_->build_left();
+        auto &lcols = build_left_ ? build_->cols() : prev_->cols();
+        auto &rcols = build_left_ ? prev_->cols() : build_->cols();
+        l_len_ = build_left_ ? build_->tupleLen() : prev_->tupleLen();
+        r_len_ = build_left_ ? prev_->tupleLen() : build_->tupleLen();
+        len_ = l_len_ + r_len_;
+        cols_ = lcols;
+        for (auto col : rcols) {
+            col.offset += l_len_;
+            cols_.push_back(col);
+        }
+        conds_ = build_->rest();
+        pred_.bind(cols_, conds_);
+    }
+
+    [[nodiscard]] const std::vector<ColMeta> &cols() const override { return cols_; }
+
+    std::string getType() override { return "HashJoinProbeExecutor"; }
+
+    ColMeta get_col_offset(const TabCol &target) override { return *get_col(cols_, target); }
+
+    void begin_batch() override {
+        if (leader_) {
+            build_->build();
+        }
+        prev_->begin_batch();
+        reset_output();
+    }
+
+    void beginTuple() override {
+        begin_batch();
+        fill();
+    }
+
+   private:
+    // 探查下一批probe端记录，probe端结束后不再有结果
+    void produce() override {
+        if (!prev_->next_batch(in_)) {
+            finish();
+            return;
+        }
+        // 先算出整批的key和hash并预取槽位，再逐个查找
+        auto &key = build_->key();
+        int key_len = key.len();
+        keys_.resize(in_.size() * key_len);
+        hashes_.resize(in_.size());
+        for (size_t i = 0; i < in_.size(); i++) {
+            key.make(in_.at(i), !build_left_, keys_.data() + i * key_len);
+            hashes_[i] = ix_hash_key(keys_.data() + i * key_len, key_len);
+            build_->partition(hashes_[i]).table.prefetch(hashes_[i]);
+        }
+        size_t build_len = build_->tupleLen();
+        for (size_t i = 0; i < in_.size(); i++) {
+            auto &part = build_->partition(hashes_[i]);
+            for (auto j = part.table.find(keys_.data() + i * key_len, hashes_[i]); j != JoinHashTable::NIL;
+                 j = part.table.next(j)) {
+                char *record = append();
+                const char *build_rec = part.rows.data() + (size_t)j * build_len;
+                memcpy(record, build_left_ ? build_rec : in_.at(i), l_len_);
+                memcpy(record + l_len_, build_left_ ? in_.at(i) : build_rec, r_len_);
+                if (pred_.eval(record)) {
+                    commit();
+                }
+            }
+        }
+    }
+};
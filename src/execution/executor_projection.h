@@ -22,10 +22,15 @@ class ProjectionExecutor : public AbstractExecutor {
     std::vector<ColMeta> cols_;                     // 需要投影的字段
     size_t len_;                                    // 字段总长度
     std::vector<size_t> sel_idxs_;                  
+    bool identity_;                                 // 投影后每个字段的位置不变，可以直接输出儿子的记录
+    RecordBatch in_;                                // 批量执行时从儿子取到的一批记录
+    int limit_;                                     // LIMIT，-1表示不限制
+    int emitted_ = 0;                               // 已经输出的记录数
 
    public:
-    ProjectionExecutor(std::unique_ptr<AbstractExecutor> prev, const std::vector<TabCol> &sel_cols) {
+    ProjectionExecutor(std::unique_ptr<AbstractExecutor> prev, const std::vector<TabCol> &sel_cols, int limit = -1) {
         prev_ = std::move(prev);
+        limit_ = limit;
 
         size_t curr_offset = 0;
         // 注意下面的prev_确实是调用的seq scan的cols
@@ -39,7 +44,10 @@ class ProjectionExecutor : public AbstractExecutor {
             cols_.push_back(col);
         }
         len_ = curr_offset;
-
+        identity_ = true;
+        for (size_t proj_idx = 0; proj_idx < cols_.size(); proj_idx++) {
+            identity_ = identity_ && prev_cols[sel_idxs_[proj_idx]].offset == cols_[proj_idx].offset;
+        }
     }
 
     size_t tupleLen() const override { return len_;}
@@ -47,31 +55,33 @@ class ProjectionExecutor : public AbstractExecutor {
     [[nodiscard]] const std::vector<ColMeta> &cols() const override {
         return cols_; }
 
-    [[maybe_unused]] void feed(const std::map<TabCol, Value> &feed_dict)  {
-        throw InternalError("Cannot feed a projection node");
-    }
-
     void beginTuple() override {
         // std::cout<<"proj beginTuple"<<std::endl;
+        emitted_ = 0;
         prev_->beginTuple();
     }
 
     void nextTuple() override {
         // std::cout<<"proj nextTuple"<<std::endl;
-        if(prev_->is_end()){
+        if(is_end()){
             // std::cout<<"proj's prev_ is ended"<<std::endl;
             return;
         }
+        emitted_++;
+        if (limit_reached()) {
+            return;
+        }
         prev_->nextTuple();
     }
 
-    bool has_aggre() override {
-        return prev_->has_aggre();
-    }
+    bool limit_reached() const { return limit_ >= 0 && emitted_ >= limit_; }
 
     std::vector<std::unique_ptr<RmRecord>> get_block() override {
         auto blocks = prev_->get_block();
-        if((has_aggre()&&get_aggre_type() == ast::AggregationType::COUNT)||(!has_nlj()&&(prev_->cols()==cols_))) {
+        if (limit_ >= 0 && blocks.size() > (size_t)limit_) {
+            blocks.resize(limit_);
+        }
+        if(!has_nlj()&&(prev_->cols()==cols_)) {
             return blocks;
         }
         std::vector<std::unique_ptr<RmRecord>> blk;
@@ -92,10 +102,52 @@ class ProjectionExecutor : public AbstractExecutor {
         return blk;
     }
 
-    std::string get_nickname() override {
-        return prev_->get_nickname();
+    void begin_batch() override {
+        emitted_ = 0;
+        prev_->begin_batch();
     }
-    [[nodiscard]] bool is_end() const override { return prev_->is_end(); }
+
+    // 每个字段在批中按列依次拷贝；位置不变的投影直接输出儿子的批。达到LIMIT后不再向儿子取数据
+    bool next_batch(RecordBatch &batch) override {
+        if (limit_reached()) {
+            return false;
+        }
+        if (identity_) {
+            if (!prev_->next_batch(batch)) {
+                return false;
+            }
+            truncate(batch);
+            return true;
+        }
+        if (!prev_->next_batch(in_)) {
+            return false;
+        }
+        truncate(in_);
+        batch.reset(len_);
+        size_t n = in_.size();
+        for (size_t k = 0; k < n; k++) {
+            batch.append();
+        }
+        auto &prev_cols = prev_->cols();
+        for (size_t proj_idx = 0; proj_idx < cols_.size(); proj_idx++) {
+            auto &prev_col = prev_cols[sel_idxs_[proj_idx]];
+            auto &proj_col = cols_[proj_idx];
+            for (size_t k = 0; k < n; k++) {
+                memcpy(batch.row(k) + proj_col.offset, in_.at(k) + prev_col.offset, proj_col.len);
+            }
+        }
+        return true;
+    }
+
+    // 只保留LIMIT剩余的记录数
+    void truncate(RecordBatch &batch) {
+        if (limit_ >= 0) {
+            batch.sel.resize(std::min(batch.size(), (size_t)(limit_ - emitted_)));
+            emitted_ += batch.size();
+        }
+    }
+
+    [[nodiscard]] bool is_end() const override { return limit_reached() || prev_->is_end(); }
 
     std::unique_ptr<RmRecord> Next() override {
         // std::cout<<"Next() of proj is called"<<std::endl;
@@ -119,9 +171,6 @@ class ProjectionExecutor : public AbstractExecutor {
         return proj_rec;
     }
 
-    ast::AggregationType get_aggre_type() override {
-        return prev_->get_aggre_type();
-    };
     ColMeta get_col_offset(const TabCol &target) override {
 
     }
@@ -12,6 +12,8 @@ See the Mulan PSL v2 for more details. */
 
 #include "execution_defs.h"
 #include "execution_manager.h"
+#include "execution_parallel.h"
+#include "execution_predicate.h"
 #include "executor_abstract.h"
 #include "index/ix.h"
 #include "analyze/analyze.h"
@@ -25,9 +27,17 @@ class SeqScanExecutor : public AbstractExecutor {
     std::vector<ColMeta> cols_;         // scan后生成的记录的字段
     size_t len_;                        // scan后生成的每条记录的长度
     std::vector<Condition> fed_conds_;  // 同conds_，两个字段相同
+    CompiledPredicate pred_;            // 由fed_conds_编译出的条件，fed_conds_改变时重新编译
     static std::map<CompOp, CompOp> swap_op;
     Rid rid_;
     std::unique_ptr<RecScan> scan_;     // table_iterator
+    int batch_page_;                    // 批量扫描的位置：下一个要读的页面
+    int batch_slot_;                    // 批量扫描的位置：该页面中已经读过的最后一个slot，-1表示还没有开始读
+    std::vector<RmZoneCond> batch_zone_conds_;
+    int limit_;                         // 最多输出的记录数，-1表示不限制
+    int emitted_ = 0;                   // 已经输出的记录数
+    std::shared_ptr<PageMorsels> morsels_;  // 并行扫描时各线程共享的页面分配，为空时扫描整个表
+    int batch_end_;                     // 并行扫描时当前morsel的结束页面
 
     SmManager *sm_manager_;
 
@@ -37,8 +47,11 @@ class SeqScanExecutor : public AbstractExecutor {
         return cols_; }
 
 
-        SeqScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds, Context *context) {
+        SeqScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds, Context *context,
+                        int limit = -1, std::shared_ptr<PageMorsels> morsels = nullptr) {
         sm_manager_ = sm_manager;
+        limit_ = limit;
+        morsels_ = std::move(morsels);
         tab_name_ = std::move(tab_name);
         conds_ = std::move(conds);
 
@@ -68,6 +81,7 @@ class SeqScanExecutor : public AbstractExecutor {
             std::cout<<cond.to_string()<<std::endl;
         }
          */
+        pred_.bind(cols_, fed_conds_);
     }
     std::string get_tbl_name() override {
         return tab_name_;
@@ -85,17 +99,6 @@ class SeqScanExecutor : public AbstractExecutor {
         }
     }
 
-    void fast_feed(const std::map<TabCol, std::vector<Value>> &feed_dict, size_t cnt) override {
-        for (auto &cond : fed_conds_) {
-            if (!cond.is_rhs_val && cond.rhs_col.tab_name != tab_name_) {
-                cond.is_rhs_val = true;
-                cond.rhs_val = feed_dict.at(cond.rhs_col)[cnt];
-            }
-            if(feed_dict.find(cond.rhs_col)==feed_dict.end()) { continue ;}
-            cond.rhs_val = feed_dict.at(cond.rhs_col)[cnt];
-        }
-        check_runtime_conds();
-    }
     void set_conds(std::vector<Condition> conds) override {
         static std::map<CompOp, CompOp> swap_op_ack = {
                 {OP_EQ, OP_EQ}, {OP_NE, OP_NE}, {OP_LT, OP_GT}, {OP_GT, OP_LT}, {OP_LE, OP_GE}, {OP_GE, OP_LE},
@@ -108,6 +111,7 @@ class SeqScanExecutor : public AbstractExecutor {
             }
         }
         fed_conds_ = conds;
+        pred_.bind(cols_, fed_conds_);
     }
     size_t tupleLen() const override { return len_; }
     static std::vector<ColMeta>::const_iterator get_col(const std::vector<ColMeta> &rec_cols, const TabCol &target) {
@@ -121,77 +125,47 @@ class SeqScanExecutor : public AbstractExecutor {
     }
 
     bool is_end() const override {
-        return scan_->is_end();
+        return scan_ == nullptr || scan_->is_end() || limit_reached(0);
     }
 
+    // 已经输出的记录数加上pending条是否达到LIMIT
+    bool limit_reached(size_t pending) const { return limit_ >= 0 && emitted_ + (int)pending >= limit_; }
 
-    void feed(const std::map<TabCol, Value> &feed_dict) {
-        // fed_conds_ = conds_;
+    // 从条件中取出字段与常量比较的范围谓词，交给RmScan按zone map跳过页面
+    std::vector<RmZoneCond> zone_conds() {
+        static std::map<CompOp, RmZoneOp> zone_op = {
+                {OP_EQ, ZONE_EQ}, {OP_LT, ZONE_LT}, {OP_LE, ZONE_LE}, {OP_GT, ZONE_GT}, {OP_GE, ZONE_GE},
+        };
+        std::vector<RmZoneCond> zone_conds;
         for (auto &cond : fed_conds_) {
-            // 如果右侧的表名和当前的表名不一样，就说明是在nlj阶段，把lhs_tbl.attr1 < rhs_tbl.attr2
-            // 换成lhs_tbl.attr1 < concrete value
-            if (!cond.is_rhs_val && cond.rhs_col.tab_name != tab_name_) {
-                cond.is_rhs_val = true;
-                cond.rhs_val = feed_dict.at(cond.rhs_col);
+            if (!cond.is_rhs_val || cond.op == OP_NE || cond.rhs_val.raw == nullptr) {
+                continue;
             }
-            // std::cout<<"feed\n\n"<<cond.to_string()<<std::endl;
-            // 没有下面这一行就没法做双表列判断，有了下面这一行就没法做单表列判断
-            // 之所以要加下面这一行才能做nlj，是因为每一次更新left的时候，都必须feedright to get new value, but
-            // at this very moment, the right is not a column, but a value, so failed to update
-            if(feed_dict.find(cond.rhs_col)==feed_dict.end()) { continue ;}
-            cond.rhs_val = feed_dict.at(cond.rhs_col);
+            auto lhs_col = get_col(cols_, cond.lhs_col);
+            if (lhs_col->type != cond.rhs_val.type || cond.rhs_val.raw->size < lhs_col->len) {
+                continue;
+            }
+            auto *val = cond.rhs_val.raw->data;
+            zone_conds.push_back({.offset = lhs_col->offset, .op = zone_op.at(cond.op),
+                                  .val = std::vector<char>(val, val + lhs_col->len)});
         }
-        check_runtime_conds();
+        return zone_conds;
     }
 
-
-
-
-
-    bool eval_cond(const std::vector<ColMeta> &rec_cols,
-                          const Condition &cond,
-                          const RmRecord *rec) {
-        auto lhs_col = get_col(rec_cols, cond.lhs_col);
-        auto *lhs = rec->data + lhs_col->offset;
-        char* rhs;
-        ColType rhs_type;
-        if (cond.is_rhs_val) {
-            rhs_type = cond.rhs_val.type;
-            rhs = cond.rhs_val.raw->data;
-        } else {
-            // rhs is a column
-            auto rhs_col = get_col(rec_cols, cond.rhs_col);
-            rhs_type = rhs_col->type;
-            rhs = rec->data + rhs_col->offset;
-        }
-
-        if(rhs_type != lhs_col->type){
-            // 这里暂时没有管长度
-            if(rhs_type==TYPE_DATETIME&&lhs_col->type==TYPE_STRING&&lhs_col->len>=19) {
-            } else if(rhs_type==TYPE_INT&&lhs_col->type==TYPE_BIGINT){}else {
-                throw IncompatibleTypeError(coltype2str(lhs_col->type), coltype2str(rhs_type));
+    std::vector<std::unique_ptr<RmRecord>> get_block() override {
+        auto block = std::vector<std::unique_ptr<RmRecord>>{};
+        RecordBatch batch;
+        for (begin_batch(); next_batch(batch);) {
+            for (size_t k = 0; k < batch.size(); k++) {
+                auto rec = std::make_unique<RmRecord>(len_);
+                memcpy(rec->data, batch.at(k), len_);
+                block.push_back(std::move(rec));
             }
-        }  // TODO convert to common type
-
-        int cmp = ix_compare(lhs, rhs, rhs_type, lhs_col->len);
-        if (cond.op == OP_EQ) {
-            return cmp == 0;
-        } else if (cond.op == OP_NE) {
-            return cmp != 0;
-        } else if (cond.op == OP_LT) {
-            return cmp < 0;
-        } else if (cond.op == OP_GT) {
-            return cmp > 0;
-        } else if (cond.op == OP_LE) {
-            return cmp <= 0;
-        } else if (cond.op == OP_GE) {
-            return cmp >= 0;
-        } else {
-            throw InternalError("Unexpected op type");
         }
+        return block;
     }
 
-    std::vector<std::unique_ptr<RmRecord>> get_block() override {
+    void begin_batch() override {
         if(context_->txn_->get_txn_mode()) {
             auto tab_fd = fh_->GetFd();
             auto lock_mgr = context_->lock_mgr_;
@@ -199,26 +173,69 @@ class SeqScanExecutor : public AbstractExecutor {
                 throw TransactionAbortException(context_->txn_->get_transaction_id(), AbortReason::FAILED_TO_LOCK);
             }
         }
-        auto block = std::vector<std::unique_ptr<RmRecord>>{};
-        scan_ = std::make_unique<RmScan>(fh_);
-        while (!scan_->is_end()) {
-            rid_ = scan_->rid();
-            auto rec = fh_->get_record(rid_,context_);
-            if (eval_conds(cols_, fed_conds_, rec.get())) {
-                // rec2dict(cols_,rec.get());
-                block.push_back(std::move(rec));
-            }
-            scan_->next();
+        check_runtime_conds();
+        batch_page_ = RM_FIRST_RECORD_PAGE;
+        batch_slot_ = -1;
+        emitted_ = 0;
+        batch_zone_conds_ = zone_conds();
+        if (morsels_ != nullptr) {
+            morsels_->reset(RM_FIRST_RECORD_PAGE, fh_->get_file_hdr().num_pages);
+            batch_end_ = batch_page_;
         }
-        return block;
     }
 
-    bool eval_conds(const std::vector<ColMeta> &rec_cols,
-                           const std::vector<Condition> &conds,
-                           const RmRecord *rec) {
-        return std::all_of(conds.begin(), conds.end(), [&](const Condition &cond) {
-            return eval_cond(rec_cols, cond, rec);
-        });
+    // 是否还有页面要扫描；并行扫描时当前morsel扫描完后取下一个morsel
+    bool has_page(int num_pages) {
+        if (morsels_ == nullptr) {
+            return batch_page_ < num_pages;
+        }
+        return batch_page_ < batch_end_ || morsels_->next(batch_page_, batch_end_);
+    }
+
+    /**
+     * 按页继续扫描，直到凑满一批或扫描结束
+     * 行存布局直接在页面中的slot上求值条件，只拷贝满足条件的记录；PAX布局先拼出整批记录再按条件筛选
+     * 并行扫描时每个线程有自己的SeqScanExecutor，只扫描从morsels_中取到的页面
+     */
+    bool next_batch(RecordBatch &batch) override {
+        batch.reset(len_);
+        if (limit_reached(0)) {
+            return false;
+        }
+        auto file_hdr = fh_->get_file_hdr();
+        int n = file_hdr.num_records_per_page;
+        bool pax = fh_->is_pax();
+        // 有LIMIT时凑够剩余的记录数就停止，不再读后面的页面
+        while (!batch.full() && !limit_reached(batch.size()) && has_page(file_hdr.num_pages)) {
+            if (batch_slot_ == -1 && !fh_->zone_map().may_match(batch_page_, batch_zone_conds_)) {
+                batch_page_++;
+                continue;
+            }
+            RmPageHandle ph = fh_->fetch_page_handle(batch_page_);
+            int slot_no = Bitmap::next_bit(true, ph.bitmap, n, batch_slot_);
+            for (; slot_no < n && !batch.full() && !limit_reached(batch.size());
+                 slot_no = Bitmap::next_bit(true, ph.bitmap, n, slot_no)) {
+                batch_slot_ = slot_no;
+                if (pax) {
+                    ph.read_slot(slot_no, batch.append());
+                } else if (pred_.eval(ph.get_slot(slot_no))) {
+                    batch.append(ph.get_slot(slot_no));
+                }
+            }
+            sm_manager_->get_bpm()->unpin_page(ph.page->get_page_id(), false);
+            if (slot_no >= n) {
+                batch_page_++;
+                batch_slot_ = -1;
+            }
+        }
+        if (pax) {
+            batch.select(pred_);
+        }
+        if (limit_ >= 0) {
+            batch.sel.resize(std::min(batch.size(), (size_t)(limit_ - emitted_)));
+            emitted_ += batch.size();
+        }
+        return batch.num_rows > 0;
     }
 
     void beginTuple() override {
@@ -231,13 +248,14 @@ class SeqScanExecutor : public AbstractExecutor {
             }
         }
         check_runtime_conds();
+        emitted_ = 0;
         TabMeta &tab = sm_manager_->db_.get_table(tab_name_);
-        scan_ = std::make_unique<RmScan>(fh_);
+        scan_ = std::make_unique<RmScan>(fh_, zone_conds());
         while (!scan_->is_end()) {
             rid_ = scan_->rid();
             auto rec = fh_->get_record(rid_,context_);
 
-            if (eval_conds(cols_, fed_conds_, rec.get())) {
+            if (pred_.eval(rec.get())) {
                 break;
             }
             scan_->next();
@@ -249,15 +267,70 @@ class SeqScanExecutor : public AbstractExecutor {
         if(is_end()){
             return;
         }
+        emitted_++;
+        if (limit_reached(0)) {
+            return;
+        }
         for (scan_->next(); !scan_->is_end(); scan_->next()) {
             rid_ = scan_->rid();
             auto rec = fh_->get_record(rid_,context_);
-            if (eval_conds(cols_, fed_conds_, rec.get())) {
+            if (pred_.eval(rec.get())) {
                 break;
             }
         }
     }
 
+    /**
+     * @description: PAX布局的表按列扫描，只读取col和条件中涉及字段的minipage
+     * @return {bool} 行存布局的表返回false，由调用方按行处理
+     * @param {ColMeta&} col 需要读取的字段
+     * @param {function} visit 对每条满足条件的记录，以该记录col字段的地址调用一次
+     */
+    bool scan_column(const ColMeta &col, const std::function<void(const char *)> &visit) override {
+        if (!fh_->is_pax()) {
+            return false;
+        }
+        if(context_->txn_->get_txn_mode()) {
+            auto tab_fd = fh_->GetFd();
+            auto lock_mgr = context_->lock_mgr_;
+            if (!lock_mgr->lock_on_table(context_->txn_, tab_fd, LockMode::SHARED)) {
+                throw TransactionAbortException(context_->txn_->get_transaction_id(), AbortReason::FAILED_TO_LOCK);
+            }
+        }
+        check_runtime_conds();
+        // 条件中涉及的字段，只把这些字段拼到rec中用于pred_
+        std::vector<size_t> cond_cols;
+        for (auto &cond : fed_conds_) {
+            cond_cols.push_back(get_col(cols_, cond.lhs_col) - cols_.begin());
+            if (!cond.is_rhs_val) {
+                cond_cols.push_back(get_col(cols_, cond.rhs_col) - cols_.begin());
+            }
+        }
+        size_t col_no = get_col(cols_, {.tab_name = col.tab_name, .col_name = col.name}) - cols_.begin();
+        RmRecord rec(len_);
+        auto file_hdr = fh_->get_file_hdr();
+        auto page_conds = zone_conds();
+        int n = file_hdr.num_records_per_page;
+        for (int page_no = RM_FIRST_RECORD_PAGE; page_no < file_hdr.num_pages; page_no++) {
+            if (!fh_->zone_map().may_match(page_no, page_conds)) {
+                continue;
+            }
+            RmPageHandle ph = fh_->fetch_page_handle(page_no);
+            const char *minipage = ph.get_minipage(col_no);
+            for (int slot_no = Bitmap::first_bit(true, ph.bitmap, n); slot_no < n;
+                 slot_no = Bitmap::next_bit(true, ph.bitmap, n, slot_no)) {
+                for (auto i : cond_cols) {
+                    memcpy(rec.data + cols_[i].offset, ph.get_minipage(i) + slot_no * cols_[i].len, cols_[i].len);
+                }
+                if (cond_cols.empty() || pred_.eval(&rec)) {
+                    visit(minipage + slot_no * cols_[col_no].len);
+                }
+            }
+            sm_manager_->get_bpm()->unpin_page(ph.page->get_page_id(), false);
+        }
+        return true;
+    }
+
     ColMeta get_col_offset(const TabCol &target) override {
             for (auto &col : cols_) {
                 if (col.name == target.col_name) {
@@ -0,0 +1,186 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+#include "execution_aggregate.h"
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "executor_abstract.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * 输入已经按分组字段有序（例如按索引顺序扫描）时的流式聚合：只保存当前分组的状态，分组key变化时输出上一个分组
+ * 没有GROUP BY时整个输入是一个分组，即使没有输入记录也输出一行
+ */
+class StreamAggregateExecutor : public AbstractExecutor {
+   private:
+    std::unique_ptr<AbstractExecutor> prev_;
+    GroupAggregator agg_;
+    std::vector<char> cur_;                     // 当前分组的状态
+    bool has_cur_ = false;
+    std::vector<char> key_;
+    RecordBatch in_;
+    std::vector<char> out_;                     // 已经结束的分组的输出记录，定长连续存放
+    size_t out_rows_ = 0;
+    size_t out_pos_ = 0;
+    bool input_done_ = false;
+    bool begun_ = false;
+
+   public:
+    [[nodiscard]] const std::vector<ColMeta> &cols() const override { return agg_.out_cols(); }
+
+    StreamAggregateExecutor(std::unique_ptr<AbstractExecutor> prev, const std::vector<TabCol> &group_cols,
+                            const std::vector<std::shared_ptr<ast::AggreClause>> &aggres) {
+        prev_ = std::move(prev);
+        agg_ = GroupAggregator(prev_->cols(), group_cols, aggres);
+        cur_.resize(agg_.state_len());
+        key_.resize(agg_.key_len());
+    }
+
+    std::string getType() override { return "StreamAggregateExecutor"; }
+
+    size_t tupleLen() const override { return agg_.out_len(); }
+
+    ColMeta get_col_offset(const TabCol &target) override { return agg_.get_col(target); }
+
+    void beginTuple() override {
+        begun_ = true;
+        has_cur_ = false;
+        input_done_ = false;
+        out_rows_ = 0;
+        out_pos_ = 0;
+        if (aggregate_columnar()) {
+            return;
+        }
+        prev_->begin_batch();
+        fill();
+    }
+
+    void nextTuple() override {
+        if (is_end()) {
+            return;
+        }
+        out_pos_++;
+        fill();
+    }
+
+    bool is_end() const override { return out_pos_ == out_rows_ && input_done_; }
+
+    std::unique_ptr<RmRecord> Next() override {
+        if (is_end()) {
+            return nullptr;
+        }
+        auto rec = std::make_unique<RmRecord>(agg_.out_len());
+        memcpy(rec->data, out_.data() + out_pos_ * agg_.out_len(), agg_.out_len());
+        return rec;
+    }
+
+    std::vector<std::unique_ptr<RmRecord>> get_block() override {
+        std::vector<std::unique_ptr<RmRecord>> block;
+        if (!begun_) {
+            beginTuple();
+        }
+        while (!is_end()) {
+            block.push_back(Next());
+            nextTuple();
+        }
+        return block;
+    }
+
+    bool next_batch(RecordBatch &batch) override {
+        if (!begun_) {
+            beginTuple();
+        }
+        batch.reset(agg_.out_len());
+        while (!batch.full() && !is_end()) {
+            size_t n = std::min(out_rows_ - out_pos_, EXEC_BATCH_SIZE - batch.num_rows);
+            for (size_t k = 0; k < n; k++) {
+                batch.append(out_.data() + (out_pos_ + k) * agg_.out_len());
+            }
+            out_pos_ += n;
+            fill();
+        }
+        return !batch.empty();
+    }
+
+    Rid &rid() override { return _abstract_rid; }
+
+   private:
+    char *emit() {
+        out_.resize((out_rows_ + 1) * agg_.out_len());
+        return out_.data() + out_rows_++ * agg_.out_len();
+    }
+
+    /**
+     * @description: 没有GROUP BY且只读取一个字段时，子节点是PAX布局表的扫描时只读取该字段所在的minipage完成聚合
+     * @return {bool} 是否已经通过列式访问完成聚合
+     */
+    bool aggregate_columnar() {
+        ColMeta col;
+        if (!agg_.single_input(col)) {
+            return false;
+        }
+        // 全部是COUNT(*)时只需要条件中的字段，任取一列作为访问对象
+        const ColMeta &target = col.name.empty() ? prev_->cols().front() : col;
+        std::vector<char> row(prev_->tupleLen());
+        bool found = false;
+        bool done = prev_->scan_column(target, [&](const char *val) {
+            memcpy(row.data() + target.offset, val, target.len);
+            if (found) {
+                agg_.update(cur_.data(), row.data());
+            } else {
+                agg_.init(cur_.data(), row.data());
+                found = true;
+            }
+        });
+        if (!done) {
+            return false;
+        }
+        if (!found) {
+            agg_.init_empty(cur_.data());
+        }
+        agg_.finalize(cur_.data(), emit());
+        input_done_ = true;
+        return true;
+    }
+
+    // 已输出的分组用完后继续读入子节点的批，直到有分组结束或输入结束
+    void fill() {
+        while (out_pos_ == out_rows_ && !input_done_) {
+            out_rows_ = 0;
+            out_pos_ = 0;
+            if (!prev_->next_batch(in_)) {
+                input_done_ = true;
+                if (has_cur_) {
+                    agg_.finalize(cur_.data(), emit());
+                } else if (agg_.key_len() == 0) {
+                    agg_.init_empty(cur_.data());
+                    agg_.finalize(cur_.data(), emit());
+                }
+                return;
+            }
+            for (size_t k = 0; k < in_.size(); k++) {
+                const char *row = in_.at(k);
+                agg_.make_key(row, key_.data());
+                if (has_cur_ && memcmp(cur_.data(), key_.data(), agg_.key_len()) == 0) {
+                    agg_.update(cur_.data(), row);
+                    continue;
+                }
+                if (has_cur_) {
+                    agg_.finalize(cur_.data(), emit());
+                }
+                memcpy(cur_.data(), key_.data(), agg_.key_len());
+                agg_.init(cur_.data(), row);
+                has_cur_ = true;
+            }
+        }
+    }
+};
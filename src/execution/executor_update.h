@@ -9,6 +9,8 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #pragma once
+#include <unordered_set>
+
 #include "execution_defs.h"
 #include "execution_manager.h"
 #include "executor_abstract.h"
@@ -21,35 +23,37 @@ private:
     TabMeta tab_;
     std::vector<Condition> conds_;
     RmFileHandle *fh_;
-    std::vector<Rid> rids_;
+    std::unique_ptr<AbstractExecutor> prev_;    // 产生待更新记录的扫描节点
     std::string tab_name_;
     std::vector<ColMeta> cols_;
     std::vector<SetClause> set_clauses_;
+    std::vector<ColMeta> set_cols_;             // 与set_clauses_一一对应的左值字段
+    std::vector<size_t> ix_nos_;                // 包含被set字段的索引在tab_.indexes中的下标
+    std::vector<IxIndexHandle *> ihs_;          // 与ix_nos_一一对应的索引句柄
+    std::vector<std::string> ix_names_;         // 与ix_nos_一一对应的索引名
+    std::vector<char> old_buf_;                 // 整条语句复用的旧记录缓冲区
+    std::vector<char> new_buf_;                 // 整条语句复用的新记录缓冲区
+    std::vector<size_t> key_offs_;              // 与ix_nos_一一对应，旧key在每条记录的key区中的偏移，新key紧随其后
+    size_t key_stride_ = 0;                     // 每条记录所有旧key和新key的总长度
+    std::vector<char> keys_;                    // 按rids顺序存放每条记录的旧key和新key
+    std::vector<RmDelta> deltas_;               // 当前记录发生变化的字节区间
     SmManager *sm_manager_;
 
 public:
     [[nodiscard]] const std::vector<ColMeta> &cols() const override {
         return cols_; }
     UpdateExecutor(SmManager *sm_manager, const std::string &tab_name, std::vector<SetClause> set_clauses,
-                   std::vector<Condition> conds, std::vector<Rid> rids, Context *context) {
+                   std::vector<Condition> conds, std::unique_ptr<AbstractExecutor> prev, Context *context) {
         sm_manager_ = sm_manager;
         tab_name_ = tab_name;
         set_clauses_ = set_clauses;
         tab_ = sm_manager_->db_.get_table(tab_name);
         fh_ = sm_manager_->fhs_.at(tab_name).get();
         conds_ = conds;
-        rids_ = rids;
+        prev_ = std::move(prev);
         context_ = context;
     }
 
-    std::vector<ColMeta> get_all_cols(const std::vector<std::string> &tab_names) {
-        std::vector<ColMeta> all_cols;
-        for (auto &sel_tab_name : tab_names) {
-            const auto &sel_tab_cols = sm_manager_->db_.get_table(sel_tab_name).cols;
-            all_cols.insert(all_cols.end(), sel_tab_cols.begin(), sel_tab_cols.end());
-        }
-        return all_cols;
-    }
     bool check_index_match(std::vector<std::string>& col_names,std::vector<ColMeta>& cols){
         std::vector<std::string> cols_to_use;
         // 只要列被索引包含，匹配成功
@@ -63,29 +67,13 @@ public:
         }
         return !cols_to_use.empty();
     }
-    // 这个函数必须给它拆了
-    void update_set(const std::string &tab_name, std::vector<SetClause> set_clauses) {
-        auto txn = context_->txn_;
-        /* 下面这段之前为什么留着？谁留的?
-        TabMeta &tab = sm_manager_->db_.get_table(tab_name);
-        for (auto &set_clause : set_clauses) {
-            auto lhs_col = tab.get_col(set_clause.lhs.col_name);
-            if (lhs_col->type != set_clause.rhs.type) {
-                if((lhs_col->type == TYPE_BIGINT)&&(set_clause.rhs.type==TYPE_INT)){
-                    set_clause.rhs.set_bigint(set_clause.rhs.int_val);
-                } else {
-                    throw IncompatibleTypeError(coltype2str(lhs_col->type), coltype2str(set_clause.rhs.type));
-                }
-            }
-            set_clause.rhs.init_raw(lhs_col->len);
-        }
-         */
+
+    // 检查set子句的类型，找出需要维护的索引，并分配整条语句复用的缓冲区
+    void prepare() {
         // 记录set中用到的列名
-        TabMeta &tab = sm_manager_->db_.get_table(tab_name);
         std::vector<std::string> col_names;
-        // Get raw values in set clause
-        for (auto &set_clause : set_clauses) {
-            auto lhs_col = tab.get_col(set_clause.lhs.col_name);
+        for (auto &set_clause : set_clauses_) {
+            auto lhs_col = tab_.get_col(set_clause.lhs.col_name);
             if (lhs_col->type != set_clause.rhs.type) {
                 if(lhs_col->type==TYPE_STRING&&set_clause.rhs.type==TYPE_DATETIME&&lhs_col->len>=19) {
                 } else if((lhs_col->type == TYPE_BIGINT)&&(set_clause.rhs.type==TYPE_INT)){
@@ -97,265 +85,169 @@ public:
             if(!set_clause.exp) {
                 set_clause.rhs.init_raw(lhs_col->len);
             }
+            set_cols_.push_back(*lhs_col);
             col_names.emplace_back(set_clause.lhs.col_name);
         }
-        // Get record file
-        auto fh = sm_manager_->fhs_.at(tab_name).get();
-        // Get all necessary index files
-        auto ix_manager=sm_manager_->get_ix_manager();
-        std::vector<IxIndexHandle*> ihs(tab.indexes.size(), nullptr);
-        for (size_t index_i = 0; index_i < tab.indexes.size(); index_i++) {
-            auto cols=tab.indexes[index_i].cols;
-            if (!cols.empty()) {
-                // match
-                if (check_index_match(col_names,cols)){
-                    ihs[index_i] = sm_manager_->ihs_.at(ix_manager->get_index_name(tab_name_, cols)).get();
-                }
+        // 只有包含被set字段的索引才可能需要维护
+        auto ix_manager = sm_manager_->get_ix_manager();
+        for (size_t index_i = 0; index_i < tab_.indexes.size(); index_i++) {
+            auto cols = tab_.indexes[index_i].cols;
+            if (!cols.empty() && check_index_match(col_names, cols)) {
+                ix_nos_.push_back(index_i);
+                ix_names_.push_back(ix_manager->get_index_name(tab_name_, cols));
+                ihs_.push_back(sm_manager_->ihs_.at(ix_names_.back()).get());
+                key_offs_.push_back(key_stride_);
+                key_stride_ += 2 * tab_.indexes[index_i].col_tot_len;
             }
         }
-        // 计算给定name在索引列名中的位置
-        auto index_pos=[](const std::vector<std::string>& index_col_names,const std::string&name)->int {
-            for (auto i = 0; i < index_col_names.size(); i++) {
-                if (index_col_names.at(i) == name) {
-                    return i;
-                }
-            }
-            return -1;
-        };
-        auto offset=[](const std::vector<int>&col_lens,int pos)->int{
-            int off=0;
-            for(int i=0;i<pos;i++){
-                off+=col_lens[i];
-            }
-            return off;
-        };
-        // 对每一个索引进行唯一性检查
-        // 保证新key和旧key不冲突，新key之间也不冲突
-        bool unique=true;
-        for(size_t index_i=0;index_i<tab.indexes.size();index_i++){
-            if (ihs[index_i] != nullptr){
-                // std::cout<<"In the uniqueness check phase, ihs[index_i] is not nullptr\n";
-                std::vector<std::string> new_keys;
-                size_t key_len;
-                for(auto& rid:rids_){
-                    auto rec = fh->get_record(rid,context_);
-                    key_len=tab.indexes[index_i].col_tot_len;
-                    char* key = new char[key_len+1];
-                    memset(key, 0, key_len+1);
-                    std::vector<std::string> index_col_names;
-                    std::vector<int>col_len;
-                    std::vector<int>col_off;
-                    for (auto& col:tab.indexes[index_i].cols){
-                        index_col_names.emplace_back(col.name);
-                        col_len.emplace_back(col.len);
-                        col_off.emplace_back(col.offset);
-                    }
-                    // make new key
-                    for (auto& set_clause:set_clauses){
-                        auto pos=index_pos(index_col_names,set_clause.lhs.col_name);
-                        if (pos==-1)continue;
-                        auto off = offset(col_len, pos);
-                        if(set_clause.exp) {
-                            auto data = rec->data + col_off[pos];
-                            auto type = set_clause.rhs.type;
-                            switch(type) {
-                                case TYPE_INT:
-                                    if(set_clause.add) {
-                                        *(int *) data += set_clause.rhs.int_val;
-                                    } else {
-                                        *(int *) data -= set_clause.rhs.int_val;
-                                    }
-                                    break;
-                                case TYPE_FLOAT:
-                                    if(set_clause.add) {
-                                        *(float*)data += set_clause.rhs.float_val;
-                                    } else {
-                                        *(float*)data -= set_clause.rhs.float_val;
-                                    }
-                                    break;
-                                default:
-                                    break;
-                            }
-                            memcpy(key + off, rec->data + col_off[pos], col_len[pos]);
+        int record_size = fh_->get_file_hdr().record_size;
+        old_buf_.resize(record_size);
+        new_buf_.resize(record_size);
+    }
+
+    // 在rec上原地执行全部set子句
+    void apply_set_clauses(char *rec) {
+        for (size_t i = 0; i < set_clauses_.size(); i++) {
+            auto &set_clause = set_clauses_[i];
+            auto data = rec + set_cols_[i].offset;
+            if(set_clause.exp) {
+                switch(set_clause.rhs.type) {
+                    case TYPE_INT:
+                        if(set_clause.add) {
+                            *(int *) data += set_clause.rhs.int_val;
                         } else {
-                            memcpy(key + off, set_clause.rhs.raw->data, col_len[pos]);
-                        }
-                    }
-                    // gain data from record
-                    int count = 0;
-                    for(auto& col:tab.indexes[index_i].cols){
-                        // static int count=0;
-                        // col_names就是set_clauses的左值列集合
-                        if (std::find_if(col_names.begin(),col_names.end(),[&](const std::string& name){return name==col.name;})==col_names.end()){
-                            auto col_needed = tab.get_col(col.name);
-                            auto off=offset(col_len,count);
-                            memcpy(key+off,rec->data+col_needed->offset,col_needed->len);
+                            *(int *) data -= set_clause.rhs.int_val;
                         }
-                        ++count;
-                    }
-                    std::vector<Rid> tmp;
-                    // 去掉这一段会有重复，不去掉又不能再次更新刚才被abort de value
-                    if(ihs[index_i]->get_value(key,&tmp,context_->txn_)) {
-                        throw InternalError("uniqueness check failed1");
-                    }
-                    new_keys.emplace_back(key);
-                    delete [] key;
-                }
-                for(auto i=0;i<new_keys.size();i++){
-                    for(auto j=i+1;j<new_keys.size();j++){
-                        if (memcmp(new_keys[i].c_str(),new_keys[j].c_str(),key_len)==0){
-                            throw InternalError("uniqueness check failed2");
+                        break;
+                    case TYPE_FLOAT:
+                        if(set_clause.add) {
+                            *(float*)data += set_clause.rhs.float_val;
+                        } else {
+                            *(float*)data -= set_clause.rhs.float_val;
                         }
-                    }
+                        break;
+                    default:
+                        break;
                 }
+            } else {
+                memcpy(data, set_clause.rhs.raw->data, set_cols_[i].len);
             }
         }
-        // Update each rid from record file and index file
-        for (auto &rid : rids_){
-            std::vector<char*> keys_to_delete(tab.indexes.size());
-            std::vector<char*> keys_to_insert(tab.indexes.size());
-            auto rec = fh->get_record(rid,context_);
-            // RmRecord old_rec(rec->size,rec->data);
-            // Remove old entry from index
-            for (size_t index_i = 0; index_i < tab.indexes.size(); index_i++) {
-                if (ihs[index_i] != nullptr) {
-                    // std::cout<<"ihs[index_i] != nullptr\n";
-                    char* key=new char[tab.indexes[index_i].col_tot_len];
-                    memset(key, 0, tab.indexes[index_i].col_tot_len);
-                    std::vector<std::string> index_col_names;
-                    std::vector<int>col_len(tab.indexes[index_i].col_num);
-                    for (auto& col:tab.indexes[index_i].cols){
-                        index_col_names.emplace_back(col.name);
-                    }
-                    // make origin key
-                    int off1 = 0;
-                    for(auto& col:tab.indexes[index_i].cols){
-                        // static int off=0;
-                        auto col_needed = tab.get_col(col.name);
-                        memcpy(key+off1,rec->data+col_needed->offset,col_needed->len);
-                        off1+=col_needed->len;
-                    }
-                        LogRecord index_delete_log_record = LogRecord(context_->txn_->get_transaction_id(),
-                                                                      context_->txn_->get_prev_lsn(),
-                                                                      LogType::DELETE_ENTRY, rid, key,
-                                                                      tab.indexes[index_i].col_tot_len,
-                                                                      ix_manager->get_index_name(tab_name_,
-                                                                                                 tab.indexes[index_i].cols));
-                        context_->txn_->set_prev_lsn(context_->log_mgr_->add_log_to_buffer(&index_delete_log_record));
-                    keys_to_delete[index_i]=key;
-//                    auto flag = ihs[index_i]->delete_entry(key,context_->txn_);
-//                    if(flag && context_->txn_->get_txn_mode()) {
-//                        auto *indexWriteRecord = new IndexWriteRecord(WType::DELETE_TUPLE,
-//                                                                                  tab_name_, rid, index_i,
-//                                                                                  key,tab.indexes[index_i].col_tot_len);
-//                        context_->txn_->append_index_write_record(indexWriteRecord);
-//                    }
-                }
+    }
+
+    // 从记录rec中拼出第i个需要维护的索引的key
+    void make_key(size_t i, const char *rec, char *key) {
+        ix_make_key(tab_.indexes[ix_nos_[i]].cols, rec, key);
+    }
+
+    /**
+     * @description: 每条记录只pin一次页面，读出旧记录并构造新记录，把所有需要维护的索引的旧key和新key存入keys_
+     * @param {vector<Rid>&} rids 要更新的全部记录
+     */
+    void collect_keys(const std::vector<Rid> &rids) {
+        keys_.resize(rids.size() * key_stride_);
+        for (size_t r = 0; r < rids.size(); r++) {
+            RmPageHandle page_handle = fh_->fetch_page_handle(rids[r].page_no);
+            page_handle.read_slot(rids[r].slot_no, old_buf_.data());
+            fh_->unpin_page_handle(page_handle, false);
+            memcpy(new_buf_.data(), old_buf_.data(), old_buf_.size());
+            apply_set_clauses(new_buf_.data());
+            char *keys = keys_.data() + r * key_stride_;
+            for (size_t i = 0; i < ix_nos_.size(); i++) {
+                make_key(i, old_buf_.data(), keys + key_offs_[i]);
+                make_key(i, new_buf_.data(), keys + key_offs_[i] + tab_.indexes[ix_nos_[i]].col_tot_len);
             }
+        }
+    }
 
-            // Update record in record file
-            RmRecord old_rec(rec->size,rec->data);
-            for (auto &set_clause : set_clauses) {
-                auto lhs_col = tab.get_col(set_clause.lhs.col_name);
-                if(set_clause.exp) {
-                    auto data = rec->data + lhs_col->offset;
-                    auto type = set_clause.rhs.type;
-                    switch(type) {
-                        case TYPE_INT:
-                            if(set_clause.add) {
-                                *(int *) data += set_clause.rhs.int_val;
-                            } else {
-                                *(int *) data -= set_clause.rhs.int_val;
-                            }
-                            break;
-                        case TYPE_FLOAT:
-                            if(set_clause.add) {
-                                *(float*)data += set_clause.rhs.float_val;
-                            } else {
-                                *(float*)data -= set_clause.rhs.float_val;
-                            }
-                            break;
-                        default:
-                            break;
-                    }
-                } else {
-                    memcpy(rec->data + lhs_col->offset, set_clause.rhs.raw->data, lhs_col->len);
-                }
+    // 用collect_keys得到的key对每一个唯一索引进行检查，保证新key和已有key不冲突，新key之间也不冲突
+    // key没有变化的记录不参与检查
+    void check_unique(size_t num_rows) {
+        for (size_t i = 0; i < ix_nos_.size(); i++) {
+            if (!tab_.indexes[ix_nos_[i]].unique) {
+                continue;
             }
-            RmRecord new_rec(rec->size,rec->data);
-                LogRecord updateLogRecord(context_->txn_->get_transaction_id(), context_->txn_->get_prev_lsn(),
-                                          LogType::UPDATE, rid, old_rec, new_rec, tab_name_);
-                txn->set_prev_lsn(context_->log_mgr_->add_log_to_buffer(&updateLogRecord));
-            // Insert new entry into index
-            for (size_t index_i = 0; index_i < tab.indexes.size(); index_i++) {
-                if (ihs[index_i] != nullptr) {
-                    char* key=new char[tab.indexes[index_i].col_tot_len];
-                    memset(key, 0, tab.indexes[index_i].col_tot_len);
-                    std::vector<std::string> index_col_names;
-                    std::vector<int>col_len(tab.indexes[index_i].col_num);
-                    for (auto& col:tab.indexes[index_i].cols){
-                        index_col_names.emplace_back(col.name);
-                        col_len.emplace_back(col.len);
-                    }
-                    // make new key
-                    int off2 = 0;
-                    for(auto& col:tab.indexes[index_i].cols){
-                        auto col_needed = tab.get_col(col.name);
-                        memcpy(key+off2,rec->data+col_needed->offset,col_needed->len);
-                        off2+=col_needed->len;
-                    }
-                        LogRecord index_insert_log_record = LogRecord(txn->get_transaction_id(), txn->get_prev_lsn(),
-                                                                      LogType::INSERT_ENTRY, rid,
-                                                                      key, tab.indexes[index_i].col_tot_len,
-                                                                      sm_manager_->get_ix_manager()->get_index_name(
-                                                                              tab_name_, tab.indexes[index_i].cols));
-                        txn->set_prev_lsn(context_->log_mgr_->add_log_to_buffer(&index_insert_log_record));
-                    keys_to_insert[index_i]=key;
-//                    auto flag = ihs[index_i]->insert_entry(key,rid,context_->txn_);
-//                    if(flag && context_->txn_->get_txn_mode()) {
-//                        auto *indexWriteRecord = new IndexWriteRecord(WType::INSERT_TUPLE,
-//                                                                                  tab_name_, index_i, key,tab.indexes[index_i].col_tot_len);
-//                        // std::cout<<"update insert entry"<<std::endl;
-//                        txn->append_index_write_record(indexWriteRecord);
-//                    }
+            int key_len = tab_.indexes[ix_nos_[i]].col_tot_len;
+            std::unordered_set<std::string> new_keys;
+            for (size_t r = 0; r < num_rows; r++) {
+                char *old_key = keys_.data() + r * key_stride_ + key_offs_[i];
+                char *new_key = old_key + key_len;
+                if (memcmp(old_key, new_key, key_len) == 0) {
+                    continue;
+                }
+                std::vector<Rid> tmp;
+                if (ihs_[i]->get_value(new_key, &tmp, context_->txn_)) {
+                    throw InternalError("uniqueness check failed1");
+                }
+                if (!new_keys.emplace(new_key, key_len).second) {
+                    throw InternalError("uniqueness check failed2");
                 }
             }
-            // update
-            fh->update_record(rid, rec->data,context_);
-            if(txn->get_txn_mode()) {
-                auto *writeRecord = new WriteRecord(WType::UPDATE_TUPLE, tab_name_, rid,old_rec,new_rec);
-                txn->append_write_record(writeRecord);
+        }
+    }
+
+    /**
+     * @description: 在一次页面pin内原地更新一条记录：读出旧记录、构造新记录，只把变化的字节区间写入日志和页面。
+     * 记录没有变化时不写日志也不标脏页面，索引只在key真正变化时维护
+     * @param {Rid&} rid 要更新的记录
+     * @param {char*} keys collect_keys为该记录存下的旧key和新key，没有需要维护的索引时为nullptr
+     */
+    void update_record(const Rid &rid, char *keys) {
+        auto txn = context_->txn_;
+        RmPageHandle page_handle = fh_->fetch_page_handle(rid.page_no);
+        page_handle.read_slot(rid.slot_no, old_buf_.data());
+        memcpy(new_buf_.data(), old_buf_.data(), old_buf_.size());
+        apply_set_clauses(new_buf_.data());
+        fh_->diff_records(old_buf_.data(), new_buf_.data(), deltas_);
+        if (deltas_.empty()) {
+            fh_->unpin_page_handle(page_handle, false);
+            return;
+        }
+        LogRecord update_log_record(txn->get_transaction_id(), txn->get_prev_lsn(), LogType::UPDATE_DELTA, rid,
+                                    old_buf_.data(), new_buf_.data(), deltas_, tab_name_);
+        txn->set_prev_lsn(context_->log_mgr_->add_log_to_buffer(&update_log_record));
+        fh_->update_record(page_handle, rid.slot_no, new_buf_.data(), deltas_);
+        if(txn->get_txn_mode()) {
+            auto *writeRecord = new WriteRecord(WType::UPDATE_TUPLE, tab_name_, rid,
+                                                RmRecord(old_buf_.size(), old_buf_.data()));
+            txn->append_write_record(writeRecord);
+        }
+        for (size_t i = 0; i < ix_nos_.size(); i++) {
+            size_t index_i = ix_nos_[i];
+            int key_len = tab_.indexes[index_i].col_tot_len;
+            char *old_key = keys + key_offs_[i];
+            char *new_key = old_key + key_len;
+            if (memcmp(old_key, new_key, key_len) == 0) {
+                continue;
             }
-            for(size_t index_i = 0; index_i < tab.indexes.size(); index_i++){
-                if (ihs[index_i] != nullptr){
-                    // delete from index
-                    auto flag = ihs[index_i]->delete_entry(keys_to_delete[index_i],context_->txn_);
-                    if(flag && context_->txn_->get_txn_mode()) {
-                        auto *indexWriteRecord = new IndexWriteRecord(WType::DELETE_TUPLE,
-                                                                                  tab_name_, rid, index_i,
-                                                                                  keys_to_delete[index_i],tab.indexes[index_i].col_tot_len);
-                        context_->txn_->append_index_write_record(indexWriteRecord);
-                    } else {
-                        delete [] keys_to_delete[index_i];
-                    }
-                    // insert into index
-                    flag = ihs[index_i]->insert_entry(keys_to_insert[index_i],rid,context_->txn_);
-                    if(flag && context_->txn_->get_txn_mode()) {
-                        auto *indexWriteRecord = new IndexWriteRecord(WType::INSERT_TUPLE,
-                                                                                  tab_name_, index_i, keys_to_insert[index_i],tab.indexes[index_i].col_tot_len);
-                        txn->append_index_write_record(indexWriteRecord);
-                    } else{
-                        delete[] keys_to_insert[index_i];
-                    }
-                }
+            // delete from index
+            LogRecord index_delete_log_record(txn->get_transaction_id(), txn->get_prev_lsn(),
+                                              LogType::DELETE_ENTRY, rid, old_key, key_len, ix_names_[i]);
+            txn->set_prev_lsn(context_->log_mgr_->add_log_to_buffer(&index_delete_log_record));
+            auto flag = ihs_[i]->delete_entry(old_key, rid, txn);
+            if(flag && txn->get_txn_mode()) {
+                char *key = new char[key_len];
+                memcpy(key, old_key, key_len);
+                auto *indexWriteRecord = new IndexWriteRecord(WType::DELETE_TUPLE, tab_name_, rid, index_i,
+                                                              key, key_len);
+                txn->append_index_write_record(indexWriteRecord);
+            }
+            // insert into index
+            LogRecord index_insert_log_record(txn->get_transaction_id(), txn->get_prev_lsn(),
+                                              LogType::INSERT_ENTRY, rid, new_key, key_len, ix_names_[i]);
+            txn->set_prev_lsn(context_->log_mgr_->add_log_to_buffer(&index_insert_log_record));
+            flag = ihs_[i]->insert_entry(new_key, rid, txn);
+            if(flag && txn->get_txn_mode()) {
+                char *key = new char[key_len];
+                memcpy(key, new_key, key_len);
+                auto *indexWriteRecord = new IndexWriteRecord(WType::INSERT_TUPLE, tab_name_, rid, index_i,
+                                                              key, key_len);
+                txn->append_index_write_record(indexWriteRecord);
             }
         }
     }
 
     std::unique_ptr<RmRecord> Next() override {
-        if (rids_.empty()) {
-            return nullptr;
-        }
         if(context_->txn_->get_txn_mode()) {
             auto tab_fd = fh_->GetFd();
             // std::cout<<"in update executor: the fd is "<<tab_fd<<"\n";
@@ -364,12 +256,27 @@ public:
                 throw TransactionAbortException(context_->txn_->get_transaction_id(), AbortReason::FAILED_TO_LOCK);
             }
         }
-        update_set(tab_name_,set_clauses_);
+        prepare();
+        if (ix_nos_.empty()) {
+            // 记录原地更新不会移动位置，也不影响任何索引，可以边扫描边更新
+            for (prev_->beginTuple(); !prev_->is_end(); prev_->nextTuple()) {
+                update_record(prev_->rid(), nullptr);
+            }
+            return nullptr;
+        }
+        // 索引key会变化时先收集全部记录：避免索引扫描再次访问移动后的记录，唯一性检查也要在修改前完成，
+        // 所以每条记录先pin一次算出key，检查通过后再pin一次写入
+        std::vector<Rid> rids;
+        for (prev_->beginTuple(); !prev_->is_end(); prev_->nextTuple()) {
+            rids.push_back(prev_->rid());
+        }
+        collect_keys(rids);
+        check_unique(rids.size());
+        for (size_t r = 0; r < rids.size(); r++) {
+            update_record(rids[r], keys_.data() + r * key_stride_);
+        }
         return nullptr;
     }
-    void feed(const std::map<TabCol, Value> &feed_dict) override {
-        throw InternalError("Cannot feed a projection node");
-    }
 
     Rid &rid() override { return _abstract_rid; }
-};
\ No newline at end of file
+};
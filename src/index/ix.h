@@ -12,3 +12,4 @@ See the Mulan PSL v2 for more details. */
 
 #include "ix_scan.h"
 #include "ix_manager.h"
+#include "ix_bulk_builder.h"
@@ -0,0 +1,262 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "ix_bulk_builder.h"
+
+#include <algorithm>
+#include <numeric>
+#include <queue>
+
+#include "errors.h"
+
+IxBulkSorter::IxBulkSorter(const IxFileHdr *file_hdr, size_t mem_limit)
+        : key_len_(file_hdr->col_tot_len_), entry_len_(file_hdr->col_tot_len_ + sizeof(Rid)) {
+    max_buf_entries_ = std::max<size_t>(1, mem_limit / entry_len_);
+}
+
+IxBulkSorter::~IxBulkSorter() {
+    for (auto run : runs_) {
+        fclose(run);
+    }
+}
+
+void IxBulkSorter::add(const char *key, const Rid &rid) {
+    if (buf_.size() / entry_len_ == max_buf_entries_) {
+        spill();
+    }
+    size_t off = buf_.size();
+    buf_.resize(off + entry_len_);
+    memcpy(buf_.data() + off, key, key_len_);
+    memcpy(buf_.data() + off + key_len_, &rid, sizeof(Rid));
+    num_entries_++;
+}
+
+std::vector<size_t> IxBulkSorter::sort_buffer() const {
+    std::vector<size_t> order(buf_.size() / entry_len_);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return memcmp(buf_.data() + a * entry_len_, buf_.data() + b * entry_len_, key_len_) < 0;
+    });
+    return order;
+}
+
+void IxBulkSorter::spill() {
+    FILE *run = tmpfile();
+    if (run == nullptr) {
+        throw UnixError();
+    }
+    runs_.push_back(run);
+    for (auto i : sort_buffer()) {
+        if (fwrite(buf_.data() + i * entry_len_, entry_len_, 1, run) != 1) {
+            throw UnixError();
+        }
+    }
+    buf_.clear();
+}
+
+void IxBulkSorter::finish(const std::function<void(const char *, const Rid &)> &visit) {
+    if (runs_.empty()) {
+        for (auto i : sort_buffer()) {
+            const char *entry = buf_.data() + i * entry_len_;
+            visit(entry, *reinterpret_cast<const Rid *>(entry + key_len_));
+        }
+        buf_.clear();
+        return;
+    }
+    if (!buf_.empty()) {
+        spill();
+    }
+    buf_.shrink_to_fit();
+    // 多路归并，每个run当前的项存放在heads中，key相同时run号小的先输出
+    std::vector<char> heads(runs_.size() * entry_len_);
+    auto read_head = [&](size_t run) {
+        return fread(heads.data() + run * entry_len_, entry_len_, 1, runs_[run]) == 1;
+    };
+    auto greater = [&](size_t a, size_t b) {
+        int cmp = memcmp(heads.data() + a * entry_len_, heads.data() + b * entry_len_, key_len_);
+        return cmp != 0 ? cmp > 0 : a > b;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(greater);
+    for (size_t run = 0; run < runs_.size(); run++) {
+        rewind(runs_[run]);
+        if (read_head(run)) {
+            heap.push(run);
+        }
+    }
+    while (!heap.empty()) {
+        size_t run = heap.top();
+        heap.pop();
+        const char *entry = heads.data() + run * entry_len_;
+        visit(entry, *reinterpret_cast<const Rid *>(entry + key_len_));
+        if (read_head(run)) {
+            heap.push(run);
+        }
+    }
+}
+
+IxBulkBuilder::IxBulkBuilder(IxIndexHandle *ih, double fill_factor)
+        : ih_(ih), key_len_(ih->file_hdr_->col_tot_len_), fill_factor_(fill_factor),
+          low_(key_len_, 0), max_key_(key_len_, (char)0xFF) {}
+
+int IxBulkBuilder::fill(int capacity, bool is_leaf) const {
+    // 叶子达到容量时就会分裂，内部结点也留出一个空位
+    int min_size = is_leaf ? capacity / 2 : (capacity + 1) / 2;
+    return std::clamp((int)(capacity * fill_factor_), min_size, capacity - 1);
+}
+
+void IxBulkBuilder::append(const char *key, const Rid &rid) {
+    // 以key为高键时缓存的叶子已达到填充率：正好达到时全部写出，
+    // 超过说明公共前缀在key处变短、容量变小，此时除最后一个key外都写出，以最后一个key为高键
+    int n = pending_rids_.size();
+    if (n > 0) {
+        int limit = fill(ih_->file_hdr_->node_capacity(low_.data(), key), true);
+        if (n == limit) {
+            write_leaf(n, key);
+        } else if (n > limit) {
+            write_leaf(n - 1, pending_keys_.data() + (size_t)(n - 1) * key_len_);
+        }
+    }
+    pending_keys_.insert(pending_keys_.end(), key, key + key_len_);
+    pending_rids_.push_back(rid);
+}
+
+void IxBulkBuilder::write_leaf(int n, const char *high) {
+    char high_key[IX_MAX_COL_LEN];
+    memcpy(high_key, high, key_len_);
+    PageID page_no;
+    std::unique_ptr<IxNodeHandle> node;
+    if (leaf_ == nullptr) {
+        // 第一个叶子复用初始的根结点页面，保持first_leaf不变
+        page_no = IX_INIT_ROOT_PAGE;
+        node = ih_->fetch_node(page_no);
+        node->Init(true);
+        node->set_prev_leaf(IX_LEAF_HEADER_PAGE);
+    } else {
+        node = ih_->create_node(&page_no);
+        node->Init(true);
+        node->set_prev_leaf(leaf_->get_page_no());
+        leaf_->set_next_leaf(page_no);
+    }
+    node->set_fences(low_.data(), high_key);
+    node->insert_pairs(0, pending_keys_.data(), pending_rids_.data(), n);
+    sep_keys_.insert(sep_keys_.end(), low_.begin(), low_.end());
+    sep_pages_.push_back(page_no);
+    pending_keys_.erase(pending_keys_.begin(), pending_keys_.begin() + (size_t)n * key_len_);
+    pending_rids_.erase(pending_rids_.begin(), pending_rids_.begin() + n);
+    memcpy(low_.data(), high_key, key_len_);
+    prev_leaf_ = std::move(leaf_);
+    leaf_ = std::move(node);
+}
+
+void IxBulkBuilder::fix_last_leaf() {
+    int size = leaf_->get_size();
+    if (prev_leaf_ == nullptr || size >= leaf_->get_min_size()) {
+        return;
+    }
+    int prev_size = prev_leaf_->get_size();
+    if (prev_size + size < prev_leaf_->capacity_for(prev_leaf_->get_low_key(), leaf_->get_high_key())) {
+        // 合并到前一个叶子
+        prev_leaf_->set_high_key(leaf_->get_high_key());
+        prev_leaf_->insert_pairs_from(prev_size, *leaf_, 0, size);
+        prev_leaf_->set_next_leaf(IX_LEAF_HEADER_PAGE);
+        ih_->delete_node(leaf_);
+        leaf_ = std::move(prev_leaf_);
+        sep_keys_.resize(sep_keys_.size() - key_len_);
+        sep_pages_.pop_back();
+        return;
+    }
+    // 从前一个叶子移动一部分使两者都不少于min_size，低键前移后容量可能变小，放不下时保持原样
+    int move = leaf_->get_min_size() - size;
+    int from = prev_size - move;
+    char sep[IX_MAX_COL_LEN];
+    prev_leaf_->copy_key(from, sep);
+    if (from < prev_leaf_->get_min_size() || size + move >= leaf_->capacity_for(sep, leaf_->get_high_key())) {
+        return;
+    }
+    leaf_->set_low_key(sep);
+    leaf_->insert_pairs_from(0, *prev_leaf_, from, move);
+    prev_leaf_->set_size(from);
+    prev_leaf_->set_high_key(sep);
+    memcpy(sep_keys_.data() + sep_keys_.size() - key_len_, sep, key_len_);
+}
+
+void IxBulkBuilder::finish() {
+    auto file_hdr = ih_->file_hdr_;
+    // 最后一个叶子的高键为正无穷，没有任何key时也写出一个空叶子作为根结点
+    int n = pending_rids_.size();
+    if (n > 1 && n >= file_hdr->node_capacity(low_.data(), max_key_.data())) {
+        write_leaf(n - 1, pending_keys_.data() + (size_t)(n - 1) * key_len_);
+    }
+    if (!pending_rids_.empty() || leaf_ == nullptr) {
+        write_leaf(pending_rids_.size(), max_key_.data());
+    }
+    leaf_->set_next_leaf(IX_LEAF_HEADER_PAGE);
+    fix_last_leaf();
+    file_hdr->first_leaf_ = IX_INIT_ROOT_PAGE;
+    file_hdr->last_leaf_ = leaf_->get_page_no();
+    leaf_.reset();
+    prev_leaf_.reset();
+
+    // 逐层向上构建，每个结点贪心地放入孩子直到达到填充率，高键为下一个结点的第一个key
+    std::vector<char> keys = std::move(sep_keys_);
+    std::vector<PageID> pages = std::move(sep_pages_);
+    while (pages.size() > 1) {
+        size_t num_children = pages.size();
+        auto key_at = [&](size_t i) { return i < num_children ? keys.data() + i * key_len_ : max_key_.data(); };
+        auto capacity = [&](size_t begin, size_t end) { return file_hdr->node_capacity(key_at(begin), key_at(end)); };
+        // 第i个结点的孩子为[starts[i], starts[i+1])
+        std::vector<size_t> starts;
+        for (size_t pos = 0; pos < num_children;) {
+            size_t cnt = 1;
+            while (pos + cnt < num_children && (int)cnt + 1 <= fill(capacity(pos, pos + cnt + 1), false)) {
+                cnt++;
+            }
+            starts.push_back(pos);
+            pos += cnt;
+        }
+        starts.push_back(num_children);
+        // 最后一个结点不足半满时与前一个结点平分孩子
+        size_t num_nodes = starts.size() - 1;
+        if (num_nodes > 1) {
+            size_t begin = starts[num_nodes - 2];
+            size_t last = starts[num_nodes - 1];
+            size_t mid = begin + (num_children - begin) / 2;
+            if ((int)(num_children - last) < (capacity(last, num_children) + 1) / 2 &&
+                (int)(mid - begin) < capacity(begin, mid) && (int)(num_children - mid) < capacity(mid, num_children)) {
+                starts[num_nodes - 1] = mid;
+            }
+        }
+        std::vector<char> parent_keys;
+        std::vector<PageID> parent_pages;
+        std::unique_ptr<IxNodeHandle> prev;
+        for (size_t i = 0; i < num_nodes; i++) {
+            size_t pos = starts[i];
+            int cnt = starts[i + 1] - pos;
+            PageID page_no;
+            auto node = ih_->create_node(&page_no);
+            node->Init(false);
+            node->set_fences(key_at(pos), key_at(pos + cnt));
+            std::vector<Rid> rids(cnt);
+            for (int j = 0; j < cnt; j++) {
+                rids[j] = Rid{pages[pos + j], j};
+            }
+            node->insert_pairs(0, key_at(pos), rids.data(), cnt);
+            if (prev != nullptr) {
+                prev->set_next_leaf(page_no);
+            }
+            parent_keys.insert(parent_keys.end(), key_at(pos), key_at(pos) + key_len_);
+            parent_pages.push_back(page_no);
+            prev = std::move(node);
+        }
+        keys = std::move(parent_keys);
+        pages = std::move(parent_pages);
+    }
+    ih_->update_root_page_no(pages[0]);
+}
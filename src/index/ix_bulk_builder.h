@@ -0,0 +1,87 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "ix_defs.h"
+#include "ix_index_handle.h"
+
+/**
+ * 批量构建索引时对(key, rid)按编码后的key排序，内存中的数据超过mem_limit时排好序写成一个run，
+ * 最后对所有run做多路归并；key相同的项按add的顺序输出
+ */
+class IxBulkSorter {
+public:
+    IxBulkSorter(const IxFileHdr *file_hdr, size_t mem_limit = IX_BULK_SORT_MEM);
+
+    ~IxBulkSorter();
+
+    void add(const char *key, const Rid &rid);
+
+    size_t size() const { return num_entries_; }
+
+    /* 按key递增的顺序对每一项调用visit，只能调用一次 */
+    void finish(const std::function<void(const char *, const Rid &)> &visit);
+
+private:
+    // 对buf_中的项排序，返回排好序的下标
+    std::vector<size_t> sort_buffer() const;
+
+    void spill();
+
+    int key_len_;
+    int entry_len_;                 // 每一项为 | key | rid |
+    size_t max_buf_entries_;
+    std::vector<char> buf_;
+    std::vector<FILE *> runs_;      // 已经写出的有序run
+    size_t num_entries_ = 0;
+};
+
+/**
+ * 自底向上构建B+树：按key严格递增的顺序append，叶子按填充率依次写满并串成链表，
+ * finish时再由各叶子的低键逐层构建内部结点
+ * 结点的容量取决于低键与高键的公共前缀，因此一个叶子的key先缓存起来，知道下一个叶子的第一个key（即高键）后再写入
+ * @note 构建会丢弃索引中原有的内容（旧结点不回收），期间不能有并发访问
+ */
+class IxBulkBuilder {
+public:
+    IxBulkBuilder(IxIndexHandle *ih, double fill_factor = IX_BULK_FILL_FACTOR);
+
+    void append(const char *key, const Rid &rid);
+
+    void finish();
+
+private:
+    // 容量为capacity的结点按填充率写入的键值对数量
+    int fill(int capacity, bool is_leaf) const;
+
+    // 把缓存中的前n个键值对写成一个叶子，高键为high
+    void write_leaf(int n, const char *high);
+
+    // 最后一个叶子不足半满时与前一个叶子合并或重新分配
+    void fix_last_leaf();
+
+    IxIndexHandle *ih_;
+    int key_len_;
+    double fill_factor_;
+    std::vector<char> low_;                     // 正在缓存的叶子的低键
+    std::vector<char> max_key_;                 // 全0xFF，最右结点的高键
+    std::vector<char> pending_keys_;            // 正在缓存的叶子的key
+    std::vector<Rid> pending_rids_;
+    std::unique_ptr<IxNodeHandle> leaf_;        // 最后写入的叶子
+    std::unique_ptr<IxNodeHandle> prev_leaf_;   // 上一个写入的叶子，finish时可能需要调整
+    std::vector<char> sep_keys_;                // 每个叶子的低键
+    std::vector<PageID> sep_pages_;             // 每个叶子的页号
+};
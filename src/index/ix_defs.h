@@ -15,15 +15,38 @@ See the Mulan PSL v2 for more details. */
 #include "defs.h"
 #include "storage/buffer_pool_manager.h"
 
+constexpr int IX_FILE_MAGIC = 0x58444e49;   // 索引文件头的第一个字段，"INDX"；旧版本文件这里是文件头的长度
+constexpr int IX_FILE_VERSION = 1;          // 索引文件格式的版本，key的编码、结点布局或IxFileHdr变化时加一
 constexpr int IX_NO_PAGE = -1;
 constexpr int IX_FILE_HDR_PAGE = 0;
 constexpr int IX_LEAF_HEADER_PAGE = 1;
 constexpr int IX_INIT_ROOT_PAGE = 2;
 constexpr int IX_INIT_NUM_PAGES = 3;
 constexpr int IX_MAX_COL_LEN = 512;
+constexpr int IX_NODE_DELETED = -2;         // 结点被合并回收后写入next_free_page_no，并发的下降据此从根重试
+constexpr int IX_OPTIMISTIC_RETRY = 3;      // 查找时乐观下降的最多尝试次数，之后改为读锁crabbing
+constexpr double IX_BULK_FILL_FACTOR = 0.9;  // 批量构建索引时结点的默认填充率
+constexpr size_t IX_BULK_SORT_MEM = 64 << 20;   // 批量构建索引时内存排序的上限，超过后生成有序run写入临时文件
+// 哈希索引：第1页为头页面，第2页为第一个目录页面，第3页为第一个桶
+constexpr int IX_HASH_HEADER_PAGE = 1;
+constexpr int IX_HASH_INIT_DIR_PAGE = 2;
+constexpr int IX_HASH_INIT_BUCKET_PAGE = 3;
+constexpr int IX_HASH_INIT_NUM_PAGES = 4;
+constexpr int IX_HASH_DIR_ENTRIES = PAGE_SIZE / sizeof(page_id_t);  // 每个目录页面存放的目录项数量
+constexpr int IX_HASH_MAX_DEPTH = 19;                               // 全局深度的上限，目录页面列表需放入头页面
+constexpr int IX_HASH_MAX_DIR_PAGES = (1 << IX_HASH_MAX_DEPTH) / IX_HASH_DIR_ENTRIES;
+
+/* 结点内查找使用的key比较方式，由索引字段决定，不写入磁盘 */
+enum IxKeyKind {
+    IX_KEY_INT,         // 单列INT
+    IX_KEY_BIGINT,      // 单列BIGINT
+    IX_KEY_MEMCMP       // 其余情况，编码后的key整体memcmp
+};
 
 class IxFileHdr {
 public: 
+    int magic_ = IX_FILE_MAGIC;         // 固定为IX_FILE_MAGIC
+    int version_ = IX_FILE_VERSION;     // 索引文件格式的版本，见IX_FILE_VERSION
     page_id_t first_free_page_no_;      // 文件中第一个空闲的磁盘页面的页面号
     int num_pages_;                     // 磁盘文件中页面的数量
     page_id_t root_page_;               // B+树根节点对应的页面号
@@ -31,12 +54,16 @@ public:
     std::vector<ColType> col_types_;    // 字段的类型
     std::vector<int> col_lens_;         // 字段的长度
     int col_tot_len_;                   // 索引包含的字段的总长度
-    int btree_order_;                   // # children per page 每个结点最多可插入的键值对数量
-    int keys_size_;                     // keys_size = (btree_order + 1) * col_tot_len
+    int btree_order_;                   // # children per page 不压缩前缀时每个结点最多可插入的键值对数量
+    int keys_size_;                     // keys_size = btree_order * col_tot_len，不压缩前缀时结点中key的总长度
     // first_leaf初始化之后没有进行修改，只不过是在测试文件中遍历叶子结点的时候用了
     page_id_t first_leaf_;              // 首叶节点对应的页号，在上层IxManager的open函数进行初始化，初始化为root page_no
     page_id_t last_leaf_;               // 尾叶节点对应的页号
     int tot_len_;                       // 记录结构体的整体长度
+    IxKeyKind key_kind_ = IX_KEY_MEMCMP;   // 由col_types_推导，deserialize时设置
+    bool prefix_compress_ = false;      // 结点内是否压缩公共前缀，只对IX_KEY_MEMCMP的key开启
+    IndexType index_type_ = INDEX_BTREE;  // B+树或可扩展哈希
+    bool unique_ = true;                // 非唯一索引的col_tot_len_包含追加在key后的rid
 
     IxFileHdr() {
         tot_len_ = col_num_ = 0;
@@ -51,12 +78,51 @@ public:
 
     void update_tot_len() {
         tot_len_ = 0;
-        tot_len_ += sizeof(page_id_t) * 4 + sizeof(int) * 6;
+        tot_len_ += sizeof(page_id_t) * 4 + sizeof(int) * 8;
         tot_len_ += sizeof(ColType) * col_num_ + sizeof(int) * col_num_;
+        tot_len_ += sizeof(IndexType) + sizeof(bool);
+    }
+
+    // 上层传入的key的长度，不含非唯一索引追加的rid
+    int user_key_len() const { return unique_ ? col_tot_len_ : col_tot_len_ - static_cast<int>(sizeof(Rid)); }
+
+    void update_key_kind() {
+        key_kind_ = IX_KEY_MEMCMP;
+        if (unique_ && col_num_ == 1 && col_types_[0] == TYPE_INT) {
+            key_kind_ = IX_KEY_INT;
+        } else if (unique_ && col_num_ == 1 && col_types_[0] == TYPE_BIGINT) {
+            key_kind_ = IX_KEY_BIGINT;
+        }
+        // 单列INT/BIGINT本身很短，保持定长以使用整数查找
+        prefix_compress_ = key_kind_ == IX_KEY_MEMCMP;
+    }
+
+    // 低键为low、高键为high的结点中key共享的前缀长度，至少保留一个字节的后缀
+    int prefix_len(const char *low, const char *high) const {
+        int len = 0;
+        if (prefix_compress_) {
+            while (len < col_tot_len_ - 1 && low[len] == high[len]) {
+                len++;
+            }
+        }
+        return len;
+    }
+
+    // 低键为low、高键为high的结点的容量
+    int node_capacity(const char *low, const char *high) const;
+
+    // 文件头的magic和版本与当前格式一致时才能按当前格式读出
+    static bool is_current(const char* src) {
+        return reinterpret_cast<const int*>(src)[0] == IX_FILE_MAGIC &&
+               reinterpret_cast<const int*>(src)[1] == IX_FILE_VERSION;
     }
 
     void serialize(char* dest) {
         int offset = 0;
+        memcpy(dest + offset, &magic_, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, &version_, sizeof(int));
+        offset += sizeof(int);
         memcpy(dest + offset, &tot_len_, sizeof(int));
         offset += sizeof(int);
         memcpy(dest + offset, &first_free_page_no_, sizeof(page_id_t));
@@ -85,11 +151,19 @@ public:
         offset += sizeof(page_id_t);
         memcpy(dest + offset, &last_leaf_, sizeof(page_id_t));
         offset += sizeof(page_id_t);
+        memcpy(dest + offset, &index_type_, sizeof(IndexType));
+        offset += sizeof(IndexType);
+        memcpy(dest + offset, &unique_, sizeof(bool));
+        offset += sizeof(bool);
         assert(offset == tot_len_);
     }
 
     void deserialize(char* src) {
         int offset = 0;
+        magic_ = *reinterpret_cast<const int*>(src + offset);
+        offset += sizeof(int);
+        version_ = *reinterpret_cast<const int*>(src + offset);
+        offset += sizeof(int);
         tot_len_ = *reinterpret_cast<const int*>(src + offset);
         offset += sizeof(int);
         first_free_page_no_ = *reinterpret_cast<const page_id_t*>(src + offset);
@@ -123,20 +197,60 @@ public:
         offset += sizeof(page_id_t);
         last_leaf_ = *reinterpret_cast<const page_id_t*>(src + offset);
         offset += sizeof(page_id_t);
+        index_type_ = *reinterpret_cast<const IndexType*>(src + offset);
+        offset += sizeof(IndexType);
+        unique_ = *reinterpret_cast<const bool*>(src + offset);
+        offset += sizeof(bool);
         assert(offset == tot_len_);
+        update_key_kind();
     }
 };
 
 class IxPageHdr {
 public:
-    page_id_t next_free_page_no;    // unused
+    page_id_t next_free_page_no;    // 结点被回收后为IX_NODE_DELETED，其余情况unused
     page_id_t parent;               // 父亲节点所在页面的叶号
     int num_key;                    // # current keys (always equals to #child - 1) 已插入的keys数量，key_idx∈[0,num_key)
     bool is_leaf;                   // 是否为叶节点
     page_id_t prev_leaf;            // previous leaf node's page_no, effective only when is_leaf is true
-    page_id_t next_leaf;            // next leaf node's page_no, effective only when is_leaf is true
+    page_id_t next_leaf;            // 右兄弟结点的page_no（B-link），叶子结点和内部结点都维护
+    int prefix_len;                 // 结点内所有key共享的前缀长度，即低键与高键的公共前缀长度，前缀只存在低键中
+    int capacity;                   // 结点最多可插入的键值对数量，由prefix_len决定
 };
 
+/**
+ * 结点页面的布局：| IxPageHdr | 低键 | 高键 | rids[capacity] | key后缀[capacity] |
+ * 低键、高键为完整的key，结点中的key都在[低键, 高键]之间，因此共享两者的公共前缀，每个key只存去掉前缀后的部分
+ * 返回前缀长度为prefix_len时结点的容量
+ */
+inline int ix_node_capacity(int key_len, int prefix_len) {
+    return static_cast<int>((PAGE_SIZE - sizeof(IxPageHdr) - 2 * key_len) / (key_len - prefix_len + sizeof(Rid)));
+}
+
+inline int IxFileHdr::node_capacity(const char *low, const char *high) const {
+    return ix_node_capacity(col_tot_len_, prefix_len(low, high));
+}
+
+/* 哈希索引头页面：全局深度和目录页面列表，目录项按下标依次存放在各目录页面中 */
+struct IxHashHdr {
+    int global_depth;                               // 目录共有2^global_depth项，由key的hash值低global_depth位定位
+    int num_dir_pages;                              // 已分配的目录页面数量
+    page_id_t dir_pages[IX_HASH_MAX_DIR_PAGES];     // 目录页面的页号
+};
+
+/**
+ * 哈希桶页面的布局：| IxHashBucketHdr | hash值[capacity] | rids[capacity] | keys[capacity] |
+ * 桶中key无序存放，查找时先比较32位hash值，相等才比较key
+ */
+struct IxHashBucketHdr {
+    int local_depth;                // 桶中所有key的hash值低local_depth位相同
+    int num_key;                    // 桶中已插入的键值对数量
+};
+
+inline int ix_hash_bucket_capacity(int key_len) {
+    return static_cast<int>((PAGE_SIZE - sizeof(IxHashBucketHdr)) / (sizeof(uint32_t) + sizeof(Rid) + key_len));
+}
+
 class Iid {
 public:
     int page_no;
@@ -0,0 +1,216 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "ix_hash_table.h"
+
+#include <mutex>
+
+#include "errors.h"
+#include "ix_index_handle.h"
+
+IxHashTable::IxHashTable(IxIndexHandle *ih)
+        : ih_(ih), key_len_(ih->file_hdr_->col_tot_len_), capacity_(ix_hash_bucket_capacity(key_len_)) {
+    // 从头页面和目录页面读入目录
+    auto hdr_page = fetch_page(IX_HASH_HEADER_PAGE, LatchMode::READ);
+    auto hdr = reinterpret_cast<const IxHashHdr *>(hdr_page.get_data());
+    global_depth_ = hdr->global_depth;
+    dir_pages_.assign(hdr->dir_pages, hdr->dir_pages + hdr->num_dir_pages);
+    dir_.resize((size_t)1 << global_depth_);
+    for (size_t i = 0; i < dir_.size(); i += IX_HASH_DIR_ENTRIES) {
+        auto dir_page = fetch_page(dir_pages_[i / IX_HASH_DIR_ENTRIES], LatchMode::READ);
+        auto entries = reinterpret_cast<const page_id_t *>(dir_page.get_data());
+        std::copy(entries, entries + std::min<size_t>(IX_HASH_DIR_ENTRIES, dir_.size() - i), dir_.begin() + i);
+    }
+}
+
+IxHashTable::Bucket IxHashTable::bucket_of(PageGuard &page) const {
+    char *data = page.get_data();
+    Bucket bucket;
+    bucket.hdr = reinterpret_cast<IxHashBucketHdr *>(data);
+    bucket.hashes = reinterpret_cast<uint32_t *>(data + sizeof(IxHashBucketHdr));
+    bucket.rids = reinterpret_cast<Rid *>(bucket.hashes + capacity_);
+    bucket.keys = reinterpret_cast<char *>(bucket.rids + capacity_);
+    return bucket;
+}
+
+int IxHashTable::find(const Bucket &bucket, uint32_t hash, const char *key) const {
+    for (int i = 0; i < bucket.hdr->num_key; i++) {
+        if (bucket.hashes[i] == hash && memcmp(bucket.keys + (size_t)i * key_len_, key, key_len_) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void IxHashTable::append(Bucket &bucket, uint32_t hash, const char *key, const Rid &rid) const {
+    int pos = bucket.hdr->num_key++;
+    bucket.hashes[pos] = hash;
+    bucket.rids[pos] = rid;
+    memcpy(bucket.keys + (size_t)pos * key_len_, key, key_len_);
+}
+
+bool IxHashTable::get_value(const char *key, std::vector<Rid> *result) {
+    auto hash = static_cast<uint32_t>(ix_hash_key(key, key_len_));
+    std::shared_lock<std::shared_mutex> lock(dir_latch_);
+    auto page = fetch_page(dir_[dir_index(hash)], LatchMode::READ);
+    auto bucket = bucket_of(page);
+    int pos = find(bucket, hash, key);
+    if (pos == -1) {
+        return false;
+    }
+    result->push_back(bucket.rids[pos]);
+    return true;
+}
+
+bool IxHashTable::insert_entry(const char *key, const Rid &rid) {
+    auto hash = static_cast<uint32_t>(ix_hash_key(key, key_len_));
+    {
+        std::shared_lock<std::shared_mutex> lock(dir_latch_);
+        auto page = fetch_page(dir_[dir_index(hash)], LatchMode::WRITE);
+        auto bucket = bucket_of(page);
+        if (find(bucket, hash, key) != -1) {
+            return false;
+        }
+        if (bucket.hdr->num_key < capacity_) {
+            append(bucket, hash, key, rid);
+            return true;
+        }
+    }
+    // 桶已满，持有目录写锁分裂，分裂后key所在的桶仍可能是满的（hash值的下一位都相同），继续分裂
+    std::unique_lock<std::shared_mutex> lock(dir_latch_);
+    while (true) {
+        auto page = fetch_page(dir_[dir_index(hash)], LatchMode::NONE);
+        auto bucket = bucket_of(page);
+        if (find(bucket, hash, key) != -1) {
+            return false;
+        }
+        if (bucket.hdr->num_key < capacity_) {
+            append(bucket, hash, key, rid);
+            return true;
+        }
+        page.Drop();
+        split(hash);
+    }
+}
+
+bool IxHashTable::delete_entry(const char *key) {
+    auto hash = static_cast<uint32_t>(ix_hash_key(key, key_len_));
+    std::shared_lock<std::shared_mutex> lock(dir_latch_);
+    auto page = fetch_page(dir_[dir_index(hash)], LatchMode::WRITE);
+    auto bucket = bucket_of(page);
+    int pos = find(bucket, hash, key);
+    if (pos == -1) {
+        return false;
+    }
+    // 用最后一个键值对填补空位
+    int last = --bucket.hdr->num_key;
+    if (pos != last) {
+        bucket.hashes[pos] = bucket.hashes[last];
+        bucket.rids[pos] = bucket.rids[last];
+        memcpy(bucket.keys + (size_t)pos * key_len_, bucket.keys + (size_t)last * key_len_, key_len_);
+    }
+    return true;
+}
+
+void IxHashTable::split(uint32_t hash) {
+    auto page = fetch_page(dir_[dir_index(hash)], LatchMode::NONE);
+    auto bucket = bucket_of(page);
+    int depth = bucket.hdr->local_depth;
+    if (depth == global_depth_) {
+        if (global_depth_ == IX_HASH_MAX_DEPTH) {
+            throw InternalError("Hash index directory is full");
+        }
+        // 目录加倍，新的一半与原目录相同
+        size_t size = dir_.size();
+        dir_.resize(size * 2);
+        std::copy(dir_.begin(), dir_.begin() + size, dir_.begin() + size);
+        global_depth_++;
+        write_dir(size, size * 2, 1);
+        write_hdr();
+    }
+    // hash值第depth位为1的键值对移到新桶
+    page_id_t new_page_no;
+    auto new_page = ih_->create_page(&new_page_no);
+    auto new_bucket = bucket_of(new_page);
+    new_bucket.hdr->local_depth = depth + 1;
+    new_bucket.hdr->num_key = 0;
+    bucket.hdr->local_depth = depth + 1;
+    int kept = 0;
+    for (int i = 0; i < bucket.hdr->num_key; i++) {
+        const char *key = bucket.keys + (size_t)i * key_len_;
+        if (bucket.hashes[i] >> depth & 1) {
+            append(new_bucket, bucket.hashes[i], key, bucket.rids[i]);
+        } else if (kept != i) {
+            bucket.hashes[kept] = bucket.hashes[i];
+            bucket.rids[kept] = bucket.rids[i];
+            memcpy(bucket.keys + (size_t)kept * key_len_, key, key_len_);
+            kept++;
+        } else {
+            kept++;
+        }
+    }
+    bucket.hdr->num_key = kept;
+    // 低depth位与hash相同且第depth位为1的目录项指向新桶
+    size_t step = (size_t)1 << (depth + 1);
+    size_t first = (hash & ((1u << depth) - 1)) | (1u << depth);
+    for (size_t i = first; i < dir_.size(); i += step) {
+        dir_[i] = new_page_no;
+    }
+    write_dir(first, dir_.size(), step);
+}
+
+void IxHashTable::write_dir(size_t begin, size_t end, size_t step) {
+    size_t num_dir_pages = (end + IX_HASH_DIR_ENTRIES - 1) / IX_HASH_DIR_ENTRIES;
+    while (dir_pages_.size() < num_dir_pages) {
+        page_id_t page_no;
+        ih_->create_page(&page_no);
+        dir_pages_.push_back(page_no);
+    }
+    PageGuard page;
+    size_t page_idx = SIZE_MAX;
+    for (size_t i = begin; i < end; i += step) {
+        if (i / IX_HASH_DIR_ENTRIES != page_idx) {
+            page_idx = i / IX_HASH_DIR_ENTRIES;
+            page = fetch_page(dir_pages_[page_idx], LatchMode::NONE);
+        }
+        reinterpret_cast<page_id_t *>(page.get_data())[i % IX_HASH_DIR_ENTRIES] = dir_[i];
+    }
+}
+
+void IxHashTable::write_hdr() {
+    auto page = fetch_page(IX_HASH_HEADER_PAGE, LatchMode::NONE);
+    auto hdr = reinterpret_cast<IxHashHdr *>(page.get_data());
+    hdr->global_depth = global_depth_;
+    hdr->num_dir_pages = dir_pages_.size();
+    std::copy(dir_pages_.begin(), dir_pages_.end(), hdr->dir_pages);
+}
+
+void IxHashTable::reset() {
+    std::unique_lock<std::shared_mutex> lock(dir_latch_);
+    auto page = fetch_page(IX_HASH_INIT_BUCKET_PAGE, LatchMode::NONE);
+    auto bucket = bucket_of(page);
+    bucket.hdr->local_depth = 0;
+    bucket.hdr->num_key = 0;
+    global_depth_ = 0;
+    dir_.assign(1, IX_HASH_INIT_BUCKET_PAGE);
+    write_dir(0, 1, 1);
+    write_hdr();
+}
+
+int IxHashTable::get_global_depth() {
+    std::shared_lock<std::shared_mutex> lock(dir_latch_);
+    return global_depth_;
+}
+
+PageGuard IxHashTable::fetch_page(page_id_t page_no, LatchMode mode) const {
+    auto page = ih_->buffer_pool_manager_->FetchPageBasic(PageId{ih_->fd_, page_no});
+    page.Latch(mode);
+    return page;
+}
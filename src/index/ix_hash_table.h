@@ -0,0 +1,98 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <shared_mutex>
+#include <vector>
+
+#include "ix_defs.h"
+#include "storage/page_guard.h"
+
+class IxIndexHandle;
+
+/* 编码后key的64位hash，按8字节分块混合，最后用fmix64打散，结果与平台无关 */
+inline uint64_t ix_hash_key(const char *key, int len) {
+    constexpr uint64_t MUL = 0x9E3779B97F4A7C15ULL;
+    uint64_t h = static_cast<uint64_t>(len) * MUL;
+    for (int i = 0; i < len; i += 8) {
+        uint64_t word = 0;
+        memcpy(&word, key + i, std::min(8, len - i));
+        h = (h ^ (word * 0xFF51AFD7ED558CCDULL)) * MUL;
+        h = (h << 31) | (h >> 33);
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/**
+ * 可扩展哈希索引，页面都由缓冲池管理，只支持等值查找
+ * 目录在内存中保留一份，修改时同步写回目录页面；桶满时分裂，局部深度等于全局深度时先将目录加倍，桶不合并
+ * 并发：普通的查找、插入、删除持有目录读锁和桶页面锁，分裂和目录加倍持有目录写锁
+ */
+class IxHashTable {
+public:
+    explicit IxHashTable(IxIndexHandle *ih);
+
+    bool get_value(const char *key, std::vector<Rid> *result);
+
+    // key已存在时返回false
+    bool insert_entry(const char *key, const Rid &rid);
+
+    bool delete_entry(const char *key);
+
+    // 清空索引，只保留一个空桶，原有的桶页面不再使用
+    void reset();
+
+    int get_global_depth();
+
+private:
+    /* 桶页面上的视图 */
+    struct Bucket {
+        IxHashBucketHdr *hdr;
+        uint32_t *hashes;
+        Rid *rids;
+        char *keys;
+    };
+
+    Bucket bucket_of(PageGuard &page) const;
+
+    // key在桶中的位置，不存在时返回-1
+    int find(const Bucket &bucket, uint32_t hash, const char *key) const;
+
+    void append(Bucket &bucket, uint32_t hash, const char *key, const Rid &rid) const;
+
+    // 持有目录写锁时调用，分裂hash所在的桶
+    void split(uint32_t hash);
+
+    // 把目录项[begin, end)中步长为step的项写回目录页面，目录页面不够时分配新页面
+    void write_dir(size_t begin, size_t end, size_t step);
+
+    void write_hdr();
+
+    PageGuard fetch_page(page_id_t page_no, LatchMode mode) const;
+
+    size_t dir_index(uint32_t hash) const { return hash & ((1u << global_depth_) - 1); }
+
+    IxIndexHandle *ih_;
+    int key_len_;
+    int capacity_;                          // 每个桶最多存放的键值对数量
+    std::shared_mutex dir_latch_;           // 保护global_depth_、dir_和dir_pages_
+    int global_depth_;
+    std::vector<page_id_t> dir_;            // 目录项，下标为hash值的低global_depth_位
+    std::vector<page_id_t> dir_pages_;
+};
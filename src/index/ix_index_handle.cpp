@@ -20,32 +20,87 @@ See the Mulan PSL v2 for more details. */
 #include <cstring>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <utility>
 #include <iostream>
 
+namespace {
+
+/* 删除引起的结构修改（借键、合并、降低树高）期间smo_version_为奇数 */
+class SmoGuard {
+public:
+    explicit SmoGuard(std::atomic<uint64_t> &version) : version_(version) { version_++; }
+    ~SmoGuard() { version_++; }
+
+private:
+    std::atomic<uint64_t> &version_;
+};
+
+}  // namespace
+
 /**
  * @brief 在当前node中查找第一个>=target的key_idx
  *
  * @return key_idx，范围为[0,num_key)，如果返回的key_idx=num_key，则表示target大于最后一个key
  * @note 返回key index（同时也是rid index），作为slot no
  */
-int IxNodeHandle::lower_bound(char *target) const {
-    // Todo:
-    // 查找当前节点中第一个大于等于target的key，并返回key的位置给上层
-    // 提示: 可以采用多种查找方式，如顺序遍历、二分查找等；使用ix_compare()函数进行比较
-
+int IxNodeHandle::lower_bound(const char *target) const {
     // 叶子结点从0开始，内部结点从1开始
     int l=is_leaf_page()?0:1;
     int r=page_hdr->num_key;
-    while (l<r) {
-        int m=(l+r)/2;
-        if (ix_compare(get_key(m),target,file_hdr->col_types_,file_hdr->col_lens_)>=0) {
-            r=m;
-        }else {
-            l=m+1;
+    if (l>=r) {
+        return r;
+    }
+    // 按key布局选择特化的查找，INT/BIGINT不压缩前缀，后缀就是完整的key
+    switch (file_hdr->key_kind_) {
+        case IX_KEY_INT:
+            return ix_search::lower_bound_integral<std::int32_t>(suffixes(), l, r, ix_search::load_key<std::int32_t>(target));
+        case IX_KEY_BIGINT:
+            return ix_search::lower_bound_integral<std::int64_t>(suffixes(), l, r, ix_search::load_key<std::int64_t>(target));
+        default: {
+            // 先和公共前缀比较，前缀不同时target在所有key之前或之后
+            int prefix=page_hdr->prefix_len;
+            int cmp=memcmp(target, get_low_key(), prefix);
+            if (cmp!=0) {
+                return cmp<0?l:r;
+            }
+            int len=suffix_len();
+            const char *suffix=target+prefix;
+            return ix_search::lower_bound(suffixes(), len, l, r, [=](const char *key) { return memcmp(key, suffix, len) < 0; });
         }
     }
-    return r;
+}
+
+/**
+ * @brief 修改结点的低键和高键
+ * 结点中的key共享低键与高键的公共前缀，公共前缀变化时把所有key还原为完整的key，再按新的前缀存放后缀
+ *
+ * @note low、high可以指向结点自身（如get_low_key()），因此先复制
+ */
+void IxNodeHandle::set_fences(const char *low, const char *high) {
+    int len=file_hdr->col_tot_len_;
+    int size=page_hdr->num_key;
+    char new_low[IX_MAX_COL_LEN];
+    char new_high[IX_MAX_COL_LEN];
+    memcpy(new_low, low, len);
+    memcpy(new_high, high, len);
+    int prefix=file_hdr->prefix_len(new_low, new_high);
+    if (prefix!=page_hdr->prefix_len||memcmp(new_low, get_low_key(), prefix)!=0) {
+        std::vector<char> keys((size_t)size*len);
+        for (int i = 0; i < size; i++) {
+            copy_key(i, keys.data()+(size_t)i*len);
+        }
+        // rids的位置固定，只有后缀区随容量移动
+        page_hdr->prefix_len=prefix;
+        page_hdr->capacity=ix_node_capacity(len, prefix);
+        assert(size<=page_hdr->capacity);
+        for (int i = 0; i < size; i++) {
+            memcpy(get_suffix(i), keys.data()+(size_t)i*len+prefix, suffix_len());
+        }
+    }
+    memcpy(get_low_key(), new_low, len);
+    memcpy(get_high_key(), new_high, len);
+    set_dirty(true);
 }
 
 /**
@@ -63,7 +118,7 @@ bool IxNodeHandle::leaf_lookup(char *key, Rid **value) {
     // 3. 如果存在，获取key对应的Rid，并赋值给传出参数value
     // 提示：可以调用lower_bound()和get_rid()函数。
     int begin=lower_bound(key);
-    if (begin!=get_size()&& ix_compare(get_key(begin),key,file_hdr->col_types_,file_hdr->col_lens_)==0){
+    if (begin!=get_size()&& compare_key_at(begin,key)==0){
         *value=get_rid(begin);
         return true;
     }
@@ -73,8 +128,7 @@ bool IxNodeHandle::leaf_lookup(char *key, Rid **value) {
 bool IxNodeHandle::leaf_lookup(char *key){
     int begin=lower_bound(key);
 //    std::cout<<"in leaf look up,page_no="<<get_page_no() <<" ,pos="<<begin<<"\n";
-//    std::cout<<"key find="<<*(int*)(get_key(begin))<<"\n";
-    return begin!=get_size()&& ix_compare(get_key(begin),key,file_hdr->col_types_,file_hdr->col_lens_)==0;
+    return begin!=get_size()&& compare_key_at(begin,key)==0;
 }
 /**
  * 用于内部结点（非叶子节点）查找目标key所在的孩子结点（子树）
@@ -89,10 +143,8 @@ PageID IxNodeHandle::internal_lookup(char *key) {
     int r=lower_bound(key);
     // 指向了末尾，在最后一个结点中搜索
     r= r==page_hdr->num_key ?r-1:r;
-    // 定位到第r个key
-    auto key_at_r=get_key(r);
-    // key <= ket_at_r 获取r个孩子指针 否则获取第r-1个孩子指针
-    r=ix_compare(key,key_at_r,file_hdr->col_types_,file_hdr->col_lens_)>=0?r:r-1;
+    // key >= 第r个key 获取r个孩子指针 否则获取第r-1个孩子指针
+    r=compare_key_at(r,key)<=0?r:r-1;
     // value 是指向的孩子结点的 page_id
     auto next_page_id= get_rid(r)->page_no;
     return next_page_id;
@@ -112,7 +164,7 @@ PageID IxNodeHandle::internal_lookup(char *key) {
  *       [0,pos)     [pos,pos+n)   [pos+n,num_key+n)
  *                      key           key_slot
  */
-void IxNodeHandle::insert_pairs(int pos, char *key, const Rid *rid, int n) {
+void IxNodeHandle::insert_pairs(int pos, const char *key, const Rid *rid, int n) {
     // Todo:
     // 1. 判断pos的合法性
     // 2. 通过key获取n个连续键值对的key值，并把n个key值插入到pos位置
@@ -120,42 +172,52 @@ void IxNodeHandle::insert_pairs(int pos, char *key, const Rid *rid, int n) {
     // 4. 更新当前节点的键数量
     auto size=page_hdr->num_key;
     // 插入位置不合法，直接返回
-    if (pos>size||size+n>file_hdr->btree_order_) {
+    if (pos>size||size+n>page_hdr->capacity) {
         return;
     }
     // 移动k-v
-    memmove(get_key(pos+n), get_key(pos), file_hdr->col_tot_len_*(size-pos));
+    int len=file_hdr->col_tot_len_;
+    int prefix=page_hdr->prefix_len;
+    memmove(get_suffix(pos+n), get_suffix(pos), suffix_len()*(size-pos));
     memmove(get_rid(pos+n), get_rid(pos),sizeof(Rid)*(size-pos));
-    // 插入
-    memcpy(get_key(pos), key,file_hdr->col_tot_len_*n);
+    // 插入，key都在[低键, 高键]之间，只存后缀
+    for (int i = 0; i < n; i++) {
+        assert(memcmp(key+(size_t)i*len, get_low_key(), prefix)==0);
+        memcpy(get_suffix(pos+i), key+(size_t)i*len+prefix, suffix_len());
+    }
     memcpy(get_rid(pos), rid, sizeof(Rid)*n);
     // 更新键数量
     page_hdr->num_key+=n;
     set_dirty(true);
 }
-void IxNodeHandle::internal_insert_pair(int pos,char*key,Rid rid){
-    internal_insert_pairs(pos,key,std::vector<Rid>{rid},1);
-}
-void IxNodeHandle::internal_insert_pairs(int pos,char* key,const std::vector<Rid>& rids_,int n){
+void IxNodeHandle::insert_pairs_from(int pos, const IxNodeHandle &src, int src_pos, int n) {
     auto size=page_hdr->num_key;
-    // 插入位置不合法，直接返回
-    if (pos>size||size+n>file_hdr->btree_order_) {
+    if (pos>size||size+n>page_hdr->capacity) {
         return;
     }
-    // 移动k-v
-    memmove(get_key(pos+n), get_key(pos), file_hdr->col_tot_len_*(size-pos));
+    int prefix=page_hdr->prefix_len;
+    memmove(get_suffix(pos+n), get_suffix(pos), suffix_len()*(size-pos));
     memmove(get_rid(pos+n), get_rid(pos),sizeof(Rid)*(size-pos));
-    // 插入
-    memcpy(get_key(pos), key,file_hdr->col_tot_len_*n);
-    auto rid_start= get_rid(pos);
-    for (int i = 0; i < n; ++i,++rid_start) {
-        rid_start->page_no=rids_[i].page_no;
-        rid_start->slot_no=rids_[i].slot_no;
+    if (src.page_hdr->prefix_len==prefix&&memcmp(src.get_low_key(), get_low_key(), prefix)==0) {
+        memcpy(get_suffix(pos), src.get_suffix(src_pos), suffix_len()*n);
+    } else {
+        char key[IX_MAX_COL_LEN];
+        for (int i = 0; i < n; i++) {
+            src.copy_key(src_pos+i, key);
+            assert(memcmp(key, get_low_key(), prefix)==0);
+            memcpy(get_suffix(pos+i), key+prefix, suffix_len());
+        }
     }
-    // 更新键数量
+    memcpy(get_rid(pos), src.get_rid(src_pos), sizeof(Rid)*n);
     page_hdr->num_key+=n;
     set_dirty(true);
 }
+void IxNodeHandle::internal_insert_pair(int pos,char*key,Rid rid){
+    insert_pairs(pos,key,&rid,1);
+}
+void IxNodeHandle::internal_insert_pairs(int pos,char* key,const std::vector<Rid>& rids_,int n){
+    insert_pairs(pos,key,rids_.data(),n);
+}
 /**
  * @brief 用于在结点中插入单个键值对。
  * 函数返回插入后的键值对数量
@@ -170,7 +232,7 @@ int IxNodeHandle::insert(char *key, const Rid &value) {
     // 3. 如果key不重复则插入键值对
     // 4. 返回完成插入操作之后的键值对数量
     auto pos=lower_bound(key);
-    if (pos<page_hdr->num_key&&ix_compare(key,get_key(pos),file_hdr->col_types_,file_hdr->col_lens_)==0) {
+    if (pos<page_hdr->num_key&&compare_key_at(pos,key)==0) {
         // 重复
         return page_hdr->num_key;
     }
@@ -189,7 +251,7 @@ void IxNodeHandle::erase_pair(int pos) {
     // 2. 删除该位置的rid
     // 3. 更新结点的键值对数量
     auto size=page_hdr->num_key-pos-1;
-    memmove(get_key(pos), get_key(pos+1), file_hdr->col_tot_len_*size);
+    memmove(get_suffix(pos), get_suffix(pos+1), suffix_len()*size);
     memmove(get_rid(pos), get_rid(pos+1), sizeof(Rid)*size);
     --page_hdr->num_key;
     set_dirty(true);
@@ -207,7 +269,7 @@ int IxNodeHandle::remove(char *key) {
     // 2. 如果要删除的键值对存在，删除键值对
     // 3. 返回完成删除操作后的键值对数量
     int begin=lower_bound(key);
-    if (begin<page_hdr->num_key&&ix_compare(key,get_key(begin),file_hdr->col_types_,file_hdr->col_lens_)==0){
+    if (begin<page_hdr->num_key&&compare_key_at(begin,key)==0){
         erase_pair(begin);
     }
     return page_hdr->num_key;
@@ -226,6 +288,9 @@ IxIndexHandle::IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffe
     // disk_manager管理的fd对应的文件中，设置从file_hdr_->num_pages开始分配page_no
     int now_page_no = disk_manager_->get_fd2pageno(fd);
     disk_manager_->set_fd2pageno(fd, now_page_no + 1);
+    if (file_hdr_->index_type_ == INDEX_HASH) {
+        hash_ = std::make_unique<IxHashTable>(this);
+    }
 }
 
 /**
@@ -244,16 +309,97 @@ IxIndexHandle::IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffe
 // 3. 找到包含该key值的叶子结点停止查找，并返回叶子节点
 // 如果根节点是叶子结点
 // 使用ctx的leaf_find
+// 查找：先乐观下降，多次失败后改为读锁crabbing；插入、删除：写锁crabbing，结点安全时释放祖先
 void IxIndexHandle::find_leaf_page(char *key, Ctx&ctx , std::shared_ptr<Transaction> transaction)const {
-    ctx.write_.emplace_back(fetch_node(ctx.root_page_id_));
+    if (ctx.opt==Operation::FIND) {
+        for (int i = 0; i < IX_OPTIMISTIC_RETRY; i++) {
+            if (find_leaf_optimistic(key, ctx, LatchMode::READ)) {
+                return;
+            }
+        }
+        std::shared_lock<std::shared_mutex> root_lock(root_latch_);
+        ctx.root_page_id_=file_hdr_->root_page_;
+        ctx.write_.emplace_back(fetch_node(ctx.root_page_id_, LatchMode::READ));
+        root_lock.unlock();
+        while (true) {
+            // 持有父结点读锁时孩子不会被分裂或合并，右移只是防御
+            if (ctx.back()->need_move_right(key)) {
+                auto right=fetch_node(ctx.back()->get_next_leaf());
+                ctx.Drop();
+                right->latch(LatchMode::READ);
+                ctx.write_.emplace_back(std::move(right));
+                continue;
+            }
+            if (ctx.back()->is_leaf_page()) {
+                return;
+            }
+            ctx.write_.emplace_back(fetch_node(ctx.back()->internal_lookup(key), LatchMode::READ));
+            ctx.Release();
+        }
+    }
+    ctx.root_lock_=std::unique_lock<std::shared_mutex>(root_latch_);
+    ctx.root_page_id_=file_hdr_->root_page_;
+    ctx.write_.emplace_back(fetch_node(ctx.root_page_id_, LatchMode::WRITE));
     ctx.Release();
     while (!ctx.back()->is_leaf_page()) {
         auto next_page_id=ctx.back()->internal_lookup(key);
 //        std::cout<<"internal node#"<<next_page_id<<"\n";
-        ctx.write_.emplace_back(fetch_node(next_page_id));
+        ctx.write_.emplace_back(fetch_node(next_page_id, LatchMode::WRITE));
         ctx.Release();
     }
 }
+
+/**
+ * @brief 乐观下降：内部结点只在读取时短暂持有读锁，读完孩子页号并pin住孩子后即释放，
+ * 遇到并发分裂时沿B-link右移；到达叶子后按leaf_mode加锁
+ *
+ * @param leaf_mode 叶子结点需要的锁
+ * @return 是否成功，遇到已回收的结点或期间发生了删除引起的结构修改时返回false，调用者从根重试
+ * @note 成功时叶子结点留在ctx.write_中并持有leaf_mode的锁
+ */
+bool IxIndexHandle::find_leaf_optimistic(char *key, Ctx &ctx, LatchMode leaf_mode) const {
+    std::unique_ptr<IxNodeHandle> node;
+    {
+        std::shared_lock<std::shared_mutex> root_lock(root_latch_);
+        ctx.version_=smo_version_.load();
+        if (ctx.version_ & 1) {
+            return false;
+        }
+        ctx.root_page_id_=file_hdr_->root_page_;
+        node=fetch_node(ctx.root_page_id_);
+    }
+    node->latch(LatchMode::READ);
+    while (true) {
+        if (node->is_deleted()) {
+            return false;
+        }
+        if (node->need_move_right(key)) {
+            // 先pin住右兄弟再释放当前结点，右兄弟在此期间不会被回收
+            auto right=fetch_node(node->get_next_leaf());
+            auto mode=node->latch_mode();
+            node=std::move(right);
+            node->latch(mode);
+            continue;
+        }
+        if (!node->is_leaf_page()) {
+            auto child=fetch_node(node->internal_lookup(key));
+            node=std::move(child);
+            node->latch(LatchMode::READ);
+            continue;
+        }
+        if (node->latch_mode()!=leaf_mode) {
+            // 升级为写锁的间隙叶子可能被分裂或回收，重新检查
+            node->latch(leaf_mode);
+            continue;
+        }
+        break;
+    }
+    if (smo_version_.load()!=ctx.version_) {
+        return false;
+    }
+    ctx.write_.emplace_back(std::move(node));
+    return true;
+}
 /**
  * @brief 用于查找指定键在叶子结点中的对应的值result
  *
@@ -268,10 +414,14 @@ bool IxIndexHandle::get_value(char *key, std::vector<Rid> *result, std::shared_p
     // 2. 在叶子节点中查找目标key值的位置，并读取key对应的rid
     // 3. 把rid存入result参数中
     // 提示：使用完buffer_pool提供的page之后，记得unpin page；记得处理并发的上锁
+    if (hash_ != nullptr) {
+        return hash_->get_value(key, result);
+    }
+    if (!file_hdr_->unique_) {
+        return get_duplicates(key, result);
+    }
 
-    // 上锁,确保能获取根节点
-    // lock();
-    Ctx ctx{Operation::FIND,file_hdr_->root_page_};
+    Ctx ctx{Operation::FIND};
     find_leaf_page(key,ctx);
     Rid* rid;
     // 叶子结点是否含有该key
@@ -282,6 +432,159 @@ bool IxIndexHandle::get_value(char *key, std::vector<Rid> *result, std::shared_p
     return false;
 }
 
+/**
+ * @brief 批量等值查找，key升序排列时相邻的key大多落在同一叶子或相邻的叶子中
+ * 当前叶子覆盖下一个key时直接在叶子中查找；否则先看右兄弟，仍不覆盖时从上一次下降路径中
+ * 覆盖该key的最低祖先重新下降，而不是每个key都从根开始
+ * @note 当前叶子的读锁一直持有到离开该叶子，visit中不能再访问本索引
+ */
+void IxIndexHandle::lookup_many(const char *keys, int n, const std::function<void(int, const Rid &)> &visit) const {
+    int len=file_hdr_->user_key_len();
+    char key[IX_MAX_COL_LEN];
+    char cur[IX_MAX_COL_LEN];
+    std::vector<PageID> path;
+    uint64_t version=0;
+    std::unique_ptr<IxNodeHandle> leaf;
+    for (int i = 0; i < n; i++) {
+        // 非唯一索引以rid为0的项作为下界
+        memcpy(key,keys+(size_t)i*len,len);
+        memset(key+len,0,file_hdr_->col_tot_len_-len);
+        if (leaf!=nullptr&&!leaf->covers(key)&&leaf->has_right_sibling()) {
+            // 持有当前叶子再锁右兄弟，与写者从左到右的加锁顺序一致
+            auto right=fetch_node(leaf->get_next_leaf(), LatchMode::READ);
+            leaf=std::move(right);
+        }
+        if (leaf==nullptr||!leaf->covers(key)) {
+            leaf.reset();
+            leaf=descend_from_path(key,path,version);
+        }
+        int pos=leaf->lower_bound(key);
+        while (true) {
+            if (pos==leaf->get_size()) {
+                // 唯一索引的key一定在覆盖它的叶子中；非唯一索引key相同的项可能延续到右兄弟
+                if (file_hdr_->unique_||!leaf->has_right_sibling()) {
+                    break;
+                }
+                auto right=fetch_node(leaf->get_next_leaf(), LatchMode::READ);
+                leaf=std::move(right);
+                pos=0;
+                continue;
+            }
+            leaf->copy_key(pos,cur);
+            if (memcmp(cur,key,len)!=0) {
+                break;
+            }
+            visit(i,*leaf->get_rid(pos));
+            if (file_hdr_->unique_) {
+                break;
+            }
+            pos++;
+        }
+    }
+}
+
+/**
+ * @brief 乐观下降，从path中覆盖key的最低内部结点开始，path为空或期间发生了删除引起的结构修改时从根开始
+ * 下降经过的内部结点记录在path中，version为path对应的smo_version_
+ * @return 持有读锁的叶子
+ */
+std::unique_ptr<IxNodeHandle> IxIndexHandle::descend_from_path(char *key, std::vector<PageID> &path, uint64_t &version) const {
+    for (int i = 0; i < IX_OPTIMISTIC_RETRY; i++) {
+        std::unique_ptr<IxNodeHandle> node;
+        if (smo_version_.load()==version) {
+            while (!path.empty()) {
+                node=fetch_node(path.back(), LatchMode::READ);
+                if (!node->is_deleted()&&node->covers(key)) {
+                    break;
+                }
+                node.reset();
+                path.pop_back();
+            }
+        } else {
+            path.clear();
+        }
+        if (node==nullptr) {
+            std::shared_lock<std::shared_mutex> root_lock(root_latch_);
+            version=smo_version_.load();
+            if (version & 1) {
+                continue;
+            }
+            node=fetch_node(file_hdr_->root_page_);
+            root_lock.unlock();
+            node->latch(LatchMode::READ);
+        }
+        bool ok=true;
+        while (true) {
+            if (node->is_deleted()) {
+                ok=false;
+                break;
+            }
+            if (node->need_move_right(key)) {
+                auto right=fetch_node(node->get_next_leaf());
+                node=std::move(right);
+                node->latch(LatchMode::READ);
+                continue;
+            }
+            if (node->is_leaf_page()) {
+                break;
+            }
+            if (path.empty()||path.back()!=node->get_page_no()) {
+                path.push_back(node->get_page_no());
+            }
+            auto child=fetch_node(node->internal_lookup(key));
+            node=std::move(child);
+            node->latch(LatchMode::READ);
+        }
+        if (ok&&smo_version_.load()==version) {
+            return node;
+        }
+        path.clear();
+    }
+    // 多次失败后改为读锁crabbing，不再复用路径
+    path.clear();
+    Ctx ctx{Operation::FIND};
+    find_leaf_page(key,ctx);
+    auto leaf=std::move(ctx.back());
+    ctx.Drop();
+    return leaf;
+}
+
+/**
+ * @brief 非唯一索引的等值查找：key相同的项按rid相邻排列，从第一项开始沿叶子链表收集所有rid
+ */
+bool IxIndexHandle::get_duplicates(char *key, std::vector<Rid> *result) const {
+    int len=file_hdr_->user_key_len();
+    char low[IX_MAX_COL_LEN];
+    memcpy(low,key,len);
+    memset(low+len,0,sizeof(Rid));
+    Ctx ctx{Operation::FIND};
+    find_leaf_page(low,ctx);
+    auto node=std::move(ctx.back());
+    ctx.Drop();
+    int pos=node->lower_bound(low);
+    char cur[IX_MAX_COL_LEN];
+    bool found=false;
+    while (true) {
+        if (pos==node->get_size()) {
+            if (node->get_next_leaf()==IX_LEAF_HEADER_PAGE) {
+                break;
+            }
+            // 先锁住右兄弟再释放当前叶子：写者同样从左到右加锁，合并右兄弟需要当前叶子的写锁，右兄弟不会在此期间被合并
+            node=fetch_node(node->get_next_leaf(), LatchMode::READ);
+            pos=0;
+            continue;
+        }
+        node->copy_key(pos,cur);
+        if (memcmp(cur,key,len)!=0) {
+            break;
+        }
+        result->push_back(*node->get_rid(pos));
+        found=true;
+        pos++;
+    }
+    return found;
+}
+
 void IxIndexHandle::split_leaf_node(Ctx&ctx){
     // 将要分裂的叶子结点作为左结点，新创建的结点作为右结点
     // 左节点的大小设置为 min_size 右节点为 max_size-min_size
@@ -297,8 +600,12 @@ void IxIndexHandle::split_leaf_node(Ctx&ctx){
     auto right_node=create_node(&right_id);
     right_node->Init(true);
 //    std::cout<<"in split leaf node,right node id="<<right_id<<"\n";
+    // 右结点的低键为分隔key，高键继承左结点原来的高键，范围缩小后公共前缀只会变长
+    char sep[IX_MAX_COL_LEN];
+    left_node->copy_key(left_size, sep);
+    right_node->set_fences(sep, left_node->get_high_key());
     // 移动左节点的键值对
-    right_node->insert_pairs(0,left_node->get_key(left_size), left_node->get_rid(left_size),max_size-left_size);
+    right_node->insert_pairs_from(0, *left_node, left_size, max_size-left_size);
     // 更新左结点的Size,右结点在Insert时已经更新了
     left_node->set_size(left_size);
     // 如果left_node是原来的last_leaf，设置file_hd
@@ -309,9 +616,15 @@ void IxIndexHandle::split_leaf_node(Ctx&ctx){
 //        outfile<<"in split leaf node set last leaf="<<right_id<<"\n";
 //        outfile.close();
     }
-    // 设置结点的next_page_id
+    // 设置结点的next_page_id和高键
     right_node->set_next_leaf(left_node->get_next_leaf());
     left_node->set_next_leaf(right_id);
+    left_node->set_high_key(sep);
+    // 维护prev_leaf，按从左到右的顺序锁住原来的右兄弟，不会与其他写者死锁
+    right_node->set_prev_leaf(left_node->get_page_no());
+    if (right_node->has_right_sibling()) {
+        fetch_node(right_node->get_next_leaf(), LatchMode::WRITE)->set_prev_leaf(right_id);
+    }
     // 如果左节点为根节点，创建一个新的根节点
     if (left_node->get_page_no()==ctx.root_page_id_) {
         // 创建根节点
@@ -328,8 +641,8 @@ void IxIndexHandle::split_leaf_node(Ctx&ctx){
 //        outfile.close();
 //        std::cout<<"in split leaf node,new root node id="<<root_id<<"\n";
         // 插入左右结点
-        root_node->internal_insert_pair(0, left_node->get_key(0),Rid{left_node->get_page_no(),0});
-        root_node->internal_insert_pair(1, right_node->get_key(0), Rid{right_node->get_page_no(),1});
+        root_node->internal_insert_pair(0, left_node->get_low_key(),Rid{left_node->get_page_no(),0});
+        root_node->internal_insert_pair(1, sep, Rid{right_node->get_page_no(),1});
         ctx.Drop();
         return;
     }
@@ -345,10 +658,9 @@ void IxIndexHandle::split_leaf_node(Ctx&ctx){
         return;
     }
     // 更新key,插入右结点的第一个key 和右节点的page_id
-    auto key=right_node->get_key(0);
-    auto pos=ctx.back()->lower_bound(key);
+    auto pos=ctx.back()->lower_bound(sep);
 
-    ctx.back()->internal_insert_pair(pos, key,Rid{right_id,pos});
+    ctx.back()->internal_insert_pair(pos, sep,Rid{right_id,pos});
 }
 
 // TODO(ZMY) 拆分内部结点
@@ -358,7 +670,9 @@ void IxIndexHandle::split_internal_node(Ctx&ctx){
     // 获取父亲页面
     auto node_to_update=std::move(ctx.back());
     ctx.pop_back();
-    auto key=right_node->get_key(0);
+    // 新孩子的低键就是要插入的分隔key
+    char key[IX_MAX_COL_LEN];
+    memcpy(key, right_node->get_low_key(), file_hdr_->col_tot_len_);
     auto pos_to_insert=node_to_update->lower_bound(key);
     // 获取左右内部结点的size
     auto left_size=node_to_update->get_min_size();
@@ -374,7 +688,10 @@ void IxIndexHandle::split_internal_node(Ctx&ctx){
 //        outfile<<"#"<<i<<" : key="<<*(int*)(node_to_update->get_key(i))<<", Rid.page_no="<<node_to_update->get_rid(i)->page_no<<", Rid.slot_no="<<node_to_update->get_rid(i)<<"\n";
 //        outfile.close();
 //    }
-    new_node->insert_pairs(0,node_to_update->get_key(left_size) , node_to_update->get_rid(left_size), max_size-left_size);
+    char sep[IX_MAX_COL_LEN];
+    node_to_update->copy_key(left_size, sep);
+    new_node->set_fences(sep, node_to_update->get_high_key());
+    new_node->insert_pairs_from(0, *node_to_update, left_size, max_size-left_size);
 //    {
 //        std::fstream outfile;
 //        outfile.open("test.log", std::ios::out | std::ios::app);
@@ -388,6 +705,10 @@ void IxIndexHandle::split_internal_node(Ctx&ctx){
 //        outfile.close();
 //    }
     node_to_update->set_size(left_size);
+    // 设置B-link，新结点的高键继承原结点的高键
+    new_node->set_next_leaf(node_to_update->get_next_leaf());
+    node_to_update->set_next_leaf(new_page_id);
+    node_to_update->set_high_key(sep);
     // 插入 key-right_page_id
     if (pos_to_insert<=left_size) {
         // 插入到左内部结点
@@ -420,9 +741,8 @@ void IxIndexHandle::split_internal_node(Ctx&ctx){
             return;
         }
         // 插入到父亲结点
-        key=new_node->get_key(0);
-        pos_to_insert=ctx.back()->lower_bound(key);
-        ctx.back()->internal_insert_pair(pos_to_insert, key,Rid{new_page_id,pos_to_insert});
+        pos_to_insert=ctx.back()->lower_bound(sep);
+        ctx.back()->internal_insert_pair(pos_to_insert, sep,Rid{new_page_id,pos_to_insert});
         ctx.Drop();
         return;
     }
@@ -431,10 +751,9 @@ void IxIndexHandle::split_internal_node(Ctx&ctx){
     auto parent=create_node(&parent_id);
     parent->Init(false);
     // 将左节点插入到父节点
-    parent->internal_insert_pair(0, node_to_update->get_key(0),Rid{node_to_update->get_page_no(),0});
+    parent->internal_insert_pair(0, node_to_update->get_low_key(),Rid{node_to_update->get_page_no(),0});
     // 将右节点插入到父节点
-    key=new_node->get_key(0);
-    parent->internal_insert_pair(1, key,Rid{new_page_id,1});
+    parent->internal_insert_pair(1, sep,Rid{new_page_id,1});
     // 设置根节点为新创建的结点
     update_root_page_no(parent_id);
     ctx.root_page_id_=parent_id;
@@ -457,12 +776,30 @@ bool IxIndexHandle::insert_entry( char *key, const Rid &value, std::shared_ptr<T
     // 2. 在该叶子节点中插入键值对
     // 3. 如果结点已满，分裂结点，并把新结点的相关信息插入父节点
     // 提示：记得unpin page；若当前叶子节点是最右叶子节点，则需要更新file_hdr_.last_leaf；记得处理并发的上锁
-    // lock();
 //    std::cout<<"in insert entry\n";
-    // 根节点是叶子结点直接插入
-    auto root_id=file_hdr_->root_page_;
+    if (hash_ != nullptr) {
+        return hash_->insert_entry(key, value);
+    }
+    char entry[IX_MAX_COL_LEN];
+    key=entry_key(key,value,entry);
+    // 乐观插入：只对叶子加写锁，叶子插入后不会分裂时直接完成
+    for (int i = 0; i < IX_OPTIMISTIC_RETRY; i++) {
+        Ctx ctx{Operation::INSERT};
+        if (!find_leaf_optimistic(key, ctx, LatchMode::WRITE)) {
+            continue;
+        }
+        auto &leaf=ctx.back();
+        if (leaf->leaf_lookup(key)) {
+            return false;
+        }
+        if (leaf->get_size()+1<leaf->get_max_size()) {
+            leaf->insert_pair(leaf->lower_bound(key), key, value);
+            return true;
+        }
+        break;
+    }
     // 使用Ctx管理结点
-    Ctx ctx{Operation::INSERT,root_id};
+    Ctx ctx{Operation::INSERT};
     find_leaf_page(key,ctx);
     // 存在，返回false
     // ctx.write_最后一个结点就是插入的结点
@@ -491,14 +828,34 @@ bool IxIndexHandle::insert_entry( char *key, const Rid &value, std::shared_ptr<T
  * @param key 要删除的key值
  * @param transaction 事务指针
  */
-bool IxIndexHandle::delete_entry(char *key, std::shared_ptr<Transaction> transaction) {
+bool IxIndexHandle::delete_entry(char *key, const Rid &rid, std::shared_ptr<Transaction> transaction) {
     // Todo:
     // 1. 获取该键值对所在的叶子结点
     // 2. 在该叶子结点中删除键值对
     // 3. 如果删除成功需要调用CoalesceOrRedistribute来进行合并或重分配操作，并根据函数返回结果判断是否有结点需要删除
     // 4. 如果需要并发，并且需要删除叶子结点，则需要在事务的delete_page_set中添加删除结点的对应页面；记得处理并发的上锁
-    Ctx ctx{Operation::DELETE,file_hdr_->root_page_};
-    // 如果根节点不合法，直接返回false
+    if (hash_ != nullptr) {
+        return hash_->delete_entry(key);
+    }
+    char entry[IX_MAX_COL_LEN];
+    key=entry_key(key,rid,entry);
+    // 乐观删除：叶子删除后不需要借键或合并时只对叶子加写锁
+    for (int i = 0; i < IX_OPTIMISTIC_RETRY; i++) {
+        Ctx ctx{Operation::DELETE};
+        if (!find_leaf_optimistic(key, ctx, LatchMode::WRITE)) {
+            continue;
+        }
+        auto &leaf=ctx.back();
+        if (!leaf->leaf_lookup(key)) {
+            return false;
+        }
+        if (leaf->get_size()-1>=leaf->get_min_size()&&(leaf->get_page_no()!=ctx.root_page_id_||leaf->get_size()>1)) {
+            leaf->erase_pair(leaf->lower_bound(key));
+            return true;
+        }
+        break;
+    }
+    Ctx ctx{Operation::DELETE};
     find_leaf_page(key,ctx);
     auto node=std::move(ctx.back());
     ctx.pop_back();
@@ -533,68 +890,66 @@ bool IxIndexHandle::delete_entry(char *key, std::shared_ptr<Transaction> transac
     }
     // 如果删除后size小于了minsize执行合并或借孩子操作
     if (node->get_size()<node->get_min_size()) {
+        SmoGuard smo(smo_version_);
         // 更新父节点中的key
         auto node_index=ctx.back()->find_child(node->get_page_no());
         auto right_exist = node_index + 1 < ctx.back()->get_size();
         auto left_exist = node_index != 0;
-        PageID left_page_id;
-        PageID right_page_id;
+        // 同一层的结点一律从左到右加锁：左兄弟、node、右兄弟，与读者和分裂的顺序一致
+        std::unique_ptr<IxNodeHandle> left_node;
+        std::unique_ptr<IxNodeHandle> right_node;
         bool merge_to_left = false;
         bool merge_to_right = false;
         // 能借就借，不能借再考虑合并
         // 如果有左兄弟,从左兄弟结点借
         if (left_exist) {
-            left_page_id=ctx.back()->value_at(node_index-1);
-            auto left_node=fetch_node(left_page_id);
-            // 向左借
-            if (left_node->get_size()>left_node->get_min_size()) {
+            left_node=latch_left_sibling(node, ctx.back()->value_at(node_index-1));
+            // 向左借，node的低键变为借来的key，范围扩大后容量可能变小
+            char borrowed[IX_MAX_COL_LEN];
+            if (left_node->get_size()>0) {
+                left_node->copy_key(left_node->get_size()-1, borrowed);
+            }
+            if (left_node->get_size()>left_node->get_min_size()&&
+                node->get_size()+1<node->capacity_for(borrowed, node->get_high_key())) {
                 // 需要使用的页面加入队列
                 ctx.write_.emplace_back(std::move(left_node));
                 ctx.write_.emplace_back(std::move(node));
                 leaf_borrow_left(ctx);
-//                std::fstream outfile;
-//                outfile.open("test.log", std::ios::out | std::ios::app);
-//                outfile<<"delete key="<<*(int*)key<<" ,first leaf page="<<file_hdr_->first_leaf_<<", last leaf="<<file_hdr_->last_leaf_<<"\n";
-//                outfile.close();
                 return true;
             }
-            merge_to_left=node->get_size()+left_node->get_size()<left_node->get_max_size();
+            merge_to_left=node->get_size()+left_node->get_size()<left_node->capacity_for(left_node->get_low_key(), node->get_high_key());
         }
-        // 从右兄弟结点借
+        // 从右兄弟结点借，此时仍持有左兄弟的锁
         if (right_exist) {
-            right_page_id=ctx.back()->value_at(node_index+1);
-            auto right_node=fetch_node(right_page_id);
-            if (right_node->get_size()>right_node->get_min_size()) {
+            right_node=fetch_node(ctx.back()->value_at(node_index+1), LatchMode::WRITE);
+            // 向右借，node的高键变为右兄弟的第二个key
+            char new_high[IX_MAX_COL_LEN];
+            if (right_node->get_size()>1) {
+                right_node->copy_key(1, new_high);
+            }
+            if (right_node->get_size()>right_node->get_min_size()&&
+                node->get_size()+1<node->capacity_for(node->get_low_key(), new_high)) {
+                left_node.reset();
                 ctx.write_.emplace_back(std::move(right_node));
                 ctx.write_.emplace_back(std::move(node));
                 leaf_borrow_right(ctx);
-//                std::fstream outfile;
-//                outfile.open("test.log", std::ios::out | std::ios::app);
-//                outfile<<"delete key="<<*(int*)key<<" ,first leaf page="<<file_hdr_->first_leaf_<<", last leaf="<<file_hdr_->last_leaf_<<"\n";
-//                outfile.close();
                 return true;
             }
-            merge_to_right=node->get_size()+right_node->get_size()<right_node->get_max_size();
+            merge_to_right=node->get_size()+right_node->get_size()<node->capacity_for(node->get_low_key(), right_node->get_high_key());
         }
         if (merge_to_left) {
-            ctx.write_.emplace_back(fetch_node(left_page_id));
+            right_node.reset();
+            ctx.write_.emplace_back(std::move(left_node));
             ctx.write_.emplace_back(std::move(node));
             leaf_merge_left(ctx);
-//            std::fstream outfile;
-//            outfile.open("test.log", std::ios::out | std::ios::app);
-//            outfile<<"delete key="<<*(int*)key<<" ,first leaf page="<<file_hdr_->first_leaf_<<", last leaf="<<file_hdr_->last_leaf_<<"\n";
-//            outfile.close();
             return true;
         }
         if (merge_to_right) {
+            left_node.reset();
             // 调用merge_to_right(a,b) 等于调用merge_to_left(b,a)
             ctx.write_.emplace_back(std::move(node));
-            ctx.write_.emplace_back(fetch_node(right_page_id));
+            ctx.write_.emplace_back(std::move(right_node));
             leaf_merge_left(ctx);
-//            std::fstream outfile;
-//            outfile.open("test.log", std::ios::out | std::ios::app);
-//            outfile<<"delete key="<<*(int*)key<<" ,first leaf page="<<file_hdr_->first_leaf_<<", last leaf="<<file_hdr_->last_leaf_<<"\n";
-//            outfile.close();
             return true;
         }
     }
@@ -612,21 +967,20 @@ void IxIndexHandle::leaf_borrow_right(Ctx& ctx){
     ctx.pop_back();
     auto right_node=std::move(ctx.back());
     ctx.pop_back();
-    // 移动
-    auto old_Key=right_node->get_key(0);
-    node->insert_pair(node->get_size(), old_Key, *right_node->get_rid(0));
+    // 移动，先扩大node的范围再插入
+    char old_key[IX_MAX_COL_LEN];
+    char new_key[IX_MAX_COL_LEN];
+    right_node->copy_key(0, old_key);
+    right_node->copy_key(1, new_key);
+    node->set_high_key(new_key);
+    node->insert_pair(node->get_size(), old_key, *right_node->get_rid(0));
     right_node->erase_pair(0);
-    // 更新父亲结点的指针
-    auto new_key=right_node->get_key(0);
-    auto node_new_key=node->get_key(0);
-    // 更新右结点的父亲
+    right_node->set_low_key(new_key);
+    // 更新右结点的父亲，node的下界不变，其父亲中的key不需要修改，否则会与左兄弟的高键不一致
     auto parent_node=std::move(ctx.back());
     ctx.pop_back();
     auto index=parent_node->find_child(right_node->get_page_no());
     parent_node->set_key(index, new_key);
-    // 更新node的父亲
-    index=parent_node->find_child(node->get_page_no());
-    parent_node->set_key(index, node_new_key);
     // Drop
     ctx.Drop();
 }
@@ -635,12 +989,14 @@ void IxIndexHandle::leaf_borrow_left(Ctx& ctx){
     ctx.pop_back();
     auto left_node=std::move(ctx.back());
     ctx.pop_back();
-    // 移动
+    // 移动，先扩大node的范围再插入
     auto last=left_node->get_size()-1;
-    node->insert_pair(0,left_node->get_key(last), *left_node->get_rid(last));
+    char new_key[IX_MAX_COL_LEN];
+    left_node->copy_key(last, new_key);
+    node->set_low_key(new_key);
+    node->insert_pair(0,new_key, *left_node->get_rid(last));
     left_node->erase_pair(last);
-    // 更新
-    auto new_key=node->get_key(0);
+    left_node->set_high_key(new_key);
     // 获取父节点
     auto parent_node=std::move(ctx.back());
     ctx.pop_back();
@@ -663,9 +1019,13 @@ void IxIndexHandle::leaf_merge_left(Ctx& ctx){
     // 移动剩余k-v到左边结点
     auto left_size=left_node->get_size();
     auto size=node->get_size();
-    left_node->insert_pairs(left_size, node->get_key(0), node->get_rid(0), size);
-    // 设置next_page,prev_leaf不适用，不设置
+    // 设置next_page、高键和右兄弟的prev_leaf
     left_node->set_next_leaf(node->get_next_leaf());
+    if (node->has_right_sibling()) {
+        fetch_node(node->get_next_leaf(), LatchMode::WRITE)->set_prev_leaf(left_node->get_page_no());
+    }
+    left_node->set_high_key(node->get_high_key());
+    left_node->insert_pairs_from(left_size, *node, 0, size);
     // 右边的结点被回收,判断是不是最右结点
     if (file_hdr_->last_leaf_==node->get_page_no()) {
         file_hdr_->last_leaf_=left_node->get_page_no();
@@ -674,11 +1034,8 @@ void IxIndexHandle::leaf_merge_left(Ctx& ctx){
 //        outfile<<"in leaf merge left set last leaf="<<left_node->get_page_no()<<"\n";
 //        outfile.close();
     }
-    // 回收node,必须先drop才能删除
-    auto page_id=node->get_page_id();
-    node.reset();
-    buffer_pool_manager_->delete_page(page_id);
-    --file_hdr_->num_pages_;
+    // 回收node
+    delete_node(node);
     // 如果父亲结点的孩子数少于MinSize
     if (ctx.back()->get_size()<ctx.back()->get_min_size()) {
         left_node.reset();
@@ -706,9 +1063,7 @@ void IxIndexHandle::reduce_internal_node(Ctx& ctx){
 //            outfile<<"in reduce internal node set last leaf="<<root_page_id<<" ,set root_page_id="<<root_page_id<<"\n";
 //            outfile.close();
             // 回收该页面
-            node.reset();
-            buffer_pool_manager_->delete_page(page_id);
-            --file_hdr_->num_pages_;
+            delete_node(node);
         }
         // 如果根节点孩子数大于1但小于min_size，不执行任何操作
         return;
@@ -720,42 +1075,54 @@ void IxIndexHandle::reduce_internal_node(Ctx& ctx){
     auto right_exist = index + 1 != ctx.back()->get_size();
     bool merge_to_right = false;
     bool merge_to_left = false;
-    PageID right_page_id ;
-    PageID left_page_id ;
+    // 与叶子层相同，从左到右加锁
+    std::unique_ptr<IxNodeHandle> left_node;
+    std::unique_ptr<IxNodeHandle> right_node;
     // 从左借
     if (left_exist) {
-        left_page_id=ctx.back()->value_at(index-1);
-        auto left_node=fetch_node(left_page_id);
-        if (left_node->get_size()>left_node->get_min_size()) {
+        left_node=latch_left_sibling(node, ctx.back()->value_at(index-1));
+        char borrowed[IX_MAX_COL_LEN];
+        if (left_node->get_size()>0) {
+            left_node->copy_key(left_node->get_size()-1, borrowed);
+        }
+        if (left_node->get_size()>left_node->get_min_size()&&
+            node->get_size()+1<=node->capacity_for(borrowed, node->get_high_key())) {
             ctx.write_.emplace_back(std::move(left_node));
             ctx.write_.emplace_back(std::move(node));
             internal_borrow_left(ctx);
             return;
         }
-        merge_to_left=left_node->get_size()+node->get_size()<=left_node->get_max_size();
+        merge_to_left=left_node->get_size()+node->get_size()<=left_node->capacity_for(left_node->get_low_key(), node->get_high_key());
     }
     // 从右借
     if (right_exist) {
-        right_page_id=ctx.back()->value_at(index+1);
-        auto right_node=fetch_node(right_page_id);
-        if (right_node->get_size()>right_node->get_min_size()) {
+        right_node=fetch_node(ctx.back()->value_at(index+1), LatchMode::WRITE);
+        char new_high[IX_MAX_COL_LEN];
+        if (right_node->get_size()>1) {
+            right_node->copy_key(1, new_high);
+        }
+        if (right_node->get_size()>right_node->get_min_size()&&
+            node->get_size()+1<=node->capacity_for(node->get_low_key(), new_high)) {
+            left_node.reset();
             ctx.write_.emplace_back(std::move(right_node));
             ctx.write_.emplace_back(std::move(node));
             internal_borrow_right(ctx);
             return;
         }
-        merge_to_right=right_node->get_size()+node->get_size()<=right_node->get_max_size();
+        merge_to_right=right_node->get_size()+node->get_size()<=node->capacity_for(node->get_low_key(), right_node->get_high_key());
     }
     // 向左合并
     if (merge_to_left) {
-        ctx.write_.emplace_back(fetch_node(left_page_id));
+        right_node.reset();
+        ctx.write_.emplace_back(std::move(left_node));
         ctx.write_.emplace_back(std::move(node));
         internal_merge_left(ctx);
         return;
     }
     if (merge_to_right) {
+        left_node.reset();
         ctx.write_.emplace_back(std::move(node));
-        ctx.write_.emplace_back(fetch_node(right_page_id));
+        ctx.write_.emplace_back(std::move(right_node));
         internal_merge_left(ctx);
         return;
     }
@@ -768,14 +1135,18 @@ void IxIndexHandle::internal_borrow_right(Ctx& ctx){
     ctx.pop_back();
     auto parent_node=std::move(ctx.back());
     ctx.pop_back();
-    // 移动kv到node
-    node->insert_pair(node->get_size(), right_node->get_key(0), *right_node->get_rid(0));
-    right_node->erase_pair(0);
-    // 将right_node在父节点对应的key向下移动到page新插入的kv
+    // 移动kv到node，key为right_node在父节点对应的key，right_node的第二个key成为新的分隔key
     auto right_node_index=parent_node->find_child(right_node->get_page_no());
-    node->set_key(node->get_size()-1, parent_node->get_key(right_node_index));
+    char old_key[IX_MAX_COL_LEN];
+    char new_key[IX_MAX_COL_LEN];
+    parent_node->copy_key(right_node_index, old_key);
+    right_node->copy_key(1, new_key);
+    node->set_high_key(new_key);
+    node->insert_pair(node->get_size(), old_key, *right_node->get_rid(0));
+    right_node->erase_pair(0);
+    right_node->set_low_key(new_key);
     // 将right_node的第一个key移动到父节点中
-    parent_node->set_key(right_node_index, right_node->get_key(0));
+    parent_node->set_key(right_node_index, new_key);
     // 结束
     ctx.Drop();
 }
@@ -789,13 +1160,19 @@ void IxIndexHandle::internal_borrow_left(Ctx& ctx){
     ctx.pop_back();
     // 移动
     auto last=left_node->get_size()-1;
-    node->insert_pair(0,left_node->get_key(last), *left_node->get_rid(last));
+    auto node_index=parent_node->find_child(node->get_page_no());
+    char old_key[IX_MAX_COL_LEN];
+    char new_key[IX_MAX_COL_LEN];
+    parent_node->copy_key(node_index, old_key);
+    left_node->copy_key(last, new_key);
+    node->set_low_key(new_key);
+    node->insert_pair(0,new_key, *left_node->get_rid(last));
     left_node->erase_pair(last);
+    left_node->set_high_key(new_key);
     // 更新node的第一个key
-    auto node_index=parent_node->find_child(node->get_page_no());
-    node->set_key(1, parent_node->get_key(node_index));
+    node->set_key(1, old_key);
     // 将node的第0个key移动到父节点中
-    parent_node->set_key(node_index, node->get_key(0));
+    parent_node->set_key(node_index, new_key);
     // Drop
     ctx.Drop();
 }
@@ -808,11 +1185,13 @@ void IxIndexHandle::internal_merge_left(Ctx& ctx){
     // 移动
     auto left_size=left_node->get_size();
     auto size=node->get_size();
-    left_node->insert_pairs(left_size, node->get_key(0), node->get_rid(0), size);
+    left_node->set_high_key(node->get_high_key());
+    left_node->insert_pairs_from(left_size, *node, 0, size);
     PageID next_page_id=left_node->value_at(left_size);
+    left_node->set_next_leaf(node->get_next_leaf());
     // 如果左结点孩子结点是叶子结点，设置左结点最后一个旧孩子结点的next_page
     {
-        auto child_node=fetch_node(left_node->value_at(left_size-1));
+        auto child_node=fetch_node(left_node->value_at(left_size-1), LatchMode::WRITE);
         if (child_node->is_leaf_page()) {
             child_node->set_next_leaf(next_page_id);
         }
@@ -822,13 +1201,13 @@ void IxIndexHandle::internal_merge_left(Ctx& ctx){
     auto page_id=node->get_page_id();
     auto page_no=page_id.page_no;
     auto node_index=ctx.back()->find_child(page_no);
-    left_node->set_key(left_size, ctx.back()->get_key(node_index));
+    char sep[IX_MAX_COL_LEN];
+    ctx.back()->copy_key(node_index, sep);
+    left_node->set_key(left_size, sep);
     // 从父亲节点中删除
     ctx.back()->erase_pair(node_index);
     // 回收page
-    node.reset();
-    buffer_pool_manager_->delete_page(page_id);
-    --file_hdr_->num_pages_;
+    delete_node(node);
     if (ctx.back()->get_size()<ctx.back()->get_min_size()) {
         left_node.reset();
         reduce_internal_node(ctx);
@@ -844,13 +1223,22 @@ void IxIndexHandle::internal_merge_left(Ctx& ctx){
  * @note iid和rid存的不是一个东西，rid是上层传过来的记录位置，iid是索引内部生成的索引槽位置
  */
 Rid IxIndexHandle::get_rid(const Iid &iid) const {
-    auto node = fetch_node(iid.page_no);
+    auto node = fetch_node(iid.page_no, LatchMode::READ);
     if (iid.slot_no >= node->get_size()) {
         throw IndexEntryNotFoundError();
     }
     return *node->get_rid(iid.slot_no);
 }
 
+Rid IxIndexHandle::get_entry(const Iid &iid, char *key) const {
+    auto node = fetch_node(iid.page_no, LatchMode::READ);
+    if (iid.slot_no >= node->get_size()) {
+        throw IndexEntryNotFoundError();
+    }
+    node->copy_key(iid.slot_no, key);
+    return *node->get_rid(iid.slot_no);
+}
+
 /**
  * @brief FindLeafPage + lower_bound
  *
@@ -885,7 +1273,7 @@ Iid IxIndexHandle::leaf_end() const {
     if(file_hdr_->last_leaf_==INVALID_PAGE_ID){
         return {-1,0};
     }
-    auto node = fetch_node(file_hdr_->last_leaf_);
+    auto node = fetch_node(file_hdr_->last_leaf_, LatchMode::READ);
     Iid iid = {.page_no = file_hdr_->last_leaf_, .slot_no = node->get_size()};
     return iid;
 }
@@ -901,15 +1289,113 @@ Iid IxIndexHandle::leaf_begin() const {
     return iid;
 }
 Iid IxIndexHandle::leaf_begin(char* key)const{
-    Ctx ctx{Operation::FIND,file_hdr_->root_page_};
-    find_leaf_page(key,ctx);
-    int pos=ctx.back()->lower_bound(key);
-    if(pos==ctx.back()->get_size()){
+    // 非唯一索引从key相同的项中rid最小的开始，全0就是rid的最小编码
+    char entry[IX_MAX_COL_LEN];
+    if (!file_hdr_->unique_) {
+        int len=file_hdr_->user_key_len();
+        memcpy(entry,key,len);
+        memset(entry+len,0,sizeof(Rid));
+        key=entry;
+    }
+    return leaf_seek(key,false);
+}
+
+Iid IxIndexHandle::leaf_upper(char *key) const {
+    // 非唯一索引跳过key相同的所有项，全0xFF是rid的最大编码
+    char entry[IX_MAX_COL_LEN];
+    if (!file_hdr_->unique_) {
+        int len=file_hdr_->user_key_len();
+        memcpy(entry,key,len);
+        memset(entry+len,0xFF,sizeof(Rid));
+        key=entry;
+    }
+    return leaf_seek(key,true);
+}
+
+Iid IxIndexHandle::leaf_seek(const char *key, bool after) const {
+    char buf[IX_MAX_COL_LEN];
+    memcpy(buf,key,file_hdr_->col_tot_len_);
+    Ctx ctx{Operation::FIND};
+    find_leaf_page(buf,ctx);
+    auto &node=ctx.back();
+    int pos=node->lower_bound(buf);
+    if (after && pos<node->get_size() && node->compare_key_at(pos,buf)==0) {
+        pos++;
+    }
+    if (pos==node->get_size()) {
+        // 叶子末尾的下一项在右兄弟的开头，最右叶子的末尾就是leaf_end
+        if (node->has_right_sibling()) {
+            return {node->get_next_leaf(),0};
+        }
+        ctx.Drop();
         return leaf_end();
     }
-    Iid iid={ctx.back()->get_page_no(),pos};
-    return iid;
+    return {node->get_page_no(),pos};
 }
+
+/**
+ * @brief 反向遍历时把iid移到前一项
+ * prev_leaf只作为提示：先释放当前叶子再锁左兄弟（避免与从左到右加锁的写者死锁），
+ * 左兄弟在此期间被分裂或回收时，next_leaf不再指向当前叶子，改为按当前叶子低键的前驱重新下降
+ */
+bool IxIndexHandle::prev_iid(Iid &iid) const {
+    if (iid.slot_no>0) {
+        iid.slot_no--;
+        return true;
+    }
+    int len=file_hdr_->col_tot_len_;
+    char low[IX_MAX_COL_LEN];
+    PageID page_no=iid.page_no;
+    while (true) {
+        PageID prev;
+        {
+            auto node=fetch_node(page_no, LatchMode::READ);
+            memcpy(low,node->get_low_key(),len);
+            prev=node->get_prev_leaf();
+        }
+        std::unique_ptr<IxNodeHandle> left;
+        if (prev!=INVALID_PAGE_ID && prev!=IX_LEAF_HEADER_PAGE) {
+            left=fetch_node(prev, LatchMode::READ);
+            if (left->is_deleted() || !left->is_leaf_page() || left->get_next_leaf()!=page_no) {
+                left.reset();
+            }
+        }
+        if (left==nullptr) {
+            // 第一个叶子的低键全为0，没有前驱
+            if (!ix_key_decrement(low,len)) {
+                return false;
+            }
+            Ctx ctx{Operation::FIND};
+            find_leaf_page(low,ctx);
+            left=std::move(ctx.back());
+            ctx.pop_back();
+            ctx.Drop();
+        }
+        if (left->get_size()>0) {
+            iid={left->get_page_no(),left->get_size()-1};
+            return true;
+        }
+        page_no=left->get_page_no();
+    }
+}
+
+bool IxIndexHandle::empty() {
+    std::shared_lock<std::shared_mutex> root_lock(root_latch_);
+    auto root = fetch_node(file_hdr_->root_page_, LatchMode::READ);
+    return root->is_leaf_page() && root->get_size() == 0;
+}
+
+int IxIndexHandle::get_height() {
+    std::shared_lock<std::shared_mutex> root_lock(root_latch_);
+    int height=1;
+    auto node=fetch_node(file_hdr_->root_page_, LatchMode::READ);
+    while (!node->is_leaf_page()) {
+        node=fetch_node(node->value_at(0), LatchMode::READ);
+        height++;
+    }
+    return height;
+}
+
 /**
  * @brief 获取一个指定结点
  *
@@ -918,12 +1404,30 @@ Iid IxIndexHandle::leaf_begin(char* key)const{
  * @note pin the page, remember to unpin it outside!
  */
 
-std::unique_ptr<IxNodeHandle>IxIndexHandle::fetch_node(int page_no) const {
+std::unique_ptr<IxNodeHandle>IxIndexHandle::fetch_node(int page_no, LatchMode mode) const {
     // TODO(ZMY) 将Page*换成了BasicPageGuard避免手动UnpinPage
     // Page *page = buffer_pool_manager_->fetch_page(PageId{fd_, page_no});
     // IxNodeHandle *node = new IxNodeHandle(file_hdr_, page);
     auto page=buffer_pool_manager_->FetchPageBasic(PageId{fd_, page_no});
-    return std::make_unique<IxNodeHandle>(file_hdr_, std::move(page));
+    auto node=std::make_unique<IxNodeHandle>(file_hdr_, std::move(page));
+    node->latch(mode);
+    return node;
+}
+
+/**
+ * @brief 在持有node写锁时锁住它的左兄弟
+ * 同一层的结点都按从左到右的顺序加锁，因此先释放node（保留pin），锁住左兄弟后再重新锁node。
+ * 调用者持有父结点的写锁并处于SmoGuard中，其他写者在间隙中无法修改node，但调用者仍应在重新加锁后再读取node
+ *
+ * @param node 持有写锁的结点，返回时仍持有写锁
+ * @param left_page_id 父结点中记录的左兄弟
+ * @return 持有写锁的左兄弟
+ */
+std::unique_ptr<IxNodeHandle> IxIndexHandle::latch_left_sibling(std::unique_ptr<IxNodeHandle> &node, PageID left_page_id) {
+    node->latch(LatchMode::NONE);
+    auto left_node=fetch_node(left_page_id, LatchMode::WRITE);
+    node->latch(LatchMode::WRITE);
+    return left_node;
 }
 
 /**
@@ -938,9 +1442,62 @@ std::unique_ptr<IxNodeHandle>IxIndexHandle::fetch_node(int page_no) const {
  */
 
 std::unique_ptr<IxNodeHandle> IxIndexHandle::create_node(int* page_no){
-    file_hdr_->num_pages_++;
+    auto page=create_page(page_no);
+    // 新结点链接进树之前就加写锁，沿B-link右移的读者要等它初始化完成
+    auto node=std::make_unique<IxNodeHandle>(file_hdr_,std::move(page));
+    node->latch(LatchMode::WRITE);
+    return node;
+}
+
+/**
+ * @brief 在索引文件中分配一个新页面
+ */
+PageGuard IxIndexHandle::create_page(int* page_no){
+    {
+        std::lock_guard<std::mutex> lock(hdr_latch_);
+        file_hdr_->num_pages_++;
+    }
     PageId new_page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
     auto page=buffer_pool_manager_->NewPageGuarded(&new_page_id);
     *page_no=new_page_id.page_no;
-    return std::make_unique<IxNodeHandle>(file_hdr_,std::move(page));
+    return page;
+}
+
+/**
+ * @brief 丢弃B+树的全部结点，恢复为刚创建时的状态：根结点为空的叶子，没有空闲页面
+ * @note 要求没有并发访问。原有结点的页面从缓冲池中丢弃，文件截断到初始大小，之后分配的页面从IX_INIT_NUM_PAGES开始。
+ * 回收结点会减少num_pages_但页号不会被重新分配，因此按已经分配过的页号丢弃
+ */
+void IxIndexHandle::reset(){
+    PageID end=disk_manager_->get_fd2pageno(fd_);
+    for(PageID page_no=IX_INIT_NUM_PAGES;page_no<end;page_no++){
+        if (!buffer_pool_manager_->delete_page(PageId{fd_, page_no})) {
+            throw InternalError("Index page " + std::to_string(page_no) + " is still pinned");
+        }
+    }
+    disk_manager_->truncate_file(fd_, IX_INIT_NUM_PAGES);
+    disk_manager_->set_fd2pageno(fd_, IX_INIT_NUM_PAGES);
+    file_hdr_->num_pages_=IX_INIT_NUM_PAGES;
+    file_hdr_->first_free_page_no_=IX_NO_PAGE;
+    file_hdr_->first_leaf_=IX_INIT_ROOT_PAGE;
+    file_hdr_->last_leaf_=IX_INIT_ROOT_PAGE;
+    update_root_page_no(IX_INIT_ROOT_PAGE);
+    auto root=fetch_node(IX_INIT_ROOT_PAGE);
+    root->Init(true);
+    root->set_prev_leaf(IX_LEAF_HEADER_PAGE);
+    root->set_next_leaf(IX_LEAF_HEADER_PAGE);
+}
+
+/**
+ * @brief 回收一个已经从树中摘除的结点
+ * @note 先标记为已回收再释放，已经pin住该结点的并发下降会看到标记并从根重试；
+ * 仍被pin住的页面不会被缓冲池回收，page_no也不会被重新分配
+ */
+void IxIndexHandle::delete_node(std::unique_ptr<IxNodeHandle> &node){
+    node->set_deleted();
+    auto page_id=node->get_page_id();
+    node.reset();
+    buffer_pool_manager_->delete_page(page_id);
+    std::lock_guard<std::mutex> lock(hdr_latch_);
+    --file_hdr_->num_pages_;
 }
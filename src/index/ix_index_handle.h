@@ -14,18 +14,23 @@ See the Mulan PSL v2 for more details. */
 #include "common/config.h"
 #include "common/context.h"
 #include "ix_defs.h"
+#include "ix_hash_table.h"
+#include "ix_key.h"
+#include "ix_node_search.h"
 #include "storage/page.h"
 #include "storage/page_guard.h"
 #include "transaction/transaction.h"
+#include <atomic>
 #include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 
 
 enum class Operation { FIND = 0, INSERT, DELETE };  // 三种操作：查找、插入、删除
 
-static const bool binary_search = false;
-
 inline int ix_compare(const char *a, const char *b, ColType type, int col_len) {
     switch (type) {
         case TYPE_INT: {
@@ -53,16 +58,6 @@ inline int ix_compare(const char *a, const char *b, ColType type, int col_len) {
     }
 }
 
-inline int ix_compare(const char* a, const char* b, const std::vector<ColType>& col_types, const std::vector<int>& col_lens) {
-    int offset = 0;
-    for(size_t i = 0; i < col_types.size(); ++i) {
-        int res = ix_compare(a + offset, b + offset, col_types[i], col_lens[i]);
-        if(res != 0) return res;
-        offset += col_lens[i];
-    }
-    return 0;
-}
-
 /* 管理B+树中的每个节点 */
 class IxNodeHandle {
     friend class IxIndexHandle;
@@ -74,31 +69,43 @@ class IxNodeHandle {
     PageGuard page;
     // 存储节点的页面
     IxPageHdr *page_hdr;            // page->data的第一部分，指针指向首地址，长度为sizeof(IxPageHdr)
-    char *keys;                     // page->data的第二部分，指针指向首地址，长度为file_hdr->keys_size，每个key的长度为file_hdr->col_len
-    Rid *rids;                      // page->data的第三部分，指针指向首地址
+    char *data;                     // page->data的首地址，低键、高键、rids、key后缀的位置见ix_node_capacity
+
+    // rids和key后缀的位置随prefix_len变化，乐观下降的读者在加锁前就构造了handle，因此每次现算
+    char *fences() const { return data + sizeof(IxPageHdr); }
+    Rid *rids() const { return reinterpret_cast<Rid *>(fences() + 2 * file_hdr->col_tot_len_); }
+    char *suffixes() const { return reinterpret_cast<char *>(rids() + page_hdr->capacity); }
+    int suffix_len() const { return file_hdr->col_tot_len_ - page_hdr->prefix_len; }
+    char *get_suffix(int key_idx) const { return suffixes() + key_idx * suffix_len(); }
 
    public:
     IxNodeHandle() = default;
 
     // TODO(ZMY)将Page*换成了BasicPageGuard避免手动UnpinPage
     IxNodeHandle(const IxFileHdr *file_hdr_, PageGuard&& page_) : file_hdr(file_hdr_), page(std::move(page_)) {
-        page_hdr = reinterpret_cast<IxPageHdr *>(page.get_data());
-        keys = page.get_data() + sizeof(IxPageHdr);
-        rids = reinterpret_cast<Rid *>(keys + file_hdr->keys_size_);
+        data = page.get_data();
+        page_hdr = reinterpret_cast<IxPageHdr *>(data);
     }
 
     inline void set_dirty(bool is_dirty){page.set_dirty(is_dirty);}
-    // 添加初始化函数
+    // 添加初始化函数，低键为全0（负无穷），高键为全0xFF（正无穷）
     void Init(bool is_leaf){
         page_hdr->num_key=0;
         page_hdr->is_leaf=is_leaf;
         page_hdr->prev_leaf=page_hdr->next_leaf=INVALID_PAGE_ID;
+        page_hdr->next_free_page_no=IX_NO_PAGE;
+        page_hdr->prefix_len=0;
+        page_hdr->capacity=ix_node_capacity(file_hdr->col_tot_len_, 0);
+        memset(get_low_key(), 0, file_hdr->col_tot_len_);
+        memset(get_high_key(), 0xFF, file_hdr->col_tot_len_);
     }
+    inline void latch(LatchMode mode){page.Latch(mode);}
+    inline LatchMode latch_mode()const{return page.latch_mode();}
     int get_size() { return page_hdr->num_key; }
 
     void set_size(int size) { page_hdr->num_key = size; }
 
-    int get_max_size() { return file_hdr->btree_order_ ; }
+    int get_max_size() { return page_hdr->capacity; }
     // 修改get_min_size
     int get_min_size() {
         if (!is_leaf_page()) {
@@ -107,7 +114,9 @@ class IxNodeHandle {
         }
         return get_max_size() / 2;
     }
-    int key_at(int i) { return *(int *)get_key(i); }
+
+    // 低键、高键改为low、high后结点的容量
+    int capacity_for(const char *low, const char *high) const { return file_hdr->node_capacity(low, high); }
 
     /* 得到第i个孩子结点的page_no */
     PageID value_at(int i) { return get_rid(i)->page_no; }
@@ -132,17 +141,66 @@ class IxNodeHandle {
 
     void set_parent_page_no(PageID parent) { page_hdr->parent = parent; }
 
-    char *get_key(int key_idx) const { return keys + key_idx * file_hdr->col_tot_len_; }
+    // 结点中只存key去掉公共前缀后的部分，取完整的key需要拼上低键中的前缀
+    void copy_key(int key_idx, char *dst) const {
+        memcpy(dst, get_low_key(), page_hdr->prefix_len);
+        memcpy(dst + page_hdr->prefix_len, get_suffix(key_idx), suffix_len());
+    }
+
+    // key已经按ix_key.h编码，直接按字节比较
+    int compare_key(const char *a, const char *b) const { return memcmp(a, b, file_hdr->col_tot_len_); }
+
+    // 比较第key_idx个key与完整的key
+    int compare_key_at(int key_idx, const char *key) const {
+        int cmp = memcmp(get_low_key(), key, page_hdr->prefix_len);
+        return cmp != 0 ? cmp : memcmp(get_suffix(key_idx), key + page_hdr->prefix_len, suffix_len());
+    }
+
+    Rid *get_rid(int rid_idx) const { return &rids()[rid_idx]; }
+
+    // key为完整的key，必须位于结点的[低键, 高键]之间
+    void set_key(int key_idx, const char *key) { memcpy(get_suffix(key_idx), key + page_hdr->prefix_len, suffix_len()); set_dirty(true);}
+
+    void set_rid(int rid_idx, const Rid &rid) { rids()[rid_idx] = rid; set_dirty(true);}
+
+    // B-link：最右的结点没有右兄弟，最右叶子的next_leaf指向leaf header
+    bool has_right_sibling() const {
+        return page_hdr->next_leaf != INVALID_PAGE_ID && page_hdr->next_leaf != IX_LEAF_HEADER_PAGE;
+    }
+
+    // 低键：结点子树中的key都不小于低键，即父结点中指向该结点的key
+    char *get_low_key() const { return fences(); }
+
+    // 高键：结点子树中的key都小于高键，右兄弟子树中的key都不小于高键
+    // 只有存在右兄弟时才用于右移，最右的结点高键为正无穷
+    char *get_high_key() const { return fences() + file_hdr->col_tot_len_; }
+
+    // 修改低键、高键，公共前缀变化时重新排布结点中的key，调用者保证修改后容量足够
+    void set_fences(const char *low, const char *high);
+
+    void set_low_key(const char *key) { set_fences(key, get_high_key()); }
+
+    void set_high_key(const char *key) { set_fences(get_low_key(), key); }
 
-    Rid *get_rid(int rid_idx) const { return &rids[rid_idx]; }
+    // key是否已经随分裂或借键移到了右兄弟中
+    bool need_move_right(const char *key) const {
+        return has_right_sibling() && compare_key(key, get_high_key()) >= 0;
+    }
+
+    // key是否在结点的[低键, 高键)范围内
+    bool covers(const char *key) const { return compare_key(get_low_key(), key) <= 0 && !need_move_right(key); }
+
+    bool is_deleted() const { return page_hdr->next_free_page_no == IX_NODE_DELETED; }
 
-    void set_key(int key_idx, const char *key) { memcpy(keys + key_idx * file_hdr->col_tot_len_, key, file_hdr->col_tot_len_); set_dirty(true);}
+    void set_deleted() { page_hdr->next_free_page_no = IX_NODE_DELETED; set_dirty(true); }
 
-    void set_rid(int rid_idx, const Rid &rid) { rids[rid_idx] = rid; set_dirty(true);}
+    int lower_bound(const char *target) const;
 
-    int lower_bound(char *target) const;
+    // key为n个连续存放的完整key
+    void insert_pairs(int pos, const char *key, const Rid *rid, int n);
 
-    void insert_pairs(int pos, char *key, const Rid *rid, int n);
+    // 插入src中从src_pos开始的n个键值对，两个结点前缀相同时直接复制后缀
+    void insert_pairs_from(int pos, const IxNodeHandle &src, int src_pos, int n);
 
     PageID internal_lookup(char *key);
 
@@ -152,7 +210,7 @@ class IxNodeHandle {
     int insert(char *key, const Rid &value);
 
     // 用于在结点中的指定位置插入单个键值对
-    void insert_pair(int pos, char *key, const Rid &rid) { insert_pairs(pos, key, &rid, 1); }
+    void insert_pair(int pos, const char *key, const Rid &rid) { insert_pairs(pos, key, &rid, 1); }
     void internal_insert_pair(int pos,char*key,Rid rid);
     void internal_insert_pairs(int pos,char* key,const std::vector<Rid>& rids_,int n);
     void erase_pair(int pos);
@@ -195,13 +253,18 @@ class Ctx;
 class IxIndexHandle {
     friend class IxScan;
     friend class IxManager;
+    friend class IxBulkBuilder;
+    friend class IxHashTable;
 
 private:
     DiskManager *disk_manager_;
     BufferPoolManager *buffer_pool_manager_;
     int fd_;                                    // 存储B+树的文件
     IxFileHdr* file_hdr_;                       // 存了root_page，但其初始化为2（第0页存FILE_HDR_PAGE，第1页存LEAF_HEADER_PAGE）
-    std::mutex root_latch_;
+    mutable std::shared_mutex root_latch_;      // 保护root_page_，悲观写操作在根结点可能被修改期间持有写锁
+    std::mutex hdr_latch_;                      // 保护file_hdr_中的页面计数
+    std::atomic<uint64_t> smo_version_{0};      // 借键、合并等删除引起的结构修改开始和结束时各加一
+    std::unique_ptr<IxHashTable> hash_;         // 哈希索引时不为空，查找、插入、删除都交给它
 
 public:
     IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd);
@@ -210,6 +273,7 @@ public:
     bool get_value(char *key, std::vector<Rid> *result, std::shared_ptr<Transaction> transaction);
     // 修改定义，不需要返回根节点是否加锁
     void find_leaf_page(char *key, Ctx&ctx , std::shared_ptr<Transaction>transaction=nullptr)const;
+    bool find_leaf_optimistic(char *key, Ctx &ctx, LatchMode leaf_mode) const;
     // for insert
     bool insert_entry(char *key, const Rid &value, std::shared_ptr<Transaction>transaction);
 
@@ -218,7 +282,11 @@ public:
     void split_internal_node(Ctx&ctx);
 
     // for delete
-    bool delete_entry(char *key, std::shared_ptr<Transaction> transaction);
+    // rid只用于非唯一索引定位要删除的项
+    bool delete_entry(char *key, const Rid &rid, std::shared_ptr<Transaction> transaction);
+
+    // 批量等值查找：keys为n个升序连续存放的key，非唯一索引只含用户字段，对找到的每一项调用visit(key的下标, rid)
+    void lookup_many(const char *keys, int n, const std::function<void(int, const Rid &)> &visit) const;
     Iid lower_bound(const char *key);
 
     Iid upper_bound(const char *key);
@@ -229,6 +297,18 @@ public:
 
     Iid leaf_begin(char* key)const;
 
+    // 第一个大于key的项，非唯一索引的key只含用户字段，与key相等的项都跳过
+    Iid leaf_upper(char *key) const;
+
+    // 索引中没有任何key
+    bool empty();
+
+    // 树高，只有一个叶子时为1
+    int get_height();
+
+    // 丢弃全部结点，恢复为刚创建时只有一个空的根结点的状态，之后可以重新批量构建
+    void reset();
+
     inline void lock(){root_latch_.lock();}
     inline void unlock(){root_latch_.unlock();}
     PageID get_root_page_id(){return file_hdr_->root_page_;};
@@ -246,6 +326,20 @@ public:
     DiskManager* get_disk_mgr(){return disk_manager_;}
     IxFileHdr* get_ix_file_hdr(){return file_hdr_;}
     int get_fd(){return fd_;}
+    bool is_hash() const { return hash_ != nullptr; }
+    bool is_unique() const { return file_hdr_->unique_; }
+
+    // 索引中实际存放的key：唯一索引就是key本身，非唯一索引在key后追加rid，buf至少IX_MAX_COL_LEN字节
+    char *entry_key(char *key, const Rid &rid, char *buf) const {
+        if (file_hdr_->unique_) {
+            return key;
+        }
+        int len = file_hdr_->user_key_len();
+        memmove(buf, key, len);
+        ix_encode_rid(rid, buf + len);
+        return buf;
+    }
+    IxHashTable* get_hash_table(){return hash_.get();}
 private:
     // 辅助函数
     void update_root_page_no(PageID root) { file_hdr_->root_page_ = root; }
@@ -254,11 +348,27 @@ private:
     bool is_empty() const { return file_hdr_->root_page_ == IX_INIT_ROOT_PAGE && file_hdr_->first_leaf_==IX_INIT_ROOT_PAGE; }
 
     // 使用智能指针进行内存管理
-    std::unique_ptr<IxNodeHandle> fetch_node(int page_no)const;
+    std::unique_ptr<IxNodeHandle> fetch_node(int page_no, LatchMode mode = LatchMode::NONE)const;
     std::unique_ptr<IxNodeHandle> create_node(int* page_no);
+    PageGuard create_page(int* page_no);
+    void delete_node(std::unique_ptr<IxNodeHandle> &node);
+    std::unique_ptr<IxNodeHandle> latch_left_sibling(std::unique_ptr<IxNodeHandle> &node, PageID left_page_id);
+
+    bool get_duplicates(char *key, std::vector<Rid> *result) const;
+
+    std::unique_ptr<IxNodeHandle> descend_from_path(char *key, std::vector<PageID> &path, uint64_t &version) const;
 
     // for index test
     Rid get_rid(const Iid &iid) const;
+
+    // 读出iid处的key（含非唯一索引追加的rid）和rid，key至少IX_MAX_COL_LEN字节
+    Rid get_entry(const Iid &iid, char *key) const;
+
+    // 把iid移到前一项，iid已是第一项时返回false
+    bool prev_iid(Iid &iid) const;
+
+    // 第一个不小于（after为true时大于）key的项，key为完整的项
+    Iid leaf_seek(const char *key, bool after) const;
 };
 
 // TODO(郑卯杨) 添加自定义上下文类 来记录加锁过程
@@ -269,6 +379,10 @@ public:
     Operation opt;
     // 保存根结点ID
     PageID root_page_id_{INVALID_PAGE_ID};
+    // 悲观写操作持有的root_latch_，根结点离开write_时释放；必须声明在write_之前，保证析构时先释放结点
+    std::unique_lock<std::shared_mutex> root_lock_;
+    // 乐观下降开始时的smo_version_
+    uint64_t version_{0};
     // 节点管理
     std::deque<std::unique_ptr<IxNodeHandle>> write_;
     // 函数
@@ -278,12 +392,22 @@ public:
     // 释放所有结点
     void Drop(){
         write_.clear();
+        if (root_lock_.owns_lock()) {
+            root_lock_.unlock();
+        }
     }
 
     // 释放不需要的结点
     void Release(){
         auto release=[&](){
+            if (write_.size() < 2) {
+                return;
+            }
             write_.erase(write_.begin(),--write_.end());
+            // 根结点总是write_中的第一个结点，祖先结点被释放后根结点一定不在write_中
+            if (root_lock_.owns_lock()) {
+                root_lock_.unlock();
+            }
         };
         auto size=write_.size();
         if(size==0){return;}
@@ -0,0 +1,145 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "defs.h"
+#include "errors.h"
+#include "system/sm_meta.h"
+
+/**
+ * 索引key的编码：每个字段从记录中的存储格式转换为可按字节比较的格式，整个key按字段顺序拼接，
+ * 两个key的大小关系与逐字段比较原值的结果相同，因此B+树、排序等只需要memcmp
+ * INT/BIGINT：符号位取反后按大端存储
+ * FLOAT：非负数符号位取反，负数全部位取反，再按大端存储；-0.0与0.0编码相同
+ * STRING/DATETIME：本身按字节比较，原样复制
+ * 全0的字节串是每种类型的最小值，可用于构造只包含前缀字段的查找key
+ */
+
+namespace ix_key_detail {
+
+template <typename T>
+inline T bswap(T val) {
+    if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+        return __builtin_bswap32(val);
+    } else {
+        return __builtin_bswap64(val);
+    }
+}
+
+template <typename T>
+inline T load(const char *src) {
+    T val;
+    memcpy(&val, src, sizeof(T));
+    return val;
+}
+
+template <typename T>
+inline void store(char *dst, T val) {
+    memcpy(dst, &val, sizeof(T));
+}
+
+/* U为与字段等长的无符号整数 */
+template <typename U>
+inline void encode_int(const char *src, char *dst) {
+    constexpr U sign = U(1) << (sizeof(U) * 8 - 1);
+    store<U>(dst, bswap<U>(load<U>(src) ^ sign));
+}
+
+template <typename U>
+inline void decode_int(const char *src, char *dst) {
+    constexpr U sign = U(1) << (sizeof(U) * 8 - 1);
+    store<U>(dst, bswap<U>(load<U>(src)) ^ sign);
+}
+
+}  // namespace ix_key_detail
+
+/* 把一个字段从存储格式编码到dst，src与dst可以相同 */
+inline void ix_encode_col(ColType type, int len, const char *src, char *dst) {
+    using namespace ix_key_detail;
+    switch (type) {
+        case TYPE_INT:
+            encode_int<std::uint32_t>(src, dst);
+            break;
+        case TYPE_BIGINT:
+            encode_int<std::uint64_t>(src, dst);
+            break;
+        case TYPE_FLOAT: {
+            float val = load<float>(src);
+            std::uint32_t bits;
+            val = val == 0 ? 0.0f : val;
+            memcpy(&bits, &val, sizeof(bits));
+            bits = (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+            store<std::uint32_t>(dst, bswap<std::uint32_t>(bits));
+            break;
+        }
+        case TYPE_STRING:
+        case TYPE_DATETIME:
+            memmove(dst, src, len);
+            break;
+        default:
+            throw InternalError("Unexpected data type");
+    }
+}
+
+/* ix_encode_col的逆变换，src与dst可以相同 */
+inline void ix_decode_col(ColType type, int len, const char *src, char *dst) {
+    using namespace ix_key_detail;
+    switch (type) {
+        case TYPE_INT:
+            decode_int<std::uint32_t>(src, dst);
+            break;
+        case TYPE_BIGINT:
+            decode_int<std::uint64_t>(src, dst);
+            break;
+        case TYPE_FLOAT: {
+            std::uint32_t bits = bswap<std::uint32_t>(load<std::uint32_t>(src));
+            bits = (bits & 0x80000000u) ? bits & ~0x80000000u : ~bits;
+            store<std::uint32_t>(dst, bits);
+            break;
+        }
+        case TYPE_STRING:
+        case TYPE_DATETIME:
+            memmove(dst, src, len);
+            break;
+        default:
+            throw InternalError("Unexpected data type");
+    }
+}
+
+/* 从记录rec中按索引字段拼出编码后的key */
+inline void ix_make_key(const std::vector<ColMeta> &cols, const char *rec, char *key) {
+    for (auto &col : cols) {
+        ix_encode_col(col.type, col.len, rec + col.offset, key);
+        key += col.len;
+    }
+}
+
+/* 非唯一索引在key后追加rid使每一项唯一，rid按(page_no, slot_no)编码，key相同的项按rid排列 */
+inline void ix_encode_rid(const Rid &rid, char *dst) {
+    ix_encode_col(TYPE_INT, sizeof(int), (const char *)&rid.page_no, dst);
+    ix_encode_col(TYPE_INT, sizeof(int), (const char *)&rid.slot_no, dst + sizeof(int));
+}
+
+/* 把key改为按字节序紧邻的前一个key，用于求比key小的最大项所在的叶子；key全为0时没有前驱，返回false */
+inline bool ix_key_decrement(char *key, int len) {
+    for (int i = len - 1; i >= 0; i--) {
+        if (key[i] != 0) {
+            key[i]--;
+            memset(key + i + 1, 0xFF, len - i - 1);
+            return true;
+        }
+    }
+    return false;
+}
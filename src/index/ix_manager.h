@@ -54,44 +54,50 @@ public:
         return disk_manager_->is_file(ix_name);
     }
 
-    IndexMeta create_index(const std::string &filename, const std::vector<ColMeta>& index_cols) {
+    IndexMeta create_index(const std::string &filename, const std::vector<ColMeta>& index_cols,
+                           IndexType index_type = INDEX_BTREE, bool unique = true) {
         std::string ix_name = get_index_name(filename, index_cols);
         // Create index file
         disk_manager_->create_file(ix_name);
         // Open index file
         int fd = disk_manager_->open_file(ix_name);
 
-        // Create file header and write to file
-        // Theoretically we have: |page_hdr| + (|attr| + |rid|) * n <= PAGE_SIZE
-        // but we reserve one slot for convenient inserting and deleting, i.e.
-        // |page_hdr| + (|attr| + |rid|) * (n + 1) <= PAGE_SIZE
         int col_tot_len = 0;
         int col_num = index_cols.size();
         for(auto& col: index_cols) {
             col_tot_len += col.len;
         }
-        if (col_tot_len > IX_MAX_COL_LEN) {
-            throw InvalidColLengthError(col_tot_len);
+        // 非唯一索引中存放的key后追加了rid
+        int key_len = unique ? col_tot_len : col_tot_len + static_cast<int>(sizeof(Rid));
+        if (key_len > IX_MAX_COL_LEN) {
+            throw InvalidColLengthError(key_len);
         }
         IndexMeta index_meta = { .tab_name = filename,
                 .col_tot_len = col_tot_len,
                 .col_num = col_num,
                 .cols = index_cols,
+                .type = index_type,
+                .unique = unique,
         };
 
-        // 根据 |page_hdr| + (|attr| + |rid|) * (n + 1) <= PAGE_SIZE 求得n的最大值btree_order
-        // 即 n <= btree_order，那么btree_order就是每个结点最多可插入的键值对数量（实际还多留了一个空位，但其不可插入）
-        int btree_order = static_cast<int>((PAGE_SIZE - sizeof(IxPageHdr)) / (col_tot_len + sizeof(Rid)) - 1);
+        // 根据 |page_hdr| + 2 * |attr| + (|attr| + |rid|) * n <= PAGE_SIZE 求得n的最大值btree_order
+        // 两个|attr|为结点的低键和高键，btree_order是不压缩前缀时每个结点最多可插入的键值对数量
+        int btree_order = ix_node_capacity(key_len, 0);
         assert(btree_order > 2);
 
         // Create file header and write to file
         IxFileHdr* fhdr = new IxFileHdr(IX_NO_PAGE, IX_INIT_NUM_PAGES, IX_INIT_ROOT_PAGE,
-                                        col_num, col_tot_len, btree_order, (btree_order + 1) * col_tot_len,
+                                        col_num, key_len, btree_order, btree_order * key_len,
                                         IX_INIT_ROOT_PAGE, IX_INIT_ROOT_PAGE);
         for(int i = 0; i < col_num; ++i) {
             fhdr->col_types_.push_back(index_cols[i].type);
             fhdr->col_lens_.push_back(index_cols[i].len);
         }
+        fhdr->index_type_ = index_type;
+        fhdr->unique_ = unique;
+        if (index_type == INDEX_HASH) {
+            fhdr->num_pages_ = IX_HASH_INIT_NUM_PAGES;
+        }
         fhdr->update_tot_len();
 
         char* data = new char[fhdr->tot_len_];
@@ -102,6 +108,11 @@ public:
         delete  fhdr;
         char page_buf[PAGE_SIZE];  // 在内存中初始化page_buf中的内容，然后将其写入磁盘
         memset(page_buf, 0, PAGE_SIZE);
+        if (index_type == INDEX_HASH) {
+            create_hash_pages(fd, page_buf);
+            disk_manager_->close_file(fd);
+            return index_meta;
+        }
         // 注意leaf header页号为1，也标记为叶子结点，其前一个/后一个叶子均指向root node
         // Create leaf list header page and write to file
         {
@@ -129,7 +140,11 @@ public:
                     .is_leaf = true,
                     .prev_leaf = IX_LEAF_HEADER_PAGE,
                     .next_leaf = IX_LEAF_HEADER_PAGE,
+                    .prefix_len = 0,
+                    .capacity = btree_order,
             };
+            // 低键为全0，高键为全0xFF
+            memset(page_buf + sizeof(IxPageHdr) + key_len, 0xFF, key_len);
             // Must write PAGE_SIZE here in case of future fetch_node()
             disk_manager_->write_page(fd, IX_INIT_ROOT_PAGE, page_buf, PAGE_SIZE);
         }
@@ -141,6 +156,34 @@ public:
         return index_meta;
     }
 
+    bool is_current(int fd) {
+        char hdr[sizeof(int) * 2];
+        disk_manager_->read_page(fd, IX_FILE_HDR_PAGE, hdr, sizeof(hdr));
+        return IxFileHdr::is_current(hdr);
+    }
+
+    // 哈希索引的初始页面：全局深度为0，唯一的目录项指向一个空桶
+    void create_hash_pages(int fd, char *page_buf) {
+        {
+            memset(page_buf, 0, PAGE_SIZE);
+            auto hdr = reinterpret_cast<IxHashHdr *>(page_buf);
+            hdr->global_depth = 0;
+            hdr->num_dir_pages = 1;
+            hdr->dir_pages[0] = IX_HASH_INIT_DIR_PAGE;
+            disk_manager_->write_page(fd, IX_HASH_HEADER_PAGE, page_buf, PAGE_SIZE);
+        }
+        {
+            memset(page_buf, 0, PAGE_SIZE);
+            reinterpret_cast<page_id_t *>(page_buf)[0] = IX_HASH_INIT_BUCKET_PAGE;
+            disk_manager_->write_page(fd, IX_HASH_INIT_DIR_PAGE, page_buf, PAGE_SIZE);
+        }
+        {
+            memset(page_buf, 0, PAGE_SIZE);
+            disk_manager_->write_page(fd, IX_HASH_INIT_BUCKET_PAGE, page_buf, PAGE_SIZE);
+        }
+        disk_manager_->set_fd2pageno(fd, IX_HASH_INIT_NUM_PAGES - 1);
+    }
+
     void destroy_index(const std::string &filename, const std::vector<ColMeta>& index_cols) {
         std::string ix_name = get_index_name(filename, index_cols);
         disk_manager_->destroy_file(ix_name);
@@ -153,14 +196,31 @@ public:
 
     // 注意这里打开文件，创建并返回了index file handle的指针
     std::unique_ptr<IxIndexHandle> open_index(const std::string &filename, const std::vector<ColMeta>& index_cols) {
-        std::string ix_name = get_index_name(filename, index_cols);
-        int fd = disk_manager_->open_file(ix_name);
-        return std::make_unique<IxIndexHandle>(disk_manager_, buffer_pool_manager_, fd);
+        return open_index(get_index_name(filename, index_cols));
     }
 
     std::unique_ptr<IxIndexHandle> open_index(const std::string &filename, const std::vector<std::string>& index_cols) {
-        std::string ix_name = get_index_name(filename, index_cols);
+        return open_index(get_index_name(filename, index_cols));
+    }
+
+    /**
+     * @description: 索引文件是否是当前的格式，在打开索引之前检查。旧版本文件的key编码和结点布局都不同，
+     *               不能打开，需要从表中的记录重新构建
+     */
+    bool is_current(const std::string &filename, const std::vector<std::string>& index_cols) {
+        int fd = disk_manager_->open_file(get_index_name(filename, index_cols));
+        bool current = is_current(fd);
+        disk_manager_->close_file(fd);
+        return current;
+    }
+
+    std::unique_ptr<IxIndexHandle> open_index(const std::string &ix_name) {
         int fd = disk_manager_->open_file(ix_name);
+        if (!is_current(fd)) {
+            disk_manager_->close_file(fd);
+            throw InternalError("Unsupported index file format " + ix_name + ", expected version " +
+                                std::to_string(IX_FILE_VERSION));
+        }
         return std::make_unique<IxIndexHandle>(disk_manager_, buffer_pool_manager_, fd);
     }
 
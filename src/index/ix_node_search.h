@@ -0,0 +1,136 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define IX_SEARCH_X86
+#endif
+
+/**
+ * 结点内查找第一个>=target的key，按key的布局在编译期特化：
+ * 单列INT/BIGINT的key按ix_key.h编码（大端、符号位取反），读出时还原为整数比较：
+ * 先用无分支二分把区间缩小到IX_LINEAR_SEARCH_THRESHOLD以内，再线性统计小于target的key数（支持时用AVX2）；
+ * 其余布局对整个区间做无分支二分，比较函数由模板参数传入
+ */
+namespace ix_search {
+
+constexpr int IX_LINEAR_SEARCH_THRESHOLD = 32;  // 剩余key数不超过该值时改为线性统计
+
+/* 读出编码后的整数key，还原为原值 */
+template <typename T>
+inline T load_key(const char *key) {
+    using U = std::make_unsigned_t<T>;
+    U val;
+    memcpy(&val, key, sizeof(T));
+    if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+        val = __builtin_bswap32(val);
+    } else {
+        val = __builtin_bswap64(val);
+    }
+    return static_cast<T>(val ^ (U(1) << (sizeof(T) * 8 - 1)));
+}
+
+/* 统计keys[0, n)中小于target的key数 */
+template <typename T>
+inline int count_less_scalar(const char *keys, int n, T target) {
+    int cnt = 0;
+    for (int i = 0; i < n; i++) {
+        cnt += load_key<T>(keys + i * sizeof(T)) < target;
+    }
+    return cnt;
+}
+
+#ifdef IX_SEARCH_X86
+inline bool has_avx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+// 每个元素内部字节逆序，再翻转符号位，得到原值
+__attribute__((target("avx2"))) inline int count_less_avx2(const char *keys, int n, std::int32_t target) {
+    const __m256i bswap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                           3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m256i sign = _mm256_set1_epi32(INT32_MIN);
+    __m256i t = _mm256_set1_epi32(target);
+    int cnt = 0;
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i * sizeof(std::int32_t)));
+        v = _mm256_xor_si256(_mm256_shuffle_epi8(v, bswap), sign);
+        __m256i lt = _mm256_cmpgt_epi32(t, v);
+        cnt += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(lt)));
+    }
+    return cnt + count_less_scalar<std::int32_t>(keys + i * sizeof(std::int32_t), n - i, target);
+}
+
+__attribute__((target("avx2"))) inline int count_less_avx2(const char *keys, int n, std::int64_t target) {
+    const __m256i bswap = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                           7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+    __m256i t = _mm256_set1_epi64x(target);
+    int cnt = 0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i * sizeof(std::int64_t)));
+        v = _mm256_xor_si256(_mm256_shuffle_epi8(v, bswap), sign);
+        __m256i lt = _mm256_cmpgt_epi64(t, v);
+        cnt += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(lt)));
+    }
+    return cnt + count_less_scalar<std::int64_t>(keys + i * sizeof(std::int64_t), n - i, target);
+}
+#endif
+
+template <typename T>
+inline int count_less(const char *keys, int n, T target) {
+#ifdef IX_SEARCH_X86
+    if (has_avx2()) {
+        return count_less_avx2(keys, n, target);
+    }
+#endif
+    return count_less_scalar<T>(keys, n, target);
+}
+
+/* 单列定长整数key，keys中的key紧密排列，target为原值，返回[l, r)中第一个>=target的位置 */
+template <typename T>
+inline int lower_bound_integral(const char *keys, int l, int r, T target) {
+    int base = l;
+    int len = r - l;
+    // 答案始终位于[base, base + len]中
+    while (len > IX_LINEAR_SEARCH_THRESHOLD) {
+        int half = len / 2;
+        base = load_key<T>(keys + (base + half) * sizeof(T)) < target ? base + half : base;
+        len -= half;
+    }
+    return base + count_less<T>(keys + base * sizeof(T), len, target);
+}
+
+/* 任意布局的key，less(key)表示key < target，返回[l, r)中第一个>=target的位置 */
+template <typename Less>
+inline int lower_bound(const char *keys, int key_len, int l, int r, Less less) {
+    int base = l;
+    int len = r - l;
+    if (len <= 0) {
+        return r;
+    }
+    while (len > 1) {
+        int half = len / 2;
+        base = less(keys + (base + half) * key_len) ? base + half : base;
+        len -= half;
+    }
+    return base + less(keys + base * key_len);
+}
+
+}  // namespace ix_search
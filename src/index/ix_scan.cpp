@@ -11,12 +11,16 @@ See the Mulan PSL v2 for more details. */
 #include "ix_scan.h"
 
 /**
- * @brief 
- * @todo 加上读锁（需要使用缓冲池得到page）
+ * @brief 持有当前叶子的读锁前进一个位置，到达叶子末尾时沿next_leaf进入下一个叶子；反向遍历时退到前一项
  */
 void IxScan::next() {
     assert(!is_end());
-    auto node = ih_->fetch_node(iid_.page_no);
+    if (reverse_) {
+        // lower已经遍历过，或者已经是第一项
+        done_ = iid_ == end_ || !ih_->prev_iid(iid_);
+        return;
+    }
+    auto node = ih_->fetch_node(iid_.page_no, LatchMode::READ);
     assert(node->is_leaf_page());
     assert(iid_.slot_no < node->get_size());
     // increment slot no
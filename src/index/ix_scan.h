@@ -17,28 +17,59 @@ See the Mulan PSL v2 for more details. */
 
 // 用于遍历叶子结点
 // 用于直接遍历叶子结点，而不用findleafpage来得到叶子结点
-// TODO：对page遍历时，要加上读锁
 class IxScan : public RecScan {
     friend class IndexScanExecutor;
     const IxIndexHandle *ih_;
     Iid iid_;  // 初始为lower（用于遍历的指针）
     Iid end_;  // 初始为upper
     BufferPoolManager *bpm_;
+    bool reverse_{false};  // 从upper的前一项向lower反向遍历，end_为lower
+    bool done_{false};     // 反向遍历是否结束
 
 public:
-    IxScan(const IxIndexHandle *ih, const Iid &lower, const Iid &upper, BufferPoolManager *bpm)
-            : ih_(ih), iid_(lower), end_(upper), bpm_(bpm) {
+    IxScan(const IxIndexHandle *ih, const Iid &lower, const Iid &upper, BufferPoolManager *bpm, bool reverse = false)
+            : ih_(ih), iid_(lower), end_(upper), bpm_(bpm), reverse_(reverse) {
+        if (reverse_) {
+            iid_ = upper;
+            end_ = lower;
+            done_ = lower == upper || !ih_->prev_iid(iid_);
+        }
     }
 
     void next() override;
 
     bool is_end() const override {
-        return iid_ == end_;
+        return reverse_ ? done_ : iid_ == end_;
     }
 
     Rid rid() const override;
 
+    // 当前位置的rid，同时把叶子中的key复制到key
+    Rid entry(char *key) const { return ih_->get_entry(iid_, key); }
+
     const Iid &iid() const { return iid_; }
 
-    void set_end(){iid_=end_;}
-};
\ No newline at end of file
+    void set_end() override {
+        if (reverse_) {
+            done_ = true;
+        } else {
+            iid_ = end_;
+        }
+    }
+};
+// 遍历哈希索引等值查找得到的rid
+class IxPointScan : public RecScan {
+    std::vector<Rid> rids_;
+    size_t pos_{0};
+
+public:
+    explicit IxPointScan(std::vector<Rid> rids) : rids_(std::move(rids)) {}
+
+    void next() override { pos_++; }
+
+    bool is_end() const override { return pos_ >= rids_.size(); }
+
+    Rid rid() const override { return rids_[pos_]; }
+
+    void set_end() override { pos_ = rids_.size(); }
+};
@@ -0,0 +1,481 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+/**
+ * B+树并发压力测试：多个线程并发插入、查找、删除同一个索引，结束后校验索引内容并输出吞吐量；
+ * 然后在长字符串key上分别关闭、开启结点前缀压缩建索引，对比树高和查找延迟；
+ * 再对可扩展哈希索引做同样的并发插入、查找、删除，与B+树的点查吞吐量对比；
+ * 最后在非唯一索引上插入大量重复key，校验等值查找返回全部重复项
+ * 用法：index_bench [线程数] [每个线程的key数量]
+ */
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "index/ix.h"
+#include "storage/buffer_pool_manager.h"
+#include "storage/disk_manager.h"
+
+namespace {
+
+const std::string BENCH_DB_NAME = "index_bench_db";
+const std::string BENCH_TAB_NAME = "bench";
+constexpr int BENCH_POOL_SIZE = 65536;
+constexpr int BENCH_WIDE_KEY_LEN = 64;
+constexpr int BENCH_WIDE_KEYS = 200000;     // 长字符串key的个数，与线程数无关，使两次建出的树高可以直接比较
+
+using Clock = std::chrono::steady_clock;
+
+std::atomic<bool> failed{false};
+
+void fail(const std::string &msg) {
+    if (!failed.exchange(true)) {
+        std::cerr << "index_bench: " << msg << std::endl;
+    }
+}
+
+/* 启动num_threads个线程执行work(thread_id)，返回耗时（毫秒） */
+double run_threads(int num_threads, const std::function<void(int)> &work) {
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; i++) {
+        threads.emplace_back(work, i);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void report(const std::string &phase, size_t ops, double ms) {
+    std::cout << phase << ": " << ops << " ops in " << (int64_t)ms << " ms ("
+              << (int64_t)(ms > 0 ? ops / ms * 1000 : 0) << " ops/s)" << std::endl;
+}
+
+/* 索引中的key按ix_key.h编码 */
+int encode(int key) {
+    int enc;
+    ix_encode_col(TYPE_INT, sizeof(int), (char *)&key, (char *)&enc);
+    return enc;
+}
+
+bool lookup(IxIndexHandle *ih, int key, Rid *rid) {
+    std::vector<Rid> result;
+    int enc = encode(key);
+    if (!ih->get_value((char *)&enc, &result, nullptr)) {
+        return false;
+    }
+    *rid = result[0];
+    return true;
+}
+
+/* 形如"https://example.com/users/0000012345"的长字符串key，不足部分补0，公共前缀很长 */
+std::string wide_key(int key) {
+    std::string str(BENCH_WIDE_KEY_LEN, '\0');
+    snprintf(str.data(), str.size(), "https://example.com/users/%010d", key);
+    return str;
+}
+
+/**
+ * 在长字符串key上建索引，输出树高和单线程查找延迟
+ * 随机插入num_keys个key再删除四分之一：不压缩时结点平均约38个key，压缩掉公共前缀后约66个，
+ * num_keys为BENCH_WIDE_KEYS时树高由4降为3；num_keys超过约38万后压缩的树也是4层
+ * 返回的索引由调用者最后统一关闭：缓冲池不会丢弃已关闭文件的页面，复用同一个fd的新索引会读到旧页面
+ */
+std::unique_ptr<IxIndexHandle> bench_prefix(IxManager *ix_manager, bool compress, int num_keys) {
+    std::string tab_name = compress ? "wide_prefix" : "wide_plain";
+    ColMeta col = {.tab_name = tab_name, .name = "name", .type = TYPE_STRING, .len = BENCH_WIDE_KEY_LEN,
+                   .offset = 0, .index = true};
+    std::vector<ColMeta> index_cols{col};
+    ix_manager->create_index(tab_name, index_cols);
+    auto ih = ix_manager->open_index(tab_name, index_cols);
+    ih->get_ix_file_hdr()->prefix_compress_ = compress;
+
+    std::vector<int> order(num_keys);
+    for (int i = 0; i < num_keys; i++) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(num_keys));
+    for (int key : order) {
+        auto str = wide_key(key);
+        if (!ih->insert_entry(str.data(), Rid{key, 0}, nullptr)) {
+            fail("wide insert failed for key " + std::to_string(key));
+        }
+    }
+    // 删除四分之一的key，触发借键与合并
+    for (int key = 0; key < num_keys; key += 4) {
+        auto str = wide_key(key);
+        if (!ih->delete_entry(str.data(), Rid{key, 0}, nullptr)) {
+            fail("wide delete failed for key " + std::to_string(key));
+        }
+    }
+
+    auto start = Clock::now();
+    for (int key : order) {
+        auto str = wide_key(key);
+        std::vector<Rid> result;
+        bool found = ih->get_value(str.data(), &result, nullptr);
+        if (found != (key % 4 != 0) || (found && result[0].page_no != key)) {
+            fail("wide lookup mismatch for key " + std::to_string(key));
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / num_keys;
+    std::cout << "prefix compression " << (compress ? "on" : "off") << ": height " << ih->get_height()
+              << ", lookup " << (int64_t)ns << " ns/op" << std::endl;
+    return ih;
+}
+
+/**
+ * 哈希索引：并发插入、并发查找，再并发删除四分之一的key后逐个校验
+ * 返回的索引由调用者最后统一关闭
+ */
+std::unique_ptr<IxIndexHandle> bench_hash(IxManager *ix_manager, int num_threads, int keys_per_thread) {
+    int num_keys = num_threads * keys_per_thread;
+    ColMeta col = {.tab_name = "hash", .name = "k", .type = TYPE_INT, .len = sizeof(int), .offset = 0,
+                   .index = true};
+    std::vector<ColMeta> index_cols{col};
+    ix_manager->create_index(col.tab_name, index_cols, INDEX_HASH);
+    auto ih = ix_manager->open_index(col.tab_name, index_cols);
+
+    double ms = run_threads(num_threads, [&](int t) {
+        for (int i = 0; i < keys_per_thread; i++) {
+            int key = i * num_threads + t;
+            int enc = encode(key);
+            if (!ih->insert_entry((char *)&enc, Rid{key, t}, nullptr)) {
+                fail("hash insert failed for key " + std::to_string(key));
+            }
+        }
+    });
+    report("hash insert", num_keys, ms);
+
+    ms = run_threads(num_threads, [&](int t) {
+        std::mt19937 rng(t);
+        for (int i = 0; i < keys_per_thread; i++) {
+            int key = rng() % num_keys;
+            Rid rid;
+            if (!lookup(ih.get(), key, &rid) || rid.page_no != key) {
+                fail("hash lookup failed for key " + std::to_string(key));
+            }
+        }
+    });
+    report("hash lookup", num_keys, ms);
+
+    ms = run_threads(num_threads, [&](int t) {
+        for (int key = 4 * t; key < num_keys; key += 4 * num_threads) {
+            int enc = encode(key);
+            if (!ih->delete_entry((char *)&enc, Rid{key, t}, nullptr)) {
+                fail("hash delete failed for key " + std::to_string(key));
+            }
+        }
+    });
+    report("hash delete", num_keys / 4, ms);
+
+    for (int key = 0; key < num_keys && !failed; key++) {
+        Rid rid;
+        if (lookup(ih.get(), key, &rid) != (key % 4 != 0)) {
+            fail("hash final lookup mismatch for key " + std::to_string(key));
+        }
+    }
+    std::cout << "hash global depth " << ih->get_hash_table()->get_global_depth() << std::endl;
+    return ih;
+}
+
+/**
+ * 非唯一索引：每个key重复BENCH_DUPLICATES次，并发插入后删除一半的rid，校验每个key的查找结果
+ * 返回的索引由调用者最后统一关闭
+ */
+std::unique_ptr<IxIndexHandle> bench_duplicates(IxManager *ix_manager, int num_threads, int keys_per_thread) {
+    constexpr int BENCH_DUPLICATES = 16;
+    int num_rows = num_threads * keys_per_thread;
+    int num_keys = num_rows / BENCH_DUPLICATES;
+    ColMeta col = {.tab_name = "dup", .name = "k", .type = TYPE_INT, .len = sizeof(int), .offset = 0,
+                   .index = true};
+    std::vector<ColMeta> index_cols{col};
+    ix_manager->create_index(col.tab_name, index_cols, INDEX_BTREE, false);
+    auto ih = ix_manager->open_index(col.tab_name, index_cols);
+
+    // 第row行的key为row % num_keys，rid为{row, 0}
+    double ms = run_threads(num_threads, [&](int t) {
+        for (int row = t; row < num_rows; row += num_threads) {
+            int enc = encode(row % std::max(num_keys, 1));
+            if (!ih->insert_entry((char *)&enc, Rid{row, 0}, nullptr)) {
+                fail("duplicate insert failed for row " + std::to_string(row));
+            }
+        }
+    });
+    report("duplicate insert", num_rows, ms);
+    run_threads(num_threads, [&](int t) {
+        for (int row = 2 * t; row < num_rows; row += 2 * num_threads) {
+            int enc = encode(row % std::max(num_keys, 1));
+            if (!ih->delete_entry((char *)&enc, Rid{row, 0}, nullptr)) {
+                fail("duplicate delete failed for row " + std::to_string(row));
+            }
+        }
+    });
+
+    auto start = Clock::now();
+    for (int key = 0; key < num_keys && !failed; key++) {
+        std::vector<Rid> result;
+        int enc = encode(key);
+        ih->get_value((char *)&enc, &result, nullptr);
+        std::vector<Rid> expected;
+        for (int row = key; row < num_rows; row += num_keys) {
+            if (row % 2 == 1) {
+                expected.push_back(Rid{row, 0});
+            }
+        }
+        if (result != expected) {
+            fail("duplicate lookup mismatch for key " + std::to_string(key));
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / std::max(num_keys, 1);
+    std::cout << "duplicate lookup: " << (int64_t)ns << " ns/key" << std::endl;
+
+    // 批量查找一次取回所有key的重复项，key相同的项可能跨越多个叶子
+    std::vector<int> keys(num_keys);
+    for (int key = 0; key < num_keys; key++) {
+        keys[key] = encode(key);
+    }
+    std::vector<std::vector<Rid>> results(num_keys);
+    ih->lookup_many((const char *)keys.data(), num_keys, [&](int i, const Rid &rid) { results[i].push_back(rid); });
+    for (int key = 0; key < num_keys && !failed; key++) {
+        size_t expected = 0;
+        for (int row = key; row < num_rows; row += num_keys) {
+            expected += row % 2 == 1;
+        }
+        if (results[key].size() != expected) {
+            fail("batched duplicate lookup mismatch for key " + std::to_string(key));
+        }
+    }
+    return ih;
+}
+
+/**
+ * 每批BENCH_BATCH个随机key排序后调用lookup_many，与逐个get_value比较结果和单key耗时
+ */
+void bench_batched_lookup(IxIndexHandle *ih, int num_keys, const std::function<bool(int)> &exists) {
+    constexpr int BENCH_BATCH = 256;
+    int num_batches = std::max(1, num_keys / BENCH_BATCH / 4);
+    std::mt19937 rng(42);
+    std::vector<std::vector<int>> batches(num_batches);
+    for (auto &batch : batches) {
+        for (int i = 0; i < BENCH_BATCH; i++) {
+            batch.push_back(rng() % num_keys);
+        }
+        std::sort(batch.begin(), batch.end());
+    }
+    auto start = Clock::now();
+    for (auto &batch : batches) {
+        for (int key : batch) {
+            Rid rid;
+            if (lookup(ih, key, &rid) != exists(key)) {
+                fail("single lookup mismatch for key " + std::to_string(key));
+            }
+        }
+    }
+    double single_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    start = Clock::now();
+    for (auto &batch : batches) {
+        std::vector<int> keys;
+        for (int key : batch) {
+            keys.push_back(encode(key));
+        }
+        std::vector<int> found(BENCH_BATCH, 0);
+        ih->lookup_many((const char *)keys.data(), BENCH_BATCH, [&](int i, const Rid &rid) {
+            found[i] += rid.page_no == batch[i];
+        });
+        for (int i = 0; i < BENCH_BATCH; i++) {
+            if ((found[i] == 1) != exists(batch[i])) {
+                fail("batched lookup mismatch for key " + std::to_string(batch[i]));
+            }
+        }
+    }
+    double batched_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    size_t total = (size_t)num_batches * BENCH_BATCH;
+    std::cout << "sorted lookup: " << (int64_t)(single_ns / total) << " ns/key single, "
+              << (int64_t)(batched_ns / total) << " ns/key batched" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    int num_threads = argc > 1 ? atoi(argv[1]) : 8;
+    int keys_per_thread = argc > 2 ? atoi(argv[2]) : 50000;
+    int num_keys = num_threads * keys_per_thread;
+
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(BENCH_POOL_SIZE, disk_manager.get());
+    auto ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
+    if (disk_manager->is_dir(BENCH_DB_NAME)) {
+        disk_manager->destroy_dir(BENCH_DB_NAME);
+    }
+    disk_manager->create_dir(BENCH_DB_NAME);
+    if (chdir(BENCH_DB_NAME.c_str()) < 0) {
+        throw UnixError();
+    }
+    ColMeta col = {.tab_name = BENCH_TAB_NAME, .name = "k", .type = TYPE_INT, .len = sizeof(int), .offset = 0,
+                   .index = true};
+    std::vector<ColMeta> index_cols{col};
+    ix_manager->create_index(BENCH_TAB_NAME, index_cols);
+    auto ih = ix_manager->open_index(BENCH_TAB_NAME, index_cols);
+
+    // 1. 并发插入：各线程的key交错分布，相邻的key由不同线程插入，叶子分裂时竞争激烈
+    double ms = run_threads(num_threads, [&](int t) {
+        for (int i = 0; i < keys_per_thread; i++) {
+            int key = i * num_threads + t;
+            int enc = encode(key);
+            if (!ih->insert_entry((char *)&enc, Rid{key, t}, nullptr)) {
+                fail("insert failed for key " + std::to_string(key));
+            }
+        }
+    });
+    report("insert", num_keys, ms);
+
+    // 2. 并发查找
+    ms = run_threads(num_threads, [&](int t) {
+        std::mt19937 rng(t);
+        for (int i = 0; i < keys_per_thread; i++) {
+            int key = rng() % num_keys;
+            Rid rid;
+            if (!lookup(ih.get(), key, &rid) || rid.page_no != key) {
+                fail("lookup failed for key " + std::to_string(key));
+            }
+        }
+    });
+    report("lookup", num_keys, ms);
+
+    // 3. 混合负载：一半线程删除奇数key并重新插入其中一部分，另一半线程查找始终存在的偶数key
+    int writers = std::max(1, num_threads / 2);
+    std::atomic<size_t> ops{0};
+    ms = run_threads(num_threads, [&](int t) {
+        size_t local_ops = 0;
+        if (t < writers) {
+            for (int key = 2 * t + 1; key < num_keys; key += 2 * writers) {
+                int enc = encode(key);
+                if (!ih->delete_entry((char *)&enc, Rid{key, t}, nullptr)) {
+                    fail("delete failed for key " + std::to_string(key));
+                }
+                local_ops++;
+                // 每4个奇数key中重新插入一个，交替触发合并与分裂
+                if (key % 8 == 1) {
+                    if (!ih->insert_entry((char *)&enc, Rid{key, t}, nullptr)) {
+                        fail("reinsert failed for key " + std::to_string(key));
+                    }
+                    local_ops++;
+                }
+            }
+        } else {
+            std::mt19937 rng(t);
+            for (int i = 0; i < keys_per_thread; i++) {
+                int key = (rng() % (num_keys / 2)) * 2;
+                Rid rid;
+                if (!lookup(ih.get(), key, &rid) || rid.page_no != key) {
+                    fail("concurrent lookup failed for key " + std::to_string(key));
+                }
+                local_ops++;
+            }
+        }
+        ops += local_ops;
+    });
+    report("mixed", ops, ms);
+
+    // 4. 校验：顺序扫描得到的key严格递增，且恰好是偶数key和模8余1的奇数key
+    auto is_expected = [](int key) { return key % 2 == 0 || key % 8 == 1; };
+    int expected = 0;
+    size_t scanned = 0;
+    IxScan scan(ih.get(), ih->leaf_begin(), ih->leaf_end(), buffer_pool_manager.get());
+    for (; !scan.is_end() && !failed; scan.next()) {
+        while (expected < num_keys && !is_expected(expected)) {
+            expected++;
+        }
+        Rid rid = scan.rid();
+        if (rid.page_no != expected) {
+            fail("scan returned key " + std::to_string(rid.page_no) + ", expected " + std::to_string(expected));
+            break;
+        }
+        scanned++;
+        expected++;
+    }
+    while (expected < num_keys && !is_expected(expected)) {
+        expected++;
+    }
+    if (!failed && expected < num_keys) {
+        fail("scan stopped early before key " + std::to_string(expected));
+    }
+    for (int key = 0; key < num_keys && !failed; key++) {
+        Rid rid;
+        if (lookup(ih.get(), key, &rid) != is_expected(key)) {
+            fail("final lookup mismatch for key " + std::to_string(key));
+        }
+    }
+    // 反向扫描沿prev_leaf得到同样的key，顺序相反
+    size_t reversed = 0;
+    int last = num_keys;
+    IxScan rscan(ih.get(), ih->leaf_begin(), ih->leaf_end(), buffer_pool_manager.get(), true);
+    for (; !rscan.is_end() && !failed; rscan.next()) {
+        Rid rid = rscan.rid();
+        if (rid.page_no >= last || !is_expected(rid.page_no)) {
+            fail("reverse scan returned key " + std::to_string(rid.page_no) + " after " + std::to_string(last));
+        }
+        last = rid.page_no;
+        reversed++;
+    }
+    if (!failed && reversed != scanned) {
+        fail("reverse scan returned " + std::to_string(reversed) + " keys, forward scan " + std::to_string(scanned));
+    }
+
+
+    // 5. 批量查找：排好序的一批key共用下降路径
+    if (!failed) {
+        bench_batched_lookup(ih.get(), num_keys, is_expected);
+    }
+
+    // 6. 前缀压缩：长字符串key关闭、开启压缩各建一次索引
+    std::vector<std::unique_ptr<IxIndexHandle>> ihs;
+    ihs.push_back(std::move(ih));
+    if (!failed) {
+        ihs.push_back(bench_prefix(ix_manager.get(), false, BENCH_WIDE_KEYS));
+        ihs.push_back(bench_prefix(ix_manager.get(), true, BENCH_WIDE_KEYS));
+    }
+
+    // 7. 可扩展哈希索引
+    if (!failed) {
+        ihs.push_back(bench_hash(ix_manager.get(), num_threads, keys_per_thread));
+    }
+
+    // 8. 非唯一索引
+    if (!failed) {
+        ihs.push_back(bench_duplicates(ix_manager.get(), num_threads, keys_per_thread));
+    }
+    for (auto &handle : ihs) {
+        ix_manager->close_index(handle.get());
+    }
+    ihs.clear();
+
+    if (chdir("..") < 0) {
+        throw UnixError();
+    }
+    disk_manager->destroy_dir(BENCH_DB_NAME);
+    if (failed) {
+        return 1;
+    }
+    std::cout << "verified " << scanned << " keys" << std::endl;
+    return 0;
+}
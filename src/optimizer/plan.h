@@ -39,9 +39,13 @@ typedef enum PlanTag{
     T_SeqScan,
     T_IndexScan,
     T_NestLoop,
+    T_IndexNLJoin,
+    T_HashJoin,
+    T_MergeJoin,
     T_Sort,
     T_Projection,
-    T_Aggre,
+    T_HashAggre,
+    T_StreamAggre,
     T_ShowIndex
 } PlanTag;
 
@@ -76,6 +80,11 @@ class ScanPlan : public Plan
         size_t len_;                               
         std::vector<Condition> fed_conds_;
         std::vector<std::string> index_col_names_;
+        bool covering_ = false;                    // 用到的字段都在索引key中，只读索引不回表
+        bool reverse_ = false;                     // 按索引的逆序扫描
+        int limit_ = -1;                           // 最多输出的记录数，-1表示不限制；索引扫描时按索引顺序输出
+        bool ordered_ = false;                     // 按索引顺序输出，供流式聚合使用
+        int dop_ = 1;                              // 顺序扫描的并行度，大于1时按morsel并行扫描
     
 };
 
@@ -99,7 +108,16 @@ class JoinPlan : public Plan
         std::vector<Condition> conds_;
         // future TODO: 后续可以支持的连接类型
         JoinType type;
-        
+        // T_IndexNLJoin：内表（左边或右边的基本表扫描）用来探查的索引
+        std::vector<std::string> index_col_names_;
+        bool inner_is_left_ = false;
+        // T_HashJoin：是否在左边建哈希表
+        bool build_left_ = false;
+        // T_MergeJoin：两边记录的排序字段，按顺序一一对应
+        std::vector<std::pair<TabCol, TabCol>> merge_keys_;
+        // T_HashJoin：并行度，大于1时probe端按流水线并行探查共享的哈希表
+        int dop_ = 1;
+
 };
 
 class ProjectionPlan : public Plan
@@ -114,6 +132,7 @@ class ProjectionPlan : public Plan
         ~ProjectionPlan(){}
         std::shared_ptr<Plan> subplan_;
         std::vector<TabCol> sel_cols_;
+        int limit_ = -1;                           // 最多输出的记录数，-1表示不限制
         
 };
 
@@ -135,17 +154,22 @@ class SortPlan : public Plan
         
 };
 
-class AggrePlan : public Plan
+// GROUP BY和聚合函数，T_StreamAggre要求子计划的输出按分组字段有序
+class GroupAggrePlan : public Plan
 {
 public:
-    AggrePlan(PlanTag tag, std::shared_ptr<Plan> subplan, std::shared_ptr<ast::AggreClause> aggreClause){
+    GroupAggrePlan(PlanTag tag, std::shared_ptr<Plan> subplan, std::vector<TabCol> group_cols,
+                   std::vector<std::shared_ptr<ast::AggreClause>> aggres) {
         Plan::tag = tag;
         subplan_ = std::move(subplan);
-        aggreClause_ = std::move(aggreClause);
+        group_cols_ = std::move(group_cols);
+        aggres_ = std::move(aggres);
     }
-    ~AggrePlan(){}
+    ~GroupAggrePlan(){}
     std::shared_ptr<Plan> subplan_;
-    std::shared_ptr<ast::AggreClause> aggreClause_;
+    std::vector<TabCol> group_cols_;
+    std::vector<std::shared_ptr<ast::AggreClause>> aggres_;
+    int dop_ = 1;                           // T_HashAggre的并行度，大于1时两阶段并行聚合
 };
 
 // dml语句，包括insert; delete; update; select语句　
@@ -186,6 +210,10 @@ class DDLPlan : public Plan
         std::string tab_name_;
         std::vector<std::string> tab_col_names_;
         std::vector<ColDef> cols_;
+        RmLayout layout_ = RM_LAYOUT_ROW;   // create table的页面布局
+        double fill_factor_ = IX_BULK_FILL_FACTOR;     // create index批量构建时结点的填充率
+        IndexType index_type_ = INDEX_BTREE;            // create index的索引类型
+        bool unique_ = true;                            // create index是否为唯一索引
 };
 
 // help; show tables; desc tables; begin; abort; commit; rollback语句对应的plan
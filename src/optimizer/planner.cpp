@@ -10,9 +10,13 @@ See the Mulan PSL v2 for more details. */
 
 #include "planner.h"
 
+#include <algorithm>
+#include <charconv>
+#include <functional>
 #include <memory>
 
 #include "execution/executor_delete.h"
+#include "execution/executor_hash_join.h"
 #include "execution/executor_index_scan.h"
 #include "execution/executor_insert.h"
 #include "execution/executor_nestedloop_join.h"
@@ -28,15 +32,37 @@ bool Planner::get_index_cols(std::string tab_name, std::vector<Condition> curr_c
     index_col_names.clear();
     // acquire col_name
     std::vector<std::string> check_list;
+    std::vector<std::string> eq_list;
     for(auto& cond:curr_conds){
         if(cond.is_rhs_val&&(cond.op==OP_EQ || cond.op==OP_GT) && cond.lhs_col.tab_name==tab_name){
             check_list.push_back(cond.lhs_col.col_name);
+            if (cond.op==OP_EQ) {
+                eq_list.push_back(cond.lhs_col.col_name);
+            }
         }
     }
     TabMeta& tab = sm_manager_->db_.get_table(tab_name);
+    // 所有字段都有等值条件时优先使用哈希索引，哈希索引不能用于范围查找和前缀匹配
+    for (auto& index:tab.indexes) {
+        if (index.type!=INDEX_HASH) {
+            continue;
+        }
+        bool covered=std::all_of(index.cols.begin(),index.cols.end(),[&](const ColMeta& col){
+            return std::find(eq_list.begin(),eq_list.end(),col.name)!=eq_list.end();
+        });
+        if (covered) {
+            for(auto& col:index.cols){
+                index_col_names.push_back(col.name);
+            }
+            return true;
+        }
+    }
     IndexMeta index_to_use;
     // 优先使用完全匹配
     for (auto& index:tab.indexes) {
+        if (index.type==INDEX_HASH) {
+            continue;
+        }
         std::vector<std::string> col_names;
 //        if (index.col_num!=check_list.size())continue;
         auto& index_cols=index.cols;
@@ -81,6 +107,472 @@ bool Planner::get_index_cols(std::string tab_name, std::vector<Condition> curr_c
     return false;
 }
 
+// 单表查询用到的字段（投影、条件、排序、聚合）都在B+树索引的key中时，可以只读索引不回表
+bool Planner::index_covers(std::shared_ptr<Query> query, const std::vector<Condition>& curr_conds, const std::vector<std::string>& index_col_names) {
+    if (query->tables.size() != 1) {
+        return false;
+    }
+    return index_covers(query, query->tables[0], curr_conds, index_col_names);
+}
+
+// 查询用到的tab_name表的字段（投影、排序、聚合，以及conds中的字段）都在B+树索引的key中，连接查询中的一个表也适用
+// 没有写表名的字段（单表查询或未限定的ORDER BY/GROUP BY字段）按属于tab_name处理
+bool Planner::index_covers(std::shared_ptr<Query> query, const std::string& tab_name, const std::vector<Condition>& conds,
+                           const std::vector<std::string>& index_col_names) {
+    auto x = std::dynamic_pointer_cast<ast::SelectStmt>(query->parse);
+    if (x == nullptr) {
+        return false;
+    }
+    auto index_meta = sm_manager_->db_.get_table(tab_name).get_index_meta(index_col_names);
+    if (index_meta->type == INDEX_HASH) {
+        return false;
+    }
+    std::vector<std::string> used;
+    auto use = [&](const std::string& col_tab, const std::string& col_name) {
+        if (col_tab.empty() || col_tab == tab_name) {
+            used.push_back(col_name);
+        }
+    };
+    if (x->has_group) {
+        // 分组聚合只读取分组字段和聚合字段，query->cols中的聚合结果不是表中的字段
+        for (auto& col : x->group_bys) {
+            use(col->tab_name, col->col_name);
+        }
+        for (auto& item : x->items) {
+            if (item->aggre != nullptr && item->aggre->aggregation_column_ != nullptr) {
+                use(item->aggre->aggregation_column_->tab_name, item->aggre->aggregation_column_->col_name);
+            }
+        }
+    } else {
+        for (auto& col : query->cols) {
+            use(col.tab_name, col.col_name);
+        }
+        for (auto& order : x->orders) {
+            use(order->cols->tab_name, order->cols->col_name);
+        }
+    }
+    for (auto& cond : conds) {
+        use(cond.lhs_col.tab_name, cond.lhs_col.col_name);
+        if (!cond.is_rhs_val) {
+            use(cond.rhs_col.tab_name, cond.rhs_col.col_name);
+        }
+    }
+    return std::all_of(used.begin(), used.end(), [&](const std::string& name) {
+        return std::find(index_col_names.begin(), index_col_names.end(), name) != index_col_names.end();
+    });
+}
+
+// 单表的ORDER BY ... LIMIT n和MIN/MAX(col)只需要按B+树索引的顺序读出前n条（MIN/MAX为1条），逆序时反向遍历叶子：
+// 索引字段跳过有常量等值条件的字段后，依次是各排序字段，且排序方向一致。
+// 已经按条件选中了索引时只检查该索引，避免放弃选择性高的索引去按顺序扫描
+bool Planner::use_index_order(std::shared_ptr<Query> query, ScanPlan& scan) {
+    auto x = std::dynamic_pointer_cast<ast::SelectStmt>(query->parse);
+    std::vector<std::string> order_cols;
+    bool desc = false;
+    int limit;
+    if (x->has_group) {
+        // 没有GROUP BY时只有一个MIN/MAX，它的结果就是按该字段顺序的第一条
+        if (!x->group_bys.empty() || x->items.size() != 1 || x->items.front()->aggre == nullptr) {
+            return false;
+        }
+        auto& aggre = x->items.front()->aggre;
+        if ((aggre->aggregation_type_ != ast::MIN && aggre->aggregation_type_ != ast::MAX) ||
+            aggre->aggregation_column_ == nullptr) {
+            return false;
+        }
+        order_cols.push_back(aggre->aggregation_column_->col_name);
+        desc = aggre->aggregation_type_ == ast::MAX;
+        limit = 1;
+    } else if (x->has_sort && x->has_limit) {
+        desc = x->orders.front()->orderby_dir == ast::OrderBy_DESC;
+        for (auto& order : x->orders) {
+            if ((order->orderby_dir == ast::OrderBy_DESC) != desc) {
+                return false;
+            }
+            order_cols.push_back(order->cols->col_name);
+        }
+        limit = x->limit->number_;
+    } else {
+        return false;
+    }
+    auto eq_bound = [&](const std::string& name) {
+        return std::any_of(scan.conds_.begin(), scan.conds_.end(), [&](const Condition& cond) {
+            return cond.is_rhs_val && cond.op == OP_EQ && cond.lhs_col.col_name == name;
+        });
+    };
+    // 有常量等值条件的字段在结果中取值都相同，不影响顺序
+    order_cols.erase(std::remove_if(order_cols.begin(), order_cols.end(), eq_bound), order_cols.end());
+    if (order_cols.empty()) {
+        return false;
+    }
+    auto ordered_by = [&](const IndexMeta& index) {
+        if (index.type == INDEX_HASH) {
+            return false;
+        }
+        size_t matched = 0;
+        for (auto& col : index.cols) {
+            if (matched == order_cols.size()) {
+                break;
+            }
+            if (col.name == order_cols[matched]) {
+                matched++;
+            } else if (!eq_bound(col.name)) {
+                return false;
+            }
+        }
+        return matched == order_cols.size();
+    };
+    TabMeta& tab = sm_manager_->db_.get_table(scan.tab_name_);
+    if (scan.tag == T_IndexScan) {
+        if (!ordered_by(*tab.get_index_meta(scan.index_col_names_))) {
+            return false;
+        }
+    } else {
+        auto it = std::find_if(tab.indexes.begin(), tab.indexes.end(), ordered_by);
+        if (it == tab.indexes.end()) {
+            return false;
+        }
+        scan.tag = T_IndexScan;
+        scan.index_col_names_.clear();
+        for (auto& col : it->cols) {
+            scan.index_col_names_.push_back(col.name);
+        }
+    }
+    scan.reverse_ = desc;
+    scan.limit_ = limit;
+    scan.covering_ = index_covers(query, scan.conds_, scan.index_col_names_);
+    return true;
+}
+
+// 单表的GROUP BY在B+树索引的字段跳过有常量等值条件的字段后，开头恰好是全部分组字段（先后不限）时，
+// 按索引顺序读出的记录中同一分组相邻，可以流式聚合。已经按条件选中了索引时只检查该索引，
+// 否则只在索引覆盖了用到的字段时改为按索引扫描，避免逐条回表比hash聚合更慢
+bool Planner::use_group_order(std::shared_ptr<Query> query, ScanPlan& scan) {
+    auto x = std::dynamic_pointer_cast<ast::SelectStmt>(query->parse);
+    std::vector<std::string> group_cols;
+    for (auto& col : x->group_bys) {
+        group_cols.push_back(col->col_name);
+    }
+    auto eq_bound = [&](const std::string& name) {
+        return std::any_of(scan.conds_.begin(), scan.conds_.end(), [&](const Condition& cond) {
+            return cond.is_rhs_val && cond.op == OP_EQ && cond.lhs_col.col_name == name;
+        });
+    };
+    auto grouped_by = [&](const IndexMeta& index) {
+        if (index.type == INDEX_HASH) {
+            return false;
+        }
+        std::vector<std::string> rest = group_cols;
+        for (auto& col : index.cols) {
+            if (rest.empty()) {
+                break;
+            }
+            auto pos = std::find(rest.begin(), rest.end(), col.name);
+            if (pos != rest.end()) {
+                rest.erase(pos);
+            } else if (!eq_bound(col.name)) {
+                return false;
+            }
+        }
+        return rest.empty();
+    };
+    TabMeta& tab = sm_manager_->db_.get_table(scan.tab_name_);
+    if (scan.tag == T_IndexScan) {
+        if (!grouped_by(*tab.get_index_meta(scan.index_col_names_))) {
+            return false;
+        }
+    } else {
+        auto it = std::find_if(tab.indexes.begin(), tab.indexes.end(), [&](const IndexMeta& index) {
+            std::vector<std::string> index_col_names;
+            for (auto& col : index.cols) {
+                index_col_names.push_back(col.name);
+            }
+            return grouped_by(index) && index_covers(query, scan.conds_, index_col_names);
+        });
+        if (it == tab.indexes.end()) {
+            return false;
+        }
+        scan.tag = T_IndexScan;
+        scan.index_col_names_.clear();
+        for (auto& col : it->cols) {
+            scan.index_col_names_.push_back(col.name);
+        }
+    }
+    scan.ordered_ = true;
+    scan.covering_ = index_covers(query, scan.conds_, scan.index_col_names_);
+    return true;
+}
+
+// 内表上B+树或哈希索引的每个字段都有与外表字段（类型、长度相同）的等值连接条件或常量等值条件，且至少有一个连接条件时可以做索引连接
+bool Planner::index_join_cols(const JoinPlan& join, const ScanPlan& inner, std::vector<std::string>& index_col_names) {
+    auto& tab_name = inner.tab_name_;
+    TabMeta& tab = sm_manager_->db_.get_table(tab_name);
+    auto bound_by_join = [&](const ColMeta& col) {
+        return std::any_of(join.conds_.begin(), join.conds_.end(), [&](const Condition& cond) {
+            if (cond.is_rhs_val || cond.op != OP_EQ) {
+                return false;
+            }
+            const TabCol* outer = nullptr;
+            if (cond.lhs_col.tab_name == tab_name && cond.lhs_col.col_name == col.name) {
+                outer = &cond.rhs_col;
+            } else if (cond.rhs_col.tab_name == tab_name && cond.rhs_col.col_name == col.name) {
+                outer = &cond.lhs_col;
+            }
+            if (outer == nullptr || outer->tab_name == tab_name) {
+                return false;
+            }
+            auto outer_col = sm_manager_->db_.get_table(outer->tab_name).get_col(outer->col_name);
+            return outer_col->type == col.type && outer_col->len == col.len;
+        });
+    };
+    auto bound_by_const = [&](const ColMeta& col) {
+        return std::any_of(inner.conds_.begin(), inner.conds_.end(), [&](const Condition& cond) {
+            return cond.is_rhs_val && cond.op == OP_EQ && cond.lhs_col.col_name == col.name && cond.rhs_val.type == col.type;
+        });
+    };
+    for (auto& index : tab.indexes) {
+        bool any_join = false;
+        bool bound = std::all_of(index.cols.begin(), index.cols.end(), [&](const ColMeta& col) {
+            if (bound_by_join(col)) {
+                any_join = true;
+                return true;
+            }
+            return bound_by_const(col);
+        });
+        if (bound && any_join) {
+            index_col_names.clear();
+            for (auto& col : index.cols) {
+                index_col_names.push_back(col.name);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// 自底向上把可以用内表索引探查的连接改为索引嵌套循环连接，优先以右边为内表
+void Planner::choose_index_join(std::shared_ptr<Plan> plan) {
+    auto join = std::dynamic_pointer_cast<JoinPlan>(plan);
+    if (join == nullptr) {
+        return;
+    }
+    choose_index_join(join->left_);
+    choose_index_join(join->right_);
+    if (join->tag != T_NestLoop) {
+        return;
+    }
+    for (bool inner_is_left : {false, true}) {
+        auto inner = std::dynamic_pointer_cast<ScanPlan>(inner_is_left ? join->left_ : join->right_);
+        if (inner != nullptr && index_join_cols(*join, *inner, join->index_col_names_)) {
+            join->tag = T_IndexNLJoin;
+            join->inner_is_left_ = inner_is_left;
+            return;
+        }
+    }
+}
+
+// 两边都是基本表扫描，且各自的B+树索引（已经按条件选中索引时就是该索引）跳过常量等值条件的字段后，
+// 开头的字段依次由等值连接条件一一对应时，两边按索引顺序扫描就已经按连接key有序，改为归并连接
+// 顺序扫描只改用覆盖了该表所用全部字段的索引（conds为整个查询的条件）：不覆盖时逐条回表的随机读比顺序扫描慢得多
+void Planner::choose_merge_join(std::shared_ptr<Query> query, const std::vector<Condition>& conds, std::shared_ptr<Plan> plan) {
+    auto join = std::dynamic_pointer_cast<JoinPlan>(plan);
+    if (join == nullptr) {
+        return;
+    }
+    choose_merge_join(query, conds, join->left_);
+    choose_merge_join(query, conds, join->right_);
+    auto left = std::dynamic_pointer_cast<ScanPlan>(join->left_);
+    auto right = std::dynamic_pointer_cast<ScanPlan>(join->right_);
+    if (join->tag != T_NestLoop || left == nullptr || right == nullptr) {
+        return;
+    }
+    // 类型、长度相同的等值连接条件，按(左边字段, 右边字段)
+    std::vector<std::pair<TabCol, TabCol>> pairs;
+    for (auto& cond : join->conds_) {
+        if (cond.is_rhs_val || cond.op != OP_EQ) {
+            continue;
+        }
+        TabCol lcol = cond.lhs_col, rcol = cond.rhs_col;
+        if (lcol.tab_name != left->tab_name_) {
+            std::swap(lcol, rcol);
+        }
+        if (lcol.tab_name != left->tab_name_ || rcol.tab_name != right->tab_name_) {
+            continue;
+        }
+        auto lmeta = sm_manager_->db_.get_table(lcol.tab_name).get_col(lcol.col_name);
+        auto rmeta = sm_manager_->db_.get_table(rcol.tab_name).get_col(rcol.col_name);
+        if (lmeta->type == rmeta->type && lmeta->len == rmeta->len) {
+            pairs.emplace_back(lcol, rcol);
+        }
+    }
+    if (pairs.empty()) {
+        return;
+    }
+    auto candidates = [&](const ScanPlan& scan) {
+        std::vector<IndexMeta> indexes;
+        auto& tab = sm_manager_->db_.get_table(scan.tab_name_);
+        if (scan.tag == T_IndexScan) {
+            indexes.push_back(*tab.get_index_meta(scan.index_col_names_));
+        } else {
+            for (auto& index : tab.indexes) {
+                std::vector<std::string> names;
+                for (auto& col : index.cols) {
+                    names.push_back(col.name);
+                }
+                if (index_covers(query, scan.tab_name_, conds, names)) {
+                    indexes.push_back(index);
+                }
+            }
+        }
+        indexes.erase(std::remove_if(indexes.begin(), indexes.end(), [](const IndexMeta& index) {
+            return index.type == INDEX_HASH;
+        }), indexes.end());
+        return indexes;
+    };
+    auto eq_bound = [](const ScanPlan& scan, const std::string& name) {
+        return std::any_of(scan.conds_.begin(), scan.conds_.end(), [&](const Condition& cond) {
+            return cond.is_rhs_val && cond.op == OP_EQ && cond.lhs_col.col_name == name;
+        });
+    };
+    // 索引跳过常量等值字段后，开头依次是哪些连接字段
+    auto order_of = [&](const ScanPlan& scan, const IndexMeta& index, bool is_left) {
+        std::vector<std::pair<TabCol, TabCol>> keys;
+        for (auto& col : index.cols) {
+            if (eq_bound(scan, col.name)) {
+                continue;
+            }
+            auto it = std::find_if(pairs.begin(), pairs.end(), [&](const std::pair<TabCol, TabCol>& pair) {
+                return (is_left ? pair.first : pair.second).col_name == col.name;
+            });
+            if (it == pairs.end()) {
+                break;
+            }
+            keys.push_back(*it);
+        }
+        return keys;
+    };
+    std::vector<std::pair<TabCol, TabCol>> best;
+    const IndexMeta *best_left = nullptr, *best_right = nullptr;
+    auto left_indexes = candidates(*left);
+    auto right_indexes = candidates(*right);
+    for (auto& lindex : left_indexes) {
+        auto lkeys = order_of(*left, lindex, true);
+        for (auto& rindex : right_indexes) {
+            auto rkeys = order_of(*right, rindex, false);
+            size_t n = 0;
+            while (n < lkeys.size() && n < rkeys.size() &&
+                   lkeys[n].first.col_name == rkeys[n].first.col_name && lkeys[n].second.col_name == rkeys[n].second.col_name) {
+                n++;
+            }
+            if (n > best.size()) {
+                best.assign(lkeys.begin(), lkeys.begin() + n);
+                best_left = &lindex;
+                best_right = &rindex;
+            }
+        }
+    }
+    if (best.empty()) {
+        return;
+    }
+    for (auto [scan, index] : {std::make_pair(left, best_left), std::make_pair(right, best_right)}) {
+        if (scan->tag == T_SeqScan) {
+            scan->covering_ = true;
+        }
+        scan->tag = T_IndexScan;
+        scan->index_col_names_.clear();
+        for (auto& col : index->cols) {
+            scan->index_col_names_.push_back(col.name);
+        }
+    }
+    join->tag = T_MergeJoin;
+    join->merge_keys_ = std::move(best);
+}
+
+// 按表文件的页数估计扫描的记录数，连接取两边中较大的估计值
+size_t Planner::estimate_rows(const std::shared_ptr<Plan>& plan) {
+    if (auto scan = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+        auto hdr = sm_manager_->fhs_.at(scan->tab_name_)->get_file_hdr();
+        return (size_t)hdr.num_pages * hdr.num_records_per_page;
+    }
+    if (auto join = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+        return std::max(estimate_rows(join->left_), estimate_rows(join->right_));
+    }
+    return 0;
+}
+
+// 没有改为索引连接的连接上，有左右两边字段类型、长度相同的等值条件时改为hash join，在估计较小的一边建哈希表
+void Planner::choose_hash_join(std::shared_ptr<Plan> plan) {
+    auto join = std::dynamic_pointer_cast<JoinPlan>(plan);
+    if (join == nullptr) {
+        return;
+    }
+    choose_hash_join(join->left_);
+    choose_hash_join(join->right_);
+    if (join->tag != T_NestLoop) {
+        return;
+    }
+    std::vector<std::string> left_tabs;
+    std::function<void(const std::shared_ptr<Plan>&)> collect = [&](const std::shared_ptr<Plan>& p) {
+        if (auto scan = std::dynamic_pointer_cast<ScanPlan>(p)) {
+            left_tabs.push_back(scan->tab_name_);
+        } else if (auto sub = std::dynamic_pointer_cast<JoinPlan>(p)) {
+            collect(sub->left_);
+            collect(sub->right_);
+        }
+    };
+    collect(join->left_);
+    auto on_left = [&](const TabCol& col) {
+        return std::find(left_tabs.begin(), left_tabs.end(), col.tab_name) != left_tabs.end();
+    };
+    bool equi = std::any_of(join->conds_.begin(), join->conds_.end(), [&](const Condition& cond) {
+        if (cond.is_rhs_val || cond.op != OP_EQ || on_left(cond.lhs_col) == on_left(cond.rhs_col)) {
+            return false;
+        }
+        auto lhs = sm_manager_->db_.get_table(cond.lhs_col.tab_name).get_col(cond.lhs_col.col_name);
+        auto rhs = sm_manager_->db_.get_table(cond.rhs_col.tab_name).get_col(cond.rhs_col.col_name);
+        return lhs->type == rhs->type && lhs->len == rhs->len;
+    });
+    if (equi) {
+        join->tag = T_HashJoin;
+        join->build_left_ = estimate_rows(join->left_) < estimate_rows(join->right_);
+    }
+}
+
+/**
+ * @brief 把可以拆成并行流水线的计划标记上并行度：足够大的表的顺序扫描，以及probe端可以并行、build端估计能放进内存的hash join
+ * build端也是足够大的扫描或可以并行的hash join时同样并行读入
+ * @return 是否标记了plan
+ */
+bool Planner::mark_parallel(const std::shared_ptr<Plan>& plan, int dop) {
+    if (auto scan = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+        if (scan->tag != T_SeqScan || scan->limit_ >= 0 ||
+            sm_manager_->fhs_.at(scan->tab_name_)->get_file_hdr().num_pages < PARALLEL_SCAN_MIN_PAGES) {
+            return false;
+        }
+        scan->dop_ = dop;
+        return true;
+    }
+    auto join = std::dynamic_pointer_cast<JoinPlan>(plan);
+    if (join == nullptr || join->tag != T_HashJoin) {
+        return false;
+    }
+    std::function<size_t(const std::shared_ptr<Plan>&)> tuple_len = [&](const std::shared_ptr<Plan>& p) -> size_t {
+        if (auto scan = std::dynamic_pointer_cast<ScanPlan>(p)) {
+            return scan->len_;
+        }
+        auto sub = std::dynamic_pointer_cast<JoinPlan>(p);
+        return sub == nullptr ? 0 : tuple_len(sub->left_) + tuple_len(sub->right_);
+    };
+    auto &build = join->build_left_ ? join->left_ : join->right_;
+    auto &probe = join->build_left_ ? join->right_ : join->left_;
+    // 并行建表不分区写出，build端放不下时仍用串行的hash join
+    if (estimate_rows(build) * tuple_len(build) > HASH_JOIN_MEM_LIMIT || !mark_parallel(probe, dop)) {
+        return false;
+    }
+    mark_parallel(build, dop);
+    join->dop_ = dop;
+    return true;
+}
 
 /**
  * @brief 表算子条件谓词生成
@@ -180,10 +672,32 @@ std::shared_ptr<Plan> Planner::physical_optimization(std::shared_ptr<Query> quer
     // 其他物理优化
 
     auto x = std::dynamic_pointer_cast<ast::SelectStmt>(query->parse);
-    if(x->has_aggre) {
-        plan = generate_aggre_plan(query, std::move(plan));
+    // 单表查询按索引顺序读取时不再需要排序
+    bool ordered = false;
+    // 没有GROUP BY的聚合函数只有一个分组，不需要有序
+    bool group_ordered = x->has_group && x->group_bys.empty();
+    if (auto scan = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+        if (x->has_group && !x->group_bys.empty()) {
+            group_ordered = use_group_order(query, *scan);
+        } else {
+            ordered = use_index_order(query, *scan);
+        }
+        // 没有排序和聚合的单表LIMIT下推到扫描，扫描够了就停止
+        if (x->has_limit && !x->has_sort && !x->has_group) {
+            scan->limit_ = x->limit->number_;
+        }
+    }
+    // 按会话的并行度把大表的顺序扫描和hash join拆成几条并行的流水线，过滤、投影和探查都在工作线程中完成，
+    // 排序在汇合之后进行，GROUP BY分两阶段并行聚合；没有排序的LIMIT已经下推到扫描，不再并行
+    bool parallel = context != nullptr && context->dop_ > 1 &&
+                    (x->has_sort || x->has_group || !x->has_limit) && mark_parallel(plan, context->dop_);
+    if(x->has_group) {
+        plan = generate_group_plan(query, std::move(plan), group_ordered && !parallel);
+        if (parallel) {
+            std::static_pointer_cast<GroupAggrePlan>(plan)->dop_ = context->dop_;
+        }
     }
-    if(x->has_sort) {
+    if(x->has_sort && !ordered) {
         // 处理orderby
         plan = generate_sort_plan(query, std::move(plan));
     }
@@ -208,8 +722,9 @@ std::shared_ptr<Plan> Planner::make_one_rel(std::shared_ptr<Query> query)
             table_scan_executors[i] = 
                 std::make_shared<ScanPlan>(T_SeqScan, sm_manager_, tables[i], curr_conds, index_col_names);
         } else {  // 存在索引
-            table_scan_executors[i] =
-                std::make_shared<ScanPlan>(T_IndexScan, sm_manager_, tables[i], curr_conds, index_col_names);
+            auto scan = std::make_shared<ScanPlan>(T_IndexScan, sm_manager_, tables[i], curr_conds, index_col_names);
+            scan->covering_ = index_covers(query, curr_conds, index_col_names);
+            table_scan_executors[i] = scan;
         }
     }
     // 只有一个表，不需要join。
@@ -297,6 +812,21 @@ std::shared_ptr<Plan> Planner::make_one_rel(std::shared_ptr<Query> query)
         }
     }
 
+    // 整个查询的条件：各表扫描上的条件和连接上的条件
+    std::vector<Condition> all_conds;
+    std::function<void(const std::shared_ptr<Plan>&)> collect_conds = [&](const std::shared_ptr<Plan>& p) {
+        if (auto scan = std::dynamic_pointer_cast<ScanPlan>(p)) {
+            all_conds.insert(all_conds.end(), scan->conds_.begin(), scan->conds_.end());
+        } else if (auto join = std::dynamic_pointer_cast<JoinPlan>(p)) {
+            all_conds.insert(all_conds.end(), join->conds_.begin(), join->conds_.end());
+            collect_conds(join->left_);
+            collect_conds(join->right_);
+        }
+    };
+    collect_conds(table_join_executors);
+    choose_merge_join(query, all_conds, table_join_executors);
+    choose_index_join(table_join_executors);
+    choose_hash_join(table_join_executors);
     return table_join_executors;
 
 }
@@ -313,19 +843,22 @@ std::shared_ptr<Plan> Planner::generate_sort_plan(std::shared_ptr<Query> query,
 }
 
 
-std::shared_ptr<Plan> Planner::generate_aggre_plan(std::shared_ptr<Query> query, std::shared_ptr<Plan> plan)
+std::shared_ptr<Plan> Planner::generate_group_plan(std::shared_ptr<Query> query, std::shared_ptr<Plan> plan, bool ordered)
 {
     auto x = std::dynamic_pointer_cast<ast::SelectStmt>(query->parse);
 
-    std::vector<std::string> tables = query->tables;
-    std::vector<ColMeta> all_cols;
-    for (auto &sel_tab_name : tables) {
-        // 这里db_不能写成get_db(), 注意要传指针
-        const auto &sel_tab_cols = sm_manager_->db_.get_table(sel_tab_name).cols;
-        all_cols.insert(all_cols.end(), sel_tab_cols.begin(), sel_tab_cols.end());
+    std::vector<TabCol> group_cols;
+    for (auto &col : x->group_bys) {
+        group_cols.push_back({.tab_name = col->tab_name, .col_name = col->col_name});
     }
-
-    return std::make_shared<AggrePlan>(T_Aggre, std::move(plan), std::move(x->aggreClause) );
+    std::vector<std::shared_ptr<ast::AggreClause>> aggres;
+    for (auto &item : x->items) {
+        if (item->aggre != nullptr) {
+            aggres.push_back(item->aggre);
+        }
+    }
+    return std::make_shared<GroupAggrePlan>(ordered ? T_StreamAggre : T_HashAggre, std::move(plan),
+                                            std::move(group_cols), std::move(aggres));
 }
 /**
  * @brief select plan 生成
@@ -341,8 +874,13 @@ std::shared_ptr<Plan> Planner::generate_select_plan(std::shared_ptr<Query> query
     //物理优化
     auto sel_cols = query->cols;
     std::shared_ptr<Plan> plannerRoot = physical_optimization(query, context);
-    plannerRoot = std::make_shared<ProjectionPlan>(T_Projection, std::move(plannerRoot), 
+    auto projection = std::make_shared<ProjectionPlan>(T_Projection, std::move(plannerRoot),
                                                         std::move(sel_cols));
+    auto x = std::dynamic_pointer_cast<ast::SelectStmt>(query->parse);
+    if (x != nullptr && x->has_limit) {
+        projection->limit_ = x->limit->number_;
+    }
+    plannerRoot = projection;
 
     return plannerRoot;
 }
@@ -364,13 +902,57 @@ std::shared_ptr<Plan> Planner::do_planner(std::shared_ptr<Query> query, Context
                 throw InternalError("Unexpected field type");
             }
         }
-        plannerRoot = std::make_shared<DDLPlan>(T_CreateTable, x->tab_name, std::vector<std::string>(), col_defs);
+        auto ddl = std::make_shared<DDLPlan>(T_CreateTable, x->tab_name, std::vector<std::string>(), col_defs);
+        // 表选项，目前只支持layout = {row | pax}
+        for (auto &option : x->options) {
+            std::string key = option->key, value = option->value;
+            std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+            std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+            if (key == "layout" && value == "row") {
+                ddl->layout_ = RM_LAYOUT_ROW;
+            } else if (key == "layout" && value == "pax") {
+                ddl->layout_ = RM_LAYOUT_PAX;
+            } else {
+                throw InvalidTableOptionError(option->key, option->value);
+            }
+        }
+        plannerRoot = ddl;
     } else if (auto x = std::dynamic_pointer_cast<ast::DropTable>(query->parse)) {
         // drop table;
         plannerRoot = std::make_shared<DDLPlan>(T_DropTable, x->tab_name, std::vector<std::string>(), std::vector<ColDef>());
     } else if (auto x = std::dynamic_pointer_cast<ast::CreateIndex>(query->parse)) {
         // create index;
-        plannerRoot = std::make_shared<DDLPlan>(T_CreateIndex, x->tab_name, x->col_names, std::vector<ColDef>());
+        auto ddl = std::make_shared<DDLPlan>(T_CreateIndex, x->tab_name, x->col_names, std::vector<ColDef>());
+        // 索引类型，USING btree | hash
+        std::string method = x->method;
+        std::transform(method.begin(), method.end(), method.begin(), ::tolower);
+        if (method == "hash") {
+            ddl->index_type_ = INDEX_HASH;
+        } else if (!method.empty() && method != "btree") {
+            throw InvalidTableOptionError("using", x->method);
+        }
+        // 索引选项：fillfactor = 10~100（百分比），unique = {true | false}
+        for (auto &option : x->options) {
+            std::string key = option->key, value = option->value;
+            std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+            std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+            if (key == "unique" && (value == "true" || value == "false")) {
+                ddl->unique_ = value == "true";
+                continue;
+            }
+            int percent = 0;
+            auto res = std::from_chars(option->value.data(), option->value.data() + option->value.size(), percent);
+            if (key != "fillfactor" || res.ec != std::errc() || res.ptr != option->value.data() + option->value.size() ||
+                percent < 10 || percent > 100) {
+                throw InvalidTableOptionError(option->key, option->value);
+            }
+            ddl->fill_factor_ = percent / 100.0;
+        }
+        // 哈希索引按完整的key定位，不能存放重复的key
+        if (ddl->index_type_ == INDEX_HASH && !ddl->unique_) {
+            throw InvalidTableOptionError("unique", "false");
+        }
+        plannerRoot = ddl;
     } else if (auto x = std::dynamic_pointer_cast<ast::DropIndex>(query->parse)) {
         // drop index
         plannerRoot = std::make_shared<DDLPlan>(T_DropIndex, x->tab_name, x->col_names, std::vector<ColDef>());
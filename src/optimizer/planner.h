@@ -46,11 +46,32 @@ class Planner {
     
     std::shared_ptr<Plan> generate_select_plan(std::shared_ptr<Query> query, Context *context);
 
-    std::shared_ptr<Plan> generate_aggre_plan(std::shared_ptr<Query> query, std::shared_ptr<Plan> plan);
+    std::shared_ptr<Plan> generate_group_plan(std::shared_ptr<Query> query, std::shared_ptr<Plan> plan, bool ordered);
 
     // int get_indexNo(std::string tab_name, std::vector<Condition> curr_conds);
     bool get_index_cols(std::string tab_name, std::vector<Condition> curr_conds, std::vector<std::string>& index_col_names);
 
+    void choose_index_join(std::shared_ptr<Plan> plan);
+
+    void choose_hash_join(std::shared_ptr<Plan> plan);
+
+    void choose_merge_join(std::shared_ptr<Query> query, const std::vector<Condition>& conds, std::shared_ptr<Plan> plan);
+
+    size_t estimate_rows(const std::shared_ptr<Plan>& plan);
+
+    bool index_join_cols(const JoinPlan& join, const ScanPlan& inner, std::vector<std::string>& index_col_names);
+
+    bool index_covers(std::shared_ptr<Query> query, const std::vector<Condition>& curr_conds, const std::vector<std::string>& index_col_names);
+
+    bool index_covers(std::shared_ptr<Query> query, const std::string& tab_name, const std::vector<Condition>& conds,
+                      const std::vector<std::string>& index_col_names);
+
+    bool use_index_order(std::shared_ptr<Query> query, ScanPlan& scan);
+
+    bool use_group_order(std::shared_ptr<Query> query, ScanPlan& scan);
+
+    bool mark_parallel(const std::shared_ptr<Plan>& plan, int dop);
+
     ColType interp_sv_type(ast::SvType sv_type) {
         std::map<ast::SvType, ColType> m = {
             {ast::SV_TYPE_INT, TYPE_INT}, {ast::SV_TYPE_FLOAT, TYPE_FLOAT}, {ast::SV_TYPE_STRING, TYPE_STRING}, {ast::SV_TYPE_BIGINT, TYPE_BIGINT},{ast::SV_TYPE_DATETIME, TYPE_DATETIME}};
@@ -82,12 +82,26 @@ struct ColDef : public Field {
             col_name(std::move(col_name_)), type_len(std::move(type_len_)) {}
 };
 
+// create table ... with (key = value, ...) 中的表选项，例如 layout = pax
+struct TableOption : public TreeNode {
+    std::string key;
+    std::string value;
+
+    TableOption(std::string key_, std::string value_) :
+            key(std::move(key_)), value(std::move(value_)) {}
+};
+
 struct CreateTable : public TreeNode {
     std::string tab_name;
     std::vector<std::shared_ptr<Field>> fields;
+    std::vector<std::shared_ptr<TableOption>> options;
 
     CreateTable(std::string tab_name_, std::vector<std::shared_ptr<Field>> fields_) :
             tab_name(std::move(tab_name_)), fields(std::move(fields_)) {}
+
+    CreateTable(std::string tab_name_, std::vector<std::shared_ptr<Field>> fields_,
+                std::vector<std::shared_ptr<TableOption>> options_) :
+            tab_name(std::move(tab_name_)), fields(std::move(fields_)), options(std::move(options_)) {}
 };
 
 struct DropTable : public TreeNode {
@@ -106,8 +120,16 @@ struct DescTable : public TreeNode {
         std::string tab_name;
         std::vector<std::string> col_names;
 
+        std::vector<std::shared_ptr<TableOption>> options;
+        std::string method;     // USING子句指定的索引类型，为空时使用B+树
+
         CreateIndex(std::string tab_name_, std::vector<std::string> col_names_) :
                 tab_name(std::move(tab_name_)), col_names(std::move(col_names_)) {}
+
+        CreateIndex(std::string tab_name_, std::vector<std::string> col_names_,
+                    std::vector<std::shared_ptr<TableOption>> options_, std::string method_ = "") :
+                tab_name(std::move(tab_name_)), col_names(std::move(col_names_)), options(std::move(options_)),
+                method(std::move(method_)) {}
     };
     struct ShowIndex : public  TreeNode {
         std::string tab_name;
@@ -205,6 +227,14 @@ struct AggreClause : TreeNode
         aggregation_column_ = nullptr;
     }
 };
+// select列表中的一项：普通字段或聚合函数，两者只有一个非空
+struct SelectItem : TreeNode
+{
+    std::shared_ptr<Col> col;
+    std::shared_ptr<AggreClause> aggre;
+    explicit SelectItem(std::shared_ptr<Col> col_) : col(std::move(col_)) {}
+    explicit SelectItem(std::shared_ptr<AggreClause> aggre_) : aggre(std::move(aggre_)) {}
+};
 struct Limit : public TreeNode
 {
     int number_;
@@ -253,26 +283,17 @@ struct JoinExpr : public TreeNode {
 
 struct SelectStmt : public TreeNode {
     std::vector<std::shared_ptr<Col>> cols;
-    std::shared_ptr<AggreClause> aggreClause;
     std::vector<std::string> tabs;
     std::vector<std::shared_ptr<BinaryExpr>> conds;
     std::vector<std::shared_ptr<JoinExpr>> jointree;
     std::vector<std::shared_ptr<OrderBy>> orders;
     std::shared_ptr<Limit> limit;
+    std::vector<std::shared_ptr<SelectItem>> items;     // 有GROUP BY或聚合函数时的select列表，按书写顺序
+    std::vector<std::shared_ptr<Col>> group_bys;
     
     bool has_sort;
     bool has_limit;
-    bool has_aggre;
-
-    SelectStmt(std::shared_ptr<AggreClause> aggreClause_, std::vector<std::string> tabs_,
-               std::vector<std::shared_ptr<BinaryExpr>> conds_) :
-               aggreClause(std::move(aggreClause_)), tabs(std::move(tabs_)), conds(std::move(conds_)){
-        cols = {};
-        has_sort = false;
-        has_limit = false;
-        has_aggre = true;
-        // std::cout<<"select stmt ctor for aggregation"<<std::endl;
-    }
+    bool has_group = false;                             // 是否由分组聚合执行，没有GROUP BY的聚合函数也是一个分组
 
     SelectStmt(std::vector<std::shared_ptr<Col>> cols_,
                std::vector<std::string> tabs_,
@@ -283,7 +304,19 @@ struct SelectStmt : public TreeNode {
             orders(std::move(order_)), limit(std::move(limit_)) {
         has_sort = !(orders.empty());
         has_limit = bool(limit);
-        has_aggre = false;
+    }
+
+    SelectStmt(std::vector<std::shared_ptr<SelectItem>> items_,
+               std::vector<std::string> tabs_,
+               std::vector<std::shared_ptr<BinaryExpr>> conds_,
+               std::vector<std::shared_ptr<Col>> group_bys_,
+               std::vector<std::shared_ptr<OrderBy>> order_,
+               std::shared_ptr<Limit> limit_) :
+            tabs(std::move(tabs_)), conds(std::move(conds_)), orders(std::move(order_)), limit(std::move(limit_)),
+            items(std::move(items_)), group_bys(std::move(group_bys_)) {
+        has_sort = !(orders.empty());
+        has_limit = bool(limit);
+        has_group = true;
     }
 };
 
@@ -306,6 +339,9 @@ struct SemValue {
     std::shared_ptr<Field> sv_field;
     std::vector<std::shared_ptr<Field>> sv_fields;
 
+    std::shared_ptr<TableOption> sv_table_option;
+    std::vector<std::shared_ptr<TableOption>> sv_table_options;
+
     std::shared_ptr<Expr> sv_expr;
 
     std::shared_ptr<Value> sv_val;
@@ -326,6 +362,9 @@ struct SemValue {
 
     std::shared_ptr<AggreClause> sv_aggre_clause;
     AggregationType sv_aggre_type;
+
+    std::shared_ptr<SelectItem> sv_select_item;
+    std::vector<std::shared_ptr<SelectItem>> sv_select_items;
 };
 
 extern std::shared_ptr<ast::TreeNode> parse_tree;
@@ -85,6 +85,9 @@ private:
             std::cout << "CREATE_TABLE\n";
             print_val(x->tab_name, offset);
             print_node_list(x->fields, offset);
+            for (auto &option : x->options) {
+                print_val(option->key + "=" + option->value, offset);
+            }
         } else if (auto x = std::dynamic_pointer_cast<DropTable>(node)) {
             std::cout << "DROP_TABLE\n";
             print_val(x->tab_name, offset);
@@ -380,8 +380,8 @@ static void yynoreturn yy_fatal_error ( const char* msg  );
 	(yy_hold_char) = *yy_cp; \
 	*yy_cp = '\0'; \
 	(yy_c_buf_p) = yy_cp;
-#define YY_NUM_RULES 57
-#define YY_END_OF_BUFFER 58
+#define YY_NUM_RULES 60
+#define YY_END_OF_BUFFER 61
 /* This struct is not used in this scanner,
    but its presence is necessary. */
 struct yy_trans_info
@@ -389,30 +389,33 @@ struct yy_trans_info
 	flex_int32_t yy_verify;
 	flex_int32_t yy_nxt;
 	};
-static const flex_int16_t yy_accept[201] =
+static const flex_int16_t yy_accept[222] =
     {   0,
-        0,    0,    0,    0,   58,   56,    6,    7,    7,   56,
-       49,   50,   50,   56,   52,   49,   49,   51,   51,   51,
-       51,   51,   51,   51,   51,   51,   51,   51,   51,   51,
-       51,   51,   51,   51,   51,   51,    3,    4,    6,    7,
-        0,   55,    0,    5,   52,    1,   53,   47,   48,   46,
-       51,   51,   51,   45,   51,   51,   38,   51,   51,   51,
-       51,   51,   51,   51,   51,   51,   51,   51,   51,   51,
-       51,   51,   51,   51,   51,   51,   51,   51,   51,   51,
-       51,    2,    0,    0,    5,   53,   51,   33,   39,   51,
-       51,   51,   51,   51,   51,   51,   51,   51,   51,   51,
-
-       51,   51,   51,   51,   51,   27,   51,   51,   42,   43,
-       51,   51,   51,   25,   51,   41,   51,   51,   51,   51,
-        0,    0,   51,   51,   51,   28,   51,   51,   51,   51,
-       51,   17,   16,   35,   51,   22,   36,   51,   51,   19,
-       34,   51,   51,   51,   51,    8,   51,   51,   51,   51,
-        0,    0,    0,   11,    9,   51,   51,   44,   51,   51,
-       51,   29,   32,   51,   40,   37,   51,   51,   15,   51,
-       51,   23,    0,   31,   10,   14,   51,   21,   18,   51,
-       26,   13,   24,   20,    0,    0,   51,   51,    0,   30,
-       12,    0,    0,    0,    0,    0,    0,   54,    0,    0
-
+        0,    0,    0,    0,   61,   59,    6,    7,    7,   59,
+       52,   52,   52,   53,   52,   53,   52,   59,   55,   52,
+       52,   52,   52,   54,   54,   54,   54,   54,   54,   54,
+       54,   54,   54,   54,   54,   54,   54,   54,   54,   54,
+       54,   54,   54,    3,    3,    4,    6,    7,    0,   58,
+        0,    5,   55,    1,   56,   50,   51,   49,   54,   54,
+       54,   54,   46,   54,   54,   54,   39,   54,   54,   54,
+       54,   54,   54,   54,   54,   54,   54,   54,   54,   54,
+       54,   54,   54,   54,   54,   54,   54,   54,   54,   54,
+       54,   54,   54,   54,    2,    0,    0,    5,   56,   54,
+
+       33,   40,   54,   54,   54,   54,   54,   54,   54,   54,
+       54,   54,   54,   54,   54,   54,   54,   54,   54,   27,
+       54,   54,   43,   44,   54,   54,   54,   25,   54,   42,
+       54,   54,   54,   54,   54,   54,    0,    0,   54,   54,
+       54,   28,   54,   54,   54,   54,   54,   17,   16,   35,
+       54,   22,   54,   36,   54,   54,   19,   34,   54,   54,
+       54,   54,    8,   54,   54,   54,   54,   54,   47,    0,
+        0,    0,   11,    9,   54,   54,   45,   54,   54,   54,
+       29,   38,   32,   54,   41,   37,   54,   54,   15,   54,
+       48,   54,   23,    0,   31,   10,   14,   54,   21,   18,
+
+       54,   26,   13,   24,   20,    0,    0,   54,   54,    0,
+       30,   12,    0,    0,    0,    0,    0,    0,   57,    0,
+        0
     } ;
 
 static const YY_CHAR yy_ec[256] =
@@ -449,125 +452,164 @@ static const YY_CHAR yy_ec[256] =
 
 static const YY_CHAR yy_meta[70] =
     {   0,
-        1,    1,    2,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    3,    1,    1,    1,    1,    1,    3,
-        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
-        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
-        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
-        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
-        3,    3,    3,    3,    3,    3,    3,    3,    3
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1
     } ;
 
-static const flex_int16_t yy_base[205] =
+static const flex_int16_t yy_base[222] =
     {   0,
-        0,    0,  387,  377,  382,  397,  379,  397,  377,   65,
-      397,  397,   60,  352,   61,   58,  337,   51,   57,   53,
-       58,   48,   55,    0,   59,   60,   62,   69,  101,   62,
-       68,  103,   85,   83,  105,  105,  397,  341,  350,  397,
-      229,  397,   89,    0,  121,  397,  190,  397,  397,  397,
-        0,  100,  113,  115,  112,  113,    0,  120,  109,  121,
-      109,  119,  112,  124,  120,  125,  130,  152,  141,  138,
-      134,  146,  158,  152,  153,  152,  156,  172,  171,  166,
-      174,  397,  194,  216,    0,  175,  163,    0,    0,  175,
-      178,  174,  181,  185,  202,  202,  204,  209,  198,  196,
-
-      217,  206,  205,  217,  218,  209,  212,  218,    0,    0,
-      223,  218,  226,    0,  211,    0,  220,  235,  218,  224,
-      251,  274,  231,  241,  247,    0,  254,  245,  248,  250,
-      251,    0,    0,    0,  252,    0,    0,  249,  256,    0,
-        0,  255,  259,  276,  276,    0,  275,  262,  278,  279,
-      299,  300,  322,    0,    0,  268,  271,    0,  296,  294,
-      306,    0,    0,  295,    0,    0,  311,  297,  299,  314,
-      302,    0,  337,    0,    0,    0,  309,    0,    0,  321,
-        0,    0,    0,    0,  339,  345,  321,  319,  358,    0,
-        0,  353,  365,  369,  361,  372,  373,  397,  137,  397,
-
-      387,  390,   85,  393
+        1,    1,   70,    1,    1,  714,  140,  714,  141,  144,
+      714,  714,  714,  714,  714,  214,  714,  215,  205,  714,
+      218,  714,  220,  219,  268,  270,  314,  281,  304,  309,
+      312,  257,  305,  252,  315,  339,  308,  319,  351,  336,
+      346,  343,  359,  714,  714,  221,    1,  714,  129,  714,
+      213,  413,    1,  714,  299,  714,  714,  714,    1,    1,
+      340,  460,  462,    1,  459,  460,    1,  467,  456,  465,
+      452,  461,  459,  466,  463,  466,  467,  471,  494,  475,
+      472,  463,  475,  499,  494,  505,  501,  505,  517,  516,
+      512,  510,  518,  506,  714,  208,  212,    1,    1,  509,
+
+        1,    1,  519,  521,  515,  518,  520,  534,  531,  532,
+      537,  525,  533,  554,  546,  543,  549,  563,  564,  555,
+      557,  563,    1,    1,  568,  562,  570,    1,  554,    1,
+      567,  579,  568,  563,  568,  579,  218,  216,  570,  574,
+      578,    1,  584,  583,  584,  587,  590,    1,    1,    1,
+      592,    1,  600,    1,  596,  603,    1,    1,  602,  605,
+      615,  621,    1,  620,  607,  623,  626,  628,    1,  217,
+      224,  282,    1,    1,  616,  618,    1,  629,  630,  635,
+        1,    1,    1,  624,    1,    1,  640,  629,  634,  649,
+        1,  639,    1,  296,    1,    1,    1,  642,    1,    1,
+
+      659,    1,    1,    1,    1,  280,  303,  659,  657,  380,
+        1,    1,  294,  297,  382,  306,  312,  385,  714,  345,
+      714
     } ;
 
-static const flex_int16_t yy_def[205] =
+static const flex_int16_t yy_def[222] =
     {   0,
-      200,    1,  201,  201,  200,  200,  200,  200,  200,  202,
-      200,  200,  200,  200,  200,  200,  200,  203,  203,  203,
-      203,  203,  203,  203,  203,  203,  203,  203,  203,  203,
-      203,  203,  203,  203,  203,  203,  200,  200,  200,  200,
-      202,  200,  202,  204,  200,  200,  200,  200,  200,  200,
-      203,  203,  203,  203,  203,  203,  203,  203,  203,  203,
-      203,  203,  203,  203,  203,  203,  203,  203,  203,  203,
-      203,  203,  203,  203,  203,  203,  203,  203,  203,  203,
-      203,  200,  202,  202,  204,  200,  203,  203,  203,  203,
-      203,  203,  203,  203,  203,  203,  203,  203,  203,  203,
-
-      203,  203,  203,  203,  203,  203,  203,  203,  203,  203,
-      203,  203,  203,  203,  203,  203,  203,  203,  203,  203,
-      202,  202,  203,  203,  203,  203,  203,  203,  203,  203,
-      203,  203,  203,  203,  203,  203,  203,  203,  203,  203,
-      203,  203,  203,  203,  203,  203,  203,  203,  203,  203,
-      202,  202,  202,  203,  203,  203,  203,  203,  203,  203,
-      203,  203,  203,  203,  203,  203,  203,  203,  203,  203,
-      203,  203,  202,  203,  203,  203,  203,  203,  203,  203,
-      203,  203,  203,  203,  202,  202,  203,  203,  202,  203,
-      203,  202,  202,  202,  202,  202,  202,  200,  202,    0,
-
-      200,  200,  200,  200
+      221,    1,    1,    3,  221,  221,  221,  221,  221,    1,
+      221,  221,  221,  221,  221,  221,  221,  221,   16,  221,
+      221,  221,  221,  221,   24,   24,   25,   24,   28,   28,
+       28,   28,   28,   28,   34,   34,   30,   33,   31,   34,
+       34,   34,   34,  221,  221,  221,    7,  221,   10,  221,
+       10,    7,   19,  221,  221,  221,  221,  221,   34,   34,
+       33,   34,   34,   34,   34,   34,   34,   34,   34,   31,
+       34,   34,   33,   34,   33,   33,   33,   34,   34,   34,
+       34,   28,   32,   34,   34,   34,   33,   34,   34,   34,
+       34,   34,   31,   34,  221,   10,   51,   52,   55,   30,
+
+       34,   34,   34,   34,   30,   34,   32,   34,   31,   31,
+       34,   34,   34,   34,   34,   34,   34,   31,   31,   33,
+       32,   34,   34,   34,   31,   34,   31,   34,   34,   34,
+       34,   34,   32,   34,   30,   34,   10,   51,   34,   32,
+       32,   34,   34,   34,   34,   34,   34,   34,   34,   34,
+       34,   34,   34,   34,   28,   30,   34,   34,   34,   30,
+       34,   34,   34,   31,   34,   34,   31,   31,   34,   10,
+       49,   49,   34,   34,   34,   34,   34,   31,   34,   31,
+       34,   34,   34,   34,   34,   34,   34,   34,   34,   31,
+       34,   34,   34,   10,   34,   34,   34,   34,   34,   34,
+
+       34,   34,   34,   34,   34,   10,   49,   31,   34,   10,
+       34,   34,   49,   10,   10,   49,   10,   10,  221,   49,
+        0
     } ;
 
-static const flex_int16_t yy_nxt[467] =
+static const flex_int16_t yy_nxt[784] =
     {   0,
-        6,    7,    8,    9,   10,   11,   11,   11,   12,   11,
-       13,   11,   14,   15,    6,   11,   16,   11,   17,   18,
-       19,   20,   21,   22,   23,   24,   25,   26,   27,   24,
-       28,   29,   24,   30,   24,   24,   31,   32,   33,   34,
-       35,   36,   24,   24,    6,   18,   19,   20,   21,   22,
-       23,   24,   25,   26,   27,   24,   28,   29,   24,   30,
-       24,   31,   32,   33,   34,   35,   36,   24,   24,   42,
-       44,   52,   47,   45,   45,   48,   49,   61,   43,   58,
-       55,   62,   67,   53,   56,   65,   59,   51,   54,   60,
-       64,   66,   68,   42,   63,   69,   70,   52,   73,   83,
-
-       57,   74,   84,   61,   78,   58,   55,   62,   67,   53,
-       56,   65,   59,   54,   60,   64,   66,   79,   68,   63,
-       71,   69,   70,   73,   80,   57,   75,   74,   72,   76,
-       78,   81,   47,   87,   45,   88,   89,   90,   91,   92,
-       93,  198,   77,   79,   95,   99,   71,   96,   94,   97,
-       80,  100,   75,  101,   72,   76,   98,   81,  102,   87,
-      103,   88,   89,   90,   91,   92,   93,   77,  107,  108,
-       95,   99,   96,   94,  104,   97,  109,  100,  110,  101,
-      111,   98,  112,  113,  102,  115,  103,  116,   86,  105,
-      106,  114,  117,  118,  107,  108,  119,  120,   42,  123,
-
-      104,  109,  124,   86,  110,  125,  111,  121,  112,  113,
-      126,  115,  127,  116,  105,  106,  114,  128,  117,  118,
-       42,  129,  119,  120,  123,  130,   83,  131,  124,  122,
-      132,  125,  133,   42,  134,  126,  135,  136,  127,  137,
-      138,  139,  140,  128,  141,  142,  143,  129,  144,  145,
-      147,  130,  146,  131,  148,   42,  132,  149,  133,  134,
-      150,  151,  135,  136,  152,  137,  138,  139,  140,  154,
-      141,  142,  143,  155,  144,  145,  147,  146,   42,  156,
-      148,  157,  149,  158,   83,  150,  159,  153,  160,  161,
-      162,  163,  164,  165,  154,  166,  167,  168,  169,  155,
-
-      170,  171,  172,   42,   42,  156,  174,  157,  158,  175,
-      151,  159,  173,  160,  161,  162,  163,  164,  165,  176,
-      166,  177,  167,  168,  169,  170,   42,  171,  172,  178,
-      180,  174,   83,  179,  175,  181,  182,  183,  185,  184,
-      187,   42,  188,   42,  190,  176,  185,  177,  191,   42,
-      186,   39,  189,   82,   50,  178,  180,   42,  179,   46,
-      181,  182,   42,  183,  184,   42,  187,  193,  188,   42,
-      190,  192,  193,   42,  191,  196,   42,  198,  194,   40,
-       39,  200,  195,  196,   38,  197,  199,   37,   37,   37,
-       41,   41,   41,   85,   38,   85,    5,  200,  200,  200,
-
-      200,  200,  200,  200,  200,  200,  200,  200,  200,  200,
-      200,  200,  200,  200,  200,  200,  200,  200,  200,  200,
-      200,  200,  200,  200,  200,  200,  200,  200,  200,  200,
-      200,  200,  200,  200,  200,  200,  200,  200,  200,  200,
-      200,  200,  200,  200,  200,  200,  200,  200,  200,  200,
-      200,  200,  200,  200,  200,  200,  200,  200,  200,  200,
-      200,  200,  200,  200,  200,  200
+        5,    6,    7,    8,    9,   10,   11,   12,   13,   14,
+       15,   16,   17,   18,   19,    6,   20,   21,   22,   23,
+       24,   25,   26,   27,   28,   29,   30,   31,   32,   33,
+       34,   35,   36,   34,   37,   34,   34,   38,   39,   40,
+       41,   42,   43,   34,   34,    6,   24,   25,   26,   27,
+       28,   29,   30,   31,   32,   33,   34,   35,   36,   34,
+       37,   34,   38,   39,   40,   41,   42,   43,   34,   34,
+       44,   44,   45,   44,   44,   44,   44,   46,   44,   44,
+       44,   44,   44,   44,   44,   44,   44,   44,   44,   44,
+       44,   44,   44,   44,   44,   44,   44,   44,   44,   44,
+
+       44,   44,   44,   44,   44,   44,   44,   44,   44,   44,
+       44,   44,   44,   44,   44,   44,   44,   44,   44,   44,
+       44,   44,   44,   44,   44,   44,   44,   44,   44,   44,
+       44,   44,   44,   44,   44,   44,   44,   44,   44,    5,
+        5,   47,   49,   48,   49,   49,   49,   49,   50,   49,
+       49,   49,   49,   49,   49,   49,   49,   51,   49,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   49,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   49,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   49,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   49,   49,
+
+       49,   49,   49,   49,   49,   49,   49,   49,   49,   49,
+       49,   49,   49,    5,    5,  221,   55,    5,    5,    5,
+        5,  137,   54,   96,   52,  138,   97,   53,  170,  172,
+      194,  171,   59,   95,  170,   56,   57,   58,   60,   61,
+       60,   60,   60,   60,   60,   60,   60,   60,   60,   60,
+       60,   62,   60,   60,   60,   60,   63,   60,   60,   60,
+       60,   60,   60,   64,   60,   61,   60,   60,   60,   60,
+       60,   60,   60,   60,   60,   60,   60,   62,   60,   60,
+       60,   63,   60,   60,   60,   60,   60,   60,   60,   79,
+       60,   65,   96,  210,   60,   66,   68,  206,    5,   60,
+
+       60,   60,   60,   69,  206,   60,   70,   60,  214,  207,
+      215,   67,   99,   60,   60,   79,   60,   65,   60,   60,
+      217,   66,   68,   74,   60,  218,   60,   60,   60,   69,
+       60,   70,   60,   71,   75,   78,   67,   72,   80,   60,
+       76,   60,   81,   60,   84,   77,   60,   60,   74,  219,
+       73,   60,   85,    0,   60,   89,    0,   60,   82,   71,
+       75,   78,   92,   72,   80,   76,   83,   60,   81,   84,
+       77,   60,   60,  100,   86,   73,   60,   87,   85,   60,
+       90,   89,   60,   91,   82,   93,   94,    0,   92,  219,
+       88,    0,   83,  213,  214,  216,  217,    0,  220,  100,
+
+       86,    0,    0,   87,    0,    0,   90,    0,   91,    0,
+        0,   93,   94,   98,   98,   88,   98,   98,   98,   98,
+       98,   98,   98,   98,   98,   98,   98,   98,   98,   98,
+       98,   98,   98,   98,   98,   98,   98,   98,   98,   98,
+       98,   98,   98,   98,   98,   98,   98,   98,   98,   98,
+       98,   98,   98,   98,   98,   98,   98,   98,   98,   98,
+       98,   98,   98,   98,   98,   98,   98,   98,   98,   98,
+       98,   98,   98,   98,   98,   98,   98,   98,   98,   98,
+       98,   98,  101,  102,  103,  104,  105,  106,  108,    0,
+      109,  110,  112,  113,    0,  107,  114,    0,  111,  115,
+
+      116,  117,  121,  122,    0,  123,    0,  124,  101,  102,
+      103,  104,  105,  106,  108,  109,  118,  110,  112,  113,
+      107,  125,  114,  111,  126,  115,  116,  117,  121,  122,
+      123,  119,  120,  124,  129,  127,  130,  131,  132,  133,
+      134,  135,  118,  128,  136,  139,  140,  125,  141,  143,
+      126,  142,  144,  145,  146,  147,  119,  120,  148,  149,
+      129,  127,  130,  131,  132,  133,  134,  135,  128,  136,
+      139,  150,  140,  151,  141,  143,  142,  152,  144,  145,
+      146,  147,  153,  154,  148,  149,  155,  156,  157,  158,
+      159,  160,  161,  162,    0,  163,  150,  164,  165,  151,
+
+      166,    0,  167,  152,  168,  169,  174,  153,  173,  154,
+      175,  176,  155,  156,  157,  158,  159,  160,  161,  162,
+      163,  177,  178,  164,  165,  179,  166,  167,  180,  168,
+      181,  169,  174,  173,  182,  187,  175,  176,  183,  184,
+      185,  186,  188,  189,    0,  190,  177,  178,  191,  192,
+      179,  193,  197,  180,  195,  181,  196,  198,  199,  201,
+      182,  187,  200,  183,  184,  185,  186,  202,  188,  189,
+      190,  203,  204,  208,  191,  192,  205,  193,  197,  195,
+      209,  196,  211,  198,  199,  201,  212,  200,    0,    0,
+        0,    0,  202,    0,    0,    0,  203,    0,  204,  208,
+
+        0,  205,    0,    0,    0,    0,  209,    0,  211,    0,
+        0,    0,  212,  221,  221,  221,  221,  221,  221,  221,
+      221,  221,  221,  221,  221,  221,  221,  221,  221,  221,
+      221,  221,  221,  221,  221,  221,  221,  221,  221,  221,
+      221,  221,  221,  221,  221,  221,  221,  221,  221,  221,
+      221,  221,  221,  221,  221,  221,  221,  221,  221,  221,
+      221,  221,  221,  221,  221,  221,  221,  221,  221,  221,
+      221,  221,  221,  221,  221,  221,  221,  221,  221,  221,
+      221,  221,  221
     } ;
 
-static const flex_int16_t yy_chk[467] =
+static const flex_int16_t yy_chk[784] =
     {   0,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
@@ -575,51 +617,86 @@ static const flex_int16_t yy_chk[467] =
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,   10,
-       13,   18,   15,   13,   15,   16,   16,   21,   10,   20,
-       19,   21,   25,   18,   19,   23,   20,  203,   18,   20,
-       22,   23,   26,   43,   21,   27,   28,   18,   30,   43,
-
-       19,   31,   43,   21,   33,   20,   19,   21,   25,   18,
-       19,   23,   20,   18,   20,   22,   23,   34,   26,   21,
-       29,   27,   28,   30,   35,   19,   32,   31,   29,   32,
-       33,   36,   45,   52,   45,   53,   54,   55,   56,   58,
-       59,  199,   32,   34,   60,   63,   29,   61,   59,   62,
-       35,   64,   32,   65,   29,   32,   62,   36,   66,   52,
-       67,   53,   54,   55,   56,   58,   59,   32,   69,   70,
-       60,   63,   61,   59,   68,   62,   71,   64,   72,   65,
-       73,   62,   74,   75,   66,   76,   67,   77,   86,   68,
-       68,   75,   78,   79,   69,   70,   80,   81,   83,   87,
-
-       68,   71,   90,   47,   72,   91,   73,   83,   74,   75,
-       92,   76,   93,   77,   68,   68,   75,   94,   78,   79,
-       84,   95,   80,   81,   87,   96,   84,   97,   90,   84,
-       98,   91,   99,   41,  100,   92,  101,  102,   93,  103,
-      104,  105,  106,   94,  107,  108,  111,   95,  112,  113,
-      117,   96,  115,   97,  118,  121,   98,  119,   99,  100,
-      120,  121,  101,  102,  121,  103,  104,  105,  106,  123,
-      107,  108,  111,  124,  112,  113,  117,  115,  122,  125,
-      118,  127,  119,  128,  122,  120,  129,  122,  130,  131,
-      135,  138,  139,  142,  123,  143,  144,  145,  147,  124,
-
-      148,  149,  150,  151,  152,  125,  156,  127,  128,  157,
-      152,  129,  151,  130,  131,  135,  138,  139,  142,  159,
-      143,  160,  144,  145,  147,  148,  153,  149,  150,  161,
-      167,  156,  153,  164,  157,  168,  169,  170,  173,  171,
-      177,  173,  180,  185,  187,  159,  186,  160,  188,  186,
-      173,   39,  185,   38,   17,  161,  167,  192,  164,   14,
-      168,  169,  189,  170,  171,  195,  177,  192,  180,  193,
-      187,  189,  189,  194,  188,  195,  196,  197,  193,    9,
-        7,    5,  194,  194,    4,  196,  197,  201,  201,  201,
-      202,  202,  202,  204,    3,  204,  200,  200,  200,  200,
-
-      200,  200,  200,  200,  200,  200,  200,  200,  200,  200,
-      200,  200,  200,  200,  200,  200,  200,  200,  200,  200,
-      200,  200,  200,  200,  200,  200,  200,  200,  200,  200,
-      200,  200,  200,  200,  200,  200,  200,  200,  200,  200,
-      200,  200,  200,  200,  200,  200,  200,  200,  200,  200,
-      200,  200,  200,  200,  200,  200,  200,  200,  200,  200,
-      200,  200,  200,  200,  200,  200
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    7,
+        9,    7,   49,    9,   10,   10,   10,   10,   10,   10,
+       10,   10,   10,   10,   10,   10,   10,   10,   10,   10,
+       10,   10,   10,   10,   10,   10,   10,   10,   10,   10,
+       10,   10,   10,   10,   10,   10,   10,   10,   10,   10,
+       10,   10,   10,   10,   10,   10,   10,   10,   10,   10,
+       10,   10,   10,   10,   10,   10,   10,   10,   10,   10,
+
+       10,   10,   10,   10,   10,   10,   10,   10,   10,   10,
+       10,   10,   10,   16,   18,   19,   19,   21,   24,   23,
+       46,   96,   18,   51,   16,   97,   51,   16,  137,  138,
+      170,  137,   24,   46,  171,   21,   21,   23,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   25,   32,
+       26,   25,  172,  206,   34,   25,   26,  194,   55,   32,
+
+       25,   28,   26,   26,  207,   25,   26,   26,  213,  194,
+      214,   25,   55,   28,   25,   32,   26,   25,   28,   34,
+      216,   25,   26,   28,   32,  217,   25,   28,   26,   26,
+       25,   26,   26,   27,   29,   31,   25,   27,   33,   28,
+       29,   27,   35,   28,   37,   30,   29,   33,   28,  220,
+       27,   30,   38,    0,   31,   40,    0,   27,   36,   27,
+       29,   31,   42,   27,   33,   29,   36,   27,   35,   37,
+       30,   29,   33,   61,   39,   27,   30,   39,   38,   31,
+       41,   40,   27,   41,   36,   43,   43,    0,   42,  218,
+       39,    0,   36,  210,  210,  215,  215,    0,  218,   61,
+
+       39,    0,    0,   39,    0,    0,   41,    0,   41,    0,
+        0,   43,   43,   52,   52,   39,   52,   52,   52,   52,
+       52,   52,   52,   52,   52,   52,   52,   52,   52,   52,
+       52,   52,   52,   52,   52,   52,   52,   52,   52,   52,
+       52,   52,   52,   52,   52,   52,   52,   52,   52,   52,
+       52,   52,   52,   52,   52,   52,   52,   52,   52,   52,
+       52,   52,   52,   52,   52,   52,   52,   52,   52,   52,
+       52,   52,   52,   52,   52,   52,   52,   52,   52,   52,
+       52,   52,   62,   63,   65,   66,   68,   69,   70,    0,
+       71,   72,   73,   74,    0,   69,   75,    0,   72,   76,
+
+       77,   78,   80,   81,    0,   82,    0,   83,   62,   63,
+       65,   66,   68,   69,   70,   71,   79,   72,   73,   74,
+       69,   84,   75,   72,   85,   76,   77,   78,   80,   81,
+       82,   79,   79,   83,   87,   86,   88,   89,   90,   91,
+       92,   93,   79,   86,   94,  100,  103,   84,  104,  106,
+       85,  105,  107,  108,  109,  110,   79,   79,  111,  112,
+       87,   86,   88,   89,   90,   91,   92,   93,   86,   94,
+      100,  113,  103,  114,  104,  106,  105,  115,  107,  108,
+      109,  110,  116,  117,  111,  112,  118,  119,  120,  121,
+      122,  125,  126,  127,    0,  129,  113,  131,  132,  114,
+
+      133,    0,  134,  115,  135,  136,  140,  116,  139,  117,
+      141,  143,  118,  119,  120,  121,  122,  125,  126,  127,
+      129,  144,  145,  131,  132,  146,  133,  134,  147,  135,
+      151,  136,  140,  139,  153,  161,  141,  143,  155,  156,
+      159,  160,  162,  164,    0,  165,  144,  145,  166,  167,
+      146,  168,  178,  147,  175,  151,  176,  179,  180,  187,
+      153,  161,  184,  155,  156,  159,  160,  188,  162,  164,
+      165,  189,  190,  198,  166,  167,  192,  168,  178,  175,
+      201,  176,  208,  179,  180,  187,  209,  184,    0,    0,
+        0,    0,  188,    0,    0,    0,  189,    0,  190,  198,
+
+        0,  192,    0,    0,    0,    0,  201,    0,  208,    0,
+        0,    0,  209,  221,  221,  221,  221,  221,  221,  221,
+      221,  221,  221,  221,  221,  221,  221,  221,  221,  221,
+      221,  221,  221,  221,  221,  221,  221,  221,  221,  221,
+      221,  221,  221,  221,  221,  221,  221,  221,  221,  221,
+      221,  221,  221,  221,  221,  221,  221,  221,  221,  221,
+      221,  221,  221,  221,  221,  221,  221,  221,  221,  221,
+      221,  221,  221,  221,  221,  221,  221,  221,  221,  221,
+      221,  221,  221
     } ;
 
 static yy_state_type yy_last_accepting_state;
@@ -665,9 +742,9 @@ char *yytext;
         } \
     }
 
-#line 668 "lex.yy.cpp"
+#line 745 "lex.yy.cpp"
 
-#line 670 "lex.yy.cpp"
+#line 747 "lex.yy.cpp"
 
 #define INITIAL 0
 #define STATE_COMMENT 1
@@ -905,7 +982,7 @@ YY_DECL
 
 #line 53 "lex.l"
     /* block comment */
-#line 908 "lex.yy.cpp"
+#line 985 "lex.yy.cpp"
 
 	while ( /*CONSTCOND*/1 )		/* loops until end-of-file is reached */
 		{
@@ -932,13 +1009,13 @@ yy_match:
 			while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 				{
 				yy_current_state = (int) yy_def[yy_current_state];
-				if ( yy_current_state >= 201 )
+				if ( yy_current_state >= 222 )
 					yy_c = yy_meta[yy_c];
 				}
 			yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
 			++yy_cp;
 			}
-		while ( yy_base[yy_current_state] != 397 );
+		while ( yy_base[yy_current_state] != 714 );
 
 yy_find_action:
 		yy_act = yy_accept[yy_current_state];
@@ -1155,107 +1232,122 @@ YY_RULE_SETUP
 case 38:
 YY_RULE_SETUP
 #line 94 "lex.l"
-{  return BY;  }
+{ return GROUP; }
 	YY_BREAK
 case 39:
 YY_RULE_SETUP
 #line 95 "lex.l"
-{ return ASC; }
+{  return BY;  }
 	YY_BREAK
 case 40:
 YY_RULE_SETUP
 #line 96 "lex.l"
-{ return LIMIT; }
+{ return ASC; }
 	YY_BREAK
 case 41:
 YY_RULE_SETUP
 #line 97 "lex.l"
-{ return SUM; }
+{ return LIMIT; }
 	YY_BREAK
 case 42:
 YY_RULE_SETUP
 #line 98 "lex.l"
-{ return MAX; }
+{ return SUM; }
 	YY_BREAK
 case 43:
 YY_RULE_SETUP
 #line 99 "lex.l"
-{ return MIN; }
+{ return MAX; }
 	YY_BREAK
 case 44:
 YY_RULE_SETUP
 #line 100 "lex.l"
-{ return COUNT; }
+{ return MIN; }
 	YY_BREAK
 case 45:
 YY_RULE_SETUP
 #line 101 "lex.l"
-{ return AS; }
+{ return COUNT; }
 	YY_BREAK
-/* operators */
 case 46:
 YY_RULE_SETUP
-#line 103 "lex.l"
-{ return GEQ; }
+#line 102 "lex.l"
+{ return AS; }
 	YY_BREAK
 case 47:
 YY_RULE_SETUP
-#line 104 "lex.l"
-{ return LEQ; }
+#line 103 "lex.l"
+{ return WITH; }
 	YY_BREAK
 case 48:
 YY_RULE_SETUP
-#line 105 "lex.l"
-{ return NEQ; }
+#line 104 "lex.l"
+{ return USING; }
 	YY_BREAK
+/* operators */
 case 49:
 YY_RULE_SETUP
 #line 106 "lex.l"
-{ return yytext[0]; }
+{ return GEQ; }
 	YY_BREAK
 case 50:
 YY_RULE_SETUP
 #line 107 "lex.l"
-{ return yytext[0]; }
+{ return LEQ; }
 	YY_BREAK
-/* id */
 case 51:
 YY_RULE_SETUP
+#line 108 "lex.l"
+{ return NEQ; }
+	YY_BREAK
+case 52:
+YY_RULE_SETUP
 #line 109 "lex.l"
+{ return yytext[0]; }
+	YY_BREAK
+case 53:
+YY_RULE_SETUP
+#line 110 "lex.l"
+{ return yytext[0]; }
+	YY_BREAK
+/* id */
+case 54:
+YY_RULE_SETUP
+#line 112 "lex.l"
 {
     yylval->sv_str = yytext;
     return IDENTIFIER;
 }
 	YY_BREAK
 /* literals */
-case 52:
+case 55:
 YY_RULE_SETUP
-#line 114 "lex.l"
+#line 117 "lex.l"
 {
     yylval->sv_str = yytext;
     return VALUE_INT;
 }
 	YY_BREAK
-case 53:
+case 56:
 YY_RULE_SETUP
-#line 118 "lex.l"
+#line 121 "lex.l"
 {
     yylval->sv_float = atof(yytext);
     return VALUE_FLOAT;
 }
 	YY_BREAK
-case 54:
+case 57:
 YY_RULE_SETUP
-#line 122 "lex.l"
+#line 125 "lex.l"
 {
     yylval->sv_str = std::string(yytext + 1, strlen(yytext) - 2);
     return VALUE_DATETIME;
 }
 	YY_BREAK
-case 55:
-/* rule 55 can match eol */
+case 58:
+/* rule 58 can match eol */
 YY_RULE_SETUP
-#line 126 "lex.l"
+#line 129 "lex.l"
 {
     yylval->sv_str = std::string(yytext + 1, strlen(yytext) - 2);
     return VALUE_STRING;
@@ -1264,21 +1356,21 @@ YY_RULE_SETUP
 /* EOF */
 case YY_STATE_EOF(INITIAL):
 case YY_STATE_EOF(STATE_COMMENT):
-#line 132 "lex.l"
+#line 135 "lex.l"
 { return T_EOF; }
 	YY_BREAK
 /* unexpected char */
-case 56:
+case 59:
 YY_RULE_SETUP
-#line 134 "lex.l"
+#line 137 "lex.l"
 { std::cerr << "Lexer Error: unexpected character " << yytext[0] << std::endl; }
 	YY_BREAK
-case 57:
+case 60:
 YY_RULE_SETUP
-#line 135 "lex.l"
+#line 138 "lex.l"
 ECHO;
 	YY_BREAK
-#line 1281 "lex.yy.cpp"
+#line 1373 "lex.yy.cpp"
 
 	case YY_END_OF_BUFFER:
 		{
@@ -1573,7 +1665,7 @@ static int yy_get_next_buffer (void)
 		while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 			{
 			yy_current_state = (int) yy_def[yy_current_state];
-			if ( yy_current_state >= 201 )
+			if ( yy_current_state >= 222 )
 				yy_c = yy_meta[yy_c];
 			}
 		yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
@@ -1601,11 +1693,11 @@ static int yy_get_next_buffer (void)
 	while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 		{
 		yy_current_state = (int) yy_def[yy_current_state];
-		if ( yy_current_state >= 201 )
+		if ( yy_current_state >= 222 )
 			yy_c = yy_meta[yy_c];
 		}
 	yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
-	yy_is_jam = (yy_current_state == 200);
+	yy_is_jam = (yy_current_state == 221);
 
 		return yy_is_jam ? 0 : yy_current_state;
 }
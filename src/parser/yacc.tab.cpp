@@ -67,7 +67,7 @@
 
 
 /* First part of user prologue.  */
-#line 1 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+#line 1 "yacc.y"
 
 #include "ast.h"
 #include "yacc.tab.h"
@@ -82,7 +82,7 @@ void yyerror(YYLTYPE *locp, const char* s) {
 
 using namespace ast;
 
-#line 86 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 86 "yacc.tab.cpp"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -133,78 +133,86 @@ enum yysymbol_kind_t
   YYSYMBOL_MIN = 20,                       /* MIN  */
   YYSYMBOL_COUNT = 21,                     /* COUNT  */
   YYSYMBOL_AS = 22,                        /* AS  */
-  YYSYMBOL_WHERE = 23,                     /* WHERE  */
-  YYSYMBOL_UPDATE = 24,                    /* UPDATE  */
-  YYSYMBOL_SET = 25,                       /* SET  */
-  YYSYMBOL_SELECT = 26,                    /* SELECT  */
-  YYSYMBOL_INT = 27,                       /* INT  */
-  YYSYMBOL_CHAR = 28,                      /* CHAR  */
-  YYSYMBOL_FLOAT = 29,                     /* FLOAT  */
-  YYSYMBOL_BIGINT = 30,                    /* BIGINT  */
-  YYSYMBOL_DATETIME = 31,                  /* DATETIME  */
-  YYSYMBOL_INDEX = 32,                     /* INDEX  */
-  YYSYMBOL_AND = 33,                       /* AND  */
-  YYSYMBOL_JOIN = 34,                      /* JOIN  */
-  YYSYMBOL_EXIT = 35,                      /* EXIT  */
-  YYSYMBOL_HELP = 36,                      /* HELP  */
-  YYSYMBOL_TXN_BEGIN = 37,                 /* TXN_BEGIN  */
-  YYSYMBOL_TXN_COMMIT = 38,                /* TXN_COMMIT  */
-  YYSYMBOL_TXN_ABORT = 39,                 /* TXN_ABORT  */
-  YYSYMBOL_TXN_ROLLBACK = 40,              /* TXN_ROLLBACK  */
-  YYSYMBOL_ORDER_BY = 41,                  /* ORDER_BY  */
-  YYSYMBOL_LEQ = 42,                       /* LEQ  */
-  YYSYMBOL_NEQ = 43,                       /* NEQ  */
-  YYSYMBOL_GEQ = 44,                       /* GEQ  */
-  YYSYMBOL_T_EOF = 45,                     /* T_EOF  */
-  YYSYMBOL_IDENTIFIER = 46,                /* IDENTIFIER  */
-  YYSYMBOL_VALUE_INT = 47,                 /* VALUE_INT  */
-  YYSYMBOL_VALUE_DATETIME = 48,            /* VALUE_DATETIME  */
-  YYSYMBOL_VALUE_STRING = 49,              /* VALUE_STRING  */
-  YYSYMBOL_VALUE_FLOAT = 50,               /* VALUE_FLOAT  */
-  YYSYMBOL_VALUE_BIGINT = 51,              /* VALUE_BIGINT  */
-  YYSYMBOL_52_ = 52,                       /* ';'  */
-  YYSYMBOL_53_ = 53,                       /* '('  */
-  YYSYMBOL_54_ = 54,                       /* ')'  */
-  YYSYMBOL_55_ = 55,                       /* ','  */
-  YYSYMBOL_56_ = 56,                       /* '.'  */
-  YYSYMBOL_57_ = 57,                       /* '='  */
-  YYSYMBOL_58_ = 58,                       /* '<'  */
-  YYSYMBOL_59_ = 59,                       /* '>'  */
-  YYSYMBOL_60_ = 60,                       /* '+'  */
-  YYSYMBOL_61_ = 61,                       /* '*'  */
-  YYSYMBOL_YYACCEPT = 62,                  /* $accept  */
-  YYSYMBOL_start = 63,                     /* start  */
-  YYSYMBOL_stmt = 64,                      /* stmt  */
-  YYSYMBOL_txnStmt = 65,                   /* txnStmt  */
-  YYSYMBOL_dbStmt = 66,                    /* dbStmt  */
-  YYSYMBOL_ddl = 67,                       /* ddl  */
-  YYSYMBOL_dml = 68,                       /* dml  */
-  YYSYMBOL_fieldList = 69,                 /* fieldList  */
-  YYSYMBOL_colNameList = 70,               /* colNameList  */
-  YYSYMBOL_field = 71,                     /* field  */
-  YYSYMBOL_type = 72,                      /* type  */
-  YYSYMBOL_valueList = 73,                 /* valueList  */
-  YYSYMBOL_value = 74,                     /* value  */
-  YYSYMBOL_condition = 75,                 /* condition  */
-  YYSYMBOL_optWhereClause = 76,            /* optWhereClause  */
-  YYSYMBOL_whereClause = 77,               /* whereClause  */
-  YYSYMBOL_col = 78,                       /* col  */
-  YYSYMBOL_colList = 79,                   /* colList  */
-  YYSYMBOL_op = 80,                        /* op  */
-  YYSYMBOL_expr = 81,                      /* expr  */
-  YYSYMBOL_setClauses = 82,                /* setClauses  */
-  YYSYMBOL_setClause = 83,                 /* setClause  */
-  YYSYMBOL_aggreClause = 84,               /* aggreClause  */
-  YYSYMBOL_selector = 85,                  /* selector  */
-  YYSYMBOL_tableList = 86,                 /* tableList  */
-  YYSYMBOL_opt_order_clause = 87,          /* opt_order_clause  */
-  YYSYMBOL_order_clauses = 88,             /* order_clauses  */
-  YYSYMBOL_order_clause = 89,              /* order_clause  */
-  YYSYMBOL_opt_asc_desc = 90,              /* opt_asc_desc  */
-  YYSYMBOL_opt_limit_clause = 91,          /* opt_limit_clause  */
-  YYSYMBOL_tbName = 92,                    /* tbName  */
-  YYSYMBOL_colName = 93,                   /* colName  */
-  YYSYMBOL_NICK = 94                       /* NICK  */
+  YYSYMBOL_WITH = 23,                      /* WITH  */
+  YYSYMBOL_USING = 24,                     /* USING  */
+  YYSYMBOL_GROUP = 25,                     /* GROUP  */
+  YYSYMBOL_WHERE = 26,                     /* WHERE  */
+  YYSYMBOL_UPDATE = 27,                    /* UPDATE  */
+  YYSYMBOL_SET = 28,                       /* SET  */
+  YYSYMBOL_SELECT = 29,                    /* SELECT  */
+  YYSYMBOL_INT = 30,                       /* INT  */
+  YYSYMBOL_CHAR = 31,                      /* CHAR  */
+  YYSYMBOL_FLOAT = 32,                     /* FLOAT  */
+  YYSYMBOL_BIGINT = 33,                    /* BIGINT  */
+  YYSYMBOL_DATETIME = 34,                  /* DATETIME  */
+  YYSYMBOL_INDEX = 35,                     /* INDEX  */
+  YYSYMBOL_AND = 36,                       /* AND  */
+  YYSYMBOL_JOIN = 37,                      /* JOIN  */
+  YYSYMBOL_EXIT = 38,                      /* EXIT  */
+  YYSYMBOL_HELP = 39,                      /* HELP  */
+  YYSYMBOL_TXN_BEGIN = 40,                 /* TXN_BEGIN  */
+  YYSYMBOL_TXN_COMMIT = 41,                /* TXN_COMMIT  */
+  YYSYMBOL_TXN_ABORT = 42,                 /* TXN_ABORT  */
+  YYSYMBOL_TXN_ROLLBACK = 43,              /* TXN_ROLLBACK  */
+  YYSYMBOL_ORDER_BY = 44,                  /* ORDER_BY  */
+  YYSYMBOL_LEQ = 45,                       /* LEQ  */
+  YYSYMBOL_NEQ = 46,                       /* NEQ  */
+  YYSYMBOL_GEQ = 47,                       /* GEQ  */
+  YYSYMBOL_T_EOF = 48,                     /* T_EOF  */
+  YYSYMBOL_IDENTIFIER = 49,                /* IDENTIFIER  */
+  YYSYMBOL_VALUE_INT = 50,                 /* VALUE_INT  */
+  YYSYMBOL_VALUE_DATETIME = 51,            /* VALUE_DATETIME  */
+  YYSYMBOL_VALUE_STRING = 52,              /* VALUE_STRING  */
+  YYSYMBOL_VALUE_FLOAT = 53,               /* VALUE_FLOAT  */
+  YYSYMBOL_VALUE_BIGINT = 54,              /* VALUE_BIGINT  */
+  YYSYMBOL_55_ = 55,                       /* ';'  */
+  YYSYMBOL_56_ = 56,                       /* '('  */
+  YYSYMBOL_57_ = 57,                       /* ')'  */
+  YYSYMBOL_58_ = 58,                       /* ','  */
+  YYSYMBOL_59_ = 59,                       /* '='  */
+  YYSYMBOL_60_ = 60,                       /* '.'  */
+  YYSYMBOL_61_ = 61,                       /* '<'  */
+  YYSYMBOL_62_ = 62,                       /* '>'  */
+  YYSYMBOL_63_ = 63,                       /* '+'  */
+  YYSYMBOL_64_ = 64,                       /* '*'  */
+  YYSYMBOL_YYACCEPT = 65,                  /* $accept  */
+  YYSYMBOL_start = 66,                     /* start  */
+  YYSYMBOL_stmt = 67,                      /* stmt  */
+  YYSYMBOL_txnStmt = 68,                   /* txnStmt  */
+  YYSYMBOL_dbStmt = 69,                    /* dbStmt  */
+  YYSYMBOL_ddl = 70,                       /* ddl  */
+  YYSYMBOL_dml = 71,                       /* dml  */
+  YYSYMBOL_fieldList = 72,                 /* fieldList  */
+  YYSYMBOL_tableOptionList = 73,           /* tableOptionList  */
+  YYSYMBOL_tableOption = 74,               /* tableOption  */
+  YYSYMBOL_colNameList = 75,               /* colNameList  */
+  YYSYMBOL_field = 76,                     /* field  */
+  YYSYMBOL_type = 77,                      /* type  */
+  YYSYMBOL_valueList = 78,                 /* valueList  */
+  YYSYMBOL_value = 79,                     /* value  */
+  YYSYMBOL_condition = 80,                 /* condition  */
+  YYSYMBOL_optWhereClause = 81,            /* optWhereClause  */
+  YYSYMBOL_whereClause = 82,               /* whereClause  */
+  YYSYMBOL_col = 83,                       /* col  */
+  YYSYMBOL_colList = 84,                   /* colList  */
+  YYSYMBOL_op = 85,                        /* op  */
+  YYSYMBOL_expr = 86,                      /* expr  */
+  YYSYMBOL_setClauses = 87,                /* setClauses  */
+  YYSYMBOL_setClause = 88,                 /* setClause  */
+  YYSYMBOL_aggreClause = 89,               /* aggreClause  */
+  YYSYMBOL_selItem = 90,                   /* selItem  */
+  YYSYMBOL_selItemList = 91,               /* selItemList  */
+  YYSYMBOL_selector = 92,                  /* selector  */
+  YYSYMBOL_tableList = 93,                 /* tableList  */
+  YYSYMBOL_opt_group_clause = 94,          /* opt_group_clause  */
+  YYSYMBOL_opt_order_clause = 95,          /* opt_order_clause  */
+  YYSYMBOL_order_clauses = 96,             /* order_clauses  */
+  YYSYMBOL_order_clause = 97,              /* order_clause  */
+  YYSYMBOL_opt_asc_desc = 98,              /* opt_asc_desc  */
+  YYSYMBOL_opt_limit_clause = 99,          /* opt_limit_clause  */
+  YYSYMBOL_tbName = 100,                   /* tbName  */
+  YYSYMBOL_colName = 101,                  /* colName  */
+  YYSYMBOL_NICK = 102                      /* NICK  */
 };
 typedef enum yysymbol_kind_t yysymbol_kind_t;
 
@@ -533,21 +541,21 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  45
+#define YYFINAL  46
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   172
+#define YYLAST   200
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  62
+#define YYNTOKENS  65
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  33
+#define YYNNTS  38
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  87
+#define YYNRULES  100
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  177
+#define YYNSTATES  203
 
 /* YYMAXUTOK -- Last valid token kind.  */
-#define YYMAXUTOK   306
+#define YYMAXUTOK   309
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
@@ -565,9 +573,9 @@ static const yytype_int8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-      53,    54,    61,    60,    55,     2,    56,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,    52,
-      58,    57,    59,     2,     2,     2,     2,     2,     2,     2,
+      56,    57,    64,    63,    58,     2,    60,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,    55,
+      61,    59,    62,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -591,22 +599,24 @@ static const yytype_int8 yytranslate[] =
       15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
       25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
       35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
-      45,    46,    47,    48,    49,    50,    51
+      45,    46,    47,    48,    49,    50,    51,    52,    53,    54
 };
 
 #if YYDEBUG
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,    61,    61,    66,    71,    76,    84,    85,    86,    87,
-      91,    95,    99,   103,   110,   114,   121,   125,   129,   133,
-     137,   144,   148,   152,   156,   160,   167,   171,   178,   182,
-     189,   196,   200,   204,   208,   212,   219,   223,   230,   234,
-     238,   242,   246,   253,   260,   261,   268,   272,   279,   283,
-     290,   294,   301,   305,   309,   313,   317,   321,   328,   332,
-     339,   343,   350,   354,   358,   365,   369,   373,   377,   381,
-     388,   392,   396,   400,   404,   411,   415,   419,   423,   430,
-     437,   441,   446,   452,   453,   459,   461,   463
+       0,    65,    65,    70,    75,    80,    88,    89,    90,    91,
+      95,    99,   103,   107,   114,   118,   125,   129,   133,   137,
+     141,   145,   149,   153,   157,   164,   168,   172,   176,   197,
+     201,   208,   212,   219,   223,   230,   234,   241,   248,   252,
+     256,   260,   264,   271,   275,   282,   286,   290,   294,   298,
+     305,   312,   313,   320,   324,   331,   335,   342,   346,   353,
+     357,   361,   365,   369,   373,   380,   384,   391,   395,   402,
+     406,   410,   417,   421,   425,   429,   433,   440,   444,   451,
+     455,   462,   466,   470,   474,   478,   485,   489,   493,   497,
+     501,   505,   512,   519,   523,   528,   534,   535,   541,   543,
+     545
 };
 #endif
 
@@ -625,16 +635,17 @@ static const char *const yytname[] =
   "\"end of file\"", "error", "\"invalid token\"", "SHOW", "TABLES",
   "CREATE", "TABLE", "DROP", "DESC", "INSERT", "INTO", "VALUES", "DELETE",
   "FROM", "ASC", "ORDER", "BY", "LIMIT", "SUM", "MAX", "MIN", "COUNT",
-  "AS", "WHERE", "UPDATE", "SET", "SELECT", "INT", "CHAR", "FLOAT",
-  "BIGINT", "DATETIME", "INDEX", "AND", "JOIN", "EXIT", "HELP",
-  "TXN_BEGIN", "TXN_COMMIT", "TXN_ABORT", "TXN_ROLLBACK", "ORDER_BY",
-  "LEQ", "NEQ", "GEQ", "T_EOF", "IDENTIFIER", "VALUE_INT",
+  "AS", "WITH", "USING", "GROUP", "WHERE", "UPDATE", "SET", "SELECT",
+  "INT", "CHAR", "FLOAT", "BIGINT", "DATETIME", "INDEX", "AND", "JOIN",
+  "EXIT", "HELP", "TXN_BEGIN", "TXN_COMMIT", "TXN_ABORT", "TXN_ROLLBACK",
+  "ORDER_BY", "LEQ", "NEQ", "GEQ", "T_EOF", "IDENTIFIER", "VALUE_INT",
   "VALUE_DATETIME", "VALUE_STRING", "VALUE_FLOAT", "VALUE_BIGINT", "';'",
-  "'('", "')'", "','", "'.'", "'='", "'<'", "'>'", "'+'", "'*'", "$accept",
+  "'('", "')'", "','", "'='", "'.'", "'<'", "'>'", "'+'", "'*'", "$accept",
   "start", "stmt", "txnStmt", "dbStmt", "ddl", "dml", "fieldList",
-  "colNameList", "field", "type", "valueList", "value", "condition",
-  "optWhereClause", "whereClause", "col", "colList", "op", "expr",
-  "setClauses", "setClause", "aggreClause", "selector", "tableList",
+  "tableOptionList", "tableOption", "colNameList", "field", "type",
+  "valueList", "value", "condition", "optWhereClause", "whereClause",
+  "col", "colList", "op", "expr", "setClauses", "setClause", "aggreClause",
+  "selItem", "selItemList", "selector", "tableList", "opt_group_clause",
   "opt_order_clause", "order_clauses", "order_clause", "opt_asc_desc",
   "opt_limit_clause", "tbName", "colName", "NICK", YY_NULLPTR
 };
@@ -646,12 +657,12 @@ yysymbol_name (yysymbol_kind_t yysymbol)
 }
 #endif
 
-#define YYPACT_NINF (-89)
+#define YYPACT_NINF (-140)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF (-86)
+#define YYTABLE_NINF (-99)
 
 #define yytable_value_is_error(Yyn) \
   0
@@ -660,24 +671,27 @@ yysymbol_name (yysymbol_kind_t yysymbol)
    STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-      68,     7,     9,    20,   -29,    19,     6,   -29,    13,   -89,
-     -89,   -89,   -89,   -89,   -89,   -89,    38,    -7,   -89,   -89,
-     -89,   -89,   -89,    43,   -29,   -29,   -29,   -29,   -89,   -89,
-     -29,   -29,    36,    11,    25,    26,    40,    16,   -89,   -89,
-      41,    49,    82,    42,   -89,   -89,   -89,    45,    48,    61,
-     -89,    87,    91,    98,    76,    95,    95,    95,   -21,    95,
-     -29,   -29,    76,   -89,    76,    76,    76,    89,    95,   -89,
-     -89,   -20,   -89,    86,    90,    92,    93,    94,    96,   -89,
-     -18,   -89,   -18,   -89,   -48,   -89,   103,    -1,   -89,    15,
-      88,   -89,   112,    24,    76,   -89,    69,   127,   129,   130,
-     132,   133,   -29,   -29,   -89,   141,   -89,    76,   -89,   104,
-     -89,   -89,   -89,   -89,   -89,    76,   -89,   -89,   -89,   -89,
-     -89,   -89,    35,   -89,    95,   -89,   -89,   -89,   -89,   -89,
-     -89,    78,   -89,   -89,    37,   113,   113,   113,   113,   113,
-     -89,   -89,   142,   143,   -89,   114,   -89,   -89,    88,   -89,
-     -89,   -89,   -89,    88,   -89,   -89,   -89,   -89,   -89,   -89,
-     -89,    95,   115,   -89,   109,   -89,   -89,    22,   110,   -89,
-     -89,   -89,   -89,   -89,   -89,    95,   -89
+      80,     5,     2,    12,    -8,    52,    71,    -8,    14,  -140,
+    -140,  -140,  -140,  -140,  -140,  -140,    65,    31,  -140,  -140,
+    -140,  -140,  -140,    87,    -8,    -8,    -8,    -8,  -140,  -140,
+      -8,    -8,    77,    60,    73,    82,    83,    76,  -140,  -140,
+    -140,  -140,    69,   124,    91,  -140,  -140,  -140,   103,    97,
+      98,  -140,    99,   145,   131,   109,   110,   110,   110,   -13,
+      -5,    -8,   109,  -140,   109,   109,   109,   104,   110,  -140,
+    -140,   -20,  -140,   102,   105,   106,   107,   108,   112,  -140,
+     -15,  -140,  -140,   -12,  -140,   111,    -1,  -140,    22,    96,
+    -140,   130,     8,   109,  -140,    61,   146,   148,   149,   150,
+     151,    -8,    -8,   142,   152,   109,  -140,   118,  -140,  -140,
+    -140,  -140,    48,   109,  -140,  -140,  -140,  -140,  -140,  -140,
+      24,  -140,   110,  -140,  -140,  -140,  -140,  -140,  -140,    81,
+    -140,  -140,    45,   127,   127,   127,   127,   127,  -140,  -140,
+     161,   163,   123,  -140,   132,   125,   134,  -140,  -140,    96,
+    -140,  -140,  -140,  -140,    96,  -140,  -140,  -140,  -140,  -140,
+    -140,  -140,   110,   164,   167,   136,   129,   136,   165,  -140,
+    -140,  -140,   133,   110,   137,  -140,   135,    33,  -140,  -140,
+      36,   139,   110,    15,   138,  -140,  -140,    54,  -140,   136,
+    -140,   136,  -140,  -140,  -140,  -140,   110,  -140,  -140,  -140,
+      67,  -140,  -140
 };
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
@@ -687,40 +701,43 @@ static const yytype_int8 yydefact[] =
 {
        0,     0,     0,     0,     0,     0,     0,     0,     0,     4,
        3,    10,    11,    12,    13,     5,     0,     0,     9,     6,
-       7,     8,    14,     0,     0,     0,     0,     0,    85,    18,
-       0,     0,     0,     0,     0,     0,     0,    86,    70,    50,
-      71,     0,     0,     0,    49,     1,     2,     0,     0,     0,
-      17,     0,     0,    44,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,    15,     0,     0,     0,     0,     0,    22,
-      86,    44,    60,     0,     0,     0,     0,     0,     0,    51,
-      44,    72,    44,    48,     0,    26,     0,     0,    28,     0,
-       0,    46,    45,     0,     0,    23,     0,     0,     0,     0,
-       0,     0,     0,     0,    24,    76,    16,     0,    31,     0,
-      33,    34,    35,    30,    19,     0,    20,    38,    42,    40,
-      39,    41,     0,    36,     0,    56,    55,    57,    52,    53,
-      54,     0,    61,    62,     0,     0,     0,     0,     0,     0,
-      74,    73,     0,    83,    27,     0,    29,    21,     0,    47,
-      58,    59,    43,     0,    64,    87,    65,    66,    67,    69,
-      68,     0,     0,    25,     0,    37,    63,    82,    75,    77,
-      84,    32,    81,    80,    79,     0,    78
+       7,     8,    14,     0,     0,     0,     0,     0,    98,    19,
+       0,     0,     0,     0,     0,     0,     0,    99,    81,    77,
+      78,    79,    82,     0,     0,    56,     1,     2,     0,     0,
+       0,    18,     0,     0,    51,     0,     0,     0,     0,     0,
+       0,     0,     0,    15,     0,     0,     0,     0,     0,    26,
+      99,    51,    67,     0,     0,     0,     0,     0,     0,    80,
+      51,    83,    55,     0,    29,     0,     0,    35,     0,     0,
+      53,    52,     0,     0,    27,     0,     0,     0,     0,     0,
+       0,     0,     0,    87,    16,     0,    38,     0,    40,    41,
+      42,    37,    20,     0,    24,    45,    49,    47,    46,    48,
+       0,    43,     0,    63,    62,    64,    59,    60,    61,     0,
+      68,    69,     0,     0,     0,     0,     0,     0,    85,    84,
+       0,    89,     0,    30,     0,     0,     0,    36,    25,     0,
+      54,    65,    66,    50,     0,    71,   100,    72,    73,    74,
+      76,    75,     0,     0,    96,     0,     0,     0,    22,    44,
+      70,    57,    86,     0,     0,    28,     0,     0,    31,    39,
+       0,     0,     0,    95,    88,    90,    97,     0,    17,     0,
+      21,     0,    58,    94,    93,    92,     0,    33,    34,    32,
+       0,    91,    23
 };
 
 /* YYPGOTO[NTERM-NUM].  */
-static const yytype_int8 yypgoto[] =
+static const yytype_int16 yypgoto[] =
 {
-     -89,   -89,   -89,   -89,   -89,   -89,   -89,   -89,   100,    57,
-     -89,   -89,   -88,    44,   -62,   -89,    -8,   -89,   -89,   -89,
-     -89,    75,   -89,   -89,   111,   -89,   -89,    -5,   -89,   -89,
-      -3,   -52,   -27
+    -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,  -139,     1,
+     126,    84,  -140,  -140,   -90,    75,   -22,  -140,   -56,  -140,
+    -140,  -140,  -140,   100,  -140,   140,  -140,  -140,  -140,  -140,
+    -140,  -140,     3,  -140,  -140,     0,   -45,   -60
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_uint8 yydefgoto[] =
 {
-       0,    16,    17,    18,    19,    20,    21,    84,    87,    85,
-     113,   122,   123,    91,    69,    92,    93,    40,   131,   152,
-      71,    72,    41,    42,    80,   143,   168,   169,   174,   163,
-      43,    44,   156
+       0,    16,    17,    18,    19,    20,    21,    83,   177,   178,
+      86,    84,   111,   120,   121,    90,    69,    91,    39,   172,
+     129,   153,    71,    72,    40,    41,    42,    43,    80,   141,
+     164,   184,   185,   195,   175,    44,    45,   157
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
@@ -728,98 +745,111 @@ static const yytype_uint8 yydefgoto[] =
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int16 yytable[] =
 {
-      39,    29,    73,    68,    32,    68,   106,   107,   133,    95,
-      83,    22,    86,    88,    88,    24,   102,    28,   104,    31,
-     105,    48,    49,    50,    51,    37,    26,    52,    53,    30,
-     172,    33,    34,    35,    36,    94,   173,   103,    45,    23,
-      77,    25,    73,   150,   134,    46,   154,    74,    75,    76,
-      78,    79,    27,   114,   115,    86,    47,    81,    81,    37,
-     165,    54,    60,   146,    55,   166,   125,   126,   127,   116,
-     115,     1,   -85,     2,    38,     3,     4,     5,    56,    57,
-       6,   128,   129,   130,   117,   118,   119,   120,   121,   147,
-     148,    63,     7,    58,     8,    61,    59,   153,    62,   140,
-     141,    64,    67,     9,    10,    11,    12,    13,    14,   157,
-     158,   159,   160,    15,    65,    70,   117,   118,   119,   120,
-     121,    68,    70,   151,    37,   117,   118,   119,   120,   121,
-     108,   109,   110,   111,   112,   117,   118,   119,   120,   121,
-      66,    37,    90,    96,    97,   124,    98,    99,   100,   135,
-     101,   136,   137,   167,   138,   139,   142,   145,   161,   155,
-     162,   164,   170,   171,   144,   175,    89,   167,   149,   132,
-     176,     0,    82
+      74,    75,    76,    78,    29,   131,    68,    32,    24,    22,
+      73,    68,    92,    33,    34,    35,    36,    82,    26,    85,
+      87,    87,   101,   193,    49,    50,    51,    52,   180,   194,
+      53,    54,    33,    34,    35,    36,    37,    25,    93,   151,
+      23,    28,   155,   102,    37,   104,   105,    27,    73,    94,
+     132,    77,   200,   123,   124,   125,   112,   113,   103,   169,
+      85,    81,    30,    37,   170,    46,    92,   126,   147,   127,
+     128,   145,   146,   152,   158,   159,   160,   161,    38,   114,
+     113,   148,   149,     1,    31,     2,    47,     3,     4,     5,
+     188,   189,     6,   190,   189,   115,   116,   117,   118,   119,
+      48,   138,   139,   197,   198,    55,   171,     7,   154,     8,
+      70,   115,   116,   117,   118,   119,    56,   183,     9,    10,
+      11,    12,    13,    14,   202,   189,   192,    60,    15,    57,
+      37,   115,   116,   117,   118,   119,   -98,    61,    58,    59,
+     183,   106,   107,   108,   109,   110,   115,   116,   117,   118,
+     119,    62,    63,    64,    65,    66,    67,    68,    70,    37,
+      89,    95,    96,    97,    98,    99,   122,   140,   133,   100,
+     134,   135,   136,   137,   144,   142,   156,   162,   163,   165,
+     173,   167,   166,   168,   174,   176,   179,   186,   181,   143,
+     199,   182,    88,   130,   187,   191,   196,   150,     0,   201,
+      79
 };
 
 static const yytype_int16 yycheck[] =
 {
-       8,     4,    54,    23,     7,    23,    54,    55,    96,    71,
-      62,     4,    64,    65,    66,     6,    34,    46,    80,    13,
-      82,    24,    25,    26,    27,    46,     6,    30,    31,    10,
-       8,    18,    19,    20,    21,    55,    14,    55,     0,    32,
-      61,    32,    94,   131,    96,    52,   134,    55,    56,    57,
-      58,    59,    32,    54,    55,   107,    13,    60,    61,    46,
-     148,    25,    13,   115,    53,   153,    42,    43,    44,    54,
-      55,     3,    56,     5,    61,     7,     8,     9,    53,    53,
-      12,    57,    58,    59,    47,    48,    49,    50,    51,    54,
-      55,    46,    24,    53,    26,    13,    55,    60,    56,   102,
-     103,    53,    11,    35,    36,    37,    38,    39,    40,   136,
-     137,   138,   139,    45,    53,    46,    47,    48,    49,    50,
-      51,    23,    46,   131,    46,    47,    48,    49,    50,    51,
-      27,    28,    29,    30,    31,    47,    48,    49,    50,    51,
-      53,    46,    53,    57,    54,    33,    54,    54,    54,    22,
-      54,    22,    22,   161,    22,    22,    15,    53,    16,    46,
-      17,    47,    47,    54,   107,    55,    66,   175,   124,    94,
-     175,    -1,    61
+      56,    57,    58,    59,     4,    95,    26,     7,     6,     4,
+      55,    26,    68,    18,    19,    20,    21,    62,     6,    64,
+      65,    66,    37,     8,    24,    25,    26,    27,   167,    14,
+      30,    31,    18,    19,    20,    21,    49,    35,    58,   129,
+      35,    49,   132,    58,    49,    57,    58,    35,    93,    71,
+      95,    64,   191,    45,    46,    47,    57,    58,    80,   149,
+     105,    61,    10,    49,   154,     0,   122,    59,   113,    61,
+      62,    23,    24,   129,   134,   135,   136,   137,    64,    57,
+      58,    57,    58,     3,    13,     5,    55,     7,     8,     9,
+      57,    58,    12,    57,    58,    50,    51,    52,    53,    54,
+      13,   101,   102,    49,    50,    28,   162,    27,    63,    29,
+      49,    50,    51,    52,    53,    54,    56,   173,    38,    39,
+      40,    41,    42,    43,    57,    58,   182,    58,    48,    56,
+      49,    50,    51,    52,    53,    54,    60,    13,    56,    56,
+     196,    30,    31,    32,    33,    34,    50,    51,    52,    53,
+      54,    60,    49,    56,    56,    56,    11,    26,    49,    49,
+      56,    59,    57,    57,    57,    57,    36,    25,    22,    57,
+      22,    22,    22,    22,    56,    23,    49,    16,    15,    56,
+      16,    56,    50,    49,    17,    49,    57,    50,    23,   105,
+     189,    58,    66,    93,    59,    56,    58,   122,    -1,   196,
+      60
 };
 
 /* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
    state STATE-NUM.  */
 static const yytype_int8 yystos[] =
 {
-       0,     3,     5,     7,     8,     9,    12,    24,    26,    35,
-      36,    37,    38,    39,    40,    45,    63,    64,    65,    66,
-      67,    68,     4,    32,     6,    32,     6,    32,    46,    92,
-      10,    13,    92,    18,    19,    20,    21,    46,    61,    78,
-      79,    84,    85,    92,    93,     0,    52,    13,    92,    92,
-      92,    92,    92,    92,    25,    53,    53,    53,    53,    55,
-      13,    13,    56,    46,    53,    53,    53,    11,    23,    76,
-      46,    82,    83,    93,    78,    78,    78,    61,    78,    78,
-      86,    92,    86,    93,    69,    71,    93,    70,    93,    70,
-      53,    75,    77,    78,    55,    76,    57,    54,    54,    54,
-      54,    54,    34,    55,    76,    76,    54,    55,    27,    28,
-      29,    30,    31,    72,    54,    55,    54,    47,    48,    49,
-      50,    51,    73,    74,    33,    42,    43,    44,    57,    58,
-      59,    80,    83,    74,    93,    22,    22,    22,    22,    22,
-      92,    92,    15,    87,    71,    53,    93,    54,    55,    75,
-      74,    78,    81,    60,    74,    46,    94,    94,    94,    94,
-      94,    16,    17,    91,    47,    74,    74,    78,    88,    89,
-      47,    54,     8,    14,    90,    55,    89
+       0,     3,     5,     7,     8,     9,    12,    27,    29,    38,
+      39,    40,    41,    42,    43,    48,    66,    67,    68,    69,
+      70,    71,     4,    35,     6,    35,     6,    35,    49,   100,
+      10,    13,   100,    18,    19,    20,    21,    49,    64,    83,
+      89,    90,    91,    92,   100,   101,     0,    55,    13,   100,
+     100,   100,   100,   100,   100,    28,    56,    56,    56,    56,
+      58,    13,    60,    49,    56,    56,    56,    11,    26,    81,
+      49,    87,    88,   101,    83,    83,    83,    64,    83,    90,
+      93,   100,   101,    72,    76,   101,    75,   101,    75,    56,
+      80,    82,    83,    58,    81,    59,    57,    57,    57,    57,
+      57,    37,    58,    81,    57,    58,    30,    31,    32,    33,
+      34,    77,    57,    58,    57,    50,    51,    52,    53,    54,
+      78,    79,    36,    45,    46,    47,    59,    61,    62,    85,
+      88,    79,   101,    22,    22,    22,    22,    22,   100,   100,
+      25,    94,    23,    76,    56,    23,    24,   101,    57,    58,
+      80,    79,    83,    86,    63,    79,    49,   102,   102,   102,
+     102,   102,    16,    15,    95,    56,    50,    56,    49,    79,
+      79,    83,    84,    16,    17,    99,    49,    73,    74,    57,
+      73,    23,    58,    83,    96,    97,    50,    59,    57,    58,
+      57,    56,    83,     8,    14,    98,    58,    49,    50,    74,
+      73,    97,    57
 };
 
 /* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr1[] =
 {
-       0,    62,    63,    63,    63,    63,    64,    64,    64,    64,
-      65,    65,    65,    65,    66,    66,    67,    67,    67,    67,
-      67,    68,    68,    68,    68,    68,    69,    69,    70,    70,
-      71,    72,    72,    72,    72,    72,    73,    73,    74,    74,
-      74,    74,    74,    75,    76,    76,    77,    77,    78,    78,
-      79,    79,    80,    80,    80,    80,    80,    80,    81,    81,
-      82,    82,    83,    83,    83,    84,    84,    84,    84,    84,
-      85,    85,    86,    86,    86,    87,    87,    88,    88,    89,
-      90,    90,    90,    91,    91,    92,    93,    94
+       0,    65,    66,    66,    66,    66,    67,    67,    67,    67,
+      68,    68,    68,    68,    69,    69,    70,    70,    70,    70,
+      70,    70,    70,    70,    70,    71,    71,    71,    71,    72,
+      72,    73,    73,    74,    74,    75,    75,    76,    77,    77,
+      77,    77,    77,    78,    78,    79,    79,    79,    79,    79,
+      80,    81,    81,    82,    82,    83,    83,    84,    84,    85,
+      85,    85,    85,    85,    85,    86,    86,    87,    87,    88,
+      88,    88,    89,    89,    89,    89,    89,    90,    90,    91,
+      91,    92,    92,    93,    93,    93,    94,    94,    95,    95,
+      96,    96,    97,    98,    98,    98,    99,    99,   100,   101,
+     102
 };
 
 /* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr2[] =
 {
        0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     2,     4,     6,     3,     2,     6,
-       6,     7,     4,     5,     5,     7,     1,     3,     1,     3,
-       2,     1,     4,     1,     1,     1,     1,     3,     1,     1,
-       1,     1,     1,     3,     0,     2,     1,     3,     3,     1,
-       1,     3,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     3,     3,     5,     4,     6,     6,     6,     6,     6,
-       1,     1,     1,     3,     3,     3,     0,     1,     3,     2,
-       1,     1,     0,     0,     2,     1,     1,     1
+       1,     1,     1,     1,     2,     4,     6,    10,     3,     2,
+       6,    10,     8,    12,     6,     7,     4,     5,     8,     1,
+       3,     1,     3,     3,     3,     1,     3,     2,     1,     4,
+       1,     1,     1,     1,     3,     1,     1,     1,     1,     1,
+       3,     0,     2,     1,     3,     3,     1,     1,     3,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     3,     3,
+       5,     4,     6,     6,     6,     6,     6,     1,     1,     1,
+       3,     1,     1,     1,     3,     3,     3,     0,     3,     0,
+       1,     3,     2,     1,     1,     0,     0,     2,     1,     1,
+       1
 };
 
 
@@ -1675,629 +1705,745 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* start: stmt ';'  */
-#line 62 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+#line 66 "yacc.y"
     {
         parse_tree = (yyvsp[-1].sv_node);
         YYACCEPT;
     }
-#line 1684 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1714 "yacc.tab.cpp"
     break;
 
   case 3: /* start: HELP  */
-#line 67 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+#line 71 "yacc.y"
     {
         parse_tree = std::make_shared<Help>();
         YYACCEPT;
     }
-#line 1693 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1723 "yacc.tab.cpp"
     break;
 
   case 4: /* start: EXIT  */
-#line 72 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+#line 76 "yacc.y"
     {
         parse_tree = nullptr;
         YYACCEPT;
     }
-#line 1702 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1732 "yacc.tab.cpp"
     break;
 
   case 5: /* start: T_EOF  */
-#line 77 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+#line 81 "yacc.y"
     {
         parse_tree = nullptr;
         YYACCEPT;
     }
-#line 1711 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1741 "yacc.tab.cpp"
     break;
 
   case 10: /* txnStmt: TXN_BEGIN  */
-#line 92 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+#line 96 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnBegin>();
     }
-#line 1719 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1749 "yacc.tab.cpp"
     break;
 
   case 11: /* txnStmt: TXN_COMMIT  */
-#line 96 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+#line 100 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnCommit>();
     }
-#line 1727 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1757 "yacc.tab.cpp"
     break;
 
   case 12: /* txnStmt: TXN_ABORT  */
-#line 100 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+#line 104 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnAbort>();
     }
-#line 1735 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1765 "yacc.tab.cpp"
     break;
 
   case 13: /* txnStmt: TXN_ROLLBACK  */
-#line 104 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+#line 108 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnRollback>();
     }
-#line 1743 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1773 "yacc.tab.cpp"
     break;
 
   case 14: /* dbStmt: SHOW TABLES  */
-#line 111 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+#line 115 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<ShowTables>();
     }
-#line 1751 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1781 "yacc.tab.cpp"
     break;
 
   case 15: /* dbStmt: SHOW INDEX FROM IDENTIFIER  */
-#line 115 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+#line 119 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<ShowIndex>((yyvsp[0].sv_str));
     }
-#line 1759 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1789 "yacc.tab.cpp"
     break;
 
   case 16: /* ddl: CREATE TABLE tbName '(' fieldList ')'  */
-#line 122 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+#line 126 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<CreateTable>((yyvsp[-3].sv_str), (yyvsp[-1].sv_fields));
     }
-#line 1767 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1797 "yacc.tab.cpp"
     break;
 
-  case 17: /* ddl: DROP TABLE tbName  */
-#line 126 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 17: /* ddl: CREATE TABLE tbName '(' fieldList ')' WITH '(' tableOptionList ')'  */
+#line 130 "yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<CreateTable>((yyvsp[-7].sv_str), (yyvsp[-5].sv_fields), (yyvsp[-1].sv_table_options));
+    }
+#line 1805 "yacc.tab.cpp"
+    break;
+
+  case 18: /* ddl: DROP TABLE tbName  */
+#line 134 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DropTable>((yyvsp[0].sv_str));
     }
-#line 1775 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1813 "yacc.tab.cpp"
     break;
 
-  case 18: /* ddl: DESC tbName  */
-#line 130 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 19: /* ddl: DESC tbName  */
+#line 138 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DescTable>((yyvsp[0].sv_str));
     }
-#line 1783 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1821 "yacc.tab.cpp"
     break;
 
-  case 19: /* ddl: CREATE INDEX tbName '(' colNameList ')'  */
-#line 134 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 20: /* ddl: CREATE INDEX tbName '(' colNameList ')'  */
+#line 142 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<CreateIndex>((yyvsp[-3].sv_str), (yyvsp[-1].sv_strs));
     }
-#line 1791 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1829 "yacc.tab.cpp"
+    break;
+
+  case 21: /* ddl: CREATE INDEX tbName '(' colNameList ')' WITH '(' tableOptionList ')'  */
+#line 146 "yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<CreateIndex>((yyvsp[-7].sv_str), (yyvsp[-5].sv_strs), (yyvsp[-1].sv_table_options));
+    }
+#line 1837 "yacc.tab.cpp"
     break;
 
-  case 20: /* ddl: DROP INDEX tbName '(' colNameList ')'  */
-#line 138 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 22: /* ddl: CREATE INDEX tbName '(' colNameList ')' USING IDENTIFIER  */
+#line 150 "yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<CreateIndex>((yyvsp[-5].sv_str), (yyvsp[-3].sv_strs), std::vector<std::shared_ptr<TableOption>>(), (yyvsp[0].sv_str));
+    }
+#line 1845 "yacc.tab.cpp"
+    break;
+
+  case 23: /* ddl: CREATE INDEX tbName '(' colNameList ')' USING IDENTIFIER WITH '(' tableOptionList ')'  */
+#line 154 "yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<CreateIndex>((yyvsp[-9].sv_str), (yyvsp[-7].sv_strs), (yyvsp[-1].sv_table_options), (yyvsp[-4].sv_str));
+    }
+#line 1853 "yacc.tab.cpp"
+    break;
+
+  case 24: /* ddl: DROP INDEX tbName '(' colNameList ')'  */
+#line 158 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DropIndex>((yyvsp[-3].sv_str), (yyvsp[-1].sv_strs));
     }
-#line 1799 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1861 "yacc.tab.cpp"
     break;
 
-  case 21: /* dml: INSERT INTO tbName VALUES '(' valueList ')'  */
-#line 145 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 25: /* dml: INSERT INTO tbName VALUES '(' valueList ')'  */
+#line 165 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<InsertStmt>((yyvsp[-4].sv_str), (yyvsp[-1].sv_vals));
     }
-#line 1807 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1869 "yacc.tab.cpp"
     break;
 
-  case 22: /* dml: DELETE FROM tbName optWhereClause  */
-#line 149 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 26: /* dml: DELETE FROM tbName optWhereClause  */
+#line 169 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DeleteStmt>((yyvsp[-1].sv_str), (yyvsp[0].sv_conds));
     }
-#line 1815 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1877 "yacc.tab.cpp"
     break;
 
-  case 23: /* dml: UPDATE tbName SET setClauses optWhereClause  */
-#line 153 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 27: /* dml: UPDATE tbName SET setClauses optWhereClause  */
+#line 173 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<UpdateStmt>((yyvsp[-3].sv_str), (yyvsp[-1].sv_set_clauses), (yyvsp[0].sv_conds));
     }
-#line 1823 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1885 "yacc.tab.cpp"
     break;
 
-  case 24: /* dml: SELECT aggreClause FROM tableList optWhereClause  */
-#line 157 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 28: /* dml: SELECT selector FROM tableList optWhereClause opt_group_clause opt_order_clause opt_limit_clause  */
+#line 177 "yacc.y"
     {
-        (yyval.sv_node) = std::make_shared<SelectStmt>((yyvsp[-3].sv_aggre_clause), (yyvsp[-1].sv_strs), (yyvsp[0].sv_conds));
+        // 只有字段时沿用原来的查询，有聚合函数或GROUP BY时由分组聚合执行
+        std::vector<std::shared_ptr<Col>> cols;
+        std::vector<std::shared_ptr<AggreClause>> aggres;
+        for (auto &item : (yyvsp[-6].sv_select_items)) {
+            if (item->aggre != nullptr) {
+                aggres.push_back(item->aggre);
+            } else {
+                cols.push_back(item->col);
+            }
+        }
+        if (aggres.empty() && (yyvsp[-2].sv_cols).empty()) {
+            (yyval.sv_node) = std::make_shared<SelectStmt>(cols, (yyvsp[-4].sv_strs), (yyvsp[-3].sv_conds), (yyvsp[-1].sv_orderbys), (yyvsp[0].sv_limit));
+        } else {
+            (yyval.sv_node) = std::make_shared<SelectStmt>((yyvsp[-6].sv_select_items), (yyvsp[-4].sv_strs), (yyvsp[-3].sv_conds), (yyvsp[-2].sv_cols), (yyvsp[-1].sv_orderbys), (yyvsp[0].sv_limit));
+        }
     }
-#line 1831 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1907 "yacc.tab.cpp"
     break;
 
-  case 25: /* dml: SELECT selector FROM tableList optWhereClause opt_order_clause opt_limit_clause  */
-#line 161 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 29: /* fieldList: field  */
+#line 198 "yacc.y"
     {
-        (yyval.sv_node) = std::make_shared<SelectStmt>((yyvsp[-5].sv_cols), (yyvsp[-3].sv_strs), (yyvsp[-2].sv_conds), (yyvsp[-1].sv_orderbys), (yyvsp[0].sv_limit));
+        (yyval.sv_fields) = std::vector<std::shared_ptr<Field>>{(yyvsp[0].sv_field)};
     }
-#line 1839 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1915 "yacc.tab.cpp"
     break;
 
-  case 26: /* fieldList: field  */
-#line 168 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 30: /* fieldList: fieldList ',' field  */
+#line 202 "yacc.y"
     {
-        (yyval.sv_fields) = std::vector<std::shared_ptr<Field>>{(yyvsp[0].sv_field)};
+        (yyval.sv_fields).push_back((yyvsp[0].sv_field));
     }
-#line 1847 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1923 "yacc.tab.cpp"
     break;
 
-  case 27: /* fieldList: fieldList ',' field  */
-#line 172 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 31: /* tableOptionList: tableOption  */
+#line 209 "yacc.y"
     {
-        (yyval.sv_fields).push_back((yyvsp[0].sv_field));
+        (yyval.sv_table_options) = std::vector<std::shared_ptr<TableOption>>{(yyvsp[0].sv_table_option)};
+    }
+#line 1931 "yacc.tab.cpp"
+    break;
+
+  case 32: /* tableOptionList: tableOptionList ',' tableOption  */
+#line 213 "yacc.y"
+    {
+        (yyval.sv_table_options).push_back((yyvsp[0].sv_table_option));
+    }
+#line 1939 "yacc.tab.cpp"
+    break;
+
+  case 33: /* tableOption: IDENTIFIER '=' IDENTIFIER  */
+#line 220 "yacc.y"
+    {
+        (yyval.sv_table_option) = std::make_shared<TableOption>((yyvsp[-2].sv_str), (yyvsp[0].sv_str));
+    }
+#line 1947 "yacc.tab.cpp"
+    break;
+
+  case 34: /* tableOption: IDENTIFIER '=' VALUE_INT  */
+#line 224 "yacc.y"
+    {
+        (yyval.sv_table_option) = std::make_shared<TableOption>((yyvsp[-2].sv_str), (yyvsp[0].sv_str));
     }
-#line 1855 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1955 "yacc.tab.cpp"
     break;
 
-  case 28: /* colNameList: colName  */
-#line 179 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 35: /* colNameList: colName  */
+#line 231 "yacc.y"
     {
         (yyval.sv_strs) = std::vector<std::string>{(yyvsp[0].sv_str)};
     }
-#line 1863 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1963 "yacc.tab.cpp"
     break;
 
-  case 29: /* colNameList: colNameList ',' colName  */
-#line 183 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 36: /* colNameList: colNameList ',' colName  */
+#line 235 "yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 1871 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1971 "yacc.tab.cpp"
     break;
 
-  case 30: /* field: colName type  */
-#line 190 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 37: /* field: colName type  */
+#line 242 "yacc.y"
     {
         (yyval.sv_field) = std::make_shared<ColDef>((yyvsp[-1].sv_str), (yyvsp[0].sv_type_len));
     }
-#line 1879 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1979 "yacc.tab.cpp"
     break;
 
-  case 31: /* type: INT  */
-#line 197 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 38: /* type: INT  */
+#line 249 "yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_INT, 4);
     }
-#line 1887 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1987 "yacc.tab.cpp"
     break;
 
-  case 32: /* type: CHAR '(' VALUE_INT ')'  */
-#line 201 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 39: /* type: CHAR '(' VALUE_INT ')'  */
+#line 253 "yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_STRING, std::stoi((yyvsp[-1].sv_str)));
     }
-#line 1895 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 1995 "yacc.tab.cpp"
     break;
 
-  case 33: /* type: FLOAT  */
-#line 205 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 40: /* type: FLOAT  */
+#line 257 "yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_FLOAT, sizeof(float));
     }
-#line 1903 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2003 "yacc.tab.cpp"
     break;
 
-  case 34: /* type: BIGINT  */
-#line 209 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 41: /* type: BIGINT  */
+#line 261 "yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_BIGINT, 8);
     }
-#line 1911 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2011 "yacc.tab.cpp"
     break;
 
-  case 35: /* type: DATETIME  */
-#line 213 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 42: /* type: DATETIME  */
+#line 265 "yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_DATETIME, 19);
     }
-#line 1919 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2019 "yacc.tab.cpp"
     break;
 
-  case 36: /* valueList: value  */
-#line 220 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 43: /* valueList: value  */
+#line 272 "yacc.y"
     {
         (yyval.sv_vals) = std::vector<std::shared_ptr<Value>>{(yyvsp[0].sv_val)};
     }
-#line 1927 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2027 "yacc.tab.cpp"
     break;
 
-  case 37: /* valueList: valueList ',' value  */
-#line 224 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 44: /* valueList: valueList ',' value  */
+#line 276 "yacc.y"
     {
         (yyval.sv_vals).push_back((yyvsp[0].sv_val));
     }
-#line 1935 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2035 "yacc.tab.cpp"
     break;
 
-  case 38: /* value: VALUE_INT  */
-#line 231 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 45: /* value: VALUE_INT  */
+#line 283 "yacc.y"
     {
         (yyval.sv_val) = std::make_shared<IntLit>((yyvsp[0].sv_str));
     }
-#line 1943 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2043 "yacc.tab.cpp"
     break;
 
-  case 39: /* value: VALUE_FLOAT  */
-#line 235 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 46: /* value: VALUE_FLOAT  */
+#line 287 "yacc.y"
     {
         (yyval.sv_val) = std::make_shared<FloatLit>((yyvsp[0].sv_float));
     }
-#line 1951 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2051 "yacc.tab.cpp"
     break;
 
-  case 40: /* value: VALUE_STRING  */
-#line 239 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 47: /* value: VALUE_STRING  */
+#line 291 "yacc.y"
     {
         (yyval.sv_val) = std::make_shared<StringLit>((yyvsp[0].sv_str));
     }
-#line 1959 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2059 "yacc.tab.cpp"
     break;
 
-  case 41: /* value: VALUE_BIGINT  */
-#line 243 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 48: /* value: VALUE_BIGINT  */
+#line 295 "yacc.y"
     {
         (yyval.sv_val) = std::make_shared<BigintLit>((yyvsp[0].sv_bigint));
     }
-#line 1967 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2067 "yacc.tab.cpp"
     break;
 
-  case 42: /* value: VALUE_DATETIME  */
-#line 247 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 49: /* value: VALUE_DATETIME  */
+#line 299 "yacc.y"
     {
         (yyval.sv_val) = std::make_shared<DatetimeLit>((yyvsp[0].sv_str));
     }
-#line 1975 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2075 "yacc.tab.cpp"
     break;
 
-  case 43: /* condition: col op expr  */
-#line 254 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 50: /* condition: col op expr  */
+#line 306 "yacc.y"
     {
         (yyval.sv_cond) = std::make_shared<BinaryExpr>((yyvsp[-2].sv_col), (yyvsp[-1].sv_comp_op), (yyvsp[0].sv_expr));
     }
-#line 1983 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2083 "yacc.tab.cpp"
     break;
 
-  case 44: /* optWhereClause: %empty  */
-#line 260 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 51: /* optWhereClause: %empty  */
+#line 312 "yacc.y"
                       { /* ignore*/ }
-#line 1989 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2089 "yacc.tab.cpp"
     break;
 
-  case 45: /* optWhereClause: WHERE whereClause  */
-#line 262 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 52: /* optWhereClause: WHERE whereClause  */
+#line 314 "yacc.y"
     {
         (yyval.sv_conds) = (yyvsp[0].sv_conds);
     }
-#line 1997 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2097 "yacc.tab.cpp"
     break;
 
-  case 46: /* whereClause: condition  */
-#line 269 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 53: /* whereClause: condition  */
+#line 321 "yacc.y"
     {
         (yyval.sv_conds) = std::vector<std::shared_ptr<BinaryExpr>>{(yyvsp[0].sv_cond)};
     }
-#line 2005 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2105 "yacc.tab.cpp"
     break;
 
-  case 47: /* whereClause: whereClause AND condition  */
-#line 273 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 54: /* whereClause: whereClause AND condition  */
+#line 325 "yacc.y"
     {
         (yyval.sv_conds).push_back((yyvsp[0].sv_cond));
     }
-#line 2013 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2113 "yacc.tab.cpp"
     break;
 
-  case 48: /* col: tbName '.' colName  */
-#line 280 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 55: /* col: tbName '.' colName  */
+#line 332 "yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>((yyvsp[-2].sv_str), (yyvsp[0].sv_str));
     }
-#line 2021 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2121 "yacc.tab.cpp"
     break;
 
-  case 49: /* col: colName  */
-#line 284 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 56: /* col: colName  */
+#line 336 "yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>("", (yyvsp[0].sv_str));
     }
-#line 2029 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2129 "yacc.tab.cpp"
     break;
 
-  case 50: /* colList: col  */
-#line 291 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 57: /* colList: col  */
+#line 343 "yacc.y"
     {
         (yyval.sv_cols) = std::vector<std::shared_ptr<Col>>{(yyvsp[0].sv_col)};
     }
-#line 2037 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2137 "yacc.tab.cpp"
     break;
 
-  case 51: /* colList: colList ',' col  */
-#line 295 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 58: /* colList: colList ',' col  */
+#line 347 "yacc.y"
     {
         (yyval.sv_cols).push_back((yyvsp[0].sv_col));
     }
-#line 2045 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2145 "yacc.tab.cpp"
     break;
 
-  case 52: /* op: '='  */
-#line 302 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 59: /* op: '='  */
+#line 354 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_EQ;
     }
-#line 2053 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2153 "yacc.tab.cpp"
     break;
 
-  case 53: /* op: '<'  */
-#line 306 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 60: /* op: '<'  */
+#line 358 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_LT;
     }
-#line 2061 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2161 "yacc.tab.cpp"
     break;
 
-  case 54: /* op: '>'  */
-#line 310 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 61: /* op: '>'  */
+#line 362 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_GT;
     }
-#line 2069 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2169 "yacc.tab.cpp"
     break;
 
-  case 55: /* op: NEQ  */
-#line 314 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 62: /* op: NEQ  */
+#line 366 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_NE;
     }
-#line 2077 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2177 "yacc.tab.cpp"
     break;
 
-  case 56: /* op: LEQ  */
-#line 318 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 63: /* op: LEQ  */
+#line 370 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_LE;
     }
-#line 2085 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2185 "yacc.tab.cpp"
     break;
 
-  case 57: /* op: GEQ  */
-#line 322 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 64: /* op: GEQ  */
+#line 374 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_GE;
     }
-#line 2093 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2193 "yacc.tab.cpp"
     break;
 
-  case 58: /* expr: value  */
-#line 329 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 65: /* expr: value  */
+#line 381 "yacc.y"
     {
         (yyval.sv_expr) = std::static_pointer_cast<Expr>((yyvsp[0].sv_val));
     }
-#line 2101 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2201 "yacc.tab.cpp"
     break;
 
-  case 59: /* expr: col  */
-#line 333 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 66: /* expr: col  */
+#line 385 "yacc.y"
     {
         (yyval.sv_expr) = std::static_pointer_cast<Expr>((yyvsp[0].sv_col));
     }
-#line 2109 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2209 "yacc.tab.cpp"
     break;
 
-  case 60: /* setClauses: setClause  */
-#line 340 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 67: /* setClauses: setClause  */
+#line 392 "yacc.y"
     {
         (yyval.sv_set_clauses) = std::vector<std::shared_ptr<SetClause>>{(yyvsp[0].sv_set_clause)};
     }
-#line 2117 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2217 "yacc.tab.cpp"
     break;
 
-  case 61: /* setClauses: setClauses ',' setClause  */
-#line 344 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 68: /* setClauses: setClauses ',' setClause  */
+#line 396 "yacc.y"
     {
         (yyval.sv_set_clauses).push_back((yyvsp[0].sv_set_clause));
     }
-#line 2125 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2225 "yacc.tab.cpp"
     break;
 
-  case 62: /* setClause: colName '=' value  */
-#line 351 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 69: /* setClause: colName '=' value  */
+#line 403 "yacc.y"
     {
         (yyval.sv_set_clause) = std::make_shared<SetClause>((yyvsp[-2].sv_str), (yyvsp[0].sv_val), false);
     }
-#line 2133 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2233 "yacc.tab.cpp"
     break;
 
-  case 63: /* setClause: colName '=' colName '+' value  */
-#line 355 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 70: /* setClause: colName '=' colName '+' value  */
+#line 407 "yacc.y"
     {
         (yyval.sv_set_clause) = std::make_shared<SetClause>((yyvsp[-4].sv_str), (yyvsp[0].sv_val), true, true);
     }
-#line 2141 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2241 "yacc.tab.cpp"
     break;
 
-  case 64: /* setClause: colName '=' colName value  */
-#line 359 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 71: /* setClause: colName '=' colName value  */
+#line 411 "yacc.y"
     {
         (yyval.sv_set_clause) = std::make_shared<SetClause>((yyvsp[-3].sv_str), (yyvsp[0].sv_val), true, true);
     }
-#line 2149 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2249 "yacc.tab.cpp"
     break;
 
-  case 65: /* aggreClause: SUM '(' col ')' AS NICK  */
-#line 366 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 72: /* aggreClause: SUM '(' col ')' AS NICK  */
+#line 418 "yacc.y"
     {
         (yyval.sv_aggre_clause) = std::make_shared<AggreClause>(AggregationType::SUM, (yyvsp[-3].sv_col), (yyvsp[0].sv_str));
     }
-#line 2157 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2257 "yacc.tab.cpp"
     break;
 
-  case 66: /* aggreClause: MAX '(' col ')' AS NICK  */
-#line 370 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 73: /* aggreClause: MAX '(' col ')' AS NICK  */
+#line 422 "yacc.y"
     {
         (yyval.sv_aggre_clause) = std::make_shared<AggreClause>(AggregationType::MAX, (yyvsp[-3].sv_col), (yyvsp[0].sv_str));
     }
-#line 2165 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2265 "yacc.tab.cpp"
     break;
 
-  case 67: /* aggreClause: MIN '(' col ')' AS NICK  */
-#line 374 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 74: /* aggreClause: MIN '(' col ')' AS NICK  */
+#line 426 "yacc.y"
     {
         (yyval.sv_aggre_clause) = std::make_shared<AggreClause>(AggregationType::MIN, (yyvsp[-3].sv_col), (yyvsp[0].sv_str));
     }
-#line 2173 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2273 "yacc.tab.cpp"
     break;
 
-  case 68: /* aggreClause: COUNT '(' col ')' AS NICK  */
-#line 378 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 75: /* aggreClause: COUNT '(' col ')' AS NICK  */
+#line 430 "yacc.y"
     {
         (yyval.sv_aggre_clause) = std::make_shared<AggreClause>(AggregationType::COUNT, (yyvsp[-3].sv_col), (yyvsp[0].sv_str));
     }
-#line 2181 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2281 "yacc.tab.cpp"
     break;
 
-  case 69: /* aggreClause: COUNT '(' '*' ')' AS NICK  */
-#line 382 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 76: /* aggreClause: COUNT '(' '*' ')' AS NICK  */
+#line 434 "yacc.y"
     {
         (yyval.sv_aggre_clause) = std::make_shared<AggreClause>((yyvsp[0].sv_str));
     }
-#line 2189 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2289 "yacc.tab.cpp"
     break;
 
-  case 70: /* selector: '*'  */
-#line 389 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 77: /* selItem: col  */
+#line 441 "yacc.y"
     {
-        (yyval.sv_cols) = {};
+        (yyval.sv_select_item) = std::make_shared<SelectItem>((yyvsp[0].sv_col));
     }
-#line 2197 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2297 "yacc.tab.cpp"
     break;
 
-  case 72: /* tableList: tbName  */
-#line 397 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 78: /* selItem: aggreClause  */
+#line 445 "yacc.y"
+    {
+        (yyval.sv_select_item) = std::make_shared<SelectItem>((yyvsp[0].sv_aggre_clause));
+    }
+#line 2305 "yacc.tab.cpp"
+    break;
+
+  case 79: /* selItemList: selItem  */
+#line 452 "yacc.y"
+    {
+        (yyval.sv_select_items) = std::vector<std::shared_ptr<SelectItem>>{(yyvsp[0].sv_select_item)};
+    }
+#line 2313 "yacc.tab.cpp"
+    break;
+
+  case 80: /* selItemList: selItemList ',' selItem  */
+#line 456 "yacc.y"
+    {
+        (yyval.sv_select_items).push_back((yyvsp[0].sv_select_item));
+    }
+#line 2321 "yacc.tab.cpp"
+    break;
+
+  case 81: /* selector: '*'  */
+#line 463 "yacc.y"
+    {
+        (yyval.sv_select_items) = {};
+    }
+#line 2329 "yacc.tab.cpp"
+    break;
+
+  case 83: /* tableList: tbName  */
+#line 471 "yacc.y"
     {
         (yyval.sv_strs) = std::vector<std::string>{(yyvsp[0].sv_str)};
     }
-#line 2205 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2337 "yacc.tab.cpp"
     break;
 
-  case 73: /* tableList: tableList ',' tbName  */
-#line 401 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 84: /* tableList: tableList ',' tbName  */
+#line 475 "yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 2213 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2345 "yacc.tab.cpp"
     break;
 
-  case 74: /* tableList: tableList JOIN tbName  */
-#line 405 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 85: /* tableList: tableList JOIN tbName  */
+#line 479 "yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 2221 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2353 "yacc.tab.cpp"
+    break;
+
+  case 86: /* opt_group_clause: GROUP BY colList  */
+#line 486 "yacc.y"
+    {
+        (yyval.sv_cols) = (yyvsp[0].sv_cols);
+    }
+#line 2361 "yacc.tab.cpp"
+    break;
+
+  case 87: /* opt_group_clause: %empty  */
+#line 489 "yacc.y"
+                      { /* ignore*/ }
+#line 2367 "yacc.tab.cpp"
     break;
 
-  case 75: /* opt_order_clause: ORDER BY order_clauses  */
-#line 412 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 88: /* opt_order_clause: ORDER BY order_clauses  */
+#line 494 "yacc.y"
     { 
         (yyval.sv_orderbys) = (yyvsp[0].sv_orderbys); 
     }
-#line 2229 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2375 "yacc.tab.cpp"
     break;
 
-  case 76: /* opt_order_clause: %empty  */
-#line 415 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 89: /* opt_order_clause: %empty  */
+#line 497 "yacc.y"
                       { /* ignore*/ }
-#line 2235 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2381 "yacc.tab.cpp"
     break;
 
-  case 77: /* order_clauses: order_clause  */
-#line 420 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 90: /* order_clauses: order_clause  */
+#line 502 "yacc.y"
     {
         (yyval.sv_orderbys) = std::vector<std::shared_ptr<OrderBy>>{(yyvsp[0].sv_orderby)};
     }
-#line 2243 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2389 "yacc.tab.cpp"
     break;
 
-  case 78: /* order_clauses: order_clauses ',' order_clause  */
-#line 424 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 91: /* order_clauses: order_clauses ',' order_clause  */
+#line 506 "yacc.y"
     {
         (yyval.sv_orderbys).push_back((yyvsp[0].sv_orderby));
     }
-#line 2251 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2397 "yacc.tab.cpp"
     break;
 
-  case 79: /* order_clause: col opt_asc_desc  */
-#line 431 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 92: /* order_clause: col opt_asc_desc  */
+#line 513 "yacc.y"
     { 
         (yyval.sv_orderby) = std::make_shared<OrderBy>((yyvsp[-1].sv_col), (yyvsp[0].sv_orderby_dir));
     }
-#line 2259 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2405 "yacc.tab.cpp"
     break;
 
-  case 80: /* opt_asc_desc: ASC  */
-#line 438 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 93: /* opt_asc_desc: ASC  */
+#line 520 "yacc.y"
     {
         (yyval.sv_orderby_dir) = OrderBy_ASC;
     }
-#line 2267 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2413 "yacc.tab.cpp"
     break;
 
-  case 81: /* opt_asc_desc: DESC  */
-#line 442 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 94: /* opt_asc_desc: DESC  */
+#line 524 "yacc.y"
     {
         (yyval.sv_orderby_dir) = OrderBy_DESC;
     }
-#line 2275 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2421 "yacc.tab.cpp"
     break;
 
-  case 82: /* opt_asc_desc: %empty  */
-#line 446 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 95: /* opt_asc_desc: %empty  */
+#line 528 "yacc.y"
     {
         (yyval.sv_orderby_dir) = OrderBy_DEFAULT;
     }
-#line 2283 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2429 "yacc.tab.cpp"
     break;
 
-  case 83: /* opt_limit_clause: %empty  */
-#line 452 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 96: /* opt_limit_clause: %empty  */
+#line 534 "yacc.y"
                       { /* ignore*/ }
-#line 2289 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2435 "yacc.tab.cpp"
     break;
 
-  case 84: /* opt_limit_clause: LIMIT VALUE_INT  */
-#line 454 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+  case 97: /* opt_limit_clause: LIMIT VALUE_INT  */
+#line 536 "yacc.y"
     {
         (yyval.sv_limit) = std::make_shared<Limit>((yyvsp[0].sv_str));
     }
-#line 2297 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2443 "yacc.tab.cpp"
     break;
 
 
-#line 2301 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.tab.cpp"
+#line 2447 "yacc.tab.cpp"
 
       default: break;
     }
@@ -2526,5 +2672,5 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 464 "/Users/zhangjinming/db-2023-object-not-found/src/parser/yacc.y"
+#line 546 "yacc.y"
 
@@ -35,8 +35,8 @@
    especially those whose name start with YY_ or yy_.  They are
    private implementation details that can be changed or removed.  */
 
-#ifndef YY_YY_USERS_ZHANGJINMING_DB_2023_OBJECT_NOT_FOUND_SRC_PARSER_YACC_TAB_H_INCLUDED
-# define YY_YY_USERS_ZHANGJINMING_DB_2023_OBJECT_NOT_FOUND_SRC_PARSER_YACC_TAB_H_INCLUDED
+#ifndef YY_YY_YACC_TAB_H_INCLUDED
+# define YY_YY_YACC_TAB_H_INCLUDED
 /* Debug traces.  */
 #ifndef YYDEBUG
 # define YYDEBUG 0
@@ -74,35 +74,38 @@ extern int yydebug;
     MIN = 275,                     /* MIN  */
     COUNT = 276,                   /* COUNT  */
     AS = 277,                      /* AS  */
-    WHERE = 278,                   /* WHERE  */
-    UPDATE = 279,                  /* UPDATE  */
-    SET = 280,                     /* SET  */
-    SELECT = 281,                  /* SELECT  */
-    INT = 282,                     /* INT  */
-    CHAR = 283,                    /* CHAR  */
-    FLOAT = 284,                   /* FLOAT  */
-    BIGINT = 285,                  /* BIGINT  */
-    DATETIME = 286,                /* DATETIME  */
-    INDEX = 287,                   /* INDEX  */
-    AND = 288,                     /* AND  */
-    JOIN = 289,                    /* JOIN  */
-    EXIT = 290,                    /* EXIT  */
-    HELP = 291,                    /* HELP  */
-    TXN_BEGIN = 292,               /* TXN_BEGIN  */
-    TXN_COMMIT = 293,              /* TXN_COMMIT  */
-    TXN_ABORT = 294,               /* TXN_ABORT  */
-    TXN_ROLLBACK = 295,            /* TXN_ROLLBACK  */
-    ORDER_BY = 296,                /* ORDER_BY  */
-    LEQ = 297,                     /* LEQ  */
-    NEQ = 298,                     /* NEQ  */
-    GEQ = 299,                     /* GEQ  */
-    T_EOF = 300,                   /* T_EOF  */
-    IDENTIFIER = 301,              /* IDENTIFIER  */
-    VALUE_INT = 302,               /* VALUE_INT  */
-    VALUE_DATETIME = 303,          /* VALUE_DATETIME  */
-    VALUE_STRING = 304,            /* VALUE_STRING  */
-    VALUE_FLOAT = 305,             /* VALUE_FLOAT  */
-    VALUE_BIGINT = 306             /* VALUE_BIGINT  */
+    WITH = 278,                    /* WITH  */
+    USING = 279,                   /* USING  */
+    GROUP = 280,                   /* GROUP  */
+    WHERE = 281,                   /* WHERE  */
+    UPDATE = 282,                  /* UPDATE  */
+    SET = 283,                     /* SET  */
+    SELECT = 284,                  /* SELECT  */
+    INT = 285,                     /* INT  */
+    CHAR = 286,                    /* CHAR  */
+    FLOAT = 287,                   /* FLOAT  */
+    BIGINT = 288,                  /* BIGINT  */
+    DATETIME = 289,                /* DATETIME  */
+    INDEX = 290,                   /* INDEX  */
+    AND = 291,                     /* AND  */
+    JOIN = 292,                    /* JOIN  */
+    EXIT = 293,                    /* EXIT  */
+    HELP = 294,                    /* HELP  */
+    TXN_BEGIN = 295,               /* TXN_BEGIN  */
+    TXN_COMMIT = 296,              /* TXN_COMMIT  */
+    TXN_ABORT = 297,               /* TXN_ABORT  */
+    TXN_ROLLBACK = 298,            /* TXN_ROLLBACK  */
+    ORDER_BY = 299,                /* ORDER_BY  */
+    LEQ = 300,                     /* LEQ  */
+    NEQ = 301,                     /* NEQ  */
+    GEQ = 302,                     /* GEQ  */
+    T_EOF = 303,                   /* T_EOF  */
+    IDENTIFIER = 304,              /* IDENTIFIER  */
+    VALUE_INT = 305,               /* VALUE_INT  */
+    VALUE_DATETIME = 306,          /* VALUE_DATETIME  */
+    VALUE_STRING = 307,            /* VALUE_STRING  */
+    VALUE_FLOAT = 308,             /* VALUE_FLOAT  */
+    VALUE_BIGINT = 309             /* VALUE_BIGINT  */
   };
   typedef enum yytokentype yytoken_kind_t;
 #endif
@@ -129,4 +132,4 @@ struct YYLTYPE
 int yyparse (void);
 
 
-#endif /* !YY_YY_USERS_ZHANGJINMING_DB_2023_OBJECT_NOT_FOUND_SRC_PARSER_YACC_TAB_H_INCLUDED  */
+#endif /* !YY_YY_YACC_TAB_H_INCLUDED  */
@@ -21,7 +21,7 @@ using namespace ast;
 %define parse.error verbose
 
 // keywords
-%token SHOW TABLES CREATE TABLE DROP DESC INSERT INTO VALUES DELETE FROM ASC ORDER BY LIMIT SUM MAX MIN COUNT AS
+%token SHOW TABLES CREATE TABLE DROP DESC INSERT INTO VALUES DELETE FROM ASC ORDER BY LIMIT SUM MAX MIN COUNT AS WITH USING GROUP
 WHERE UPDATE SET SELECT INT CHAR FLOAT BIGINT DATETIME INDEX AND JOIN EXIT HELP TXN_BEGIN TXN_COMMIT TXN_ABORT TXN_ROLLBACK ORDER_BY
 // non-keywords
 %token LEQ NEQ GEQ T_EOF
@@ -36,6 +36,8 @@ WHERE UPDATE SET SELECT INT CHAR FLOAT BIGINT DATETIME INDEX AND JOIN EXIT HELP
 %type <sv_node> stmt dbStmt ddl dml txnStmt
 %type <sv_field> field
 %type <sv_fields> fieldList
+%type <sv_table_option> tableOption
+%type <sv_table_options> tableOptionList
 %type <sv_type_len> type
 %type <sv_comp_op> op
 %type <sv_expr> expr
@@ -44,7 +46,7 @@ WHERE UPDATE SET SELECT INT CHAR FLOAT BIGINT DATETIME INDEX AND JOIN EXIT HELP
 %type <sv_str> tbName colName NICK
 %type <sv_strs> tableList colNameList
 %type <sv_col> col
-%type <sv_cols> colList selector
+%type <sv_cols> colList opt_group_clause
 %type <sv_set_clause> setClause
 %type <sv_set_clauses> setClauses
 %type <sv_cond> condition
@@ -54,6 +56,8 @@ WHERE UPDATE SET SELECT INT CHAR FLOAT BIGINT DATETIME INDEX AND JOIN EXIT HELP
 %type <sv_limit> opt_limit_clause
 %type <sv_orderby_dir> opt_asc_desc
 %type <sv_aggre_clause> aggreClause
+%type <sv_select_item> selItem
+%type <sv_select_items> selector selItemList
 %type <sv_aggre_type> SUM MAX MIN COUNT
 
 %%
@@ -122,6 +126,10 @@ ddl:
     {
         $$ = std::make_shared<CreateTable>($3, $5);
     }
+    |   CREATE TABLE tbName '(' fieldList ')' WITH '(' tableOptionList ')'
+    {
+        $$ = std::make_shared<CreateTable>($3, $5, $9);
+    }
     |   DROP TABLE tbName
     {
         $$ = std::make_shared<DropTable>($3);
@@ -134,6 +142,18 @@ ddl:
     {
         $$ = std::make_shared<CreateIndex>($3, $5);
     }
+    |   CREATE INDEX tbName '(' colNameList ')' WITH '(' tableOptionList ')'
+    {
+        $$ = std::make_shared<CreateIndex>($3, $5, $9);
+    }
+    |   CREATE INDEX tbName '(' colNameList ')' USING IDENTIFIER
+    {
+        $$ = std::make_shared<CreateIndex>($3, $5, std::vector<std::shared_ptr<TableOption>>(), $8);
+    }
+    |   CREATE INDEX tbName '(' colNameList ')' USING IDENTIFIER WITH '(' tableOptionList ')'
+    {
+        $$ = std::make_shared<CreateIndex>($3, $5, $11, $8);
+    }
     |   DROP INDEX tbName '(' colNameList ')'
     {
         $$ = std::make_shared<DropIndex>($3, $5);
@@ -153,13 +173,23 @@ dml:
     {
         $$ = std::make_shared<UpdateStmt>($2, $4, $5);
     }
-    |   SELECT aggreClause FROM tableList optWhereClause
-    {
-        $$ = std::make_shared<SelectStmt>($2, $4, $5);
-    }
-    |   SELECT selector FROM tableList optWhereClause opt_order_clause opt_limit_clause
-    {
-        $$ = std::make_shared<SelectStmt>($2, $4, $5, $6, $7);
+    |   SELECT selector FROM tableList optWhereClause opt_group_clause opt_order_clause opt_limit_clause
+    {
+        // 只有字段时沿用原来的查询，有聚合函数或GROUP BY时由分组聚合执行
+        std::vector<std::shared_ptr<Col>> cols;
+        std::vector<std::shared_ptr<AggreClause>> aggres;
+        for (auto &item : $2) {
+            if (item->aggre != nullptr) {
+                aggres.push_back(item->aggre);
+            } else {
+                cols.push_back(item->col);
+            }
+        }
+        if (aggres.empty() && $6.empty()) {
+            $$ = std::make_shared<SelectStmt>(cols, $4, $5, $7, $8);
+        } else {
+            $$ = std::make_shared<SelectStmt>($2, $4, $5, $6, $7, $8);
+        }
     }
     ;
 
@@ -174,6 +204,28 @@ fieldList:
     }
     ;
 
+tableOptionList:
+        tableOption
+    {
+        $$ = std::vector<std::shared_ptr<TableOption>>{$1};
+    }
+    |   tableOptionList ',' tableOption
+    {
+        $$.push_back($3);
+    }
+    ;
+
+tableOption:
+        IDENTIFIER '=' IDENTIFIER
+    {
+        $$ = std::make_shared<TableOption>($1, $3);
+    }
+    |   IDENTIFIER '=' VALUE_INT
+    {
+        $$ = std::make_shared<TableOption>($1, $3);
+    }
+    ;
+
 colNameList:
         colName
     {
@@ -384,12 +436,34 @@ aggreClause:
     }
     ;
 
+selItem:
+        col
+    {
+        $$ = std::make_shared<SelectItem>($1);
+    }
+    |   aggreClause
+    {
+        $$ = std::make_shared<SelectItem>($1);
+    }
+    ;
+
+selItemList:
+        selItem
+    {
+        $$ = std::vector<std::shared_ptr<SelectItem>>{$1};
+    }
+    |   selItemList ',' selItem
+    {
+        $$.push_back($3);
+    }
+    ;
+
 selector:
         '*'
     {
         $$ = {};
     }
-    |   colList
+    |   selItemList
     ;
 
 tableList:
@@ -407,6 +481,14 @@ tableList:
     }
     ;
 
+opt_group_clause:
+        GROUP BY colList
+    {
+        $$ = $3;
+    }
+    |   /* epsilon */ { /* ignore*/ }
+    ;
+
 opt_order_clause:
     ORDER BY order_clauses
     { 
@@ -14,8 +14,15 @@ See the Mulan PSL v2 for more details. */
 #include <cstring>
 #include <string>
 #include "optimizer/plan.h"
+#include "execution/execution_memory.h"
 #include "execution/executor_abstract.h"
 #include "execution/executor_nestedloop_join.h"
+#include "execution/executor_index_nestedloop_join.h"
+#include "execution/executor_hash_join.h"
+#include "execution/executor_merge_join.h"
+#include "execution/executor_exchange.h"
+#include "execution/executor_parallel_aggregate.h"
+#include "execution/executor_parallel_hash_join.h"
 #include "execution/executor_projection.h"
 #include "execution/executor_seq_scan.h"
 #include "execution/executor_index_scan.h"
@@ -23,7 +30,8 @@ See the Mulan PSL v2 for more details. */
 #include "execution/executor_insert.h"
 #include "execution/executor_delete.h"
 #include "execution/execution_sort.h"
-#include "execution/executor_aggre.h"
+#include "execution/executor_hash_aggregate.h"
+#include "execution/executor_stream_aggregate.h"
 #include "common/common.h"
 
 typedef enum portalTag{
@@ -61,6 +69,7 @@ class Portal
     std::shared_ptr<PortalStmt> start(std::shared_ptr<Plan> plan, Context *context)
     {
         // 这里可以将select进行拆分，例如：一个select，带有return的select等
+        auto budget = std::make_shared<MemoryBudget>();
         if (auto x = std::dynamic_pointer_cast<OtherPlan>(plan)) {
             return std::make_shared<PortalStmt>(PORTAL_CMD_UTILITY, std::vector<TabCol>(), std::unique_ptr<AbstractExecutor>(),plan);
         } else if (auto x = std::dynamic_pointer_cast<DDLPlan>(plan)) {
@@ -70,23 +79,19 @@ class Portal
                 case T_select:
                 {
                     std::shared_ptr<ProjectionPlan> p = std::dynamic_pointer_cast<ProjectionPlan>(x->subplan_);
-                    std::unique_ptr<AbstractExecutor> root= convert_plan_executor(p, context);
+                    std::unique_ptr<AbstractExecutor> root= convert_plan_executor(p, context, budget);
                     return std::make_shared<PortalStmt>(PORTAL_ONE_SELECT, std::move(p->sel_cols_), std::move(root), plan);
                 }
                 case T_Update:
                 {
-                    std::unique_ptr<AbstractExecutor> scan= convert_plan_executor(x->subplan_, context);
-                    std::vector<Rid> rids;
-                    for (scan->beginTuple(); !scan->is_end(); scan->nextTuple()) {
-                        rids.push_back(scan->rid());
-                    }
+                    std::unique_ptr<AbstractExecutor> scan= convert_plan_executor(x->subplan_, context, budget);
                     std::unique_ptr<AbstractExecutor> root =std::make_unique<UpdateExecutor>(sm_manager_,
-                                                            x->tab_name_, x->set_clauses_, x->conds_, rids, context);
+                                                            x->tab_name_, x->set_clauses_, x->conds_, std::move(scan), context);
                     return std::make_shared<PortalStmt>(PORTAL_DML_WITHOUT_SELECT, std::vector<TabCol>(), std::move(root), plan);
                 }
                 case T_Delete:
                 {
-                    std::unique_ptr<AbstractExecutor> scan= convert_plan_executor(x->subplan_, context);
+                    std::unique_ptr<AbstractExecutor> scan= convert_plan_executor(x->subplan_, context, budget);
                     std::vector<Rid> rids;
                     for (scan->beginTuple(); !scan->is_end(); scan->nextTuple()) {
                         rids.push_back(scan->rid());
@@ -122,16 +127,8 @@ class Portal
         switch(portal->tag) {
             case PORTAL_ONE_SELECT:
             {
-                if(portal->root->has_aggre()) {
-                    auto sel_col = portal->sel_cols[0];
-                    sel_col.col_name = portal->root->get_nickname();
-                    auto sel_cols = std::vector<TabCol>{sel_col};
-                    ql->select_from(std::move(portal->root), std::move(sel_cols), context);
-                    break;
-                } else {
-                    ql->select_from(std::move(portal->root), std::move(portal->sel_cols), context);
-                    break;
-                }
+                ql->select_from(std::move(portal->root), std::move(portal->sel_cols), context);
+                break;
             }
 
             case PORTAL_DML_WITHOUT_SELECT:
@@ -177,41 +174,156 @@ class Portal
         return solved_conds;
     }
 
-    std::unique_ptr<AbstractExecutor> convert_plan_executor(std::shared_ptr<Plan> plan, Context *context)
+    // budget为整个查询共享的内存预算，交给排序、hash join和嵌套循环连接这些需要物化的算子
+    std::unique_ptr<AbstractExecutor> convert_plan_executor(std::shared_ptr<Plan> plan, Context *context,
+                                                            const std::shared_ptr<MemoryBudget> &budget)
     {
         if(auto x = std::dynamic_pointer_cast<ProjectionPlan>(plan)){
-
-            return std::make_unique<ProjectionExecutor>(convert_plan_executor(x->subplan_, context),
-                                                        x->sel_cols_);
+            if (is_parallel(x->subplan_)) {
+                return convert_parallel(x, context, budget);
+            }
+            return std::make_unique<ProjectionExecutor>(convert_plan_executor(x->subplan_, context, budget),
+                                                        x->sel_cols_, x->limit_);
 
         } else if(auto x = std::dynamic_pointer_cast<ScanPlan>(plan)) {
             if(x->tag == T_SeqScan) {
-                return std::make_unique<SeqScanExecutor>(sm_manager_, x->tab_name_, x->conds_, context);
+                return std::make_unique<SeqScanExecutor>(sm_manager_, x->tab_name_, x->conds_, context, x->limit_);
             }
             else {
-                return std::make_unique<IndexScanExecutor>(sm_manager_, x->tab_name_, x->conds_, x->index_col_names_, context);
+                return std::make_unique<IndexScanExecutor>(sm_manager_, x->tab_name_, x->conds_, x->index_col_names_, context, x->covering_,
+                                                           x->reverse_, x->limit_, x->ordered_);
             } 
         } else if(auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+            if(x->tag == T_IndexNLJoin) {
+                // 内表不生成扫描算子，由连接算子按批探查索引
+                auto inner = std::dynamic_pointer_cast<ScanPlan>(x->inner_is_left_ ? x->left_ : x->right_);
+                auto outer = convert_plan_executor(x->inner_is_left_ ? x->right_ : x->left_, context, budget);
+                return std::make_unique<IndexNLJoinExecutor>(std::move(outer), sm_manager_, inner->tab_name_, inner->conds_,
+                                                             x->index_col_names_, x->conds_, x->inner_is_left_, context);
+            }
 
-            std::unique_ptr<AbstractExecutor> left = convert_plan_executor(x->left_, context);
+            std::unique_ptr<AbstractExecutor> left = convert_plan_executor(x->left_, context, budget);
             // left->set_conds(x->conds_);
-            std::unique_ptr<AbstractExecutor> right = convert_plan_executor(x->right_, context);
+            std::unique_ptr<AbstractExecutor> right = convert_plan_executor(x->right_, context, budget);
             // left->set_conds(x->conds_);
+            if(x->tag == T_MergeJoin) {
+                return std::make_unique<MergeJoinExecutor>(std::move(left), std::move(right), std::move(x->conds_),
+                                                           x->merge_keys_);
+            }
+            if(x->tag == T_HashJoin) {
+                return std::make_unique<HashJoinExecutor>(std::move(left), std::move(right), std::move(x->conds_),
+                                                          x->build_left_, budget, sm_manager_->get_disk_manager());
+            }
             std::unique_ptr<AbstractExecutor> join = std::make_unique<NestedLoopJoinExecutor>(
                     std::move(left),
-                    std::move(right), std::move(x->conds_));
+                    std::move(right), std::move(x->conds_), budget);
             return join;
         } else if(auto x = std::dynamic_pointer_cast<SortPlan>(plan)) {
-            return std::make_unique<SortExecutor>(convert_plan_executor(x->subplan_, context),
-                                            x->orders_,x->limit_);
-        } else if(auto x = std::dynamic_pointer_cast<AggrePlan>(plan)) {
-            if(x->aggreClause_== nullptr) {
-                // std::cout<<"portal.h convert plan"<<std::endl;
-            }
-            // std::cout<<x->aggreClause_->aggregation_type_<<std::endl;
-            return std::make_unique<AggreExecutor>(convert_plan_executor(x->subplan_, context), std::move(x->aggreClause_));
+            if (is_parallel(x->subplan_)) {
+                return std::make_unique<SortExecutor>(convert_parallel(x->subplan_, context, budget), x->orders_,
+                                                      x->limit_, budget, sm_manager_->get_disk_manager());
+            }
+            return std::make_unique<SortExecutor>(convert_plan_executor(x->subplan_, context, budget),
+                                            x->orders_,x->limit_, budget, sm_manager_->get_disk_manager());
+        } else if(auto x = std::dynamic_pointer_cast<GroupAggrePlan>(plan)) {
+            if(x->tag == T_StreamAggre) {
+                return std::make_unique<StreamAggregateExecutor>(convert_plan_executor(x->subplan_, context, budget),
+                                                                 x->group_cols_, x->aggres_);
+            }
+            if (x->dop_ > 1 && is_parallel(x->subplan_)) {
+                return std::make_unique<ParallelHashAggregateExecutor>(convert_pipelines(x->subplan_, context, budget),
+                                                                       x->group_cols_, x->aggres_, budget);
+            }
+            return std::make_unique<HashAggregateExecutor>(convert_plan_executor(x->subplan_, context, budget),
+                                                           x->group_cols_, x->aggres_, budget,
+                                                           sm_manager_->get_disk_manager());
         }
         return nullptr;
     }
 
+    /* 同一个并行计划拆出的各条流水线共享的状态：每个并行扫描一份页面分配，每个并行hash join一个build端 */
+    struct PipelineShared {
+        std::map<const Plan *, std::shared_ptr<PageMorsels>> morsels;
+        std::map<const Plan *, std::shared_ptr<ParallelJoinBuild>> builds;
+    };
+
+    // 计划能否拆成几条并行的流水线：标记了并行度的顺序扫描和hash join，以及它们上面的投影
+    static bool is_parallel(const std::shared_ptr<Plan> &plan) {
+        if (auto x = std::dynamic_pointer_cast<ProjectionPlan>(plan)) {
+            return is_parallel(x->subplan_);
+        }
+        if (auto x = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+            return x->tag == T_SeqScan && x->dop_ > 1;
+        }
+        if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+            return x->tag == T_HashJoin && x->dop_ > 1;
+        }
+        return false;
+    }
+
+    static int parallel_degree(const std::shared_ptr<Plan> &plan) {
+        if (auto x = std::dynamic_pointer_cast<ProjectionPlan>(plan)) {
+            return parallel_degree(x->subplan_);
+        }
+        if (auto x = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+            return x->dop_;
+        }
+        return std::dynamic_pointer_cast<JoinPlan>(plan)->dop_;
+    }
+
+    // 把并行计划拆成并行度（不超过工作线程数）条结构相同的流水线
+    std::vector<std::unique_ptr<AbstractExecutor>> convert_pipelines(const std::shared_ptr<Plan> &plan, Context *context,
+                                                                     const std::shared_ptr<MemoryBudget> &budget)
+    {
+        size_t n = std::min<size_t>(parallel_degree(plan), WorkerPool::instance().size());
+        PipelineShared shared;
+        std::vector<std::unique_ptr<AbstractExecutor>> pipelines;
+        for (size_t i = 0; i < n; i++) {
+            pipelines.push_back(convert_pipeline(plan, i, n, shared, context, budget));
+        }
+        return pipelines;
+    }
+
+    // 各条流水线在工作线程中执行，结果由ExchangeExecutor汇合
+    std::unique_ptr<AbstractExecutor> convert_parallel(const std::shared_ptr<Plan> &plan, Context *context,
+                                                       const std::shared_ptr<MemoryBudget> &budget)
+    {
+        return std::make_unique<ExchangeExecutor>(convert_pipelines(plan, context, budget));
+    }
+
+    // 并行计划的第i条（共n条）流水线：顺序扫描共享页面分配，hash join共享build端并由第0条流水线负责建表
+    std::unique_ptr<AbstractExecutor> convert_pipeline(const std::shared_ptr<Plan> &plan, size_t i, size_t n,
+                                                       PipelineShared &shared, Context *context,
+                                                       const std::shared_ptr<MemoryBudget> &budget)
+    {
+        if (auto x = std::dynamic_pointer_cast<ProjectionPlan>(plan)) {
+            return std::make_unique<ProjectionExecutor>(convert_pipeline(x->subplan_, i, n, shared, context, budget),
+                                                        x->sel_cols_, x->limit_);
+        }
+        if (auto x = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+            auto &morsels = shared.morsels[x.get()];
+            if (morsels == nullptr) {
+                morsels = std::make_shared<PageMorsels>();
+            }
+            return std::make_unique<SeqScanExecutor>(sm_manager_, x->tab_name_, x->conds_, context, x->limit_, morsels);
+        }
+        auto x = std::dynamic_pointer_cast<JoinPlan>(plan);
+        auto &build_plan = x->build_left_ ? x->left_ : x->right_;
+        auto &probe_plan = x->build_left_ ? x->right_ : x->left_;
+        auto probe = convert_pipeline(probe_plan, i, n, shared, context, budget);
+        auto &build = shared.builds[x.get()];
+        if (build == nullptr) {
+            std::vector<std::unique_ptr<AbstractExecutor>> inputs;
+            if (is_parallel(build_plan)) {
+                for (size_t j = 0; j < n; j++) {
+                    inputs.push_back(convert_pipeline(build_plan, j, n, shared, context, budget));
+                }
+            } else {
+                inputs.push_back(convert_plan_executor(build_plan, context, budget));
+            }
+            build = std::make_shared<ParallelJoinBuild>(std::move(inputs), probe->cols(), x->conds_, x->build_left_,
+                                                        budget);
+        }
+        return std::make_unique<HashJoinProbeExecutor>(std::move(probe), build, i == 0);
+    }
 };
\ No newline at end of file
@@ -17,14 +17,38 @@ constexpr int RM_NO_PAGE = -1;
 constexpr int RM_FILE_HDR_PAGE = 0;
 constexpr int RM_FIRST_RECORD_PAGE = 1;
 constexpr int RM_MAX_RECORD_SIZE = 512;
+constexpr int RM_MAX_COLS = 32;
+constexpr int RM_FILE_MAGIC = 0x424d4452;   // 文件头的第一个字段，"RMDB"
+constexpr int RM_FILE_VERSION = 1;          // 文件头格式的版本，RmFileHdr的字段变化时加一
+
+/* 表数据页面的存储布局 */
+enum RmLayout {
+  RM_LAYOUT_ROW = 0, // NSM：每条记录在slot中连续存放
+  RM_LAYOUT_PAX = 1  // PAX：页面内按字段分组，每个字段占一段minipage
+};
+
+/* 加入magic、version和页面布局之前的文件头，只用于读取旧版本的表数据文件，这些文件都是行存布局 */
+struct RmFileHdrV0 {
+  int record_size;
+  int num_pages;
+  int num_records_per_page;
+  int first_free_page_no;
+  int bitmap_size;
+};
 
 /* 文件头，记录表数据文件的元信息，写入磁盘中文件的第0号页面 */
 struct RmFileHdr {
+  int magic;       // 固定为RM_FILE_MAGIC；旧版本文件这里是record_size，不会超过RM_MAX_RECORD_SIZE
+  int version;     // 文件头格式的版本，见RM_FILE_VERSION
   int record_size; // 表中每条记录的大小，由于不包含变长字段，因此当前字段初始化后保持不变
   int num_pages;   // 文件中分配的页面个数（初始化为1）
   int num_records_per_page; // 每个页面最多能存储的元组个数
   int first_free_page_no; // 文件中当前第一个包含空闲空间的页面号（初始化为-1）
   int bitmap_size; // 每个页面bitmap大小
+  int layout;      // 页面布局，见RmLayout（初始化为RM_LAYOUT_ROW）
+  int num_cols;    // PAX布局下的字段个数
+  int col_lens[RM_MAX_COLS]; // PAX布局下每个字段的长度
+  int col_offs[RM_MAX_COLS]; // PAX布局下每个字段在记录中的偏移量
 };
 
 /* 表数据文件中每个页面的页头，记录每个页面的元信息 */
@@ -33,6 +57,12 @@ struct RmPageHdr {
   int num_records; // 当前页面中当前已经存储的记录个数（初始化为0）
 };
 
+/* 原地更新时记录中发生变化的字节区间，也是增量日志的基本单位 */
+struct RmDelta {
+  int offset; // 区间在记录中的起始偏移量
+  int len;    // 区间长度
+};
+
 /* 表中的记录 */
 struct RmRecord {
   char *data;              // 记录的数据
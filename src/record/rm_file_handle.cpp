@@ -10,6 +10,8 @@ See the Mulan PSL v2 for more details. */
 
 #include "rm_file_handle.h"
 
+#include <algorithm>
+
 /**
  * @description: 获取当前表中记录号为rid的记录
  * @param {Rid&} rid 记录号，指定记录的位置
@@ -27,13 +29,65 @@ std::unique_ptr<RmRecord> RmFileHandle::get_record(const Rid &rid,
     if (!Bitmap::is_set(ph.bitmap, rid.slot_no)) {
         throw RecordNotFoundError(rid.page_no, rid.slot_no);
     }
-    char *slot = ph.get_slot(rid.slot_no);
-    memcpy(record->data, slot, file_hdr_.record_size);
+    ph.read_slot(rid.slot_no, record->data);
     record->size = file_hdr_.record_size;
     buffer_pool_manager_->unpin_page({fd_,rid.page_no}, false);
     return record;
 }
 
+/**
+ * @description: 从第0页读出文件头。旧版本文件（没有magic）只有行存布局，读出后按当前格式补全，
+ * 关闭文件时按当前格式写回；版本号不认识的文件拒绝打开
+ */
+void RmFileHandle::load_file_hdr() {
+  int magic;
+  disk_manager_->read_page(fd_, RM_FILE_HDR_PAGE, (char *)&magic, sizeof(magic));
+  if (magic != RM_FILE_MAGIC) {
+    RmFileHdrV0 old_hdr;
+    disk_manager_->read_page(fd_, RM_FILE_HDR_PAGE, (char *)&old_hdr, sizeof(old_hdr));
+    if (old_hdr.record_size < 1 || old_hdr.record_size > RM_MAX_RECORD_SIZE) {
+      throw InternalError("Not a table data file: bad file header");
+    }
+    file_hdr_ = RmFileHdr{};
+    file_hdr_.record_size = old_hdr.record_size;
+    file_hdr_.num_pages = old_hdr.num_pages;
+    file_hdr_.num_records_per_page = old_hdr.num_records_per_page;
+    file_hdr_.first_free_page_no = old_hdr.first_free_page_no;
+    file_hdr_.bitmap_size = old_hdr.bitmap_size;
+    file_hdr_.layout = RM_LAYOUT_ROW;
+  } else {
+    disk_manager_->read_page(fd_, RM_FILE_HDR_PAGE, (char *)&file_hdr_, sizeof(file_hdr_));
+    if (file_hdr_.version != RM_FILE_VERSION) {
+      throw InternalError("Unsupported table file version " + std::to_string(file_hdr_.version) +
+                          ", expected " + std::to_string(RM_FILE_VERSION));
+    }
+  }
+  file_hdr_.magic = RM_FILE_MAGIC;
+  file_hdr_.version = RM_FILE_VERSION;
+}
+
+/**
+ * @description: 设置zone map维护的字段，并扫描整个文件重建每个页面的摘要
+ * @param {vector<RmZoneCol>&} cols 表的字段
+ */
+void RmFileHandle::build_zone_map(const std::vector<RmZoneCol> &cols) {
+  zone_map_.init(cols);
+  if (!zone_map_.enabled()) {
+    return;
+  }
+  RmRecord rec(file_hdr_.record_size);
+  for (int page_no = RM_FIRST_RECORD_PAGE; page_no < file_hdr_.num_pages; page_no++) {
+    RmPageHandle ph = fetch_page_handle(page_no);
+    int n = file_hdr_.num_records_per_page;
+    for (int slot_no = Bitmap::first_bit(true, ph.bitmap, n); slot_no < n;
+         slot_no = Bitmap::next_bit(true, ph.bitmap, n, slot_no)) {
+      ph.read_slot(slot_no, rec.data);
+      zone_map_.add(page_no, rec.data);
+    }
+    buffer_pool_manager_->unpin_page({fd_, page_no}, false);
+  }
+}
+
 /**
  * @description: 在当前表中插入一条记录，不指定插入位置
  * @param {char*} buf 要插入的记录的数据
@@ -57,9 +111,9 @@ Rid RmFileHandle::insert_record(char *buf, Context *context) {
         file_hdr_.first_free_page_no = ph.page_hdr->next_free_page_no;
     }
     // copy record data into slot
-    char *slot = ph.get_slot(slot_no);
-    memcpy(slot, buf, file_hdr_.record_size);
+    ph.write_slot(slot_no, buf);
     Rid rid{ph.page->get_page_id().page_no, slot_no};
+    zone_map_.add(rid.page_no, buf);
     buffer_pool_manager_->unpin_page({fd_,rid.page_no}, true);
     return rid;
 }
@@ -75,9 +129,9 @@ void RmFileHandle::insert_record(const Rid &rid, char *buf) {
   // 确保插槽是空的
   assert(!Bitmap::is_set(page_handle.bitmap, rid.slot_no));
 
-  // 获取插槽地址并复制记录数据
-  char *record_slot = page_handle.get_slot(rid.slot_no);
-  memcpy(record_slot, buf, file_hdr_.record_size);
+  // 将记录数据写入插槽
+  page_handle.write_slot(rid.slot_no, buf);
+  zone_map_.add(rid.page_no, buf);
 
   // 更新bitmap和元数据
   Bitmap::set(page_handle.bitmap, rid.slot_no);
@@ -93,6 +147,38 @@ void RmFileHandle::insert_record(const Rid &rid, char *buf) {
 
 }
 
+/**
+ * @description: 批量导入时直接在文件末尾构建新的数据页，不经过空闲页链表逐条插入
+ * @param {char*} buf 连续存放的count条记录
+ * @param {int} count 记录条数
+ * @param {vector<Rid>&} rids 依次追加每条记录的记录号
+ */
+void RmFileHandle::append_records(const char *buf, int count, std::vector<Rid> &rids) {
+  int n = file_hdr_.num_records_per_page;
+  // create_new_page_handle会把新页作为空闲链表表头，这里先记下原来的表头
+  int free_head = file_hdr_.first_free_page_no;
+  for (int start = 0; start < count; start += n) {
+    int num = std::min(n, count - start);
+    RmPageHandle ph = create_new_page_handle();
+    int page_no = ph.page->get_page_id().page_no;
+    for (int slot_no = 0; slot_no < num; slot_no++) {
+      const char *rec = buf + (size_t)(start + slot_no) * file_hdr_.record_size;
+      ph.write_slot(slot_no, rec);
+      Bitmap::set(ph.bitmap, slot_no);
+      zone_map_.add(page_no, rec);
+      rids.push_back(Rid{page_no, slot_no});
+    }
+    ph.page_hdr->num_records = num;
+    if (num < n) {
+      // 只有最后一页可能未满，把它挂到空闲链表表头
+      ph.page_hdr->next_free_page_no = free_head;
+      free_head = page_no;
+    }
+    file_hdr_.first_free_page_no = free_head;
+    buffer_pool_manager_->unpin_page(ph.page->get_page_id(), true);
+  }
+}
+
 /**
  * @description: 删除记录文件中记录号为rid的记录
  * @param {Rid&} rid 要删除的记录的记录号（位置）
@@ -119,6 +205,9 @@ void RmFileHandle::delete_record(const Rid &rid, Context *context) {
     release_page_handle(page_handle);
   }
     page_handle.page_hdr->num_records--;
+  if (page_handle.page_hdr->num_records == 0) {
+    zone_map_.reset(rid.page_no);
+  }
   buffer_pool_manager_->unpin_page({fd_,rid.page_no},true);
 }
 
@@ -138,12 +227,65 @@ void RmFileHandle::update_record(const Rid &rid, char *buf, Context *context) {
   assert(Bitmap::is_set(page_handle.bitmap, rid.slot_no));
   // if(context!= nullptr)
   // page_handle.page->set_page_lsn(context->log_mgr_->GetNextLsn());
-  // 获取插槽地址并复制新的记录数据
-  char *record_slot = page_handle.get_slot(rid.slot_no);
-  memcpy(record_slot, buf, file_hdr_.record_size);
+  // 将新的记录数据写入插槽
+  page_handle.write_slot(rid.slot_no, buf);
+  // 旧值仍留在摘要范围内，范围只会变大，不影响裁剪的正确性
+  zone_map_.add(rid.page_no, buf);
   buffer_pool_manager_->unpin_page({fd_,rid.page_no}, true);
 }
 
+/**
+ * @description: 原地更新已经fetch的页面中slot_no处的记录，只写回deltas中的字节区间，完成后unpin页面
+ * 调用方在同一次pin内读出旧记录、构造新记录并写日志，整个过程不需要再次fetch页面
+ * @param {RmPageHandle&} page_handle 记录所在页面，由fetch_page_handle()得到
+ * @param {int} slot_no 记录所在的slot
+ * @param {char*} buf 完整的新记录
+ * @param {vector<RmDelta>&} deltas 新旧记录不同的字节区间，由diff_records()得到
+ */
+void RmFileHandle::update_record(RmPageHandle &page_handle, int slot_no, const char *buf,
+                                 const std::vector<RmDelta> &deltas) {
+  assert(Bitmap::is_set(page_handle.bitmap, slot_no));
+  for (auto &delta : deltas) {
+    page_handle.write_range(slot_no, buf, delta.offset, delta.len);
+  }
+  zone_map_.add(page_handle.page->get_page_id().page_no, buf);
+  unpin_page_handle(page_handle, !deltas.empty());
+}
+
+/**
+ * @description: 比较新旧两条记录，得到所有发生变化的字节区间
+ * 每个区间在增量日志中有offset和len两个int的开销，而合并后间隔中的字节要在旧值和新值中各存一份，
+ * 因此间隔不超过一个int的相邻区间合并成一个
+ * @param {char*} old_buf 旧记录
+ * @param {char*} new_buf 新记录
+ * @param {vector<RmDelta>&} deltas 清空后依次存放变化的区间，记录没有变化时为空
+ */
+void RmFileHandle::diff_records(const char *old_buf, const char *new_buf,
+                                std::vector<RmDelta> &deltas) const {
+  constexpr int merge_gap = sizeof(int);
+  deltas.clear();
+  int size = file_hdr_.record_size;
+  for (int i = 0; i < size; i++) {
+    if (old_buf[i] == new_buf[i]) {
+      continue;
+    }
+    if (!deltas.empty() && i - (deltas.back().offset + deltas.back().len) <= merge_gap) {
+      deltas.back().len = i + 1 - deltas.back().offset;
+    } else {
+      deltas.push_back(RmDelta{i, 1});
+    }
+  }
+}
+
+/**
+ * @description: 释放fetch_page_handle()得到的页面
+ * @param {RmPageHandle&} page_handle 页面句柄
+ * @param {bool} is_dirty 页面是否被修改
+ */
+void RmFileHandle::unpin_page_handle(RmPageHandle &page_handle, bool is_dirty) {
+  buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), is_dirty);
+}
+
 /**
  * 以下函数为辅助函数，仅提供参考，可以选择完成如下函数，也可以删除如下函数，在单元测试中不涉及如下函数接口的直接调用
  */
@@ -12,11 +12,13 @@ See the Mulan PSL v2 for more details. */
 
 #include <assert.h>
 
+#include <algorithm>
 #include <memory>
 
 #include "bitmap.h"
 #include "common/context.h"
 #include "rm_defs.h"
+#include "rm_zone_map.h"
 
 class RmManager;
 
@@ -39,12 +41,57 @@ struct RmPageHandle {
     slots = bitmap + file_hdr->bitmap_size;
   }
 
-  // 返回指定slot_no的slot存储收地址
+  // 返回指定slot_no的slot存储收地址，仅行存布局下记录是连续存放的
   char *get_slot(int slot_no) const {
     return slots +
            slot_no * file_hdr->record_size; // slots的首地址 + slot个数 *
                                             // 每个slot的大小(每个record的大小)
   }
+
+  // PAX布局下第col_no个字段的minipage首地址，minipage中依次存放每个slot的该字段
+  char *get_minipage(int col_no) const {
+    return slots + file_hdr->col_offs[col_no] * file_hdr->num_records_per_page;
+  }
+
+  // 将slot_no处的记录拷贝到buf中，PAX布局下需要从各个minipage中拼接
+  void read_slot(int slot_no, char *buf) const {
+    if (file_hdr->layout != RM_LAYOUT_PAX) {
+      memcpy(buf, get_slot(slot_no), file_hdr->record_size);
+      return;
+    }
+    for (int i = 0; i < file_hdr->num_cols; i++) {
+      int len = file_hdr->col_lens[i];
+      memcpy(buf + file_hdr->col_offs[i], get_minipage(i) + slot_no * len, len);
+    }
+  }
+
+  // 将buf中的记录写入slot_no处，PAX布局下按字段拆分到各个minipage
+  void write_slot(int slot_no, const char *buf) {
+    if (file_hdr->layout != RM_LAYOUT_PAX) {
+      memcpy(get_slot(slot_no), buf, file_hdr->record_size);
+      return;
+    }
+    for (int i = 0; i < file_hdr->num_cols; i++) {
+      int len = file_hdr->col_lens[i];
+      memcpy(get_minipage(i) + slot_no * len, buf + file_hdr->col_offs[i], len);
+    }
+  }
+
+  // 只把buf中[offset, offset + len)区间的字节写入slot_no处，PAX布局下写入与区间相交的各个minipage
+  void write_range(int slot_no, const char *buf, int offset, int len) {
+    if (file_hdr->layout != RM_LAYOUT_PAX) {
+      memcpy(get_slot(slot_no) + offset, buf + offset, len);
+      return;
+    }
+    for (int i = 0; i < file_hdr->num_cols; i++) {
+      int begin = std::max(offset, file_hdr->col_offs[i]);
+      int end = std::min(offset + len, file_hdr->col_offs[i] + file_hdr->col_lens[i]);
+      if (begin < end) {
+        memcpy(get_minipage(i) + slot_no * file_hdr->col_lens[i] + (begin - file_hdr->col_offs[i]),
+               buf + begin, end - begin);
+      }
+    }
+  }
 };
 
 /* 每个RmFileHandle对应一个表的数据文件，里面有多个page，每个page的数据封装在RmPageHandle中
@@ -58,6 +105,7 @@ private:
   BufferPoolManager *buffer_pool_manager_;
   int fd_;             // 打开文件后产生的文件句柄
   RmFileHdr file_hdr_; // 文件头，维护当前表文件的元数据
+  RmZoneMap zone_map_; // 每个页面各字段的min/max摘要，只在内存中维护
 
 public:
   RmFileHandle(DiskManager *disk_manager,
@@ -67,8 +115,7 @@ public:
     // 注意：这里从磁盘中读出文件描述符为fd的文件的file_hdr，读到内存中
     // 这里实际就是初始化file_hdr，只不过是从磁盘中读出进行初始化
     // init file_hdr_
-    disk_manager_->read_page(fd, RM_FILE_HDR_PAGE, (char *)&file_hdr_,
-                             sizeof(file_hdr_));
+    load_file_hdr();
     // std::cout<<file_hdr_.num_pages<<std::endl;
     // create_file函数创的是的1, buf if close then open, it's 0.
     // disk_manager管理的fd对应的文件中，设置从file_hdr_.num_pages开始分配page_no
@@ -77,6 +124,7 @@ public:
 
   RmFileHdr get_file_hdr() const { return file_hdr_; }
   int GetFd() { return fd_; }
+  bool is_pax() const { return file_hdr_.layout == RM_LAYOUT_PAX; }
 
   /* 判断指定位置上是否已经存在一条记录，通过Bitmap来判断 */
   bool is_record(const Rid &rid) const {
@@ -87,19 +135,35 @@ public:
 
   std::unique_ptr<RmRecord> get_record(const Rid &rid, Context *context) const;
 
+  void build_zone_map(const std::vector<RmZoneCol> &cols);
+
+  const RmZoneMap &zone_map() const { return zone_map_; }
+
   Rid insert_record(char *buf, Context *context);
 
   void insert_record(const Rid &rid, char *buf);
 
+  void append_records(const char *buf, int count, std::vector<Rid> &rids);
+
   void delete_record(const Rid &rid, Context *context);
 
   void update_record(const Rid &rid, char *buf, Context *context);
 
+  void update_record(RmPageHandle &page_handle, int slot_no, const char *buf,
+                     const std::vector<RmDelta> &deltas);
+
+  void diff_records(const char *old_buf, const char *new_buf,
+                    std::vector<RmDelta> &deltas) const;
+
+  void unpin_page_handle(RmPageHandle &page_handle, bool is_dirty);
+
   RmPageHandle create_new_page_handle();
 
   RmPageHandle fetch_page_handle(int page_no) const;
 
 private:
+  void load_file_hdr();
+
   RmPageHandle create_page_handle();
 
   void release_page_handle(RmPageHandle &page_handle);
@@ -35,23 +35,42 @@ class RmManager {
         if (record_size < 1 || record_size > RM_MAX_RECORD_SIZE) {
             throw InvalidRecordSizeError(record_size);
         }
-        disk_manager_->create_file(filename);
-        int fd = disk_manager_->open_file(filename);
-
-        // 初始化file header
         RmFileHdr file_hdr{};
         file_hdr.record_size = record_size;
-        file_hdr.num_pages = 1;
-        file_hdr.first_free_page_no = RM_NO_PAGE;
-        // We have: sizeof(hdr) + (n + 7) / 8 + n * record_size <= PAGE_SIZE
-        file_hdr.num_records_per_page =
-            (BITMAP_WIDTH * (PAGE_SIZE - 1 - (int)sizeof(RmFileHdr)) + 1) / (1 + record_size * BITMAP_WIDTH);
-        file_hdr.bitmap_size = (file_hdr.num_records_per_page + BITMAP_WIDTH - 1) / BITMAP_WIDTH;
+        file_hdr.layout = RM_LAYOUT_ROW;
+        write_file_hdr(filename, file_hdr);
+    }
 
-        // 将file header写入磁盘文件（名为file name，文件描述符为fd）中的第0页
-        // head page直接写入磁盘，没有经过缓冲区的NewPage，那么也就不需要FlushPage
-        disk_manager_->write_page(fd, RM_FILE_HDR_PAGE, (char *)&file_hdr, sizeof(file_hdr));
-        disk_manager_->close_file(fd);
+    /**
+     * @description: 创建指定页面布局的表数据文件
+     * @param {string&} filename 要创建的文件名称
+     * @param {vector<int>&} col_lens 表中每个字段的长度，PAX布局按此划分minipage
+     * @param {RmLayout} layout 页面布局
+     */
+    void create_file(const std::string& filename, const std::vector<int>& col_lens, RmLayout layout) {
+        int record_size = 0;
+        for (int len : col_lens) {
+            record_size += len;
+        }
+        if (record_size < 1 || record_size > RM_MAX_RECORD_SIZE) {
+            throw InvalidRecordSizeError(record_size);
+        }
+        if (layout == RM_LAYOUT_PAX && (int)col_lens.size() > RM_MAX_COLS) {
+            throw InternalError("PAX layout supports at most " + std::to_string(RM_MAX_COLS) + " columns");
+        }
+        RmFileHdr file_hdr{};
+        file_hdr.record_size = record_size;
+        file_hdr.layout = layout;
+        if (layout == RM_LAYOUT_PAX) {
+            file_hdr.num_cols = col_lens.size();
+            int offset = 0;
+            for (size_t i = 0; i < col_lens.size(); i++) {
+                file_hdr.col_lens[i] = col_lens[i];
+                file_hdr.col_offs[i] = offset;
+                offset += col_lens[i];
+            }
+        }
+        write_file_hdr(filename, file_hdr);
     }
 
     /**
@@ -68,7 +87,13 @@ class RmManager {
      */
     std::unique_ptr<RmFileHandle> open_file(const std::string& filename) {
         int fd = disk_manager_->open_file(filename);
-        return std::make_unique<RmFileHandle>(disk_manager_, buffer_pool_manager_, fd);
+        try {
+            return std::make_unique<RmFileHandle>(disk_manager_, buffer_pool_manager_, fd);
+        } catch (RMDBError &) {
+            // 文件头无法识别时不保留打开的文件
+            disk_manager_->close_file(fd);
+            throw;
+        }
     }
     /**
      * @description: 关闭表的数据文件
@@ -81,4 +106,32 @@ class RmManager {
         disk_manager_->close_file(file_handle->fd_);
 
     }
+
+   private:
+    /**
+     * @description: 补全file header中与页面容量相关的字段，创建文件并写入第0页
+     * @param {string&} filename 要创建的文件名称
+     * @param {RmFileHdr&} file_hdr 已填好record_size和布局信息的文件头
+     */
+    void write_file_hdr(const std::string& filename, RmFileHdr& file_hdr) {
+        disk_manager_->create_file(filename);
+        int fd = disk_manager_->open_file(filename);
+
+        // 初始化file header
+        file_hdr.magic = RM_FILE_MAGIC;
+        file_hdr.version = RM_FILE_VERSION;
+        file_hdr.num_pages = 1;
+        file_hdr.first_free_page_no = RM_NO_PAGE;
+        // We have: sizeof(hdr) + (n + 7) / 8 + n * record_size <= PAGE_SIZE
+        // 两种布局每个slot占用的总字节数相同，PAX只是把同一字段的值集中存放
+        int hdr_size = Page::OFFSET_PAGE_HDR + sizeof(RmPageHdr);
+        file_hdr.num_records_per_page =
+            (BITMAP_WIDTH * (PAGE_SIZE - 1 - hdr_size) + 1) / (1 + file_hdr.record_size * BITMAP_WIDTH);
+        file_hdr.bitmap_size = (file_hdr.num_records_per_page + BITMAP_WIDTH - 1) / BITMAP_WIDTH;
+
+        // 将file header写入磁盘文件（名为file name，文件描述符为fd）中的第0页
+        // head page直接写入磁盘，没有经过缓冲区的NewPage，那么也就不需要FlushPage
+        disk_manager_->write_page(fd, RM_FILE_HDR_PAGE, (char *)&file_hdr, sizeof(file_hdr));
+        disk_manager_->close_file(fd);
+    }
 };
@@ -22,6 +22,17 @@ RmScan::RmScan(const RmFileHandle *file_handle) : file_handle_(file_handle) {
     next();
 }
 
+/**
+ * @brief 带页面裁剪的扫描，zone map表明不可能满足zone_conds的页面直接跳过
+ * @param file_handle
+ * @param zone_conds 记录中字段与常量比较的谓词
+ */
+RmScan::RmScan(const RmFileHandle *file_handle, std::vector<RmZoneCond> zone_conds)
+    : file_handle_(file_handle), zone_conds_(std::move(zone_conds)) {
+    rid_ = Rid{RM_FIRST_RECORD_PAGE, -1};
+    next();
+}
+
 /**
  * @brief 找到文件中下一个存放了记录的位置
  */
@@ -29,6 +40,10 @@ void RmScan::next() {
   // Todo:
     assert(!is_end());
     while (rid_.page_no < file_handle_->file_hdr_.num_pages) {
+        if (rid_.slot_no == -1 && !file_handle_->zone_map_.may_match(rid_.page_no, zone_conds_)) {
+            rid_.page_no++;
+            continue;
+        }
         RmPageHandle ph = file_handle_->fetch_page_handle(rid_.page_no);
         rid_.slot_no = Bitmap::next_bit(true, ph.bitmap, file_handle_->file_hdr_.num_records_per_page, rid_.slot_no);
         if (rid_.slot_no < file_handle_->file_hdr_.num_records_per_page) {
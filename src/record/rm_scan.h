@@ -11,15 +11,19 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "rm_defs.h"
+#include "rm_zone_map.h"
 
 class RmFileHandle;
 
 class RmScan : public RecScan {
     const RmFileHandle *file_handle_;
     Rid rid_;
+    std::vector<RmZoneCond> zone_conds_;    // 用于按zone map跳过页面的范围谓词
 public:
     RmScan(const RmFileHandle *file_handle);
 
+    RmScan(const RmFileHandle *file_handle, std::vector<RmZoneCond> zone_conds);
+
     void next() override;
 
     [[nodiscard]] bool is_end() const override {return rid_.page_no==RM_NO_PAGE;}
@@ -0,0 +1,184 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL
+v2. You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+#include "defs.h"
+
+/* zone map中记录摘要的字段 */
+struct RmZoneCol {
+  ColType type; // 字段类型
+  int offset;   // 字段位于记录中的偏移量
+  int len;      // 字段长度
+};
+
+/* 页面裁剪只关心范围比较，<>无法用于裁剪 */
+enum RmZoneOp { ZONE_EQ, ZONE_LT, ZONE_LE, ZONE_GT, ZONE_GE };
+
+/* 扫描时用于页面裁剪的谓词：记录中offset处的字段 op val */
+struct RmZoneCond {
+  int offset;
+  RmZoneOp op;
+  std::vector<char> val; // 与字段同类型、同长度的常量
+};
+
+/**
+ * 表数据文件中每个页面、每个定长可比较字段的最小值/最大值摘要，只保存在内存中。
+ * 插入和更新时扩大范围，页面被删空时清除，因此范围始终覆盖页面中的全部记录（可能偏大），
+ * 顺序扫描据此跳过不可能满足范围谓词的页面。
+ * 插入/删除与（并行）扫描可能同时进行，add/reset会扩容或修改摘要，因此用读写锁保护：may_match加读锁，其余加写锁。
+ */
+class RmZoneMap {
+private:
+  std::vector<RmZoneCol> cols_;    // 维护摘要的字段，目前只维护INT/FLOAT/BIGINT/DATETIME
+  int zone_size_ = 0;              // 每个页面摘要中最小值（或最大值）部分的字节数
+  std::vector<bool> valid_;        // 页面是否已有摘要，没有摘要的页面视为空页面
+  std::vector<char> mins_;         // 按页面号依次存放各字段的最小值
+  std::vector<char> maxs_;         // 按页面号依次存放各字段的最大值
+  mutable std::shared_mutex latch_; // 保护以上全部成员
+
+  static int compare(const char *a, const char *b, const RmZoneCol &col) {
+    switch (col.type) {
+    case TYPE_INT: {
+      int ia = *(int *)a, ib = *(int *)b;
+      return (ia < ib) ? -1 : ((ia > ib) ? 1 : 0);
+    }
+    case TYPE_FLOAT: {
+      float fa = *(float *)a, fb = *(float *)b;
+      return (fa < fb) ? -1 : ((fa > fb) ? 1 : 0);
+    }
+    case TYPE_BIGINT: {
+      std::int64_t ba = *(std::int64_t *)a, bb = *(std::int64_t *)b;
+      return (ba < bb) ? -1 : ((ba > bb) ? 1 : 0);
+    }
+    default:
+      return memcmp(a, b, col.len);
+    }
+  }
+
+  // 返回zone map中偏移量为offset的字段编号及其在摘要中的位置，不存在时返回-1
+  int find_col(int offset, int *zone_off) const {
+    int off = 0;
+    for (size_t i = 0; i < cols_.size(); i++) {
+      if (cols_[i].offset == offset) {
+        *zone_off = off;
+        return i;
+      }
+      off += cols_[i].len;
+    }
+    return -1;
+  }
+
+  void ensure_page(int page_no) {
+    if (page_no >= (int)valid_.size()) {
+      valid_.resize(page_no + 1, false);
+      mins_.resize((size_t)(page_no + 1) * zone_size_);
+      maxs_.resize((size_t)(page_no + 1) * zone_size_);
+    }
+  }
+
+public:
+  /* 设置需要维护摘要的字段，并清空已有的摘要 */
+  void init(const std::vector<RmZoneCol> &cols) {
+    std::unique_lock<std::shared_mutex> lock(latch_);
+    cols_.clear();
+    zone_size_ = 0;
+    for (auto &col : cols) {
+      if (col.type == TYPE_STRING) {
+        continue; // 变长语义的字符串区分度低且占空间，不维护摘要
+      }
+      cols_.push_back(col);
+      zone_size_ += col.len;
+    }
+    valid_.clear();
+    mins_.clear();
+    maxs_.clear();
+  }
+
+  bool enabled() const {
+    std::shared_lock<std::shared_mutex> lock(latch_);
+    return !cols_.empty();
+  }
+
+  /* 记录rec被写入页面page_no，扩大该页面的摘要范围 */
+  void add(int page_no, const char *rec) {
+    std::unique_lock<std::shared_mutex> lock(latch_);
+    if (cols_.empty()) {
+      return;
+    }
+    ensure_page(page_no);
+    char *mins = mins_.data() + (size_t)page_no * zone_size_;
+    char *maxs = maxs_.data() + (size_t)page_no * zone_size_;
+    int off = 0;
+    for (auto &col : cols_) {
+      const char *val = rec + col.offset;
+      if (!valid_[page_no] || compare(val, mins + off, col) < 0) {
+        memcpy(mins + off, val, col.len);
+      }
+      if (!valid_[page_no] || compare(val, maxs + off, col) > 0) {
+        memcpy(maxs + off, val, col.len);
+      }
+      off += col.len;
+    }
+    valid_[page_no] = true;
+  }
+
+  /* 页面page_no中已经没有记录 */
+  void reset(int page_no) {
+    std::unique_lock<std::shared_mutex> lock(latch_);
+    if (page_no < (int)valid_.size()) {
+      valid_[page_no] = false;
+    }
+  }
+
+  /* 判断页面page_no中是否可能存在满足全部conds的记录 */
+  bool may_match(int page_no, const std::vector<RmZoneCond> &conds) const {
+    if (conds.empty()) {
+      return true;
+    }
+    std::shared_lock<std::shared_mutex> lock(latch_);
+    if (cols_.empty()) {
+      return true;
+    }
+    if (page_no >= (int)valid_.size() || !valid_[page_no]) {
+      return false;
+    }
+    const char *mins = mins_.data() + (size_t)page_no * zone_size_;
+    const char *maxs = maxs_.data() + (size_t)page_no * zone_size_;
+    for (auto &cond : conds) {
+      int zone_off;
+      int col_no = find_col(cond.offset, &zone_off);
+      if (col_no < 0) {
+        continue;
+      }
+      auto &col = cols_[col_no];
+      int cmp_min = compare(cond.val.data(), mins + zone_off, col); // val与页面最小值比较
+      int cmp_max = compare(cond.val.data(), maxs + zone_off, col); // val与页面最大值比较
+      bool ok = true;
+      switch (cond.op) {
+      case ZONE_EQ: ok = cmp_min >= 0 && cmp_max <= 0; break;
+      case ZONE_LT: ok = cmp_min > 0; break;  // 存在 x < val 需要 min < val
+      case ZONE_LE: ok = cmp_min >= 0; break;
+      case ZONE_GT: ok = cmp_max < 0; break;  // 存在 x > val 需要 max > val
+      case ZONE_GE: ok = cmp_max <= 0; break;
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
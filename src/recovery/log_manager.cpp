@@ -46,7 +46,8 @@ lsn_t LogManager::add_log_to_buffer(LogRecord *log_record) {
     } else if(log_record->GetLogRecordType()==LogType::INSERT || log_record->GetLogRecordType()==LogType::DELETE) {
         // std::cout<<"in add_log_to_buffer: the type is "<<LogTypeStr[log_record->GetLogRecordType()]<<"\n";
         log_record->serialize_i_and_d(buf);
-    }else if(log_record->GetLogRecordType()==LogType::INSERT_ENTRY||log_record->GetLogRecordType()==LogType::DELETE_ENTRY){
+    }else if(log_record->GetLogRecordType()==LogType::INSERT_ENTRY||log_record->GetLogRecordType()==LogType::DELETE_ENTRY
+             ||log_record->GetLogRecordType()==LogType::CREATE_INDEX){
         log_record->serialize_index(buf);
     }
     else if (log_record->GetLogRecordType()!=LogType::INVALID){
@@ -76,8 +77,11 @@ lsn_t LogManager::add_log_to_buffer(LogRecord* log_record) {
         log_record->serialize_upd(buf);
     } else if(log_record->GetLogRecordType()==LogType::INSERT || log_record->GetLogRecordType()==LogType::DELETE) {
         log_record->serialize_i_and_d(buf);
-    }else if(log_record->GetLogRecordType()==LogType::INSERT_ENTRY||log_record->GetLogRecordType()==LogType::DELETE_ENTRY){
+    }else if(log_record->GetLogRecordType()==LogType::INSERT_ENTRY||log_record->GetLogRecordType()==LogType::DELETE_ENTRY
+             ||log_record->GetLogRecordType()==LogType::CREATE_INDEX){
         log_record->serialize_index(buf);
+    } else if(log_record->GetLogRecordType()==LogType::UPDATE_DELTA) {
+        log_record->serialize_upd_delta(buf);
     }
     disk_manager_->write_log(buf, size);
     delete [] buf;
@@ -138,8 +142,11 @@ int LogManager::lastLsn(char* buff, int size) {
             rec.deserialize_upd(ptr);
         } else if(rec.GetLogRecordType()==LogType::INSERT||rec.GetLogRecordType()==LogType::DELETE){
             rec.deserialize_i_and_d(ptr);
-        } else if(rec.GetLogRecordType()==LogType::INSERT_ENTRY || rec.GetLogRecordType()==LogType::DELETE_ENTRY) {
+        } else if(rec.GetLogRecordType()==LogType::INSERT_ENTRY || rec.GetLogRecordType()==LogType::DELETE_ENTRY
+                   || rec.GetLogRecordType()==LogType::CREATE_INDEX) {
             rec.deserialize_index(ptr);
+        } else if(rec.GetLogRecordType()==LogType::UPDATE_DELTA) {
+            rec.deserialize_upd_delta(ptr);
         }
         else {
             break;
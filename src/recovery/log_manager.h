@@ -29,7 +29,9 @@ enum LogType: int {
     COMMIT,
     ABORT,
     INSERT_ENTRY,
-    DELETE_ENTRY
+    DELETE_ENTRY,
+    UPDATE_DELTA,
+    CREATE_INDEX        // 批量构建索引，只记录索引名，重做时从表中重新构建
 };
 static std::string LogTypeStr[] = {
         "INVALID",
@@ -40,7 +42,9 @@ static std::string LogTypeStr[] = {
     "COMMIT",
         "ABORT",
         "INSERT_ENTRY",
-        "DELETE_ENTRY"
+        "DELETE_ENTRY",
+        "UPDATE_DELTA",
+        "CREATE_INDEX"
 
 };
 
@@ -63,6 +67,9 @@ public:
     // case3: for index
     char* key_= nullptr;
     size_t key_size_;
+    // case4: for update delta, 依次存放每个区间的 | offset | len | old bytes | new bytes |
+    char* delta_ = nullptr;
+    size_t delta_size_;
 
 
     inline uint32_t GetSize() const { return log_tot_len_; }
@@ -277,9 +284,74 @@ public:
         key_ = new char[key_size_];
         memcpy(key_, src + offset, key_size_);
     }
+    // update delta, 只记录新旧记录中发生变化的字节区间
+    LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogType log_record_type, const Rid& rid, const char* old_value,
+              const char* new_value, const std::vector<RmDelta>& deltas, const std::string& table_name) {
+        delta_size_ = 0;
+        for (auto& delta : deltas) {
+            delta_size_ += sizeof(int) * 2 + delta.len * 2;
+        }
+        log_tot_len_ = LOG_HEADER_SIZE + sizeof(Rid) + 2 * sizeof(size_t) + table_name.size() + delta_size_;
+        lsn_ = INVALID_LSN;
+        log_tid_ = txn_id;
+        prev_lsn_ = prev_lsn;
+        log_type_ = log_record_type;
+        rid_ = rid;
+        table_name_size_ = table_name.length();
+        table_name_ = new char[table_name_size_];
+        memcpy(table_name_, table_name.c_str(), table_name_size_);
+        delta_ = new char[delta_size_];
+        char* dst = delta_;
+        for (auto& delta : deltas) {
+            memcpy(dst, &delta.offset, sizeof(int));
+            memcpy(dst + sizeof(int), &delta.len, sizeof(int));
+            dst += sizeof(int) * 2;
+            memcpy(dst, old_value + delta.offset, delta.len);
+            memcpy(dst + delta.len, new_value + delta.offset, delta.len);
+            dst += delta.len * 2;
+        }
+    }
+    void serialize_upd_delta(char* dest) const {
+        int offset = OFFSET_LOG_DATA;
+        memcpy(dest + offset, &rid_, sizeof(Rid));
+        offset += sizeof(Rid);
+        memcpy(dest + offset, &table_name_size_, sizeof(size_t));
+        offset += sizeof(size_t);
+        memcpy(dest + offset, table_name_, table_name_size_);
+        offset += table_name_size_;
+        memcpy(dest + offset, &delta_size_, sizeof(size_t));
+        offset += sizeof(size_t);
+        memcpy(dest + offset, delta_, delta_size_);
+    }
+    void deserialize_upd_delta(const char* src) {
+        int offset = OFFSET_LOG_DATA;
+        rid_ = *reinterpret_cast<const Rid*>(src + offset);
+        offset += sizeof(Rid);
+        table_name_size_ = *reinterpret_cast<const size_t*>(src + offset);
+        offset += sizeof(size_t);
+        table_name_ = new char[table_name_size_];
+        memcpy(table_name_, src + offset, table_name_size_);
+        offset += table_name_size_;
+        delta_size_ = *reinterpret_cast<const size_t*>(src + offset);
+        offset += sizeof(size_t);
+        delta_ = new char[delta_size_];
+        memcpy(delta_, src + offset, delta_size_);
+    }
+    // 把增量写回记录rec，redo时写入新值，undo时写入旧值
+    void apply_delta(char* rec, bool redo) const {
+        const char* src = delta_;
+        while (src < delta_ + delta_size_) {
+            int offset = *reinterpret_cast<const int*>(src);
+            int len = *reinterpret_cast<const int*>(src + sizeof(int));
+            src += sizeof(int) * 2;
+            memcpy(rec + offset, redo ? src + len : src, len);
+            src += len * 2;
+        }
+    }
     ~LogRecord(){
         delete [] table_name_;
         delete [] key_;
+        delete [] delta_;
     }
 
 
@@ -109,6 +109,17 @@ void RecoveryManager::redo() {
                         delete [] val;
                     // buffer_pool_manager_->unpin_page(cur_pageId, true);
                 }
+                else if(log.GetLogRecordType() == LogType::UPDATE_DELTA)
+                {
+                    log.deserialize_upd_delta(log_buffer_.buffer_+buffer_offset_);
+                    Rid cur_rid = log.GetRid();
+                    std::string file_name(log.get_table_name(), log.get_table_name_size());
+                    auto fh = sm_manager_->fhs_[file_name].get();
+                    Context* context = nullptr;
+                    auto rec = fh->get_record(cur_rid, context);
+                    log.apply_delta(rec->data, true);
+                    fh->update_record(cur_rid, rec->data, context);
+                }
                 else if(log.GetLogRecordType()==LogType::INSERT_ENTRY){
                     // std::cout<<"7\n";
 //                    std::cout<<"in undo,log type="<<LogTypeStr[log.GetLogRecordType()]<<"\n";
@@ -137,9 +148,14 @@ void RecoveryManager::redo() {
                     auto ih=sm_manager_->ihs_.at(index_name).get();
 //                    std::cout<<"delete key: id="<<*(int*)(key)<<", u="<<*(float*)(key+7)<<"\n";
 //                    std::cout<<"delete key: id="<<*(int*)(key)<<"\n";
-                    ih->delete_entry(key, nullptr);
+                    ih->delete_entry(key, log.GetRid(), nullptr);
                     delete[] key;
                 }
+                else if(log.GetLogRecordType()==LogType::CREATE_INDEX){
+                    log.deserialize_index(log_buffer_.buffer_+buffer_offset_);
+                    std::string index_name{log.get_index_name(),log.get_index_name_size()};
+                    sm_manager_->rebuild_index(index_name);
+                }
 
 
             } // idu全部处理完了
@@ -243,6 +259,17 @@ void RecoveryManager::undo() {
                     fh->update_record(cur_rid,val,context);
                     delete [] val;
             }
+            else if(log.GetLogRecordType() == LogType::UPDATE_DELTA)
+            {
+                log.deserialize_upd_delta(buffer);
+                Rid cur_rid = log.GetRid();
+                std::string file_name(log.get_table_name(), log.get_table_name_size());
+                auto fh = sm_manager_->fhs_[file_name].get();
+                Context* context = nullptr;
+                auto rec = fh->get_record(cur_rid, context);
+                log.apply_delta(rec->data, false);
+                fh->update_record(cur_rid, rec->data, context);
+            }
             else if(log.GetLogRecordType()==LogType::INSERT_ENTRY){
                 // undo insert entry
 //                std::cout<<"in undo,log type="<<LogTypeStr[log.GetLogRecordType()]<<"\n";
@@ -255,7 +282,7 @@ void RecoveryManager::undo() {
                 std::string index_name{ix_name,log.get_index_name_size()};
                 auto ih=sm_manager_->ihs_.at(index_name).get();
 //                std::cout<<"key="<<*(int*)key<<"\n";
-                ih->delete_entry(key, nullptr);
+                ih->delete_entry(key, cur_rid, nullptr);
                 delete[] key;
             }
             else if(log.GetLogRecordType()==LogType::DELETE_ENTRY){
@@ -270,6 +297,7 @@ void RecoveryManager::undo() {
                 ih->insert_entry(key,cur_rid, nullptr);
                 delete[] key;
             }
+            // CREATE_INDEX是DDL，不回滚
             if(log.prev_lsn_==INVALID_LSN) break;
             offset_ = lsn_mapping_[log.prev_lsn_];
             disk_manager_->read_log(buffer, PAGE_SIZE, offset_);
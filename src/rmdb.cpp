@@ -68,6 +68,22 @@ void SetTransaction(txn_id_t *txn_id, Context *context) {
     }
 }
 
+// 语句执行失败：把异常信息返回给客户端，并在output.txt中记录failure
+void report_failure(RMDBError &e, char *data_send, int *offset) {
+    std::cerr << e.what() << std::endl;
+    memcpy(data_send, e.what(), e.get_msg_len());
+    data_send[e.get_msg_len()] = '\n';
+    data_send[e.get_msg_len() + 1] = '\0';
+    *offset = e.get_msg_len() + 1;
+    if(!close_output) {
+        // 将报错信息写入output.txt
+        std::fstream outfile;
+        outfile.open("output.txt", std::ios::out | std::ios::app);
+        outfile << "failure\n";
+        outfile.close();
+    }
+}
+
 void *client_handler(void *sock_fd) {
     int fd = *((int *)sock_fd);
     pthread_mutex_unlock(sockfd_mutex);
@@ -114,6 +130,14 @@ void *client_handler(void *sock_fd) {
             write(fd, data_send, offset + 1);
             continue;
         }
+        // 设置本会话查询的并行度，超过EXEC_MAX_DOP时按EXEC_MAX_DOP处理
+        int dop;
+        if (sscanf(data_recv, "set parallel_degree %d", &dop) == 1) {
+            context->dop_ = std::max(1, std::min(dop, EXEC_MAX_DOP));
+            data_send[0] = '\0';
+            write(fd, data_send, offset + 1);
+            continue;
+        }
 
         std::string data_recv_str(data_recv);
 
@@ -126,56 +150,20 @@ void *client_handler(void *sock_fd) {
             std::getline(ss, segment, ' ');  // 获取 "into"
             std::getline(ss, tablename, ' ');  // 获取表名
             tablename = tablename.substr(0, tablename.size() - 1);
-            TabMeta& tab = sm_manager->db_.get_table(tablename);
-            auto fh_ = sm_manager->fhs_[tablename].get();
-            std::ifstream file(filename.c_str());
-            if (!file) {
-                throw FileNotFoundError(filename);
+            memset(data_send, '\0', BUFFER_LENGTH);
+            offset = 0;
+            try {
+                // 导入失败时表中不会留下任何导入的记录
+                sm_manager->load_table(filename, tablename, context);
+            } catch (RMDBError &e) {
+                report_failure(e, data_send, &offset);
             }
-            std::string line;
-            std::getline(file,line); // 把空的第一行消灭
-            while (std::getline(file, line)) {
-                RmRecord rec(fh_->get_file_hdr().record_size);
-                std::vector<std::string> elements;
-                std::string item;
-                std::stringstream ss1(line);
-                while (std::getline(ss1, item, ',')) {
-                    elements.push_back(item);
-                }
-                int i = 0;
-                for (const auto& col: tab.cols) {
-                    auto raw = std::make_shared<RmRecord>(col.len);
-                    if (col.type==TYPE_STRING||col.type==TYPE_DATETIME) {
-                        memset(raw->data, 0, col.len);
-                        memcpy(raw->data, elements[i].c_str(), elements[i].size());
-                    } else if (col.type==TYPE_INT) {
-                        int num = std::stoi(elements[i]);
-                        *(int*)raw->data = num;
-                    } else {
-                        float flt = std::stof(elements[i]);
-                        *(float*)raw->data = flt;
-                    }
-                    memcpy(rec.data + col.offset, raw->data, col.len);
-                    i++;
-                }
-                auto rid_ = fh_->insert_record(rec.data, nullptr);
-                if(!tab.indexes.empty()) {
-                    auto index = tab.indexes[0];
-                    char key[index.col_tot_len];
-                    memset(key, 0, sizeof(key));
-                    int off = 0;
-                    for (size_t i_ = 0; i_ < index.col_num; ++i_) {
-                        memcpy(key + off, rec.data + index.cols[i_].offset, index.cols[i_].len);
-                        off += index.cols[i_].len;
-                    }
-                    auto ih = sm_manager->ihs_.at(
-                            sm_manager->get_ix_manager()->get_index_name(tablename, index.cols)).get();
-                    ih->insert_entry(key, rid_, nullptr);
-                }
+            if(close_output) {
+                data_send[0] = '\0';
+            }
+            if (write(fd, data_send, offset + 1) == -1) {
+                break;
             }
-            data_send[0] = '\0';
-            write(fd, data_send, offset + 1);
-            file.close();
             continue;
         }
 
@@ -228,18 +216,7 @@ void *client_handler(void *sock_fd) {
                     }
                 } catch (RMDBError &e) {
                     // 遇到异常，需要打印failure到output.txt文件中，并发异常信息返回给客户端
-                    std::cerr << e.what() << std::endl;
-                    memcpy(data_send, e.what(), e.get_msg_len());
-                    data_send[e.get_msg_len()] = '\n';
-                    data_send[e.get_msg_len() + 1] = '\0';
-                    offset = e.get_msg_len() + 1;
-                    if(!close_output) {
-                        // 将报错信息写入output.txt
-                        std::fstream outfile;
-                        outfile.open("output.txt", std::ios::out | std::ios::app);
-                        outfile << "failure\n";
-                        outfile.close();
-                    }
+                    report_failure(e, data_send, &offset);
                 }
             }
         }
@@ -11,6 +11,8 @@ See the Mulan PSL v2 for more details. */
 #include "storage/disk_manager.h"
 
 #include <assert.h>   // for assert
+#include <dirent.h>   // for opendir
+#include <errno.h>    // for errno
 #include <string.h>   // for memset
 #include <sys/stat.h> // for stat
 #include <unistd.h>   // for lseek
@@ -133,11 +135,12 @@ void DiskManager::create_file(const std::string &path) {
   // 调用open()函数，使用O_CREAT模式
   // 注意不能重复创建相同文件
   // 检查文件是否已经存在，如果存在，直接返回，不重复创建
-  if (is_file(path)) {
-    throw FileExistsError(path);
-  }
-  int fd = open(path.c_str(), O_CREAT | O_WRONLY, 0666);
+  // O_EXCL保证检查与创建是原子的，并发创建同名文件时只有一个能成功
+  int fd = open(path.c_str(), O_CREAT | O_EXCL | O_WRONLY, 0666);
   if (fd == -1) {
+    if (errno == EEXIST) {
+      throw FileExistsError(path);
+    }
     throw UnixError();
   }
    close(fd);
@@ -176,6 +179,7 @@ int DiskManager::open_file(const std::string &path) {
       throw FileNotFoundError(path);
   }
 
+  std::lock_guard<std::mutex> lock(latch_);
   if (path2fd_.count(path)) {
     return path2fd_[path];
   }
@@ -204,6 +208,7 @@ void DiskManager::close_file(int fd) {
   // 调用close()函数
   // 注意不能关闭未打开的文件，并且需要更新文件打开列表
   // 检查文件是否已经打开，如果没有打开，抛出异常
+  std::unique_lock<std::mutex> lock(latch_);
   if (fd2path_.count(fd) == 0) {
     throw FileNotOpenError(fd);
   }
@@ -211,6 +216,7 @@ void DiskManager::close_file(int fd) {
     std::string path = fd2path_[fd];
     fd2path_.erase(fd);
     path2fd_.erase(path);
+    lock.unlock();
     // 关闭文件
     int ret = close(fd);
   // 如果文件关闭失败，抛出异常
@@ -221,6 +227,17 @@ void DiskManager::close_file(int fd) {
 
 }
 
+/**
+ * @description: 把文件截断为num_pages个页面，之后的页面被丢弃
+ * @param {int} fd 打开的文件的文件句柄
+ * @param {int} num_pages 保留的页面个数
+ */
+void DiskManager::truncate_file(int fd, int num_pages) {
+  if (ftruncate(fd, static_cast<off_t>(num_pages) * PAGE_SIZE) != 0) {
+    throw UnixError();
+  }
+}
+
 /**
  * @description: 获得文件的大小
  * @return {int} 文件的大小
@@ -238,6 +255,7 @@ int DiskManager::get_file_size(const std::string &file_name) {
  * @param {int} fd 文件句柄
  */
 std::string DiskManager::get_file_name(int fd) {
+  std::lock_guard<std::mutex> lock(latch_);
   if (!fd2path_.count(fd)) {
     throw FileNotOpenError(fd);
   }
@@ -250,10 +268,47 @@ std::string DiskManager::get_file_name(int fd) {
  * @param {string} &file_name 文件名
  */
 int DiskManager::get_file_fd(const std::string &file_name) {
-  if (!path2fd_.count(file_name)) {
-    return open_file(file_name);
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    auto it = path2fd_.find(file_name);
+    if (it != path2fd_.end()) {
+      return it->second;
+    }
+  }
+  return open_file(file_name);
+}
+
+/**
+ * @description: 在当前数据库目录下创建一个新的临时文件，用于算子写出中间结果
+ * 文件名包含进程号和序号，同一进程和不同进程创建的临时文件互不冲突；万一重名（例如进程号被复用）时换下一个序号
+ * @return {string} 临时文件的路径，使用完后由调用者删除
+ */
+std::string DiskManager::create_spill_file() {
+  while (true) {
+    std::string path = SPILL_FILE_PREFIX + std::to_string(getpid()) + "_" + std::to_string(spill_seq_++) + ".tmp";
+    try {
+      create_file(path);
+      return path;
+    } catch (FileExistsError &) {
+    }
+  }
+}
+
+/**
+ * @description: 删除当前数据库目录下遗留的临时文件（上次运行异常退出时没有删除的），在打开数据库时调用
+ */
+void DiskManager::destroy_spill_files() {
+  DIR *dir = opendir(".");
+  if (dir == nullptr) {
+    throw UnixError();
+  }
+  while (struct dirent *entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name.compare(0, SPILL_FILE_PREFIX.size(), SPILL_FILE_PREFIX) == 0 && is_file(name)) {
+      unlink(name.c_str());
+    }
   }
-  return path2fd_[file_name];
+  closedir(dir);
 }
 
 /**
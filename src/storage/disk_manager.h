@@ -17,6 +17,7 @@ See the Mulan PSL v2 for more details. */
 #include <atomic>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -58,6 +59,13 @@ class DiskManager {
 
     void close_file(int fd);
 
+    void truncate_file(int fd, int num_pages);
+
+    /*临时文件操作*/
+    std::string create_spill_file();
+
+    void destroy_spill_files();
+
     int get_file_size(const std::string &file_name);
 
     std::string get_file_name(int fd);
@@ -86,13 +94,18 @@ class DiskManager {
      * @param {int} fd 文件对应的句柄
      */
     page_id_t get_fd2pageno(int fd) { return fd2pageno_[fd]; }
-    std::string get_fd2path(int fd) { return fd2path_[fd];}
+    std::string get_fd2path(int fd) {
+        std::lock_guard<std::mutex> lock(latch_);
+        return fd2path_[fd];
+    }
     static constexpr int MAX_FD = 8192;
 
    private:
     // 文件打开列表，用于记录文件是否被打开
     std::unordered_map<std::string, int> path2fd_;  //<Page文件磁盘路径,Page fd>哈希表
     std::unordered_map<int, std::string> fd2path_;  //<Page fd,Page文件磁盘路径>哈希表
+    std::mutex latch_;                              // 保护文件打开列表，查询中的排序等算子会并发地打开和关闭临时文件
+    std::atomic<uint64_t> spill_seq_{0};            // 临时文件名的序号
 
     int log_fd_ = -1;                             // WAL日志文件的文件句柄，默认为-1，代表未打开日志文件
     std::atomic<page_id_t> fd2pageno_[MAX_FD]{};  // 文件中已经分配的页面个数，初始值为0
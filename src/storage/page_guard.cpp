@@ -14,12 +14,14 @@ PageGuard::PageGuard(PageGuard &&that) {
     this->page_ = that.page_;
     this->bpm_ = that.bpm_;
     this->is_dirty_ = that.is_dirty_;
+    this->latch_mode_ = that.latch_mode_;
     that.page_ = nullptr;
     that.bpm_ = nullptr;
     that.is_dirty_ = false;
-
+    that.latch_mode_ = LatchMode::NONE;
 }
 void PageGuard::Drop() {
+    Unlatch();
     if (bpm_ != nullptr) {
         bpm_->unpin_page(get_page_id(), is_dirty_);
     }
@@ -30,15 +32,37 @@ void PageGuard::Drop() {
 
 auto PageGuard::operator=(PageGuard &&that)  -> PageGuard & {
     if (this != &that) {
+        Drop();
         this->page_ = that.page_;
         this->bpm_ = that.bpm_;
         this->is_dirty_ = that.is_dirty_;
+        this->latch_mode_ = that.latch_mode_;
         that.page_ = nullptr;
         that.bpm_ = nullptr;
         that.is_dirty_ = false;
+        that.latch_mode_ = LatchMode::NONE;
     }
     return *this;
 }
 
+void PageGuard::Latch(LatchMode mode) {
+    Unlatch();
+    if (mode == LatchMode::READ) {
+        page_->RLatch();
+    } else if (mode == LatchMode::WRITE) {
+        page_->WLatch();
+    }
+    latch_mode_ = mode;
+}
+
+void PageGuard::Unlatch() {
+    if (latch_mode_ == LatchMode::READ) {
+        page_->RUnlatch();
+    } else if (latch_mode_ == LatchMode::WRITE) {
+        page_->WUnlatch();
+    }
+    latch_mode_ = LatchMode::NONE;
+}
+
 PageGuard::~PageGuard() { Drop(); };  // NOLINT
 
@@ -8,6 +8,9 @@
 #include "storage/page.h"
 class BufferPoolManager;
 
+/* 页面读写锁的持有状态 */
+enum class LatchMode { NONE = 0, READ, WRITE };
+
 class PageGuard {
 public:
     PageGuard() = default;
@@ -42,8 +45,18 @@ public:
     }
 
     inline void set_dirty(bool is_dirty){page_->set_dirty(is_dirty);}
+
+    /**
+     * @brief 对页面加读锁或写锁，Drop时先解锁再unpin
+     */
+    void Latch(LatchMode mode);
+
+    void Unlatch();
+
+    LatchMode latch_mode() const { return latch_mode_; }
 private:
     BufferPoolManager *bpm_{nullptr};
     Page *page_{nullptr};
     bool is_dirty_{false};
+    LatchMode latch_mode_{LatchMode::NONE};
 };
\ No newline at end of file
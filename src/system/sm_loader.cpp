@@ -0,0 +1,278 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <exception>
+#include <thread>
+
+#include "sm_manager.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/* 在服务端日志中输出导入一个阶段的行数、耗时和吞吐 */
+void report(const std::string &tab_name, const std::string &phase, size_t rows, double ms) {
+    double rate = ms > 0 ? rows / ms * 1000 : 0;
+    std::cout << "load " << tab_name << ": " << phase << " " << rows << " rows in " << (int64_t)ms << " ms ("
+              << (int64_t)rate << " rows/s)" << std::endl;
+}
+
+/* 导入过程中对一个索引所做的修改，出错时据此撤销 */
+struct IndexUndo {
+    IxIndexHandle *ih;
+    int key_len;
+    std::vector<char> keys;         // 导入的每一行在索引中的key
+    std::vector<size_t> inserted;   // 逐条插入成功的行
+    bool built = false;             // 索引原来为空，已经开始批量构建
+};
+
+/* 撤销已经写入的索引项和记录 */
+void undo_load(RmFileHandle *fh, const std::vector<Rid> &rids, std::vector<IndexUndo> &undo) {
+    for (auto &entry : undo) {
+        if (entry.built) {
+            entry.ih->reset();
+            continue;
+        }
+        for (auto i : entry.inserted) {
+            entry.ih->delete_entry(entry.keys.data() + i * entry.key_len, rids[i], nullptr);
+        }
+    }
+    for (auto &rid : rids) {
+        fh->delete_record(rid, nullptr);
+    }
+}
+
+/* 把CSV中的一个字段按列类型写入记录缓冲区 */
+void parse_field(const char *begin, const char *end, const ColMeta &col, char *dst) {
+    std::from_chars_result res{};
+    switch (col.type) {
+        case TYPE_INT:
+            res = std::from_chars(begin, end, *(int *)dst);
+            break;
+        case TYPE_BIGINT:
+            res = std::from_chars(begin, end, *(std::int64_t *)dst);
+            break;
+        case TYPE_FLOAT:
+            res = std::from_chars(begin, end, *(float *)dst);
+            break;
+        case TYPE_STRING:
+        case TYPE_DATETIME: {
+            size_t len = end - begin;
+            if (len > (size_t)col.len) {
+                throw StringOverflowError();
+            }
+            memset(dst, 0, col.len);
+            memcpy(dst, begin, len);
+            return;
+        }
+    }
+    if (res.ec != std::errc()) {
+        throw InternalError("Invalid value for column " + col.name + ": " + std::string(begin, end));
+    }
+}
+
+/* 解析[begin, end)中的完整行，每行生成一条记录追加到rows */
+void parse_chunk(const char *begin, const char *end, const std::vector<ColMeta> &cols, int record_size,
+                 std::vector<char> &rows) {
+    const char *p = begin;
+    while (p < end) {
+        const char *eol = static_cast<const char *>(memchr(p, '\n', end - p));
+        if (eol == nullptr) {
+            eol = end;
+        }
+        const char *line_end = (eol > p && eol[-1] == '\r') ? eol - 1 : eol;
+        if (line_end > p) {
+            size_t off = rows.size();
+            rows.resize(off + record_size);
+            const char *field = p;
+            for (size_t i = 0; i < cols.size(); i++) {
+                if (field > line_end) {
+                    throw InvalidValueCountError();
+                }
+                const char *comma = static_cast<const char *>(memchr(field, ',', line_end - field));
+                const char *field_end = comma == nullptr ? line_end : comma;
+                parse_field(field, field_end, cols[i], rows.data() + off + cols[i].offset);
+                field = field_end + 1;
+            }
+        }
+        p = eol + 1;
+    }
+}
+
+}  // namespace
+
+/**
+ * @description: 批量导入CSV文件：mmap整个文件后按行边界切分给多个线程解析，
+ * 解析结果直接构建成数据页追加到表文件末尾，最后对表上的每个索引排序key：
+ * 索引为空时自底向上批量构建，否则按排好序的key依次插入
+ * @param {string&} file_name CSV文件名，第一行为表头
+ * @param {string&} tab_name 表名
+ * @param {Context*} context
+ */
+void SmManager::load_table(const std::string& file_name, const std::string& tab_name, Context* context) {
+    TabMeta &tab = db_.get_table(tab_name);
+    RmFileHandle *fh = fhs_.at(tab_name).get();
+    int record_size = fh->get_file_hdr().record_size;
+
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw FileNotFoundError(file_name);
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        throw UnixError();
+    }
+    size_t size = st.st_size;
+    if (size == 0) {
+        close(fd);
+        return;
+    }
+    void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        throw UnixError();
+    }
+    madvise(addr, size, MADV_SEQUENTIAL);
+    const char *data = static_cast<const char *>(addr);
+    const char *end = data + size;
+
+    auto start = Clock::now();
+    // 跳过表头
+    const char *body = static_cast<const char *>(memchr(data, '\n', size));
+    body = body == nullptr ? end : body + 1;
+
+    // 按行边界切分
+    size_t num_threads = std::max(1u, std::min<unsigned>(LOAD_THREAD_NUM, std::thread::hardware_concurrency()));
+    num_threads = std::min<size_t>(num_threads, (end - body) / LOAD_CHUNK_MIN_SIZE + 1);
+    std::vector<const char *> bounds{body};
+    for (size_t i = 1; i < num_threads; i++) {
+        const char *p = body + (end - body) * i / num_threads;
+        p = std::max(p, bounds.back());
+        const char *eol = static_cast<const char *>(memchr(p, '\n', end - p));
+        bounds.push_back(eol == nullptr ? end : eol + 1);
+    }
+    bounds.push_back(end);
+
+    std::vector<std::vector<char>> chunks(num_threads);
+    std::vector<std::exception_ptr> errors(num_threads);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < num_threads; i++) {
+        workers.emplace_back([&, i]() {
+            try {
+                parse_chunk(bounds[i], bounds[i + 1], tab.cols, record_size, chunks[i]);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    munmap(addr, size);
+    for (auto &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    size_t num_rows = 0;
+    for (auto &chunk : chunks) {
+        num_rows += chunk.size() / record_size;
+    }
+    report(tab_name, "parsed", num_rows, elapsed_ms(start));
+
+    // 解析出错时表还没有被修改；之后写数据页或建索引出错时撤销已经写入的记录和索引项，导入要么全部完成，要么不留痕迹
+    std::vector<Rid> rids;
+    rids.reserve(num_rows);
+    std::vector<IndexUndo> undo;
+    undo.reserve(tab.indexes.size());
+    try {
+        // 按文件中的顺序构建数据页
+        start = Clock::now();
+        for (auto &chunk : chunks) {
+            fh->append_records(chunk.data(), chunk.size() / record_size, rids);
+        }
+        report(tab_name, "stored", num_rows, elapsed_ms(start));
+
+        // 依次构建表上的所有索引
+        for (auto &index : tab.indexes) {
+            start = Clock::now();
+            auto index_name = ix_manager_->get_index_name(tab_name, index.cols);
+            // 索引中存放的key，非唯一索引在key后追加rid
+            auto ih = ihs_.at(index_name).get();
+            int key_len = ih->get_ix_file_hdr()->col_tot_len_;
+            undo.push_back(IndexUndo{ih, key_len, std::vector<char>((size_t)num_rows * key_len), {}});
+            auto &entry = undo.back();
+            char *keys = entry.keys.data();
+            size_t row = 0;
+            for (auto &chunk : chunks) {
+                for (size_t off = 0; off < chunk.size(); off += record_size, row++) {
+                    char *key = keys + row * key_len;
+                    ix_make_key(index.cols, chunk.data() + off, key);
+                    ih->entry_key(key, rids[row], key);
+                }
+            }
+            if (index.type == INDEX_HASH) {
+                // 哈希索引不需要排序，按文件中的顺序插入，key相同时保留靠前的行
+                for (size_t i = 0; i < num_rows; i++) {
+                    if (ih->insert_entry(keys + i * key_len, rids[i], nullptr)) {
+                        entry.inserted.push_back(i);
+                    }
+                }
+                report(tab_name, "indexed " + index_name, num_rows, elapsed_ms(start));
+                continue;
+            }
+            std::vector<size_t> order(num_rows);
+            for (size_t i = 0; i < num_rows; i++) {
+                order[i] = i;
+            }
+            // key相同时保留文件中靠前的行，与逐条插入的结果一致
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                return memcmp(keys + a * key_len, keys + b * key_len, key_len) < 0;
+            });
+            if (ih->empty()) {
+                entry.built = true;
+                IxBulkBuilder builder(ih);
+                const char *last_key = nullptr;
+                for (auto i : order) {
+                    const char *key = keys + i * key_len;
+                    if (last_key != nullptr && memcmp(key, last_key, key_len) == 0) {
+                        continue;
+                    }
+                    builder.append(key, rids[i]);
+                    last_key = key;
+                }
+                builder.finish();
+            } else {
+                for (auto i : order) {
+                    if (ih->insert_entry(keys + i * key_len, rids[i], nullptr)) {
+                        entry.inserted.push_back(i);
+                    }
+                }
+            }
+            report(tab_name, "indexed " + index_name, num_rows, elapsed_ms(start));
+        }
+    } catch (...) {
+        undo_load(fh, rids, undo);
+        throw;
+    }
+}
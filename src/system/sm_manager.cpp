@@ -19,6 +19,15 @@ See the Mulan PSL v2 for more details. */
 #include "record/rm.h"
 #include "record_printer.h"
 
+// 表中需要维护zone map的字段
+static std::vector<RmZoneCol> zone_cols(const TabMeta &tab) {
+    std::vector<RmZoneCol> cols;
+    for (auto &col : tab.cols) {
+        cols.push_back({.type = col.type, .offset = col.offset, .len = col.len});
+    }
+    return cols;
+}
+
 bool isFileEmpty(const std::string &file_name) {
     std::ifstream file(file_name,std::ios::ate|std::ios::binary);
     return file.tellg()==0;
@@ -96,6 +105,7 @@ void SmManager::open_db(const std::string& db_name) {
     if (chdir(db_name.c_str()) < 0) {
         throw UnixError();
     }
+    disk_manager_->destroy_spill_files();
     // 打开数据库的元数据文件，并读取元数据
     std::ifstream ifs(DB_META_NAME);
     if (!ifs) {
@@ -111,22 +121,31 @@ void SmManager::open_db(const std::string& db_name) {
         if (!fh) {
             throw UnixError();
         }
+        fh->build_zone_map(zone_cols(entry.second));
         // 保存记录文件句柄
         fhs_[tab_name] = std::move(fh);
 //        std::cout<<"index num="<<entry.second.indexes.size()<<"\n";
         std::vector<std::vector<std::string>>col_names;
-        for(auto index:entry.second.indexes) {
+        std::vector<IndexMeta> indexes = entry.second.indexes;
+        for(auto index:indexes) {
             std::vector<std::string> col_name;
             for(const auto& col:index.cols){
                 col_name.emplace_back(col.name);
             }
             col_names.push_back(col_name);
         }
-        for(auto& col_name:col_names){
-            std::unique_ptr<IxIndexHandle> ih = ix_manager_->open_index(tab_name,col_name);
-            ihs_[ix_manager_->get_index_name(tab_name,col_name)] = std::move(ih);
+        for(size_t i = 0; i < col_names.size(); i++){
+            auto& col_name = col_names[i];
+            if (ix_manager_->is_current(tab_name, col_name)) {
+                std::unique_ptr<IxIndexHandle> ih = ix_manager_->open_index(tab_name,col_name);
+                ihs_[ix_manager_->get_index_name(tab_name,col_name)] = std::move(ih);
                 drop_index(tab_name, col_name, nullptr);
-                create_index(tab_name, col_name, nullptr);
+            } else {
+                // 旧版本的索引文件不能打开，直接删除，下面从表中的记录重新构建
+                ix_manager_->destroy_index(tab_name, col_name);
+                entry.second.indexes.erase(entry.second.get_index_meta(col_name));
+            }
+            create_index(tab_name, col_name, nullptr, IX_BULK_FILL_FACTOR, indexes[i].type, indexes[i].unique);
         }
     }
 //    std::cout<<"fhs.size="<<fhs_.size()<<"\n";
@@ -234,8 +253,10 @@ void SmManager::desc_table(const std::string& tab_name, Context* context) {
  * @param {string&} tab_name 表的名称
  * @param {vector<ColDef>&} col_defs 表的字段
  * @param {Context*} context 
+ * @param {RmLayout} layout 表数据文件的页面布局，分析型的宽表可以使用PAX
  */
-void SmManager::create_table(const std::string& tab_name, const std::vector<ColDef>& col_defs, Context* context) {
+void SmManager::create_table(const std::string& tab_name, const std::vector<ColDef>& col_defs, Context* context,
+                             RmLayout layout) {
 
     if (db_.is_table(tab_name)) {
         throw TableExistsError(tab_name);
@@ -255,11 +276,15 @@ void SmManager::create_table(const std::string& tab_name, const std::vector<ColD
         tab.cols.push_back(col);
     }
     // Create & open record file
-    int record_size = curr_offset;  // record_size就是col meta所占的大小（表的元数据也是以记录的形式进行存储的）
-    rm_manager_->create_file(tab_name, record_size);
+    std::vector<int> col_lens;  // record_size就是各字段长度之和，PAX布局还需要知道每个字段的长度
+    for (auto &col : tab.cols) {
+        col_lens.push_back(col.len);
+    }
+    rm_manager_->create_file(tab_name, col_lens, layout);
     db_.tabs_[tab_name] = tab;
     // fhs_[tab_name] = rm_manager_->open_file(tab_name);
     fhs_.emplace(tab_name, rm_manager_->open_file(tab_name));
+    fhs_.at(tab_name)->build_zone_map(zone_cols(tab));
 
     flush_meta();
 }
@@ -302,66 +327,118 @@ void SmManager::drop_table(const std::string& tab_name, Context* context) {
  * @param {string&} tab_name 表的名称
  * @param {vector<string>&} col_names 索引包含的字段名称
  * @param {Context*} context
+ * @param {double} fill_factor B+树批量构建时结点的填充率
+ * @param {IndexType} index_type B+树或哈希索引，哈希索引只用于等值查找
+ * @param {bool} unique 唯一索引构建时删除key重复的记录，非唯一索引保留所有记录
  */
 
 
-void SmManager::create_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context) {
+void SmManager::create_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context,
+                             double fill_factor, IndexType index_type, bool unique) {
     TabMeta &tab = db_.get_table(tab_name);
     if(ix_manager_->exists(tab_name,col_names)){
         throw IndexExistsError(tab_name,col_names);
     }
-    // 构造key的必要信息
-    size_t key_size=0;
     std::vector<ColMeta> index_cols;
     for(const auto& col_name : col_names){
-        auto col=tab.get_col(col_name);
-        index_cols.push_back(*col);
-        key_size+= col->len;
+        index_cols.push_back(*tab.get_col(col_name));
     }
-    auto index_meta = ix_manager_->create_index(tab_name,index_cols);
+    auto index_meta = ix_manager_->create_index(tab_name,index_cols,index_type,unique);
     tab.indexes.push_back(index_meta);
     auto ih = ix_manager_->open_index(tab_name,col_names);
     assert(ih!= nullptr);
+    // key重复的记录被删除，只保留扫描顺序中的第一条
     std::vector<Rid> rid_to_delete;
+    build_index(tab_name, index_meta, ih.get(), fill_factor, &rid_to_delete);
     auto fh = fhs_.at(tab_name).get();
-    for (RmScan rm_scan(fh); !rm_scan.is_end(); rm_scan.next()) {
-        auto rec = fh->get_record(rm_scan.rid(),context);
-        char key[key_size+1];
-        memset(key,0,sizeof(key));
-        int offset=0;
-        for(auto& col_name:col_names) {
-            auto col = tab.get_col(col_name);
-            memcpy(key+offset, rec->data+col->offset, col->len);
-            offset+=col->len;
-        }
-        // if not unique, remove record
-        bool unique=ih->insert_entry(key, rm_scan.rid(), nullptr);
-        if(!unique){
-            RmRecord rmRecord(rec->size,rec->data);
-            rid_to_delete.emplace_back(rm_scan.rid());
+    for (auto & rid:rid_to_delete){
+        if (context != nullptr) {
+            auto rec = fh->get_record(rid, context);
             auto deleteLogRecord = LogRecord(context->txn_->get_transaction_id(),context->txn_->get_prev_lsn(),
-                                             LogType::DELETE,rm_scan.rid(),rmRecord,tab_name);
+                                             LogType::DELETE,rid,*rec,tab_name);
             context->txn_->set_prev_lsn(context->log_mgr_->add_log_to_buffer(&deleteLogRecord));
-        } else{
-            auto txn= context->txn_;
-            LogRecord index_insert_log_record=LogRecord(txn->get_transaction_id(),txn->get_prev_lsn(),LogType::INSERT_ENTRY,
-                                                        rm_scan.rid(),key,key_size,ix_manager_->get_index_name(tab_name,col_names));
-            txn->set_prev_lsn(context->log_mgr_->add_log_to_buffer(&index_insert_log_record));
         }
+        fh->delete_record(rid,context);
     }
-    // remove record
-    for (auto & rid:rid_to_delete){
-        fhs_[tab_name]->delete_record(rid,context);
+    // 整个索引的构建只记录一条逻辑日志，重做时从表中的记录重新构建
+    auto index_name = ix_manager_->get_index_name(tab_name, col_names);
+    if (context != nullptr) {
+        char no_key[1] = {0};
+        auto txn = context->txn_;
+        LogRecord create_log_record(txn->get_transaction_id(), txn->get_prev_lsn(), LogType::CREATE_INDEX,
+                                    Rid{-1, -1}, no_key, 0, index_name);
+        txn->set_prev_lsn(context->log_mgr_->add_log_to_buffer(&create_log_record));
     }
     // Store index handle
-    auto index_name = ix_manager_->get_index_name(tab_name, col_names);
     assert(ihs_.count(index_name) == 0);
     ihs_[index_name] = std::move(ih);
     flush_meta();
-//    std::cout<<"create index "<<index_name<<" successfully\n";
-    ihs_.at(index_name).get();
+}
 
+/**
+ * @description: 扫描表中的记录生成(key, rid)，排序（数据量大时使用外部排序）后自底向上构建索引；哈希索引逐条插入
+ * @param {string&} tab_name 表名称
+ * @param {IndexMeta&} index 索引的元数据
+ * @param {IxIndexHandle*} ih 要构建的索引，原有内容被丢弃
+ * @param {double} fill_factor 结点的填充率
+ * @param {vector<Rid>*} duplicates 传出参数，key与扫描顺序中之前的记录重复的记录，这些记录不进入索引
+ */
+void SmManager::build_index(const std::string& tab_name, const IndexMeta& index, IxIndexHandle* ih,
+                            double fill_factor, std::vector<Rid>* duplicates) {
+    auto fh = fhs_.at(tab_name).get();
+    if (index.type == INDEX_HASH) {
+        // 哈希索引无序，按扫描顺序逐条插入，key已存在时插入失败
+        ih->get_hash_table()->reset();
+        std::vector<char> key(index.col_tot_len);
+        for (RmScan rm_scan(fh); !rm_scan.is_end(); rm_scan.next()) {
+            auto rec = fh->get_record(rm_scan.rid(), nullptr);
+            ix_make_key(index.cols, rec->data, key.data());
+            if (!ih->insert_entry(key.data(), rm_scan.rid(), nullptr) && duplicates != nullptr) {
+                duplicates->push_back(rm_scan.rid());
+            }
+        }
+        return;
+    }
+    // 重做CREATE_INDEX时索引文件中已有结点，先清空，否则原有的页面不会再被使用
+    ih->reset();
+    IxBulkSorter sorter(ih->get_ix_file_hdr());
+    // 非唯一索引的key后追加了rid，不会重复
+    int entry_len = ih->get_ix_file_hdr()->col_tot_len_;
+    std::vector<char> key(index.col_tot_len);
+    char entry[IX_MAX_COL_LEN];
+    for (RmScan rm_scan(fh); !rm_scan.is_end(); rm_scan.next()) {
+        auto rec = fh->get_record(rm_scan.rid(), nullptr);
+        ix_make_key(index.cols, rec->data, key.data());
+        sorter.add(ih->entry_key(key.data(), rm_scan.rid(), entry), rm_scan.rid());
+    }
+    IxBulkBuilder builder(ih, fill_factor);
+    std::vector<char> last_key;
+    sorter.finish([&](const char* cur_key, const Rid& rid) {
+        if (!last_key.empty() && memcmp(cur_key, last_key.data(), entry_len) == 0) {
+            if (duplicates != nullptr) {
+                duplicates->push_back(rid);
+            }
+            return;
+        }
+        last_key.assign(cur_key, cur_key + entry_len);
+        builder.append(cur_key, rid);
+    });
+    builder.finish();
+}
 
+/**
+ * @description: 从表中的记录重新构建索引，用于重做CREATE_INDEX日志
+ * @param {string&} index_name 索引文件名，索引已经不存在时什么都不做
+ */
+void SmManager::rebuild_index(const std::string& index_name) {
+    for (auto& entry : db_.tabs_) {
+        for (auto& index : entry.second.indexes) {
+            if (ix_manager_->get_index_name(entry.first, index.cols) == index_name && ihs_.count(index_name)) {
+                build_index(entry.first, index, ihs_.at(index_name).get(), IX_BULK_FILL_FACTOR, nullptr);
+                return;
+            }
+        }
+    }
 }
 
 
@@ -384,8 +461,12 @@ void SmManager::show_index(const std::string&tab_name, Context*context){
         }
         index_name = index_name.substr(0,index_name.size()-1);
         index_name+=")";
-        // 输出
-        outfile<<"| "<<tab_name<<" | unique | "<<index_name<<" |\n";
+        // 输出，默认的唯一B+树索引保持原来的格式，哈希索引在后面注明hash
+        std::string kind = index.unique ? "unique" : "non-unique";
+        if (index.type == INDEX_HASH) {
+            kind += " hash";
+        }
+        outfile<<"| "<<tab_name<<" | "<<kind<<" | "<<index_name<<" |\n";
     }
     outfile.close();
 }
@@ -54,6 +54,8 @@ class SmManager {
 
     IxManager* get_ix_manager() { return ix_manager_; }  
 
+    DiskManager* get_disk_manager() { return disk_manager_; }
+
     bool is_dir(const std::string& db_name);
 
     void create_db(const std::string& db_name);
@@ -70,11 +72,16 @@ class SmManager {
 
     void desc_table(const std::string& tab_name, Context* context);
 
-    void create_table(const std::string& tab_name, const std::vector<ColDef>& col_defs, Context* context);
+    void create_table(const std::string& tab_name, const std::vector<ColDef>& col_defs, Context* context,
+                      RmLayout layout = RM_LAYOUT_ROW);
 
     void drop_table(const std::string& tab_name, Context* context);
 
-    void create_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context);
+    void create_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context,
+                      double fill_factor = IX_BULK_FILL_FACTOR, IndexType index_type = INDEX_BTREE,
+                      bool unique = true);
+
+    void rebuild_index(const std::string& index_name);
 
     void drop_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context);
 
@@ -83,4 +90,9 @@ class SmManager {
     void desc_index(const std::string& tab_name, Context* context);
     void show_index(const std::string&tab_name,Context*context);
 
+    void load_table(const std::string& file_name, const std::string& tab_name, Context* context);
+
+   private:
+    void build_index(const std::string& tab_name, const IndexMeta& index, IxIndexHandle* ih, double fill_factor,
+                     std::vector<Rid>* duplicates);
 };
\ No newline at end of file
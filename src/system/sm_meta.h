@@ -60,15 +60,21 @@ struct ColMeta {
     }
 };
 
+constexpr char INDEX_META_MARK = '@';      // 索引元数据中版本号的前缀；旧版本这里是第一个字段的表名，不会以它开头
+constexpr int INDEX_META_VERSION = 1;       // 索引元数据格式的版本，IndexMeta的字段变化时加一
+
 /* 索引元数据 */
 struct IndexMeta {
     std::string tab_name;           // 索引所属表名称
     int col_tot_len;                // 索引字段长度总和
     int col_num;                    // 索引字段数量
     std::vector<ColMeta> cols;      // 索引包含的字段
+    IndexType type = INDEX_BTREE;   // 索引的组织方式
+    bool unique = true;             // 唯一索引不允许重复的key
 
     friend std::ostream &operator<<(std::ostream &os, const IndexMeta &index) {
-        os << index.tab_name << " " << index.col_tot_len << " " << index.col_num;
+        os << index.tab_name << " " << index.col_tot_len << " " << index.col_num << " " << INDEX_META_MARK
+           << INDEX_META_VERSION << " " << index.type << " " << index.unique;
         for(auto& col: index.cols) {
             os << "\n" << col;
         }
@@ -76,7 +82,22 @@ struct IndexMeta {
     }
 
     friend std::istream &operator>>(std::istream &is, IndexMeta &index) {
-        is >> index.tab_name >> index.col_tot_len >> index.col_num;
+        is >> index.tab_name >> index.col_tot_len >> index.col_num >> std::ws;
+        if (is.peek() == INDEX_META_MARK) {
+            int version, type;
+            is.get();
+            is >> version;
+            if (version != INDEX_META_VERSION) {
+                throw InternalError("Unsupported index meta version " + std::to_string(version) + ", expected " +
+                                    std::to_string(INDEX_META_VERSION));
+            }
+            is >> type >> index.unique;
+            index.type = static_cast<IndexType>(type);
+        } else {
+            // 旧版本的元数据没有版本号，其中的索引都是唯一的B+树索引
+            index.type = INDEX_BTREE;
+            index.unique = true;
+        }
         for(int i = 0; i < index.col_num; ++i) {
             ColMeta col;
             is >> col;
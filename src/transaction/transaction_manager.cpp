@@ -114,12 +114,12 @@ void TransactionManager::abort(std::shared_ptr<Transaction> txn, LogManager *log
         } else if (write_type == WType::UPDATE_TUPLE){
             // std::cout<<"update abort\n";
             auto rec = record->GetRecord();
-            auto new_rec = record->GetNewRec();
             if(!fh->is_record(rid)) {
                 continue;
             }
-            // auto old_rec = fh->get_record(rid,context_);//得到文件中旧的记录
-            LogRecord updateLogRecord(txn->get_transaction_id(),txn->get_prev_lsn(),LogType::UPDATE, rid, new_rec, rec, tab_name_);
+            // 写集合只保存更新前的记录，当前记录从文件中读出
+            auto cur_rec = fh->get_record(rid,context_);
+            LogRecord updateLogRecord(txn->get_transaction_id(),txn->get_prev_lsn(),LogType::UPDATE, rid, *cur_rec, rec, tab_name_);
             txn->set_prev_lsn(log_manager->add_log_to_buffer(&updateLogRecord));
             fh->update_record(rid,rec.data,context_);
 //             std::cout<<"update abort end\n";
@@ -157,7 +157,7 @@ void TransactionManager::abort(std::shared_ptr<Transaction> txn, LogManager *log
                                                         LogType::DELETE_ENTRY,item->GetRid(),orig_key,index.col_tot_len,
                                                         sm_manager_->get_ix_manager()->get_index_name(tab_name_, index.cols));
             txn->set_prev_lsn(log_manager->add_log_to_buffer(&index_delete_log_record));
-            ih->delete_entry(orig_key,txn);
+            ih->delete_entry(orig_key,item->GetRid(),txn);
             delete [] orig_key;
             // std::cout<<"in index abort insert: the lsn is "<<index_delete_log_record.GetLSN()<<"\n";
             // std::cout<<"index insert abort end\n";
@@ -48,8 +48,6 @@ class WriteRecord {
     WriteRecord(WType wtype, const std::string &tab_name, const Rid &rid, const RmRecord &record)
         : wtype_(wtype), tab_name_(tab_name), rid_(rid), record_(record) {}
 
-    WriteRecord(WType wtype, const std::string &tab_name, const Rid &rid, const RmRecord &record, const RmRecord &new_rec)
-            : wtype_(wtype), tab_name_(tab_name), rid_(rid), record_(record), new_rec_(new_rec) {}
     ~WriteRecord() = default;
 
     inline RmRecord &GetRecord() {
@@ -60,10 +58,6 @@ class WriteRecord {
          */
         return record_; }
 
-    inline RmRecord &GetNewRec() {
-        return new_rec_;
-    }
-
     inline Rid &GetRid() { return rid_; }
 
     inline WType &GetWriteType() { return wtype_; }
@@ -82,7 +76,6 @@ private:
     std::string tab_name_;
     Rid rid_;
     RmRecord record_;
-    RmRecord new_rec_;
 };
 class IndexWriteRecord {
 public:
@@ -12,26 +12,41 @@ See the Mulan PSL v2 for more details. */
 
 #define private public
 
+#include "index/ix.h"
 #include "record/rm.h"
 #include "storage/buffer_pool_manager.h"
 
 #undef private
 
+#include <dirent.h>
+
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <memory>
 #include <random>
 #include <set>
+#include <sstream>
 #include <string>
 #include <thread> // NOLINT
 #include <unordered_map>
 #include <vector>
 
+#include "analyze/analyze.h"
+#include "index/ix_key.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/planner.h"
+#include "portal.h"
+#include "recovery/log_recovery.h"
 #include "replacer/lru_replacer.h"
 #include "storage/disk_manager.h"
 #include "gtest/gtest.h"
@@ -725,3 +740,1717 @@ file_handle = rm_manager->open_file(filename);
   rm_manager->close_file(file_handle.get());
   rm_manager->destroy_file(filename);
 }
+
+// PAX布局：每个字段集中存放在自己的minipage中，read_slot/write_slot/write_range按字段拆分和拼接
+TEST(RecordManagerTest, PaxSlotTest) {
+  RmFileHdr file_hdr{};
+  std::vector<int> col_lens = {4, 8, 16, 4};
+  file_hdr.layout = RM_LAYOUT_PAX;
+  file_hdr.num_cols = col_lens.size();
+  for (size_t i = 0; i < col_lens.size(); i++) {
+    file_hdr.col_lens[i] = col_lens[i];
+    file_hdr.col_offs[i] = file_hdr.record_size;
+    file_hdr.record_size += col_lens[i];
+  }
+  file_hdr.num_records_per_page = 64;
+  file_hdr.bitmap_size = 64 / BITMAP_WIDTH;
+  Page page;
+  RmPageHandle page_handle(&file_hdr, &page);
+
+  std::vector<std::string> records;
+  char buf[RM_MAX_RECORD_SIZE];
+  for (int slot_no = 0; slot_no < file_hdr.num_records_per_page; slot_no++) {
+    rand_buf(file_hdr.record_size, buf);
+    page_handle.write_slot(slot_no, buf);
+    records.emplace_back(buf, file_hdr.record_size);
+  }
+  for (int slot_no = 0; slot_no < file_hdr.num_records_per_page; slot_no++) {
+    // 第i个字段位于第i段minipage中下标为slot_no的位置
+    for (int i = 0; i < file_hdr.num_cols; i++) {
+      EXPECT_EQ(page_handle.slots + file_hdr.col_offs[i] * file_hdr.num_records_per_page,
+                page_handle.get_minipage(i));
+      EXPECT_EQ(0, memcmp(page_handle.get_minipage(i) + slot_no * col_lens[i],
+                          records[slot_no].data() + file_hdr.col_offs[i], col_lens[i]));
+    }
+    page_handle.read_slot(slot_no, buf);
+    EXPECT_EQ(0, memcmp(buf, records[slot_no].data(), file_hdr.record_size));
+  }
+
+  // 只覆盖跨越第1、2个字段的一段区间，其余字节不变
+  int slot_no = 7;
+  int offset = 6;
+  int len = 12;
+  rand_buf(file_hdr.record_size, buf);
+  page_handle.write_range(slot_no, buf, offset, len);
+  memcpy(&records[slot_no][offset], buf + offset, len);
+  for (int i = 0; i < file_hdr.num_records_per_page; i++) {
+    page_handle.read_slot(i, buf);
+    EXPECT_EQ(0, memcmp(buf, records[i].data(), file_hdr.record_size));
+  }
+}
+
+TEST(RecordManagerTest, PaxLayoutTest) {
+  srand((unsigned)time(nullptr));
+
+  auto disk_manager = std::make_unique<DiskManager>();
+  auto buffer_pool_manager =
+      std::make_unique<BufferPoolManager>(MAX_PAGES, disk_manager.get());
+  auto rm_manager = std::make_unique<RmManager>(disk_manager.get(),
+                                                buffer_pool_manager.get());
+
+  std::string filename = "pax.txt";
+  std::string row_filename = "row.txt";
+  for (auto &name : {filename, row_filename}) {
+    if (disk_manager->is_file(name)) {
+      disk_manager->destroy_file(name);
+    }
+  }
+  std::vector<int> col_lens = {4, 8, 20, 4};
+  int record_size = 36;
+
+  // 两种布局每页的slot数相同
+  rm_manager->create_file(row_filename, record_size);
+  rm_manager->create_file(filename, col_lens, RM_LAYOUT_PAX);
+  auto row_handle = rm_manager->open_file(row_filename);
+  auto file_handle = rm_manager->open_file(filename);
+  assert(!row_handle->is_pax());
+  assert(file_handle->is_pax());
+  assert(file_handle->file_hdr_.record_size == record_size);
+  assert(file_handle->file_hdr_.num_records_per_page ==
+         row_handle->file_hdr_.num_records_per_page);
+  assert(file_handle->file_hdr_.num_cols == (int)col_lens.size());
+  for (int i = 0, offset = 0; i < (int)col_lens.size(); i++) {
+    assert(file_handle->file_hdr_.col_lens[i] == col_lens[i]);
+    assert(file_handle->file_hdr_.col_offs[i] == offset);
+    offset += col_lens[i];
+  }
+  rm_manager->close_file(row_handle.get());
+  rm_manager->destroy_file(row_filename);
+
+  std::unordered_map<Rid, std::string, rid_hash_t, rid_equal_t> mock;
+  char write_buf[PAGE_SIZE];
+  for (int round = 0; round < 2000; round++) {
+    double insert_prob = 1. - mock.size() / 500.;
+    double dice = rand() * 1. / RAND_MAX;
+    if (mock.empty() || dice < insert_prob) {
+      rand_buf(record_size, write_buf);
+      Rid rid = file_handle->insert_record(write_buf, nullptr);
+      mock[rid] = std::string(write_buf, record_size);
+    } else {
+      auto it = mock.begin();
+      std::advance(it, rand() % mock.size());
+      auto rid = it->first;
+      if (rand() % 2 == 0) {
+        rand_buf(record_size, write_buf);
+        file_handle->update_record(rid, write_buf, nullptr);
+        mock[rid] = std::string(write_buf, record_size);
+      } else {
+        file_handle->delete_record(rid, nullptr);
+        mock.erase(rid);
+      }
+    }
+    // 重新打开文件后布局信息仍然保留
+    if (round % 500 == 0) {
+      rm_manager->close_file(file_handle.get());
+      file_handle = rm_manager->open_file(filename);
+      assert(file_handle->is_pax());
+    }
+  }
+  check_equal(file_handle.get(), mock);
+
+  // 页面中按minipage存放：每条记录的第i个字段位于第i段minipage中
+  for (auto &entry : mock) {
+    const Rid &rid = entry.first;
+    RmPageHandle page_handle = file_handle->fetch_page_handle(rid.page_no);
+    for (int i = 0; i < (int)col_lens.size(); i++) {
+      assert(memcmp(page_handle.get_minipage(i) + rid.slot_no * col_lens[i],
+                    entry.second.data() + file_handle->file_hdr_.col_offs[i],
+                    col_lens[i]) == 0);
+    }
+    buffer_pool_manager->unpin_page(PageId{file_handle->fd_, rid.page_no}, false);
+  }
+
+  rm_manager->close_file(file_handle.get());
+  rm_manager->destroy_file(filename);
+}
+
+// 没有magic的旧版本文件按行存布局打开，关闭时升级文件头；版本号不认识的文件拒绝打开
+TEST(RecordManagerTest, FileHdrVersionTest) {
+  auto disk_manager = std::make_unique<DiskManager>();
+  auto buffer_pool_manager =
+      std::make_unique<BufferPoolManager>(MAX_PAGES, disk_manager.get());
+  auto rm_manager = std::make_unique<RmManager>(disk_manager.get(),
+                                                buffer_pool_manager.get());
+  std::string filename = "legacy.txt";
+  if (disk_manager->is_file(filename)) {
+    disk_manager->destroy_file(filename);
+  }
+  int record_size = 40;
+  rm_manager->create_file(filename, record_size);
+  auto file_handle = rm_manager->open_file(filename);
+  assert(file_handle->file_hdr_.magic == RM_FILE_MAGIC);
+  assert(file_handle->file_hdr_.version == RM_FILE_VERSION);
+  std::unordered_map<Rid, std::string, rid_hash_t, rid_equal_t> mock;
+  char write_buf[PAGE_SIZE];
+  for (int i = 0; i < 300; i++) {
+    rand_buf(record_size, write_buf);
+    Rid rid = file_handle->insert_record(write_buf, nullptr);
+    mock[rid] = std::string(write_buf, record_size);
+  }
+  RmFileHdr hdr = file_handle->file_hdr_;
+  rm_manager->close_file(file_handle.get());
+
+  // 按旧格式改写第0页：只有前五个字段，其余为0
+  char page_buf[PAGE_SIZE] = {};
+  RmFileHdrV0 old_hdr = {hdr.record_size, hdr.num_pages, hdr.num_records_per_page,
+                         hdr.first_free_page_no, hdr.bitmap_size};
+  memcpy(page_buf, &old_hdr, sizeof(old_hdr));
+  int fd = disk_manager->open_file(filename);
+  disk_manager->write_page(fd, RM_FILE_HDR_PAGE, page_buf, PAGE_SIZE);
+  disk_manager->close_file(fd);
+
+  file_handle = rm_manager->open_file(filename);
+  assert(!file_handle->is_pax());
+  assert(file_handle->file_hdr_.num_pages == hdr.num_pages);
+  assert(file_handle->file_hdr_.num_records_per_page == hdr.num_records_per_page);
+  check_equal(file_handle.get(), mock);
+  rm_manager->close_file(file_handle.get());
+
+  fd = disk_manager->open_file(filename);
+  disk_manager->read_page(fd, RM_FILE_HDR_PAGE, (char *)&hdr, sizeof(hdr));
+  assert(hdr.magic == RM_FILE_MAGIC);
+  assert(hdr.version == RM_FILE_VERSION);
+  hdr.version = RM_FILE_VERSION + 1;
+  disk_manager->write_page(fd, RM_FILE_HDR_PAGE, (char *)&hdr, sizeof(hdr));
+  disk_manager->close_file(fd);
+  EXPECT_THROW(rm_manager->open_file(filename), InternalError);
+
+  rm_manager->destroy_file(filename);
+}
+
+// 索引元数据带版本号写出后原样读回；没有版本号的旧版本元数据按唯一的B+树索引读出，未知版本报错
+TEST(SmMetaTest, IndexMetaVersionTest) {
+  ColMeta col{.tab_name = "t", .name = "id", .type = TYPE_INT, .len = 4, .offset = 0, .index = false};
+  IndexMeta index{.tab_name = "t", .col_tot_len = 4, .col_num = 1, .cols = {col}};
+  index.type = INDEX_HASH;
+  index.unique = false;
+  std::stringstream ss;
+  ss << index << "\n" << index;
+  for (int i = 0; i < 2; i++) {
+    IndexMeta read;
+    ss >> read;
+    EXPECT_EQ(INDEX_HASH, read.type);
+    EXPECT_FALSE(read.unique);
+    EXPECT_EQ(1, read.col_num);
+    EXPECT_TRUE(read.cols == index.cols);
+  }
+
+  std::stringstream old_meta("t 4 1\nt id " + std::to_string(TYPE_INT) + " 4 0 0\n");
+  IndexMeta old_index;
+  old_index.type = INDEX_HASH;
+  old_index.unique = false;
+  old_meta >> old_index;
+  EXPECT_EQ(INDEX_BTREE, old_index.type);
+  EXPECT_TRUE(old_index.unique);
+  ASSERT_EQ(1u, old_index.cols.size());
+  EXPECT_EQ("id", old_index.cols[0].name);
+  EXPECT_EQ(4, old_index.cols[0].len);
+
+  std::stringstream new_meta("t 4 1 " + std::string(1, INDEX_META_MARK) + std::to_string(INDEX_META_VERSION + 1) +
+                             " 0 1\nt id 0 4 0 0\n");
+  IndexMeta new_index;
+  EXPECT_THROW(new_meta >> new_index, InternalError);
+}
+
+static std::vector<char> zone_int(int val) {
+  std::vector<char> buf(sizeof(int));
+  memcpy(buf.data(), &val, sizeof(int));
+  return buf;
+}
+
+TEST(ZoneMapTest, SimpleTest) {
+  // 记录布局：int a | float b | char(8) c | bigint d
+  RmZoneMap zone_map;
+  zone_map.init({{TYPE_STRING, 8, 8}});
+  EXPECT_FALSE(zone_map.enabled());
+  zone_map.init({{TYPE_INT, 0, 4}, {TYPE_FLOAT, 4, 4}, {TYPE_STRING, 8, 8}, {TYPE_BIGINT, 16, 8}});
+  EXPECT_TRUE(zone_map.enabled());
+
+  auto make_rec = [](int a, float b, int64_t d) {
+    std::vector<char> rec(24, 'x');
+    memcpy(rec.data(), &a, sizeof(a));
+    memcpy(rec.data() + 4, &b, sizeof(b));
+    memcpy(rec.data() + 16, &d, sizeof(d));
+    return rec;
+  };
+  // 页面1：a in [-5, 10]，b in [-1.5, 2.5]，d in [100, 300]
+  zone_map.add(1, make_rec(10, -1.5f, 300).data());
+  zone_map.add(1, make_rec(-5, 2.5f, 100).data());
+  // 页面3：a in [20, 20]
+  zone_map.add(3, make_rec(20, 0.0f, -7).data());
+
+  auto cond = [](int offset, RmZoneOp op, std::vector<char> val) { return RmZoneCond{offset, op, std::move(val)}; };
+  auto float_val = [](float val) {
+    std::vector<char> buf(sizeof(float));
+    memcpy(buf.data(), &val, sizeof(float));
+    return buf;
+  };
+  auto bigint_val = [](int64_t val) {
+    std::vector<char> buf(sizeof(int64_t));
+    memcpy(buf.data(), &val, sizeof(int64_t));
+    return buf;
+  };
+
+  EXPECT_TRUE(zone_map.may_match(1, {}));
+  EXPECT_TRUE(zone_map.may_match(1, {cond(0, ZONE_EQ, zone_int(-5))}));
+  EXPECT_TRUE(zone_map.may_match(1, {cond(0, ZONE_EQ, zone_int(3))}));
+  EXPECT_FALSE(zone_map.may_match(1, {cond(0, ZONE_EQ, zone_int(11))}));
+  EXPECT_FALSE(zone_map.may_match(1, {cond(0, ZONE_LT, zone_int(-5))}));
+  EXPECT_TRUE(zone_map.may_match(1, {cond(0, ZONE_LE, zone_int(-5))}));
+  EXPECT_FALSE(zone_map.may_match(1, {cond(0, ZONE_GT, zone_int(10))}));
+  EXPECT_TRUE(zone_map.may_match(1, {cond(0, ZONE_GE, zone_int(10))}));
+  EXPECT_TRUE(zone_map.may_match(1, {cond(4, ZONE_LT, float_val(-1.0f))}));
+  EXPECT_FALSE(zone_map.may_match(1, {cond(4, ZONE_GT, float_val(2.5f))}));
+  EXPECT_FALSE(zone_map.may_match(1, {cond(16, ZONE_GT, bigint_val(300))}));
+  EXPECT_TRUE(zone_map.may_match(1, {cond(16, ZONE_GE, bigint_val(300))}));
+  // 各条件都可能满足才保留页面
+  EXPECT_FALSE(zone_map.may_match(1, {cond(0, ZONE_EQ, zone_int(3)), cond(16, ZONE_LT, bigint_val(100))}));
+  // 不维护摘要的字符串字段不参与裁剪
+  EXPECT_TRUE(zone_map.may_match(1, {cond(8, ZONE_EQ, std::vector<char>(8, 'a'))}));
+
+  EXPECT_TRUE(zone_map.may_match(3, {cond(0, ZONE_EQ, zone_int(20))}));
+  EXPECT_FALSE(zone_map.may_match(3, {cond(0, ZONE_LT, zone_int(20))}));
+  // 没有摘要的页面和被删空的页面中没有记录
+  EXPECT_FALSE(zone_map.may_match(2, {cond(0, ZONE_GE, zone_int(0))}));
+  EXPECT_FALSE(zone_map.may_match(100, {cond(0, ZONE_GE, zone_int(0))}));
+  zone_map.reset(3);
+  EXPECT_FALSE(zone_map.may_match(3, {cond(0, ZONE_EQ, zone_int(20))}));
+  zone_map.add(3, make_rec(50, 0.0f, 0).data());
+  EXPECT_FALSE(zone_map.may_match(3, {cond(0, ZONE_EQ, zone_int(20))}));
+  EXPECT_TRUE(zone_map.may_match(3, {cond(0, ZONE_EQ, zone_int(50))}));
+}
+
+// 带zone map的顺序扫描只跳过不可能满足条件的页面，满足条件的记录一条都不能漏
+TEST(ZoneMapTest, ScanTest) {
+  auto disk_manager = std::make_unique<DiskManager>();
+  auto buffer_pool_manager =
+      std::make_unique<BufferPoolManager>(MAX_PAGES, disk_manager.get());
+  auto rm_manager = std::make_unique<RmManager>(disk_manager.get(),
+                                                buffer_pool_manager.get());
+  std::string filename = "zone.txt";
+  if (disk_manager->is_file(filename)) {
+    disk_manager->destroy_file(filename);
+  }
+  int record_size = 64;
+  rm_manager->create_file(filename, record_size);
+  auto file_handle = rm_manager->open_file(filename);
+  file_handle->build_zone_map({{TYPE_INT, 0, 4}});
+
+  // 按插入顺序递增，各页面的范围互不重叠；删除不会缩小页面的范围
+  std::unordered_map<Rid, int, rid_hash_t, rid_equal_t> vals;
+  std::map<int, int> page_min;
+  char buf[PAGE_SIZE] = {};
+  for (int i = 0; i < 2000; i++) {
+    memcpy(buf, &i, sizeof(int));
+    Rid rid = file_handle->insert_record(buf, nullptr);
+    vals[rid] = i;
+    page_min.emplace(rid.page_no, i);
+  }
+  for (int i = 0; i < 200; i++) {
+    auto it = vals.begin();
+    std::advance(it, rand() % vals.size());
+    file_handle->delete_record(it->first, nullptr);
+    vals.erase(it);
+  }
+
+  for (int bound : {-1, 0, 777, 1999, 5000}) {
+    std::set<std::pair<int, int>> scanned;
+    std::set<int> pages;
+    for (RmScan scan(file_handle.get(), {RmZoneCond{0, ZONE_LE, zone_int(bound)}}); !scan.is_end(); scan.next()) {
+      scanned.insert({scan.rid().page_no, scan.rid().slot_no});
+      pages.insert(scan.rid().page_no);
+    }
+    std::set<int> expect_pages;
+    for (auto &entry : vals) {
+      bool in_scan = scanned.count({entry.first.page_no, entry.first.slot_no}) > 0;
+      if (entry.second <= bound) {
+        EXPECT_TRUE(in_scan);
+      }
+      if (page_min[entry.first.page_no] <= bound) {
+        expect_pages.insert(entry.first.page_no);
+      }
+    }
+    // 只扫描最小值不超过bound的非空页面，这些页面中的记录全部返回
+    EXPECT_EQ(expect_pages, pages);
+    size_t expect_rows = 0;
+    for (auto &entry : vals) {
+      expect_rows += pages.count(entry.first.page_no);
+    }
+    EXPECT_EQ(expect_rows, scanned.size());
+  }
+
+  rm_manager->close_file(file_handle.get());
+  rm_manager->destroy_file(filename);
+}
+
+
+// 编码后的key按字节比较的结果与原值的比较结果一致，并且可以解码回原值
+template <typename T>
+static void check_key_order(ColType type, const std::vector<T> &vals) {
+  for (size_t i = 0; i < vals.size(); i++) {
+    char key_i[sizeof(T)];
+    ix_encode_col(type, sizeof(T), (const char *)&vals[i], key_i);
+    T decoded;
+    ix_decode_col(type, sizeof(T), key_i, (char *)&decoded);
+    EXPECT_TRUE(decoded == vals[i]) << "type " << type << " value " << vals[i];
+    for (size_t j = 0; j < vals.size(); j++) {
+      char key_j[sizeof(T)];
+      ix_encode_col(type, sizeof(T), (const char *)&vals[j], key_j);
+      int cmp = memcmp(key_i, key_j, sizeof(T));
+      int expect = vals[i] < vals[j] ? -1 : (vals[j] < vals[i] ? 1 : 0);
+      EXPECT_EQ(expect, (cmp > 0) - (cmp < 0)) << "type " << type << ": " << vals[i] << " vs " << vals[j];
+    }
+  }
+}
+
+static void check_str_key_order(ColType type, int len, const std::vector<std::string> &vals) {
+  for (auto &a : vals) {
+    std::vector<char> rec_a(len, 0);
+    memcpy(rec_a.data(), a.data(), std::min<size_t>(len, a.size()));
+    std::vector<char> key_a(len);
+    ix_encode_col(type, len, rec_a.data(), key_a.data());
+    std::vector<char> decoded(len);
+    ix_decode_col(type, len, key_a.data(), decoded.data());
+    EXPECT_EQ(rec_a, decoded);
+    for (auto &b : vals) {
+      std::vector<char> rec_b(len, 0);
+      memcpy(rec_b.data(), b.data(), std::min<size_t>(len, b.size()));
+      std::vector<char> key_b(len);
+      ix_encode_col(type, len, rec_b.data(), key_b.data());
+      int cmp = memcmp(key_a.data(), key_b.data(), len);
+      int expect = memcmp(rec_a.data(), rec_b.data(), len);
+      EXPECT_EQ((expect > 0) - (expect < 0), (cmp > 0) - (cmp < 0)) << a << " vs " << b;
+    }
+  }
+}
+
+TEST(IndexKeyTest, EncodeOrderTest) {
+  std::mt19937 rng(2023);
+  std::vector<int> ints = {INT32_MIN, INT32_MIN + 1, -65536, -256, -1, 0, 1, 255, 256, 65536, INT32_MAX - 1, INT32_MAX};
+  for (int i = 0; i < 50; i++) {
+    ints.push_back((int)rng());
+  }
+  check_key_order<int>(TYPE_INT, ints);
+
+  std::vector<int64_t> bigints = {INT64_MIN, INT64_MIN + 1, -(1LL << 32), -1, 0, 1, 1LL << 32, INT64_MAX - 1, INT64_MAX};
+  for (int i = 0; i < 50; i++) {
+    bigints.push_back((int64_t)(((uint64_t)rng() << 32) | rng()));
+  }
+  check_key_order<int64_t>(TYPE_BIGINT, bigints);
+
+  std::vector<float> floats = {-std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::max(), -1e10f,
+                               -2.5f, -1.0f, -std::numeric_limits<float>::denorm_min(), 0.0f,
+                               std::numeric_limits<float>::denorm_min(), std::numeric_limits<float>::min(), 0.5f,
+                               1.0f, 3.14159f, 1e10f, std::numeric_limits<float>::max(),
+                               std::numeric_limits<float>::infinity()};
+  std::uniform_real_distribution<float> dist(-1e6f, 1e6f);
+  for (int i = 0; i < 50; i++) {
+    floats.push_back(dist(rng));
+  }
+  check_key_order<float>(TYPE_FLOAT, floats);
+  // -0.0与0.0编码相同
+  float neg_zero = -0.0f, zero = 0.0f;
+  char key_neg[sizeof(float)], key_zero[sizeof(float)];
+  ix_encode_col(TYPE_FLOAT, sizeof(float), (const char *)&neg_zero, key_neg);
+  ix_encode_col(TYPE_FLOAT, sizeof(float), (const char *)&zero, key_zero);
+  EXPECT_EQ(0, memcmp(key_neg, key_zero, sizeof(float)));
+
+  // 定长字符串不足的部分补0
+  check_str_key_order(TYPE_STRING, 8, {"", "a", "ab", "abc", "abcdefgh", "b", "ba", "z", "\x7f", "\x80", "\xff"});
+  check_str_key_order(TYPE_DATETIME, 19, {"1000-01-01 00:00:00", "1999-12-31 23:59:59", "2000-01-01 00:00:00",
+                                          "2023-05-06 07:08:09", "2023-05-06 07:08:10", "9999-12-31 23:59:59"});
+
+  // 全0的key是每种类型的最小值
+  char zeros[8] = {};
+  int min_int = INT32_MIN;
+  int64_t min_bigint = INT64_MIN;
+  float min_float = -std::numeric_limits<float>::infinity();
+  char key[8];
+  ix_encode_col(TYPE_INT, sizeof(int), (const char *)&min_int, key);
+  EXPECT_LE(memcmp(zeros, key, sizeof(int)), 0);
+  ix_encode_col(TYPE_BIGINT, sizeof(int64_t), (const char *)&min_bigint, key);
+  EXPECT_LE(memcmp(zeros, key, sizeof(int64_t)), 0);
+  ix_encode_col(TYPE_FLOAT, sizeof(float), (const char *)&min_float, key);
+  EXPECT_LE(memcmp(zeros, key, sizeof(float)), 0);
+}
+
+/** 在新的缓冲池上建索引，int类型的key按ix_key.h编码，rid的page_no等于key
+ * 每个测试点结束时关闭并删除建过的索引 */
+class IndexTest : public ::testing::Test {
+public:
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+  std::unique_ptr<IxManager> ix_manager_;
+  std::vector<std::pair<std::vector<ColMeta>, std::unique_ptr<IxIndexHandle>>> indexes_;
+
+public:
+  void SetUp() override {
+    ::testing::Test::SetUp();
+    disk_manager_ = std::make_unique<DiskManager>();
+    buffer_pool_manager_ = std::make_unique<BufferPoolManager>(TEST_BUFFER_POOL_SIZE, disk_manager_.get());
+    ix_manager_ = std::make_unique<IxManager>(disk_manager_.get(), buffer_pool_manager_.get());
+  }
+
+  void TearDown() override {
+    for (auto &[cols, ih] : indexes_) {
+      ix_manager_->close_index(ih.get());
+      ix_manager_->destroy_index(cols[0].tab_name, cols);
+    }
+  }
+
+  IxIndexHandle *create_index(const std::string &tab_name, IndexType type = INDEX_BTREE, bool unique = true) {
+    std::vector<ColMeta> cols = {ColMeta{.tab_name = tab_name, .name = "k", .type = TYPE_INT,
+                                         .len = sizeof(int), .offset = 0, .index = true}};
+    if (ix_manager_->exists(tab_name, cols)) {
+      ix_manager_->destroy_index(tab_name, cols);
+    }
+    ix_manager_->create_index(tab_name, cols, type, unique);
+    indexes_.emplace_back(cols, ix_manager_->open_index(tab_name, cols));
+    return indexes_.back().second.get();
+  }
+
+  static int encode(int key) {
+    int enc;
+    ix_encode_col(TYPE_INT, sizeof(int), (char *)&key, (char *)&enc);
+    return enc;
+  }
+
+  static bool insert(IxIndexHandle *ih, int key) {
+    int enc = encode(key);
+    return ih->insert_entry((char *)&enc, Rid{key, 0}, nullptr);
+  }
+
+  static bool remove(IxIndexHandle *ih, int key) {
+    int enc = encode(key);
+    return ih->delete_entry((char *)&enc, Rid{key, 0}, nullptr);
+  }
+
+  // 按key排序后自底向上构建，非唯一索引的key后追加rid
+  static void bulk_build(IxIndexHandle *ih, const std::vector<Rid> &rids) {
+    IxBulkSorter sorter(ih->get_ix_file_hdr());
+    char entry[IX_MAX_COL_LEN];
+    for (auto &rid : rids) {
+      int enc = encode(rid.page_no);
+      sorter.add(ih->entry_key((char *)&enc, rid, entry), rid);
+    }
+    IxBulkBuilder builder(ih);
+    sorter.finish([&](const char *key, const Rid &rid) { builder.append(key, rid); });
+    builder.finish();
+  }
+
+  // 用IxScan遍历整个索引，返回每一项的key（含非唯一索引追加的rid）和rid
+  std::vector<std::pair<std::string, Rid>> scan(IxIndexHandle *ih, bool reverse = false) {
+    std::vector<std::pair<std::string, Rid>> entries;
+    char key[IX_MAX_COL_LEN];
+    int len = ih->get_ix_file_hdr()->col_tot_len_;
+    for (IxScan scan(ih, ih->leaf_begin(), ih->leaf_end(), buffer_pool_manager_.get(), reverse); !scan.is_end();
+         scan.next()) {
+      Rid rid = scan.entry(key);
+      entries.emplace_back(std::string(key, len), rid);
+    }
+    return entries;
+  }
+
+  // 按叶子链表从左到右遍历，持有当前叶子的读锁再锁下一个叶子，返回每一项rid的page_no
+  static std::vector<int> walk_leaves(IxIndexHandle *ih) {
+    std::vector<int> keys;
+    int low = encode(INT32_MIN);
+    Ctx ctx{Operation::FIND};
+    ih->find_leaf_page((char *)&low, ctx);
+    auto node = std::move(ctx.back());
+    ctx.Drop();
+    while (true) {
+      for (int i = 0; i < node->get_size(); i++) {
+        keys.push_back(node->get_rid(i)->page_no);
+      }
+      if (node->get_next_leaf() == IX_LEAF_HEADER_PAGE) {
+        break;
+      }
+      node = ih->fetch_node(node->get_next_leaf(), LatchMode::READ);
+    }
+    return keys;
+  }
+};
+
+// 并发删除引起借键与合并的同时反复从左到右遍历叶子：写者也按从左到右的顺序锁兄弟结点，不会死锁，
+// 遍历结果始终有序并包含所有未被删除的key
+TEST_F(IndexTest, ConcurrentDeleteScanTest) {
+  auto ih = create_index("concurrent");
+  const int num_keys = 50000;
+  const int num_deleters = 2;
+  for (int key = 0; key < num_keys; key++) {
+    ASSERT_TRUE(insert(ih, key));
+  }
+  std::atomic<int> deleters_done{0};
+  std::atomic<bool> scan_failed{false};
+  std::vector<std::thread> threads;
+  // 删除key % 4为0和1的key
+  for (int t = 0; t < num_deleters; t++) {
+    threads.emplace_back([&, t]() {
+      for (int key = t; key < num_keys; key += 4) {
+        if (!remove(ih, key)) {
+          scan_failed = true;
+        }
+      }
+      deleters_done++;
+    });
+  }
+  for (int t = 0; t < 2; t++) {
+    threads.emplace_back([&]() {
+      do {
+        auto keys = walk_leaves(ih);
+        size_t kept = 0;
+        for (size_t i = 0; i < keys.size(); i++) {
+          if (i > 0 && keys[i] <= keys[i - 1]) {
+            scan_failed = true;
+          }
+          kept += keys[i] % 4 >= num_deleters;
+        }
+        if (kept != num_keys / 2) {
+          scan_failed = true;
+        }
+      } while (deleters_done < num_deleters);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(scan_failed);
+  auto keys = walk_leaves(ih);
+  ASSERT_EQ(keys.size(), (size_t)num_keys / 2);
+  for (size_t i = 0; i < keys.size(); i++) {
+    EXPECT_EQ(keys[i], (int)(i / 2 * 4 + 2 + i % 2));
+  }
+}
+
+// 非唯一索引中同一个key的大量重复项分布在多个叶子中，等值查找沿叶子链表返回全部重复项
+TEST_F(IndexTest, DuplicateKeyTest) {
+  auto ih = create_index("duplicate", INDEX_BTREE, false);
+  const int num_dups = 3000;
+  for (int key = 0; key < 1000; key++) {
+    ASSERT_TRUE(insert(ih, key));
+  }
+  int dup = 500;
+  int enc = encode(dup);
+  std::set<int> slots = {0};
+  for (int i = 1; i < num_dups; i++) {
+    ASSERT_TRUE(ih->insert_entry((char *)&enc, Rid{dup, i}, nullptr));
+    slots.insert(i);
+  }
+  EXPECT_FALSE(ih->insert_entry((char *)&enc, Rid{dup, 1}, nullptr));
+  // 重复项跨越了多个叶子
+  ASSERT_NE(ih->leaf_begin((char *)&enc).page_no, ih->leaf_upper((char *)&enc).page_no);
+
+  std::vector<Rid> result;
+  ASSERT_TRUE(ih->get_value((char *)&enc, &result, nullptr));
+  ASSERT_EQ(result.size(), slots.size());
+  std::set<int> found;
+  for (auto &rid : result) {
+    EXPECT_EQ(rid.page_no, dup);
+    found.insert(rid.slot_no);
+  }
+  EXPECT_EQ(found, slots);
+
+  // 删除一半重复项，剩下的仍然全部找到；相邻的key不受影响
+  for (int i = 0; i < num_dups; i += 2) {
+    ASSERT_TRUE(ih->delete_entry((char *)&enc, Rid{dup, i}, nullptr));
+    slots.erase(i);
+  }
+  result.clear();
+  ASSERT_TRUE(ih->get_value((char *)&enc, &result, nullptr));
+  found.clear();
+  for (auto &rid : result) {
+    found.insert(rid.slot_no);
+  }
+  EXPECT_EQ(found, slots);
+  for (int key : {dup - 1, dup + 1}) {
+    enc = encode(key);
+    result.clear();
+    ASSERT_TRUE(ih->get_value((char *)&enc, &result, nullptr));
+    ASSERT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].page_no, key);
+  }
+}
+
+// 批量等值查找与逐个get_value的结果一致：包含不存在的key、跨越多个叶子的key和非唯一索引的重复项
+TEST_F(IndexTest, LookupManyTest) {
+  for (bool unique : {true, false}) {
+    auto ih = create_index(unique ? "lookup_unique" : "lookup_dup", INDEX_BTREE, unique);
+    // 只插入偶数key，非唯一索引中每个10的倍数再追加若干重复项
+    for (int key = 0; key < 20000; key += 2) {
+      ASSERT_TRUE(insert(ih, key));
+      if (!unique && key % 10 == 0) {
+        int enc = encode(key);
+        for (int i = 1; i <= key % 7; i++) {
+          ASSERT_TRUE(ih->insert_entry((char *)&enc, Rid{key, i}, nullptr));
+        }
+      }
+    }
+    std::mt19937 rng(unique);
+    std::set<int> query_set;
+    for (int i = 0; i < 3000; i++) {
+      query_set.insert((int)(rng() % 22000) - 1000);
+    }
+    std::vector<int> queries(query_set.begin(), query_set.end());
+    std::vector<int> encoded;
+    for (int key : queries) {
+      encoded.push_back(encode(key));
+    }
+    std::vector<std::vector<Rid>> many(queries.size());
+    ih->lookup_many((char *)encoded.data(), (int)encoded.size(),
+                    [&](int i, const Rid &rid) { many[i].push_back(rid); });
+    for (size_t i = 0; i < queries.size(); i++) {
+      std::vector<Rid> expected;
+      bool found = ih->get_value((char *)&encoded[i], &expected, nullptr);
+      EXPECT_EQ(found, !many[i].empty()) << "key " << queries[i];
+      EXPECT_EQ(many[i], expected) << "key " << queries[i];
+    }
+  }
+}
+
+// 插入引起分裂、删除引起合并后清空索引，再批量构建：之前分配过的页面全部被丢弃，新树的内容与构建的数据一致
+TEST_F(IndexTest, ResetTest) {
+  auto ih = create_index("reset");
+  std::vector<int> keys(20000);
+  for (int i = 0; i < (int)keys.size(); i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(1));
+  for (int key : keys) {
+    ASSERT_TRUE(insert(ih, key));
+  }
+  ASSERT_GT(ih->get_height(), 1);
+  for (int key : keys) {
+    if (key % 4 != 0) {
+      ASSERT_TRUE(remove(ih, key));
+    }
+  }
+  // 合并回收的页面使num_pages_小于已经分配过的页数
+  ASSERT_LT(ih->get_ix_file_hdr()->num_pages_, disk_manager_->get_fd2pageno(ih->fd_));
+
+  ih->reset();
+  EXPECT_TRUE(ih->empty());
+  EXPECT_EQ(ih->get_height(), 1);
+  EXPECT_TRUE(walk_leaves(ih).empty());
+  EXPECT_EQ(disk_manager_->get_fd2pageno(ih->fd_), IX_INIT_NUM_PAGES);
+
+  std::vector<Rid> rids;
+  for (int key = 0; key < 30000; key += 3) {
+    rids.push_back(Rid{key, 0});
+  }
+  bulk_build(ih, rids);
+  auto entries = walk_leaves(ih);
+  ASSERT_EQ(entries.size(), rids.size());
+  for (size_t i = 0; i < rids.size(); i++) {
+    EXPECT_EQ(entries[i], rids[i].page_no);
+  }
+  // 重建后的树可以继续插入和删除
+  for (int key = 1; key < 30000; key += 3) {
+    ASSERT_TRUE(insert(ih, key));
+  }
+  for (int key = 0; key < 30000; key += 3) {
+    ASSERT_TRUE(remove(ih, key));
+  }
+  entries = walk_leaves(ih);
+  ASSERT_EQ(entries.size(), 10000u);
+  for (size_t i = 0; i < entries.size(); i++) {
+    EXPECT_EQ(entries[i], (int)i * 3 + 1);
+  }
+
+  // 被pin住的页面不能丢弃
+  ASSERT_GE(ih->get_root_page_id(), IX_INIT_NUM_PAGES);
+  auto root = ih->fetch_node(ih->get_root_page_id());
+  EXPECT_THROW(ih->reset(), InternalError);
+}
+
+// 批量构建与逐条随机插入相同的数据，两棵树正向、反向遍历的结果相同
+TEST_F(IndexTest, BulkBuildTest) {
+  for (bool unique : {true, false}) {
+    auto row_ih = create_index(unique ? "row_unique" : "row_dup", INDEX_BTREE, unique);
+    auto bulk_ih = create_index(unique ? "bulk_unique" : "bulk_dup", INDEX_BTREE, unique);
+    std::vector<Rid> rids;
+    std::mt19937 rng(unique);
+    for (int key = 0; key < 40000; key += 1 + rng() % 3) {
+      rids.push_back(Rid{key, 0});
+      // 非唯一索引中部分key有多个重复项
+      for (int i = 1; !unique && i <= key % 5; i++) {
+        rids.push_back(Rid{key, i});
+      }
+    }
+    std::shuffle(rids.begin(), rids.end(), rng);
+    for (auto &rid : rids) {
+      int enc = encode(rid.page_no);
+      ASSERT_TRUE(row_ih->insert_entry((char *)&enc, rid, nullptr));
+    }
+    bulk_build(bulk_ih, rids);
+
+    auto row_entries = scan(row_ih);
+    EXPECT_EQ(row_entries.size(), rids.size());
+    EXPECT_EQ(row_entries, scan(bulk_ih));
+    auto reversed = scan(bulk_ih, true);
+    std::reverse(reversed.begin(), reversed.end());
+    EXPECT_EQ(row_entries, reversed);
+    for (int key = -1; key <= 40000; key += 97) {
+      int enc = encode(key);
+      std::vector<Rid> row_result;
+      std::vector<Rid> bulk_result;
+      EXPECT_EQ(row_ih->get_value((char *)&enc, &row_result, nullptr),
+                bulk_ih->get_value((char *)&enc, &bulk_result, nullptr));
+      EXPECT_EQ(row_result, bulk_result) << "key " << key;
+    }
+  }
+}
+
+// 可扩展哈希索引：插入引起桶分裂和目录加倍后所有key都能找到，删除后只找不到被删除的key，重新打开索引后内容不变
+TEST_F(IndexTest, HashIndexTest) {
+  auto ih = create_index("hash", INDEX_HASH);
+  const int num_keys = 20000;
+  auto check = [&](IxIndexHandle *ih, const std::function<bool(int)> &exists) {
+    for (int key = -10; key < num_keys + 10; key++) {
+      int enc = encode(key);
+      std::vector<Rid> result;
+      bool found = ih->get_value((char *)&enc, &result, nullptr);
+      ASSERT_EQ(found, exists(key)) << "key " << key;
+      if (found) {
+        ASSERT_EQ(result.size(), 1u);
+        EXPECT_EQ(result[0].page_no, key);
+      }
+    }
+  };
+  EXPECT_EQ(ih->get_hash_table()->get_global_depth(), 0);
+  std::vector<int> keys(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(2));
+  for (int key : keys) {
+    ASSERT_TRUE(insert(ih, key));
+  }
+  int depth = ih->get_hash_table()->get_global_depth();
+  EXPECT_GT(depth, 0);
+  EXPECT_FALSE(insert(ih, keys[0]));
+  check(ih, [&](int key) { return key >= 0 && key < num_keys; });
+
+  for (int key = 0; key < num_keys; key += 3) {
+    ASSERT_TRUE(remove(ih, key));
+  }
+  EXPECT_FALSE(remove(ih, 0));
+  auto exists = [&](int key) { return key >= 0 && key < num_keys && key % 3 != 0; };
+  check(ih, exists);
+
+  // 目录和桶都在索引文件中，重新打开后从页面恢复
+  auto &[cols, handle] = indexes_.back();
+  ix_manager_->close_index(handle.get());
+  handle = ix_manager_->open_index(cols[0].tab_name, cols);
+  ih = handle.get();
+  EXPECT_EQ(ih->get_hash_table()->get_global_depth(), depth);
+  check(ih, exists);
+
+  // 清空后只剩一个空桶，可以重新插入
+  ih->get_hash_table()->reset();
+  EXPECT_EQ(ih->get_hash_table()->get_global_depth(), 0);
+  check(ih, [](int) { return false; });
+  for (int key = 0; key < num_keys; key += 2) {
+    ASSERT_TRUE(insert(ih, key));
+  }
+  check(ih, [&](int key) { return key >= 0 && key < num_keys && key % 2 == 0; });
+}
+
+/** 在测试数据库中通过SQL建表，解析、优化后直接运行执行器树取得查询结果
+ * 每个测试点使用新的缓冲池和数据库，结束时删除数据库 */
+class SqlTest : public ::testing::Test {
+public:
+  const std::string db_name_ = "SqlTest_db";
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+  std::unique_ptr<RmManager> rm_manager_;
+  std::unique_ptr<IxManager> ix_manager_;
+  std::unique_ptr<SmManager> sm_manager_;
+  std::unique_ptr<TransactionManager> txn_manager_;
+  std::unique_ptr<LockManager> lock_manager_;
+  std::unique_ptr<QlManager> ql_manager_;
+  std::unique_ptr<LogManager> log_manager_;
+  std::unique_ptr<Planner> planner_;
+  std::unique_ptr<Optimizer> optimizer_;
+  std::unique_ptr<Portal> portal_;
+  std::unique_ptr<Analyze> analyze_;
+  std::unique_ptr<Context> context_;
+  char data_send_[BUFFER_LENGTH];
+  int offset_ = 0;
+  txn_id_t txn_id_ = INVALID_TXN_ID;
+
+public:
+  void SetUp() override {
+    ::testing::Test::SetUp();
+    init_managers();
+    if (sm_manager_->is_dir(db_name_)) {
+      sm_manager_->drop_db(db_name_);
+    }
+    sm_manager_->create_db(db_name_);
+    sm_manager_->open_db(db_name_);
+    begin_txn();
+  }
+
+  void TearDown() override {
+    txn_manager_->commit(context_->txn_, log_manager_.get());
+    sm_manager_->close_db();
+    sm_manager_->drop_db(db_name_);
+  }
+
+  // 新的缓冲池和各个管理器，用于模拟重启
+  void init_managers() {
+    // 重启时先释放原来的缓冲池，两个缓冲池同时存在时内存不够
+    buffer_pool_manager_.reset();
+    disk_manager_ = std::make_unique<DiskManager>();
+    buffer_pool_manager_ = std::make_unique<BufferPoolManager>(BUFFER_POOL_SIZE, disk_manager_.get());
+    rm_manager_ = std::make_unique<RmManager>(disk_manager_.get(), buffer_pool_manager_.get());
+    ix_manager_ = std::make_unique<IxManager>(disk_manager_.get(), buffer_pool_manager_.get());
+    sm_manager_ = std::make_unique<SmManager>(disk_manager_.get(), buffer_pool_manager_.get(), rm_manager_.get(),
+                                              ix_manager_.get());
+    txn_manager_ = std::make_unique<TransactionManager>(sm_manager_.get());
+    lock_manager_ = std::make_unique<LockManager>(txn_manager_.get());
+    ql_manager_ = std::make_unique<QlManager>(sm_manager_.get(), txn_manager_.get());
+    log_manager_ = std::make_unique<LogManager>(disk_manager_.get());
+    planner_ = std::make_unique<Planner>(sm_manager_.get());
+    optimizer_ = std::make_unique<Optimizer>(sm_manager_.get(), planner_.get());
+    portal_ = std::make_unique<Portal>(sm_manager_.get());
+    analyze_ = std::make_unique<Analyze>(sm_manager_.get());
+  }
+
+  void begin_txn() {
+    context_ = std::make_unique<Context>(lock_manager_.get(), log_manager_.get(), nullptr, data_send_, &offset_);
+    context_->txn_ = txn_manager_->begin(nullptr, log_manager_.get());
+    txn_id_ = context_->txn_->get_transaction_id();
+    context_->txn_->set_txn_mode(false);
+  }
+
+  std::shared_ptr<Plan> plan(const std::string &sql) {
+    YY_BUFFER_STATE buf = yy_scan_string(sql.c_str());
+    if (yyparse() != 0 || ast::parse_tree == nullptr) {
+      yy_delete_buffer(buf);
+      throw InternalError("failed to parse " + sql);
+    }
+    yy_delete_buffer(buf);
+    auto query = analyze_->do_analyze(ast::parse_tree);
+    return optimizer_->plan_query(query, context_.get());
+  }
+
+  std::shared_ptr<PortalStmt> prepare(const std::string &sql) { return portal_->start(plan(sql), context_.get()); }
+
+  // 沿子计划查找第一个tag类型的计划节点，连接时先找左子树，找不到时返回nullptr
+  static std::shared_ptr<Plan> find_plan(const std::shared_ptr<Plan> &plan, PlanTag tag) {
+    if (plan == nullptr || plan->tag == tag) {
+      return plan;
+    }
+    if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+      auto res = find_plan(x->left_, tag);
+      return res != nullptr ? res : find_plan(x->right_, tag);
+    } else if (auto x = std::dynamic_pointer_cast<DMLPlan>(plan)) {
+      return find_plan(x->subplan_, tag);
+    } else if (auto x = std::dynamic_pointer_cast<ProjectionPlan>(plan)) {
+      return find_plan(x->subplan_, tag);
+    } else if (auto x = std::dynamic_pointer_cast<SortPlan>(plan)) {
+      return find_plan(x->subplan_, tag);
+    } else if (auto x = std::dynamic_pointer_cast<GroupAggrePlan>(plan)) {
+      return find_plan(x->subplan_, tag);
+    }
+    return nullptr;
+  }
+
+  void execute(const std::string &sql) {
+    offset_ = 0;
+    portal_->run(prepare(sql), ql_manager_.get(), &txn_id_, context_.get());
+  }
+
+  // 执行查询，batch为false时走逐条记录的get_block路径，返回每条输出记录的字节
+  std::vector<std::string> query(const std::string &sql, bool batch = true) {
+    auto stmt = prepare(sql);
+    auto root = stmt->root.get();
+    if (!batch) {
+      std::vector<std::string> rows;
+      root->beginTuple();
+      for (auto &rec : root->get_block()) {
+        rows.emplace_back(rec->data, root->tupleLen());
+      }
+      return rows;
+    }
+    return collect(root);
+  }
+
+  // 批量执行算子树，返回每条输出记录的字节
+  static std::vector<std::string> collect(AbstractExecutor *root) {
+    std::vector<std::string> rows;
+    RecordBatch rec_batch;
+    root->begin_batch();
+    while (root->next_batch(rec_batch)) {
+      for (size_t k = 0; k < rec_batch.size(); k++) {
+        rows.emplace_back(rec_batch.at(k), root->tupleLen());
+      }
+    }
+    return rows;
+  }
+
+  // 提交当前事务后正常关闭并重新打开数据库，关闭时数据页落盘、日志被清空
+  void restart() {
+    txn_manager_->commit(context_->txn_, log_manager_.get());
+    sm_manager_->close_db();
+    init_managers();
+    sm_manager_->open_db(db_name_);
+    begin_txn();
+  }
+
+  // 不刷脏页直接丢弃缓冲池和各个管理器，模拟宕机，重启后按日志redo、undo
+  void crash_and_recover() {
+    if (chdir("..") < 0) {
+      throw UnixError();
+    }
+    init_managers();
+    sm_manager_->open_db(db_name_);
+    // 日志缓冲区很大，不能放在栈上
+    auto recovery = std::make_unique<RecoveryManager>(disk_manager_.get(), buffer_pool_manager_.get(),
+                                                      sm_manager_.get());
+    recovery->analyze();
+    recovery->redo();
+    recovery->undo();
+    begin_txn();
+  }
+
+  // 日志文件从offset开始的每条日志记录的字节
+  std::vector<std::string> read_logs(int offset) {
+    std::vector<std::string> logs;
+    int size = disk_manager_->get_file_size(LOG_FILE_NAME);
+    std::vector<char> buf(std::max(size - offset, 0));
+    if (buf.empty() || disk_manager_->read_log(buf.data(), buf.size(), offset) <= 0) {
+      return logs;
+    }
+    for (size_t pos = 0; pos < buf.size();) {
+      LogRecord log;
+      log.deserialize(buf.data() + pos);
+      logs.emplace_back(buf.data() + pos, log.GetSize());
+      pos += log.GetSize();
+    }
+    return logs;
+  }
+
+  std::unique_ptr<AbstractExecutor> seq_scan(const std::string &tab_name) {
+    return std::make_unique<SeqScanExecutor>(sm_manager_.get(), tab_name, std::vector<Condition>{}, context_.get());
+  }
+
+  // n个共享页面分配的并行扫描流水线
+  std::vector<std::unique_ptr<AbstractExecutor>> parallel_scans(const std::string &tab_name,
+                                                                const std::vector<Condition> &conds, size_t n) {
+    auto morsels = std::make_shared<PageMorsels>();
+    std::vector<std::unique_ptr<AbstractExecutor>> pipelines;
+    for (size_t i = 0; i < n; i++) {
+      pipelines.push_back(std::make_unique<SeqScanExecutor>(sm_manager_.get(), tab_name, conds, context_.get(), -1,
+                                                            morsels));
+    }
+    return pipelines;
+  }
+
+  // 把rows行(i, f(i))写成CSV后导入表中
+  void load_rows(const std::string &tab_name, const std::string &header, int rows,
+                 const std::function<std::string(int)> &row) {
+    std::string file_name = tab_name + ".csv";
+    {
+      std::ofstream ofs(file_name);
+      ofs << header << "\n";
+      for (int i = 0; i < rows; i++) {
+        ofs << row(i) << "\n";
+      }
+    }
+    sm_manager_->load_table(file_name, tab_name, context_.get());
+    std::remove(file_name.c_str());
+  }
+};
+
+static int row_int(const std::string &row, int offset) {
+  int val;
+  memcpy(&val, row.data() + offset, sizeof(int));
+  return val;
+}
+
+// 导入CSV：非空的表和索引上追加导入；中途出错的导入不在表和索引中留下任何记录
+TEST_F(SqlTest, LoadTest) {
+  execute("create table t (id int, v int, s char(8));");
+  execute("create index t(id);");
+  auto write_csv = [](const std::string &name, int first, int last, int bad_row) {
+    std::ofstream ofs(name);
+    ofs << "id,v,s\n";
+    for (int i = first; i < last; i++) {
+      ofs << i << "," << (i == bad_row ? "oops" : std::to_string(i * 2)) << ",s" << i % 100 << "\n";
+    }
+  };
+  write_csv("first.csv", 0, 1000, -1);
+  // 服务端日志中输出每个阶段的行数、耗时和吞吐
+  testing::internal::CaptureStdout();
+  sm_manager_->load_table("first.csv", "t", context_.get());
+  std::string log = testing::internal::GetCapturedStdout();
+  for (auto phase : {"parsed 1000 rows", "stored 1000 rows", "indexed t_id.idx 1000 rows"}) {
+    EXPECT_NE(std::string::npos, log.find("load t: " + std::string(phase))) << log;
+  }
+  EXPECT_NE(std::string::npos, log.find("rows/s")) << log;
+  write_csv("second.csv", 1000, 3000, -1);
+  sm_manager_->load_table("second.csv", "t", context_.get());
+  auto rows = query("select id, v from t;");
+  ASSERT_EQ(3000u, rows.size());
+  std::set<int> ids;
+  for (auto &row : rows) {
+    EXPECT_EQ(row_int(row, 0) * 2, row_int(row, 4));
+    ids.insert(row_int(row, 0));
+  }
+  EXPECT_EQ(3000u, ids.size());
+  for (int id : {0, 999, 1000, 2999}) {
+    auto found = query("select v from t where id = " + std::to_string(id) + ";");
+    ASSERT_EQ(1u, found.size());
+    EXPECT_EQ(id * 2, row_int(found[0], 0));
+  }
+
+  // 最后几行才出错
+  write_csv("bad.csv", 3000, 6000, 5990);
+  EXPECT_THROW(sm_manager_->load_table("bad.csv", "t", context_.get()), RMDBError);
+  EXPECT_EQ(3000u, query("select id from t;").size());
+  EXPECT_TRUE(query("select v from t where id = 3000;").empty());
+  EXPECT_TRUE(query("select v from t where id > 2999;").empty());
+  // 修正后重新导入
+  write_csv("bad.csv", 3000, 6000, -1);
+  sm_manager_->load_table("bad.csv", "t", context_.get());
+  EXPECT_EQ(6000u, query("select id from t;").size());
+  EXPECT_EQ(3000u, query("select v from t where id > 2999;").size());
+}
+
+// show index按索引的元数据输出是否唯一和索引类型
+TEST_F(SqlTest, ShowIndexTest) {
+  execute("create table t (id int, v int, s char(8));");
+  execute("create index t(id);");
+  execute("create index t(v) with (unique = false);");
+  execute("create index t(s, id) using hash;");
+  std::remove("output.txt");
+  execute("show index from t;");
+  std::ifstream ifs("output.txt");
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(ifs, line);) {
+    lines.push_back(line);
+  }
+  std::vector<std::string> expected = {"| t | unique | (id) |", "| t | non-unique | (v) |",
+                                       "| t | unique hash | (s,id) |"};
+  EXPECT_EQ(expected, lines);
+}
+
+// >=条件也作为索引扫描的下界，正向和逆序扫描的范围都正确
+TEST_F(SqlTest, IndexRangeTest) {
+  execute("create table t (id int, v int);");
+  execute("create index t(id);");
+  {
+    std::ofstream ofs("range.csv");
+    ofs << "id,v\n";
+    for (int i = 0; i < 5000; i++) {
+      ofs << i << "," << i * 2 << "\n";
+    }
+  }
+  sm_manager_->load_table("range.csv", "t", context_.get());
+  std::remove("range.csv");
+
+  // 查找key从>=条件的右值开始，而不是从第一个叶子开始
+  Condition ge{.lhs_col = {.tab_name = "t", .col_name = "id"}, .op = OP_GE, .is_rhs_val = true};
+  ge.rhs_val.set_int("1234");
+  ge.rhs_val.init_raw(sizeof(int));
+  IndexScanExecutor scan(sm_manager_.get(), "t", {ge}, {"id"}, context_.get());
+  std::vector<int> lens = {sizeof(int)};
+  auto cols = scan.cols();
+  int key = 0;
+  scan.make_key({ge}, {"id"}, cols, lens, (char *)&key);
+  int expected = 0;
+  int val = 1234;
+  ix_encode_col(TYPE_INT, sizeof(int), (char *)&val, (char *)&expected);
+  EXPECT_EQ(expected, key);
+
+  auto check = [&](const std::string &cond, bool desc, int first, int last) {
+    auto rows = query("select id, v from t where " + cond + " order by id" + (desc ? " desc;" : ";"));
+    ASSERT_EQ((size_t)(last - first + 1), rows.size()) << cond;
+    for (size_t i = 0; i < rows.size(); i++) {
+      int id = desc ? last - (int)i : first + (int)i;
+      EXPECT_EQ(id, row_int(rows[i], 0)) << cond;
+      EXPECT_EQ(id * 2, row_int(rows[i], 4)) << cond;
+    }
+  };
+  for (bool desc : {false, true}) {
+    check("id >= 1234", desc, 1234, 4999);
+    check("id >= 1234 and id <= 1300", desc, 1234, 1300);
+    check("id >= 1234 and id < 1300", desc, 1234, 1299);
+    check("id > 1234 and id <= 1300", desc, 1235, 1300);
+    check("id >= 0 and id <= 10", desc, 0, 10);
+    check("id >= 4990", desc, 4990, 4999);
+    check("id >= 1300 and id > 1234", desc, 1300, 4999);
+  }
+  EXPECT_TRUE(query("select id from t where id >= 5000;").empty());
+  EXPECT_TRUE(query("select id from t where id >= 5000 order by id desc;").empty());
+}
+
+// 旧版本格式（没有magic和版本）的索引文件不能直接打开，打开数据库时从表中的记录重新构建
+TEST_F(SqlTest, IndexFileVersionTest) {
+  execute("create table t (id int, v int);");
+  execute("create index t(id);");
+  load_rows("t", "id,v", 1000, [](int i) { return std::to_string(i) + "," + std::to_string(i * 2); });
+  txn_manager_->commit(context_->txn_, log_manager_.get());
+  sm_manager_->close_db();
+  init_managers();
+  std::vector<std::string> index_cols = {"id"};
+  std::string ix_name = db_name_ + "/" + ix_manager_->get_index_name("t", index_cols);
+  // 旧版本文件头的第一个字段是文件头的长度
+  int old_hdr_len = 64;
+  int fd = disk_manager_->open_file(ix_name);
+  disk_manager_->write_page(fd, IX_FILE_HDR_PAGE, (char *)&old_hdr_len, sizeof(int));
+  disk_manager_->close_file(fd);
+  EXPECT_THROW(ix_manager_->open_index(ix_name), InternalError);
+
+  sm_manager_->open_db(db_name_);
+  begin_txn();
+  auto &ih = sm_manager_->ihs_.at(ix_manager_->get_index_name("t", index_cols));
+  EXPECT_EQ(IX_FILE_MAGIC, ih->get_ix_file_hdr()->magic_);
+  EXPECT_EQ(IX_FILE_VERSION, ih->get_ix_file_hdr()->version_);
+  std::string sql = "select id, v from t where id = 500;";
+  EXPECT_NE(nullptr, find_plan(plan(sql), T_IndexScan));
+  auto rows = query(sql);
+  ASSERT_EQ(1u, rows.size());
+  EXPECT_EQ(500, row_int(rows[0], 0));
+  EXPECT_EQ(1000, row_int(rows[0], 4));
+}
+
+// 内存上限很小时hash join溢出到临时文件并多层分区，结果与全部在内存中连接相同，结束后临时文件被删除
+TEST_F(SqlTest, HashJoinSpillTest) {
+  execute("create table a (id int, v int);");
+  execute("create table b (id int, w int);");
+  load_rows("a", "id,v", 50000, [](int i) { return std::to_string(i) + "," + std::to_string(i * 3); });
+  // b中的key有重复，每条都恰好与a中的一条连接
+  load_rows("b", "id,w", 40000, [](int i) { return std::to_string(i % 25000 * 2) + "," + std::to_string(i); });
+  Condition cond{.lhs_col = {.tab_name = "a", .col_name = "id"}, .op = OP_EQ, .is_rhs_val = false,
+                 .rhs_col = {.tab_name = "b", .col_name = "id"}};
+
+  HashJoinExecutor in_memory(seq_scan("a"), seq_scan("b"), {cond}, true);
+  auto expected = collect(&in_memory);
+  ASSERT_EQ(40000u, expected.size());
+  EXPECT_EQ(0u, disk_manager_->spill_seq_.load());
+
+  auto spill_seq = disk_manager_->spill_seq_.load();
+  auto spilled = std::make_unique<HashJoinExecutor>(seq_scan("a"), seq_scan("b"), std::vector<Condition>{cond}, true,
+                                                    nullptr, disk_manager_.get(), 16 << 10);
+  auto rows = collect(spilled.get());
+  // build端分区后仍超过上限，又按hash的下几位再分区
+  EXPECT_GT(disk_manager_->spill_seq_.load() - spill_seq, (uint64_t)2 << SPILL_PARTITION_BITS);
+  spilled.reset();
+  for (auto &row : rows) {
+    EXPECT_EQ(row_int(row, 0), row_int(row, 8));
+    EXPECT_EQ(row_int(row, 0) * 3, row_int(row, 4));
+  }
+  std::sort(expected.begin(), expected.end());
+  std::sort(rows.begin(), rows.end());
+  EXPECT_EQ(expected, rows);
+
+  // 临时文件都已删除
+  DIR *dir = opendir(".");
+  ASSERT_NE(nullptr, dir);
+  while (struct dirent *entry = readdir(dir)) {
+    EXPECT_NE(0, std::string(entry->d_name).compare(0, SPILL_FILE_PREFIX.size(), SPILL_FILE_PREFIX));
+  }
+  closedir(dir);
+}
+
+// 查询内存预算不足时外部排序把run写入临时文件再多路归并，输出顺序与全部在内存中排序相同
+TEST_F(SqlTest, SortSpillTest) {
+  execute("create table s (k int, v int);");
+  std::mt19937 rng(3);
+  load_rows("s", "k,v", 100000, [&](int i) { return std::to_string((int)(rng() % 5000) - 2500) + "," + std::to_string(i); });
+  // k有大量重复，再按v逆序，输出顺序是唯一的
+  std::vector<std::shared_ptr<ast::OrderBy>> orders = {
+      std::make_shared<ast::OrderBy>(std::make_shared<ast::Col>("s", "k"), ast::OrderBy_ASC),
+      std::make_shared<ast::OrderBy>(std::make_shared<ast::Col>("s", "v"), ast::OrderBy_DESC)};
+
+  SortExecutor in_memory(seq_scan("s"), orders, -1);
+  auto expected = collect(&in_memory);
+  ASSERT_EQ(100000u, expected.size());
+  for (size_t i = 1; i < expected.size(); i++) {
+    int k0 = row_int(expected[i - 1], 0), k1 = row_int(expected[i], 0);
+    ASSERT_TRUE(k0 < k1 || (k0 == k1 && row_int(expected[i - 1], 4) > row_int(expected[i], 4)));
+  }
+
+  // 1MB的预算只够放下一部分记录，其余的排好序写成run
+  auto spill_seq = disk_manager_->spill_seq_.load();
+  SortExecutor spilled(seq_scan("s"), orders, -1, std::make_shared<MemoryBudget>(1 << 20), disk_manager_.get());
+  auto rows = collect(&spilled);
+  EXPECT_GE(disk_manager_->spill_seq_.load() - spill_seq, 2u);
+  EXPECT_EQ(expected, rows);
+}
+
+// 多条流水线共享页面分配并行扫描，经ExchangeExecutor汇合的结果与顺序扫描相同（顺序可以不同）
+TEST_F(SqlTest, ParallelScanTest) {
+  execute("create table p (id int, v int, g int);");
+  load_rows("p", "id,v,g", 200000, [](int i) {
+    return std::to_string(i) + "," + std::to_string(i * 7 % 100003) + "," + std::to_string(i % 1000);
+  });
+  Condition lt{.lhs_col = {.tab_name = "p", .col_name = "v"}, .op = OP_LT, .is_rhs_val = true};
+  lt.rhs_val.set_int("60000");
+  lt.rhs_val.init_raw(sizeof(int));
+
+  SeqScanExecutor serial(sm_manager_.get(), "p", {lt}, context_.get());
+  auto expected = collect(&serial);
+  std::sort(expected.begin(), expected.end());
+  ASSERT_FALSE(expected.empty());
+
+  // 流水线数可以多于工作线程数
+  for (size_t n : {1, 2, 4, 8}) {
+    ExchangeExecutor exchange(parallel_scans("p", {lt}, n));
+    auto rows = collect(&exchange);
+    std::sort(rows.begin(), rows.end());
+    EXPECT_EQ(expected, rows) << n << " pipelines";
+  }
+
+  // 通过优化器生成的并行计划
+  const std::string sql = "select id, v from p where v < 60000;";
+  auto serial_rows = query(sql);
+  context_->dop_ = 4;
+  auto parallel_rows = query(sql);
+  context_->dop_ = 1;
+  std::sort(serial_rows.begin(), serial_rows.end());
+  std::sort(parallel_rows.begin(), parallel_rows.end());
+  EXPECT_EQ(expected.size(), serial_rows.size());
+  EXPECT_EQ(serial_rows, parallel_rows);
+}
+
+// 并行hash join：各流水线共享build端并分别探查，结果与串行的HashJoinExecutor相同
+TEST_F(SqlTest, ParallelHashJoinTest) {
+  execute("create table a (id int, v int);");
+  execute("create table b (id int, w int);");
+  load_rows("a", "id,v", 200000, [](int i) { return std::to_string(i) + "," + std::to_string(i * 3); });
+  // b中的key有重复，部分key在a中不存在
+  load_rows("b", "id,w", 100000, [](int i) { return std::to_string(i * 13 % 250000) + "," + std::to_string(i); });
+  Condition cond{.lhs_col = {.tab_name = "a", .col_name = "id"}, .op = OP_EQ, .is_rhs_val = false,
+                 .rhs_col = {.tab_name = "b", .col_name = "id"}};
+
+  HashJoinExecutor serial(seq_scan("a"), seq_scan("b"), {cond}, false);
+  auto expected = collect(&serial);
+  std::sort(expected.begin(), expected.end());
+  ASSERT_FALSE(expected.empty());
+
+  for (size_t n : {1, 2, 4}) {
+    // build端也是并行扫描
+    auto build = std::make_shared<ParallelJoinBuild>(parallel_scans("b", {}, n), seq_scan("a")->cols(),
+                                                     std::vector<Condition>{cond}, false, nullptr);
+    auto probes = parallel_scans("a", {}, n);
+    std::vector<std::unique_ptr<AbstractExecutor>> pipelines;
+    for (size_t i = 0; i < n; i++) {
+      pipelines.push_back(std::make_unique<HashJoinProbeExecutor>(std::move(probes[i]), build, i == 0));
+    }
+    ExchangeExecutor exchange(std::move(pipelines));
+    auto rows = collect(&exchange);
+    std::sort(rows.begin(), rows.end());
+    EXPECT_EQ(expected, rows) << n << " pipelines";
+  }
+
+  const std::string sql = "select a.id, a.v, b.w from a, b where a.id = b.id;";
+  auto serial_rows = query(sql);
+  context_->dop_ = 4;
+  auto parallel_rows = query(sql);
+  context_->dop_ = 1;
+  std::sort(serial_rows.begin(), serial_rows.end());
+  std::sort(parallel_rows.begin(), parallel_rows.end());
+  EXPECT_EQ(expected.size(), serial_rows.size());
+  EXPECT_EQ(serial_rows, parallel_rows);
+}
+
+// 两阶段并行聚合：各流水线预聚合后按分区合并，结果与串行的HashAggregateExecutor相同
+TEST_F(SqlTest, ParallelAggregateTest) {
+  execute("create table p (id int, v int, g int);");
+  load_rows("p", "id,v,g", 200000, [](int i) {
+    return std::to_string(i) + "," + std::to_string(i * 7 % 100003 - 50000) + "," + std::to_string(i % 1000);
+  });
+  auto v = std::make_shared<ast::Col>("p", "v");
+  std::vector<std::shared_ptr<ast::AggreClause>> aggres = {
+      std::make_shared<ast::AggreClause>("cnt"), std::make_shared<ast::AggreClause>(ast::SUM, v, "s"),
+      std::make_shared<ast::AggreClause>(ast::MIN, v, "lo"), std::make_shared<ast::AggreClause>(ast::MAX, v, "hi")};
+
+  for (auto &group_cols : {std::vector<TabCol>{{"p", "g"}}, std::vector<TabCol>{}}) {
+    HashAggregateExecutor serial(seq_scan("p"), group_cols, aggres);
+    auto expected = collect(&serial);
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(group_cols.empty() ? 1u : 1000u, expected.size());
+    for (size_t n : {1, 2, 4, 8}) {
+      ParallelHashAggregateExecutor parallel(parallel_scans("p", {}, n), group_cols, aggres, nullptr);
+      auto rows = collect(&parallel);
+      std::sort(rows.begin(), rows.end());
+      EXPECT_EQ(expected, rows) << n << " pipelines";
+    }
+  }
+
+  for (const std::string sql : {"select g, count(*) as c, sum(v) as s, min(v) as lo, max(v) as hi from p group by g;",
+                                "select count(*) as c, sum(v) as s, min(v) as lo, max(v) as hi from p;"}) {
+    auto serial_rows = query(sql);
+    context_->dop_ = 4;
+    auto parallel_rows = query(sql);
+    context_->dop_ = 1;
+    std::sort(serial_rows.begin(), serial_rows.end());
+    std::sort(parallel_rows.begin(), parallel_rows.end());
+    EXPECT_FALSE(serial_rows.empty()) << sql;
+    EXPECT_EQ(serial_rows, parallel_rows) << sql;
+  }
+}
+
+// 只有一个聚合函数的查询同样由分组聚合执行：整数的SUM累加到BIGINT不会溢出，空输入时输出一行0；
+// PAX布局的表按列访问聚合字段，结果与行存相同
+TEST_F(SqlTest, AggregateTest) {
+  auto int64_at = [](const std::string &row, int offset) {
+    int64_t val;
+    memcpy(&val, row.data() + offset, sizeof(int64_t));
+    return val;
+  };
+  for (const std::string layout : {"row", "pax"}) {
+    std::string tab = "a_" + layout;
+    execute("create table " + tab + " (i int, b bigint, f float) with (layout = " + layout + ");");
+    load_rows(tab, "i,b,f", 3, [](int) { return "2000000000,5000000000,1.5"; });
+    for (bool batch : {true, false}) {
+      auto rows = query("select sum(i) as s from " + tab + ";", batch);
+      ASSERT_EQ(rows.size(), 1u);
+      EXPECT_EQ(int64_at(rows[0], 0), 6000000000LL) << layout;
+      rows = query("select sum(b) as s from " + tab + ";", batch);
+      ASSERT_EQ(rows.size(), 1u);
+      EXPECT_EQ(int64_at(rows[0], 0), 15000000000LL) << layout;
+      rows = query("select sum(f) as s from " + tab + ";", batch);
+      ASSERT_EQ(rows.size(), 1u);
+      float sum;
+      memcpy(&sum, rows[0].data(), sizeof(float));
+      EXPECT_FLOAT_EQ(sum, 4.5f) << layout;
+      rows = query("select count(*) as c from " + tab + " where i > 0;", batch);
+      ASSERT_EQ(rows.size(), 1u);
+      EXPECT_EQ(row_int(rows[0], 0), 3) << layout;
+      rows = query("select max(b) as m from " + tab + " where i < 0;", batch);
+      ASSERT_EQ(rows.size(), 1u);
+      EXPECT_EQ(int64_at(rows[0], 0), 0) << layout;
+    }
+  }
+}
+
+// 按索引顺序读取的GROUP BY使用流式聚合，结果与hash聚合相同；hash聚合的内存上限很小时分组溢出到临时文件，
+// 分区中仍然放不下时继续分区，结果不变
+TEST_F(SqlTest, GroupAggregateTest) {
+  execute("create table g (k int, v int);");
+  // 没有条件时只在索引覆盖了用到的字段时才按索引顺序读取
+  execute("create index g(k, v);");
+  // 7919与5000互质，每个k恰好出现10次
+  load_rows("g", "k,v", 50000, [](int i) { return std::to_string(i * 7919 % 5000) + "," + std::to_string(i); });
+  std::string sql = "select k, count(*) as c, sum(v) as s from g group by k;";
+  auto root = plan(sql);
+  EXPECT_NE(nullptr, find_plan(root, T_StreamAggre));
+  EXPECT_EQ(nullptr, find_plan(root, T_HashAggre));
+  auto rows = query(sql);
+  ASSERT_EQ(5000u, rows.size());
+  for (size_t i = 0; i < rows.size(); i++) {
+    EXPECT_EQ((int)i, row_int(rows[i], 0));
+    EXPECT_EQ(10, row_int(rows[i], 4));
+  }
+
+  auto v = std::make_shared<ast::Col>("g", "v");
+  std::vector<std::shared_ptr<ast::AggreClause>> aggres = {std::make_shared<ast::AggreClause>("c"),
+                                                           std::make_shared<ast::AggreClause>(ast::SUM, v, "s")};
+  std::vector<TabCol> group_cols = {{"g", "k"}};
+  HashAggregateExecutor in_memory(seq_scan("g"), group_cols, aggres);
+  auto expected = collect(&in_memory);
+  std::sort(expected.begin(), expected.end());
+  std::sort(rows.begin(), rows.end());
+  EXPECT_EQ(expected, rows);
+  EXPECT_EQ(0u, disk_manager_->spill_seq_.load());
+
+  auto spilled = std::make_unique<HashAggregateExecutor>(seq_scan("g"), group_cols, aggres, nullptr,
+                                                         disk_manager_.get(), 4 << 10);
+  rows = collect(spilled.get());
+  EXPECT_GT(disk_manager_->spill_seq_.load(), (uint64_t)1 << SPILL_PARTITION_BITS);
+  spilled.reset();
+  std::sort(rows.begin(), rows.end());
+  EXPECT_EQ(expected, rows);
+}
+
+static LogType log_type(const std::string &log) {
+  LogRecord rec;
+  rec.deserialize(log.data());
+  return rec.GetLogRecordType();
+}
+
+// 更新只记录变化的字节区间；索引只在key变化时维护，记录没有变化时不写日志
+TEST_F(SqlTest, UpdateDeltaLogTest) {
+  execute("create table t (id int, v int, s char(64));");
+  execute("create index t(id);");
+  execute("create index t(v);");
+  load_rows("t", "id,v,s", 100, [](int i) { return std::to_string(i) + "," + std::to_string(i * 2) + ",s"; });
+  restart();
+  int record_size = sm_manager_->fhs_.at("t")->get_file_hdr().record_size;
+
+  int offset = disk_manager_->get_file_size(LOG_FILE_NAME);
+  execute("update t set v = 1000 where id = 5;");
+  auto logs = read_logs(offset);
+  ASSERT_EQ(3u, logs.size());
+  ASSERT_EQ(LogType::UPDATE_DELTA, log_type(logs[0]));
+  LogRecord delta;
+  delta.deserialize(logs[0].data());
+  delta.deserialize_upd_delta(logs[0].data());
+  EXPECT_LE(delta.delta_size_, sizeof(int) * 2 + sizeof(int) * 2);
+  EXPECT_LT(logs[0].size(), (size_t)record_size);
+  EXPECT_EQ(LogType::DELETE_ENTRY, log_type(logs[1]));
+  EXPECT_EQ(LogType::INSERT_ENTRY, log_type(logs[2]));
+  LogRecord entry;
+  entry.deserialize(logs[1].data());
+  entry.deserialize_index(logs[1].data());
+  EXPECT_EQ(ix_manager_->get_index_name("t", std::vector<std::string>{"v"}),
+            std::string(entry.get_index_name(), entry.get_index_name_size()));
+
+  // v的值没有变化，索引t(v)不需要维护
+  offset = disk_manager_->get_file_size(LOG_FILE_NAME);
+  execute("update t set v = 1000, s = 'changed' where id = 5;");
+  logs = read_logs(offset);
+  ASSERT_EQ(1u, logs.size());
+  EXPECT_EQ(LogType::UPDATE_DELTA, log_type(logs[0]));
+
+  offset = disk_manager_->get_file_size(LOG_FILE_NAME);
+  execute("update t set v = 1000 where id = 5;");
+  EXPECT_TRUE(read_logs(offset).empty());
+
+  std::string sql = "select id, v from t where v = 1000;";
+  EXPECT_NE(nullptr, find_plan(plan(sql), T_IndexScan));
+  auto rows = query(sql);
+  ASSERT_EQ(1u, rows.size());
+  EXPECT_EQ(5, row_int(rows[0], 0));
+  EXPECT_TRUE(query("select id from t where v = 10;").empty());
+}
+
+// 宕机后按增量日志恢复：已提交的更新被redo，未提交的更新被undo，表和索引一致
+TEST_F(SqlTest, UpdateRecoveryTest) {
+  execute("create table t (id int, v int);");
+  execute("create index t(v);");
+  load_rows("t", "id,v", 100, [](int i) { return std::to_string(i) + "," + std::to_string(i * 2); });
+  restart();
+  execute("update t set v = v + 1000 where id < 10;");
+  txn_manager_->commit(context_->txn_, log_manager_.get());
+  begin_txn();
+  execute("update t set v = v + 5000 where id >= 90;");
+  crash_and_recover();
+
+  auto rows = query("select id, v from t;");
+  ASSERT_EQ(100u, rows.size());
+  for (auto &row : rows) {
+    int id = row_int(row, 0);
+    EXPECT_EQ(id < 10 ? id * 2 + 1000 : id * 2, row_int(row, 4)) << id;
+  }
+  for (int id : {0, 5, 9, 10, 90, 99}) {
+    int v = id < 10 ? id * 2 + 1000 : id * 2;
+    std::string sql = "select id from t where v = " + std::to_string(v) + ";";
+    EXPECT_NE(nullptr, find_plan(plan(sql), T_IndexScan));
+    rows = query(sql);
+    ASSERT_EQ(1u, rows.size()) << v;
+    EXPECT_EQ(id, row_int(rows[0], 0));
+  }
+  EXPECT_TRUE(query("select id from t where v = 10;").empty());
+  EXPECT_TRUE(query("select id from t where v = 5180;").empty());
+}
+
+// 显式事务回滚更新后，表中的记录和索引都恢复原样
+TEST_F(SqlTest, UpdateAbortTest) {
+  execute("create table t (id int, v int);");
+  execute("create index t(v);");
+  load_rows("t", "id,v", 100, [](int i) { return std::to_string(i) + "," + std::to_string(i * 2); });
+  restart();
+  context_->txn_->set_txn_mode(true);
+  execute("update t set v = v + 1000 where id < 10;");
+  EXPECT_EQ(1u, query("select id from t where v = 1000;").size());
+  txn_manager_->abort(context_->txn_, log_manager_.get());
+  begin_txn();
+
+  auto rows = query("select id, v from t;");
+  ASSERT_EQ(100u, rows.size());
+  for (auto &row : rows) {
+    EXPECT_EQ(row_int(row, 0) * 2, row_int(row, 4));
+  }
+  for (int id = 0; id < 10; id++) {
+    std::string sql = "select id from t where v = " + std::to_string(id * 2) + ";";
+    EXPECT_NE(nullptr, find_plan(plan(sql), T_IndexScan));
+    rows = query(sql);
+    ASSERT_EQ(1u, rows.size());
+    EXPECT_EQ(id, row_int(rows[0], 0));
+    EXPECT_TRUE(query("select id from t where v = " + std::to_string(id * 2 + 1000) + ";").empty());
+  }
+}
+
+// 两边按非唯一索引有序且key都有重复时改为归并连接，key以外的连接条件也要满足，结果与嵌套循环连接相同
+TEST_F(SqlTest, MergeJoinTest) {
+  execute("create table a (k int, x int);");
+  execute("create table b (k int, y int);");
+  execute("create index a(k, x) with (unique = false);");
+  execute("create index b(k, y) with (unique = false);");
+  // a中的key为0~29，每个key有10条，(k, x)也有重复；b中的key为10~49，每个key有4条
+  load_rows("a", "k,x", 300, [](int i) { return std::to_string(i % 30) + "," + std::to_string(i % 7 * 40); });
+  load_rows("b", "k,y", 160, [](int i) { return std::to_string(i % 40 + 10) + "," + std::to_string(i * 2); });
+  Condition key{.lhs_col = {.tab_name = "a", .col_name = "k"}, .op = OP_EQ, .is_rhs_val = false,
+                .rhs_col = {.tab_name = "b", .col_name = "k"}};
+  Condition less{.lhs_col = {.tab_name = "a", .col_name = "x"}, .op = OP_LT, .is_rhs_val = false,
+                 .rhs_col = {.tab_name = "b", .col_name = "y"}};
+
+  std::vector<std::pair<std::string, std::vector<Condition>>> queries = {
+      {"select a.k, a.x, b.k, b.y from a, b where a.k = b.k;", {key}},
+      {"select a.k, a.x, b.k, b.y from a, b where a.k = b.k and a.x < b.y;", {key, less}}};
+  for (auto &[sql, conds] : queries) {
+    EXPECT_NE(nullptr, find_plan(plan(sql), T_MergeJoin)) << sql;
+    NestedLoopJoinExecutor nested_loop(seq_scan("a"), seq_scan("b"), conds);
+    auto expected = collect(&nested_loop);
+    ASSERT_FALSE(expected.empty());
+    auto rows = query(sql);
+    for (auto &row : rows) {
+      ASSERT_EQ(row_int(row, 0), row_int(row, 8));
+      ASSERT_LE(10, row_int(row, 0));
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(rows.begin(), rows.end());
+    EXPECT_EQ(expected, rows) << sql;
+  }
+  // 共同的key为10~29，每个key连接出10 * 4条
+  EXPECT_EQ(20u * 10 * 4, query(queries[0].first).size());
+}
+
+// ORDER BY ... LIMIT用top-n排序，结果与完整排序的前n条相同；没有排序的LIMIT下推到扫描，WHERE过滤后再计数
+TEST_F(SqlTest, LimitTest) {
+  execute("create table s (id int, k int, v int);");
+  const int num_rows = 1000;
+  load_rows("s", "id,k,v", num_rows,
+            [](int i) { return std::to_string(i) + "," + std::to_string(i % 10) + "," + std::to_string(i % 7); });
+  // k和(k, v)都有大量重复
+  auto full = query("select k, v from s order by k, v desc;");
+  ASSERT_EQ((size_t)num_rows, full.size());
+  for (int limit : {1, 25, 143, 999}) {
+    auto rows = query("select k, v from s order by k, v desc limit " + std::to_string(limit) + ";");
+    EXPECT_EQ(std::vector<std::string>(full.begin(), full.begin() + limit), rows) << limit;
+  }
+  EXPECT_EQ(full, query("select k, v from s order by k, v desc limit 5000;"));
+  EXPECT_TRUE(query("select k, v from s order by k, v desc limit 0;").empty());
+
+  std::string sql = "select id, k from s where k = 3 limit 5;";
+  auto scan = std::dynamic_pointer_cast<ScanPlan>(find_plan(plan(sql), T_SeqScan));
+  ASSERT_NE(nullptr, scan);
+  EXPECT_EQ(5, scan->limit_);
+  auto rows = query(sql);
+  ASSERT_EQ(5u, rows.size());
+  for (auto &row : rows) {
+    EXPECT_EQ(3, row_int(row, 4));
+  }
+  // 满足条件的记录比LIMIT少时全部输出
+  int matched = 0;
+  for (int i = 0; i < num_rows; i++) {
+    matched += i % 10 == 3 && i % 7 == 2;
+  }
+  rows = query("select id, k, v from s where k = 3 and v = 2 limit 500;");
+  EXPECT_EQ((size_t)matched, rows.size());
+  for (auto &row : rows) {
+    EXPECT_EQ(3, row_int(row, 4));
+    EXPECT_EQ(2, row_int(row, 8));
+  }
+  EXPECT_EQ((size_t)num_rows, query("select id from s limit 5000;").size());
+  EXPECT_TRUE(query("select id from s limit 0;").empty());
+  EXPECT_TRUE(query("select id from s where k = 3 limit 0;").empty());
+}
+
+// ORDER BY ... LIMIT和单独的MIN/MAX按索引顺序读取，读够就停止；非索引字段上的条件过滤后才计数
+TEST_F(SqlTest, IndexOrderTest) {
+  execute("create table t (id int, v int, w int);");
+  execute("create index t(v);");
+  const int num_rows = 1000;
+  // v是0~999的一个排列
+  load_rows("t", "id,v,w", num_rows, [](int i) {
+    return std::to_string(i) + "," + std::to_string(i * 7 % 1000) + "," + std::to_string(i % 5);
+  });
+  auto index_scan = [&](const std::string &sql) {
+    auto scan = std::dynamic_pointer_cast<ScanPlan>(find_plan(plan(sql), T_IndexScan));
+    EXPECT_NE(nullptr, scan) << sql;
+    return scan;
+  };
+
+  for (std::string filter : {"", "where w = 2 "}) {
+    std::string sql = "select v, w from t " + filter + "order by v desc limit 5;";
+    auto scan = index_scan(sql);
+    ASSERT_NE(nullptr, scan);
+    EXPECT_TRUE(scan->reverse_);
+    std::vector<std::pair<int, int>> expected;
+    for (int i = 0; i < num_rows; i++) {
+      if (filter.empty() || i % 5 == 2) {
+        expected.emplace_back(i * 7 % 1000, i % 5);
+      }
+    }
+    std::sort(expected.rbegin(), expected.rend());
+    expected.resize(5);
+    std::vector<std::pair<int, int>> rows;
+    for (auto &row : query(sql)) {
+      rows.emplace_back(row_int(row, 0), row_int(row, 4));
+    }
+    EXPECT_EQ(expected, rows) << sql;
+  }
+
+  for (auto &[sql, val] : std::vector<std::pair<std::string, int>>{
+           {"select max(v) as m from t where v < 500;", 499},
+           {"select min(v) as m from t where v < 500;", 0},
+           {"select max(v) as m from t where v > 500;", 999},
+           {"select min(v) as m from t where v > 500;", 501},
+           {"select max(v) as m from t where v > 100 and v < 200;", 199},
+           {"select max(v) as m from t where v > 2000;", 0}}) {
+    auto scan = index_scan(sql);
+    ASSERT_NE(nullptr, scan);
+    EXPECT_EQ(1, scan->limit_) << sql;
+    auto rows = query(sql);
+    ASSERT_EQ(1u, rows.size()) << sql;
+    EXPECT_EQ(val, row_int(rows[0], 0)) << sql;
+  }
+}
+
+// 超出查询内存预算时不能溢出的算子抛出QueryMemoryLimitError；算子析构后预留的内存全部归还
+TEST_F(SqlTest, MemoryBudgetTest) {
+  execute("create table a (id int, v int);");
+  execute("create table b (id int, w int, s char(32));");
+  load_rows("a", "id,v", 10, [](int i) { return std::to_string(i) + "," + std::to_string(i); });
+  // b约2MB，超过1MB的预算
+  load_rows("b", "id,w,s", 50000, [](int i) { return std::to_string(i) + "," + std::to_string(i % 100) + ",s"; });
+  Condition cond{.lhs_col = {.tab_name = "a", .col_name = "id"}, .op = OP_EQ, .is_rhs_val = false,
+                 .rhs_col = {.tab_name = "b", .col_name = "id"}};
+  std::vector<std::shared_ptr<ast::OrderBy>> orders = {
+      std::make_shared<ast::OrderBy>(std::make_shared<ast::Col>("b", "w"), ast::OrderBy_ASC)};
+
+  // 嵌套循环连接的内表全部读入内存
+  auto budget = std::make_shared<MemoryBudget>(1 << 20);
+  auto nested_loop = std::make_unique<NestedLoopJoinExecutor>(seq_scan("a"), seq_scan("b"),
+                                                              std::vector<Condition>{cond}, budget);
+  EXPECT_THROW(collect(nested_loop.get()), QueryMemoryLimitError);
+  nested_loop.reset();
+  EXPECT_EQ(0u, budget->used());
+
+  // 没有DiskManager的排序不能溢出到临时文件
+  auto sort = std::make_unique<SortExecutor>(seq_scan("b"), orders, -1, budget);
+  EXPECT_THROW(collect(sort.get()), QueryMemoryLimitError);
+  sort.reset();
+  EXPECT_EQ(0u, budget->used());
+
+  // 预算足够时执行期间占用预算，析构后归还
+  budget = std::make_shared<MemoryBudget>(64 << 20);
+  nested_loop = std::make_unique<NestedLoopJoinExecutor>(seq_scan("a"), seq_scan("b"),
+                                                         std::vector<Condition>{cond}, budget);
+  sort = std::make_unique<SortExecutor>(std::move(nested_loop), orders, -1, budget);
+  auto rows = collect(sort.get());
+  ASSERT_EQ(10u, rows.size());
+  for (size_t i = 1; i < rows.size(); i++) {
+    EXPECT_LE(row_int(rows[i - 1], 12), row_int(rows[i], 12));
+  }
+  EXPECT_GT(budget->used(), 0u);
+  sort.reset();
+  EXPECT_EQ(0u, budget->used());
+}